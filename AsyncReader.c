@@ -0,0 +1,357 @@
+// FILE : AsyncReader.c
+// DESCRIPTION :
+//    Implements the read-ahead reader used by the database loads. The file is opened for
+//    overlapped I/O and ASYNC_READ_BUFFERS reads of ASYNC_READ_BLOCK_BYTES are kept in flight, so
+//    while the loader works through one block the next ones are already on their way; this hides
+//    the latency of each read, which dominates on network volumes. The blocks are VirtualAlloc'd,
+//    so they are page aligned and can also be read with FILE_FLAG_NO_BUFFERING. Lines are handed
+//    out like fgets would, continuing across block boundaries. If the file cannot be opened for
+//    overlapped I/O, or an overlapped read fails, each block is read synchronously at its offset
+//    when it is needed instead.
+//    A gzip or zstd file, told apart by its first bytes, is passed through a Decompressor as its
+//    blocks arrive and the lines are handed out from the decompressed chunks.
+#include "AsyncReader.h"
+#include "Compression.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_FREE 0 // Consumed, or past the end of the file
+#define BLOCK_ISSUED 1 // Overlapped read in flight or completed
+#define BLOCK_DEFERRED 2 // Read synchronously when needed
+
+struct AsyncReader {
+  HANDLE file;
+  int isOverlappedHandle; // 1 if the file was opened for overlapped I/O
+  int isOverlapped; // 0 once reads are made synchronously, one block at a time
+  char* buffers; // ASYNC_READ_BUFFERS blocks of ASYNC_READ_BLOCK_BYTES
+  OVERLAPPED requests[ASYNC_READ_BUFFERS];
+  int blockStates[ASYNC_READ_BUFFERS]; // BLOCK_*
+  long long fileSize; // Size when opened; blocks are requested up to here
+  long long nextReadOffset; // Offset of the next block to request
+  int nextBuffer; // Buffer of the next block in file order
+  const char* block; // Block being consumed
+  DWORD blockSize;
+  int isAtEnd;
+  Decompressor* decompressor; // NULL unless the file is compressed
+  const char* chunk; // Lines are read from here: the block, or decompressed data
+  size_t chunkSize;
+  size_t chunkPosition;
+  long long chunkOffset; // Offset of the chunk in the data read, compressed or not
+};
+
+// FUNCTION : requestBlock
+// DESCRIPTION :
+//    Issues the read of the next block of the file into a buffer. Synchronous readers only note
+//    the offset; the block is read when it is needed.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+//    int buffer: The free buffer to read into.
+// RETURNS :
+//    void
+static void requestBlock(AsyncReader* reader, int buffer) {
+  if (reader->nextReadOffset >= reader->fileSize) {
+    return; // Past the end of the file
+  }
+  OVERLAPPED* request = &reader->requests[buffer];
+  request->Internal = 0;
+  request->InternalHigh = 0;
+  request->Offset = (DWORD)(reader->nextReadOffset & 0xFFFFFFFF);
+  request->OffsetHigh = (DWORD)(reader->nextReadOffset >> 32);
+  reader->nextReadOffset += ASYNC_READ_BLOCK_BYTES;
+  reader->blockStates[buffer] = BLOCK_DEFERRED;
+  if (!reader->isOverlapped) {
+    return;
+  }
+  char* data = reader->buffers + (size_t)buffer * ASYNC_READ_BLOCK_BYTES;
+  if (ReadFile(reader->file, data, ASYNC_READ_BLOCK_BYTES, NULL, request) || GetLastError() == ERROR_IO_PENDING) {
+    reader->blockStates[buffer] = BLOCK_ISSUED;
+  }
+  else if (GetLastError() != ERROR_HANDLE_EOF) {
+    logGeneric("An overlapped read failed, reading the rest of the file synchronously.");
+    reader->isOverlapped = 0;
+  }
+}
+
+// FUNCTION : readBlockNow
+// DESCRIPTION :
+//    Reads a block synchronously at its offset, the Windows counterpart of pread.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+//    int buffer: The buffer to read into, whose request holds the offset.
+// RETURNS :
+//    DWORD : The number of bytes read, 0 at the end of the file or on error.
+static DWORD readBlockNow(AsyncReader* reader, int buffer) {
+  OVERLAPPED* request = &reader->requests[buffer];
+  char* data = reader->buffers + (size_t)buffer * ASYNC_READ_BLOCK_BYTES;
+  DWORD bytesRead = 0;
+  BOOL isRead = FALSE;
+  if (reader->isOverlappedHandle) {
+    // Reads on an overlapped handle always complete asynchronously, so wait for this one at once
+    isRead = ReadFile(reader->file, data, ASYNC_READ_BLOCK_BYTES, NULL, request) || GetLastError() == ERROR_IO_PENDING;
+    isRead = isRead && GetOverlappedResult(reader->file, request, &bytesRead, TRUE);
+  }
+  else {
+    isRead = ReadFile(reader->file, data, ASYNC_READ_BLOCK_BYTES, &bytesRead, request);
+  }
+  if (!isRead && GetLastError() != ERROR_HANDLE_EOF) {
+    logGeneric("Failed to read a database file.");
+  }
+  return isRead ? bytesRead : 0;
+}
+
+// FUNCTION : waitForBlock
+// DESCRIPTION :
+//    Waits for the read of a buffer to complete, or reads it synchronously.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+//    int buffer: The buffer whose block is needed next.
+// RETURNS :
+//    DWORD : The number of bytes read, 0 at the end of the file or on error.
+static DWORD waitForBlock(AsyncReader* reader, int buffer) {
+  if (reader->blockStates[buffer] == BLOCK_ISSUED) {
+    DWORD bytesRead = 0;
+    if (GetOverlappedResult(reader->file, &reader->requests[buffer], &bytesRead, TRUE)) {
+      return bytesRead;
+    }
+    if (GetLastError() == ERROR_HANDLE_EOF) {
+      return 0;
+    }
+    if (reader->isOverlapped) {
+      logGeneric("An overlapped read failed, reading the rest of the file synchronously.");
+      reader->isOverlapped = 0;
+    }
+  }
+  return readBlockNow(reader, buffer);
+}
+
+// FUNCTION : advanceBlock
+// DESCRIPTION :
+//    Moves on to the next block of the file, reusing the buffer of the block just consumed for a
+//    new read-ahead request.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+// RETURNS :
+//    int : 1 if a block with data is ready, 0 at the end of the file.
+static int advanceBlock(AsyncReader* reader) {
+  if (reader->isAtEnd) {
+    return 0;
+  }
+  if (reader->block != NULL) {
+    int consumedBuffer = (reader->nextBuffer + ASYNC_READ_BUFFERS - 1) % ASYNC_READ_BUFFERS;
+    reader->blockStates[consumedBuffer] = BLOCK_FREE;
+    int isShort = reader->blockSize < ASYNC_READ_BLOCK_BYTES;
+    reader->blockSize = 0;
+    if (isShort) {
+      reader->isAtEnd = 1; // A short block ends the file
+      return 0;
+    }
+    requestBlock(reader, consumedBuffer);
+  }
+  int buffer = reader->nextBuffer;
+  if (reader->blockStates[buffer] == BLOCK_FREE) {
+    reader->isAtEnd = 1;
+    return 0;
+  }
+  reader->block = reader->buffers + (size_t)buffer * ASYNC_READ_BLOCK_BYTES;
+  reader->blockSize = waitForBlock(reader, buffer);
+  reader->nextBuffer = (buffer + 1) % ASYNC_READ_BUFFERS;
+  if (reader->blockSize == 0) {
+    reader->isAtEnd = 1;
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : refillCompressedInput
+// DESCRIPTION :
+//    Hands the next block of a compressed file to its Decompressor.
+// PARAMETERS :
+//    void* context: The AsyncReader.
+//    const unsigned char** data: Receives the block.
+//    size_t* size: Receives the block size.
+// RETURNS :
+//    int : 1 if a block was read, 0 at the end of the file.
+static int refillCompressedInput(void* context, const unsigned char** data, size_t* size) {
+  AsyncReader* reader = (AsyncReader*)context;
+  if (!advanceBlock(reader)) {
+    return 0;
+  }
+  *data = (const unsigned char*)reader->block;
+  *size = reader->blockSize;
+  return 1;
+}
+
+// FUNCTION : advanceChunk
+// DESCRIPTION :
+//    Moves on to the next chunk of data to read lines from: the next block, or the next
+//    decompressed chunk of a compressed file.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+// RETURNS :
+//    int : 1 if a chunk with data is ready, 0 at the end of the file.
+static int advanceChunk(AsyncReader* reader) {
+  reader->chunkOffset += reader->chunkSize;
+  reader->chunkPosition = 0;
+  if (reader->decompressor != NULL) {
+    reader->chunkSize = readDecompressed(reader->decompressor, &reader->chunk);
+  }
+  else {
+    reader->chunkSize = advanceBlock(reader) ? reader->blockSize : 0;
+    reader->chunk = reader->block;
+  }
+  return reader->chunkSize > 0;
+}
+
+// FUNCTION : openAsyncReader
+// DESCRIPTION :
+//    Opens a file for reading, issues the first read-ahead requests and waits for the first
+//    block to tell whether the file is compressed.
+// PARAMETERS :
+//    const char* fileName: The file to read.
+// RETURNS :
+//    AsyncReader* : The reader, or NULL if the file could not be opened, is compressed in a format
+//      that cannot be read, or memory could not be allocated.
+AsyncReader* openAsyncReader(const char* fileName) {
+  AsyncReader* reader = (AsyncReader*)calloc(1, sizeof(AsyncReader));
+  if (reader == NULL) {
+    return NULL;
+  }
+  DWORD flags = FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN | (ASYNC_READ_NO_BUFFERING ? FILE_FLAG_NO_BUFFERING : 0);
+  reader->isOverlappedHandle = 1;
+  reader->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, flags, NULL);
+  if (reader->file == INVALID_HANDLE_VALUE) {
+    reader->isOverlappedHandle = 0;
+    reader->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  }
+  LARGE_INTEGER fileSize;
+  if (reader->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(reader->file, &fileSize)) {
+    if (reader->file != INVALID_HANDLE_VALUE) {
+      CloseHandle(reader->file);
+    }
+    free(reader);
+    return NULL;
+  }
+  reader->fileSize = fileSize.QuadPart;
+  reader->isOverlapped = reader->isOverlappedHandle;
+  reader->buffers = (char*)VirtualAlloc(NULL, (SIZE_T)ASYNC_READ_BUFFERS * ASYNC_READ_BLOCK_BYTES, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  int isReady = reader->buffers != NULL;
+  for (int i = 0; i < ASYNC_READ_BUFFERS && isReady; i++) {
+    // Each read in flight needs its own event to tell its completion apart
+    reader->requests[i].hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    isReady = reader->requests[i].hEvent != NULL;
+  }
+  if (!isReady) {
+    logGeneric("Failed to allocate the read buffers of a database file.");
+    closeAsyncReader(reader);
+    return NULL;
+  }
+  for (int i = 0; i < ASYNC_READ_BUFFERS; i++) {
+    requestBlock(reader, i);
+  }
+  if (!advanceBlock(reader)) {
+    return reader; // Empty file
+  }
+  int compression = getCompressionByMagic((const unsigned char*)reader->block, reader->blockSize);
+  if (compression == COMPRESSION_NONE) {
+    reader->chunk = reader->block;
+    reader->chunkSize = reader->blockSize;
+    return reader;
+  }
+  reader->decompressor = openDecompressor(compression, fileName, (const unsigned char*)reader->block, reader->blockSize,
+    refillCompressedInput, reader);
+  if (reader->decompressor == NULL) {
+    closeAsyncReader(reader);
+    return NULL;
+  }
+  return reader;
+}
+
+// FUNCTION : readAsyncLine
+// DESCRIPTION :
+//    Reads the next line, like fgets: up to size - 1 characters, stopping after a newline.
+//    A line may continue across any number of blocks or decompressed chunks.
+// PARAMETERS :
+//    AsyncReader* reader: The reader.
+//    char* line: Receives the line, ending with '\0'.
+//    int size: The size of the line buffer.
+// RETURNS :
+//    char* : The line, or NULL at the end of the file.
+char* readAsyncLine(AsyncReader* reader, char* line, int size) {
+  int length = 0;
+  while (length < size - 1) {
+    if (reader->chunkPosition == reader->chunkSize && !advanceChunk(reader)) {
+      break;
+    }
+    const char* start = reader->chunk + reader->chunkPosition;
+    size_t count = reader->chunkSize - reader->chunkPosition;
+    if (count > (size_t)(size - 1 - length)) {
+      count = (size_t)(size - 1 - length);
+    }
+    const char* newline = (const char*)memchr(start, '\n', count);
+    if (newline != NULL) {
+      count = (size_t)(newline - start + 1);
+    }
+    memcpy(line + length, start, count);
+    length += (int)count;
+    reader->chunkPosition += count;
+    if (newline != NULL) {
+      break;
+    }
+  }
+  line[length] = '\0';
+  return length > 0 ? line : NULL;
+}
+
+// FUNCTION : getAsyncReadOffset
+// DESCRIPTION :
+//    Gives the offset of the next character readAsyncLine will return: a file offset, or an
+//    offset in the decompressed data of a compressed file.
+// PARAMETERS :
+//    const AsyncReader* reader: The reader.
+// RETURNS :
+//    long long : The byte offset.
+long long getAsyncReadOffset(const AsyncReader* reader) {
+  return reader->chunkOffset + (long long)reader->chunkPosition;
+}
+
+// FUNCTION : isAsyncReaderCompressed
+// DESCRIPTION :
+//    Tells whether the file is compressed, in which case its lines cannot be read back by offset.
+// PARAMETERS :
+//    const AsyncReader* reader: The reader.
+// RETURNS :
+//    int : 1 if the file is compressed, 0 otherwise.
+int isAsyncReaderCompressed(const AsyncReader* reader) {
+  return reader->decompressor != NULL;
+}
+
+// FUNCTION : closeAsyncReader
+// DESCRIPTION :
+//    Waits for the reads still in flight, then closes the file and frees the buffers.
+// PARAMETERS :
+//    AsyncReader* reader: The reader, or NULL.
+// RETURNS :
+//    void
+void closeAsyncReader(AsyncReader* reader) {
+  if (reader == NULL) {
+    return;
+  }
+  closeDecompressor(reader->decompressor);
+  for (int i = 0; i < ASYNC_READ_BUFFERS; i++) {
+    if (reader->blockStates[i] == BLOCK_ISSUED) {
+      DWORD bytesRead = 0;
+      GetOverlappedResult(reader->file, &reader->requests[i], &bytesRead, TRUE); // The buffer must outlive the read
+    }
+    if (reader->requests[i].hEvent != NULL) {
+      CloseHandle(reader->requests[i].hEvent);
+    }
+  }
+  if (reader->buffers != NULL) {
+    VirtualFree(reader->buffers, 0, MEM_RELEASE);
+  }
+  CloseHandle(reader->file);
+  free(reader);
+}
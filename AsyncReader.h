@@ -0,0 +1,15 @@
+// FILE : AsyncReader.h
+// DESCRIPTION : This header file defines the read-ahead file reader that database loads read their lines with.
+#ifndef ASYNC_READER_H
+#define ASYNC_READER_H
+
+// Holds Windows handles, so its fields stay in AsyncReader.c
+typedef struct AsyncReader AsyncReader;
+
+AsyncReader* openAsyncReader(const char* fileName);
+char* readAsyncLine(AsyncReader* reader, char* line, int size);
+long long getAsyncReadOffset(const AsyncReader* reader);
+int isAsyncReaderCompressed(const AsyncReader* reader);
+void closeAsyncReader(AsyncReader* reader);
+
+#endif
@@ -0,0 +1,107 @@
+// FILE : Checksum.c
+// DESCRIPTION :
+//    Implements the whole-file checksum of trusted database files. The producer of a trusted file
+//    writes the CRC-32 (IEEE 802.3, as printed by common crc32 tools) of the file as 8 hex digits to
+//    <database>.crc32. The file is only loaded as trusted when the CRC of its bytes matches, so a
+//    truncated or corrupted copy is caught even though its fields are not checked one by one.
+#include "Checksum.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : updateCrc32
+// DESCRIPTION :
+//    Continues a CRC-32 over more bytes, so data can be checksummed a piece at a time. The table is
+//    built on first use; threads racing to build it write the same values.
+// PARAMETERS :
+//    unsigned long crc: The CRC-32 of the bytes so far, 0 for none.
+//    const void* data: The next bytes.
+//    size_t size: The number of bytes.
+// RETURNS :
+//    unsigned long : The CRC-32 of all the bytes.
+unsigned long updateCrc32(unsigned long crc, const void* data, size_t size) {
+  static unsigned long table[256];
+  static volatile int isTableReady = 0;
+  if (!isTableReady) {
+    for (unsigned long n = 0; n < 256; n++) {
+      unsigned long value = n;
+      for (int bit = 0; bit < 8; bit++) {
+        value = (value & 1) ? 0xEDB88320UL ^ (value >> 1) : value >> 1;
+      }
+      table[n] = value;
+    }
+    isTableReady = 1;
+  }
+  const unsigned char* bytes = (const unsigned char*)data;
+  unsigned long value = crc ^ 0xFFFFFFFFUL;
+  for (size_t i = 0; i < size; i++) {
+    value = table[(value ^ bytes[i]) & 0xFF] ^ (value >> 8);
+  }
+  return (value ^ 0xFFFFFFFFUL) & 0xFFFFFFFFUL;
+}
+
+// FUNCTION : computeFileCrc32
+// DESCRIPTION :
+//    Computes the CRC-32 of all the bytes of a file, read in binary mode.
+// PARAMETERS :
+//    const char* fileName: The file to checksum.
+//    unsigned long* crc: Receives the CRC-32.
+// RETURNS :
+//    int : 1 on success, 0 if the file could not be read.
+int computeFileCrc32(const char* fileName, unsigned long* crc) {
+  FILE* file = NULL;
+  errno_t err = fopen_s(&file, fileName, "rb");
+  if (err != 0 || file == NULL) {
+    return 0;
+  }
+  unsigned char* buffer = (unsigned char*)malloc(CHECKSUM_BUFFER_BYTES);
+  if (buffer == NULL) {
+    fclose(file);
+    return 0;
+  }
+  unsigned long value = 0;
+  size_t readCount;
+  while ((readCount = fread(buffer, 1, CHECKSUM_BUFFER_BYTES, file)) > 0) {
+    value = updateCrc32(value, buffer, readCount);
+  }
+  int isRead = !ferror(file);
+  free(buffer);
+  fclose(file);
+  *crc = value;
+  return isRead;
+}
+
+// FUNCTION : verifyFileChecksum
+// DESCRIPTION :
+//    Compares the CRC-32 of a database file with the one in its <database>.crc32 sidecar file.
+//    A missing sidecar or a mismatch is logged.
+// PARAMETERS :
+//    const char* fileName: The database file.
+// RETURNS :
+//    int : 1 if the checksums match, 0 otherwise.
+int verifyFileChecksum(const char* fileName) {
+  char checksumFileName[260];
+  char errorMessage[512];
+  snprintf(checksumFileName, sizeof(checksumFileName), "%s%s", fileName, CHECKSUM_SUFFIX);
+  FILE* checksumFile = NULL;
+  unsigned long expectedCrc = 0;
+  errno_t err = fopen_s(&checksumFile, checksumFileName, "r");
+  if (err != 0 || checksumFile == NULL) {
+    snprintf(errorMessage, sizeof(errorMessage), "Trusted file %s has no %s checksum file, validating every field.", fileName, CHECKSUM_SUFFIX);
+    logGeneric(errorMessage);
+    return 0;
+  }
+  int isParsed = fscanf_s(checksumFile, "%8lx", &expectedCrc) == 1;
+  fclose(checksumFile);
+  unsigned long actualCrc = 0;
+  if (!isParsed || !computeFileCrc32(fileName, &actualCrc) || actualCrc != expectedCrc) {
+    snprintf(errorMessage, sizeof(errorMessage), "Trusted file %s does not match its checksum (expected %08lx, found %08lx), validating every field.",
+      fileName, expectedCrc, actualCrc);
+    logGeneric(errorMessage);
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,12 @@
+// FILE : Checksum.h
+// DESCRIPTION : This header file defines the CRC-32 used by whole-file checks of trusted database files and by gzip files.
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+
+unsigned long updateCrc32(unsigned long crc, const void* data, size_t size);
+int computeFileCrc32(const char* fileName, unsigned long* crc);
+int verifyFileChecksum(const char* fileName);
+
+#endif
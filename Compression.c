@@ -0,0 +1,808 @@
+// FILE : Compression.c
+// DESCRIPTION :
+//    Implements gzip (and, when ZSTD_ENABLED, zstd) streams for database files. A database can
+//    be kept as customers.db.gz and the like; the loaders find it by name and read it through a
+//    Decompressor, which hands out decompressed bytes a chunk at a time so the whole file is never
+//    held in memory. Writers compress through a CompressedWriter.
+//    gzip files are written as a series of members of at most GZIP_MEMBER_BYTES each, and every
+//    member header carries its compressed size in a "BC" extra field, as BGZF does. Members do not
+//    refer to each other, so when the sizes are known a reader can pick out GZIP_PARALLEL_MEMBERS of
+//    them at once and decompress them on worker threads. Any other gzip file (e.g. from the gzip
+//    tool) is decompressed in order. Each member's CRC-32 and size are checked.
+#include "Compression.h"
+#include "Checksum.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if ZSTD_ENABLED
+#include <zstd.h>
+#endif
+
+#define GZIP_HEADER_BYTES 18 // Header written before each member, ending with the BC extra field
+#define GZIP_TRAILER_BYTES 8 // CRC-32 and size of the member's data
+#define GZIP_FLAG_HEADER_CRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+#define GZIP_MAX_MEMBER_DATA (64 * 1024) // Most bytes a member with a BC field holds
+
+#define STREAM_MEMBER_START 0 // A gzip member header or the end of the file is next
+#define STREAM_IN_MEMBER 1 // Decompressing a gzip member in order
+#define STREAM_MEMBER_GROUP 2 // Members decompressed in parallel, handed out next
+#define STREAM_ZSTD 3
+#define STREAM_END 4
+
+typedef struct {
+  size_t memberSize; // Size of the whole member from its BC extra field, 0 if it has none
+  size_t headerSize;
+} GzipHeader;
+
+typedef struct {
+  size_t inputOffset; // Of the member's deflate data in memberInput
+  size_t inputSize;
+  size_t outputOffset; // Of the member's data in memberOutput
+  size_t outputSize; // From the trailer
+  unsigned long crc; // From the trailer
+  int isValid;
+} MemberSpan;
+
+struct Decompressor {
+  char fileName[260];
+  ByteInput input;
+  int state; // STREAM_*
+  int isParallel; // 1 to decompress members with a BC field on worker threads
+  GzipHeader pendingHeader; // Header read past the end of a member group
+  int hasPendingHeader;
+  Inflater inflater;
+  unsigned char* window; // INFLATE_HISTORY_BYTES of history, then COMPRESSED_CHUNK_BYTES of output
+  unsigned long memberCrc; // Of the member's data so far
+  unsigned long memberSize;
+  unsigned char* memberInput; // Deflate data of a member group
+  size_t memberInputCapacity;
+  unsigned char* memberOutput; // Data of a member group
+  size_t memberOutputCapacity;
+  MemberSpan members[GZIP_PARALLEL_MEMBERS];
+  int memberCount;
+  size_t groupSize; // Bytes of memberOutput to hand out
+  int stateAfterGroup;
+#if ZSTD_ENABLED
+  ZSTD_DStream* zstd;
+  size_t zstdHint; // 0 once a frame is complete
+  int hasZstdOutput; // 1 if the last call filled the output, so more may be waiting
+#endif
+};
+
+typedef struct {
+  Decompressor* decompressor;
+  int workerIndex;
+  int workerCount;
+} MemberWork;
+
+struct CompressedWriter {
+  FILE* file;
+  int compression;
+  int isFailed;
+  unsigned char* data; // gzip: data of the member being filled
+  size_t dataSize;
+  int hasMembers; // gzip: 1 once a member was written
+  unsigned char* output; // Compressed bytes before they are written
+  size_t outputSize;
+  int* matchTable;
+#if ZSTD_ENABLED
+  ZSTD_CCtx* zstd;
+#endif
+};
+
+// FUNCTION : getCompressionByName
+// DESCRIPTION :
+//    Tells how a file is compressed from the end of its name.
+// PARAMETERS :
+//    const char* fileName: The file name.
+// RETURNS :
+//    int : COMPRESSION_GZIP for ".gz", COMPRESSION_ZSTD for ".zst", COMPRESSION_NONE otherwise.
+int getCompressionByName(const char* fileName) {
+  size_t length = strlen(fileName);
+  if (length >= strlen(".gz") && _stricmp(fileName + length - strlen(".gz"), ".gz") == 0) {
+    return COMPRESSION_GZIP;
+  }
+  if (length >= strlen(".zst") && _stricmp(fileName + length - strlen(".zst"), ".zst") == 0) {
+    return COMPRESSION_ZSTD;
+  }
+  return COMPRESSION_NONE;
+}
+
+// FUNCTION : getCompressionByMagic
+// DESCRIPTION :
+//    Tells how a file is compressed from its first bytes.
+// PARAMETERS :
+//    const unsigned char* data: The start of the file.
+//    size_t size: The number of bytes available.
+// RETURNS :
+//    int : COMPRESSION_GZIP, COMPRESSION_ZSTD or COMPRESSION_NONE.
+int getCompressionByMagic(const unsigned char* data, size_t size) {
+  if (size >= 2 && data[0] == 0x1F && data[1] == 0x8B) {
+    return COMPRESSION_GZIP;
+  }
+  if (size >= 4 && data[0] == 0x28 && data[1] == 0xB5 && data[2] == 0x2F && data[3] == 0xFD) {
+    return COMPRESSION_ZSTD;
+  }
+  return COMPRESSION_NONE;
+}
+
+// FUNCTION : resolveDatabaseFile
+// DESCRIPTION :
+//    Finds the file a database is kept in: the file itself, or else a compressed copy of it with
+//    ".gz" or ".zst" added to its name.
+// PARAMETERS :
+//    const char* fileName: The database file name, e.g. "orders.db".
+//    char* sourceFileName: Receives the file to read, e.g. "orders.db.gz". The database file name
+//      if none of them exists, so opening it fails as before.
+//    int size: The size of the sourceFileName buffer.
+// RETURNS :
+//    void
+void resolveDatabaseFile(const char* fileName, char* sourceFileName, int size) {
+  static const char* suffixes[] = { "", ".gz", ".zst" };
+  for (int i = 0; i < (int)(sizeof(suffixes) / sizeof(suffixes[0])); i++) {
+    snprintf(sourceFileName, size, "%s%s", fileName, suffixes[i]);
+    if (GetFileAttributesA(sourceFileName) != INVALID_FILE_ATTRIBUTES) {
+      return;
+    }
+  }
+  strcpy_s(sourceFileName, size, fileName);
+}
+
+// FUNCTION : readLittleEndian
+// DESCRIPTION :
+//    Reads an unsigned little-endian number, as gzip stores them.
+// PARAMETERS :
+//    const unsigned char* bytes: The number.
+//    int count: Its size in bytes, at most 4.
+// RETURNS :
+//    unsigned long : The number.
+static unsigned long readLittleEndian(const unsigned char* bytes, int count) {
+  unsigned long value = 0;
+  for (int i = count - 1; i >= 0; i--) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+// FUNCTION : writeLittleEndian
+// DESCRIPTION :
+//    Writes an unsigned little-endian number.
+// PARAMETERS :
+//    unsigned char* bytes: Receives the number.
+//    unsigned long value: The number.
+//    int count: Its size in bytes.
+// RETURNS :
+//    void
+static void writeLittleEndian(unsigned char* bytes, unsigned long value, int count) {
+  for (int i = 0; i < count; i++) {
+    bytes[i] = (unsigned char)(value >> (8 * i));
+  }
+}
+
+// FUNCTION : reportCorruptStream
+// DESCRIPTION :
+//    Logs that a compressed file cannot be read past some point and ends the stream there.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+// RETURNS :
+//    void
+static void reportCorruptStream(Decompressor* decompressor) {
+  char errorMessage[400];
+  snprintf(errorMessage, sizeof(errorMessage), "Compressed file %s is corrupt or truncated, it was only read up to the damage.",
+    decompressor->fileName);
+  logGeneric(errorMessage);
+  decompressor->state = STREAM_END;
+}
+
+// FUNCTION : readGzipHeader
+// DESCRIPTION :
+//    Reads the header of the next gzip member, noting the member size from a BC extra field.
+// PARAMETERS :
+//    ByteInput* input: The compressed file.
+//    GzipHeader* header: Receives the member size and the header size.
+// RETURNS :
+//    int : 1 if a header was read, 0 at the end of the file, -1 if the header is corrupt.
+static int readGzipHeader(ByteInput* input, GzipHeader* header) {
+  unsigned char fixed[10];
+  int first = readInputByte(input);
+  if (first < 0) {
+    return 0;
+  }
+  fixed[0] = (unsigned char)first;
+  if (!readInputBytes(input, fixed + 1, sizeof(fixed) - 1) || fixed[0] != 0x1F || fixed[1] != 0x8B || fixed[2] != 8 || (fixed[3] & 0xE0) != 0) {
+    return -1;
+  }
+  header->memberSize = 0;
+  header->headerSize = sizeof(fixed);
+  if (fixed[3] & GZIP_FLAG_EXTRA) {
+    unsigned char bytes[4];
+    if (!readInputBytes(input, bytes, 2)) {
+      return -1;
+    }
+    size_t extraSize = readLittleEndian(bytes, 2);
+    header->headerSize += 2 + extraSize;
+    while (extraSize >= 4) {
+      if (!readInputBytes(input, bytes, 4)) {
+        return -1;
+      }
+      size_t fieldSize = readLittleEndian(bytes + 2, 2);
+      extraSize -= 4;
+      if (fieldSize > extraSize) {
+        return -1;
+      }
+      extraSize -= fieldSize;
+      if (bytes[0] == 'B' && bytes[1] == 'C' && fieldSize == 2) {
+        if (!readInputBytes(input, bytes, 2)) {
+          return -1;
+        }
+        header->memberSize = readLittleEndian(bytes, 2) + 1;
+      }
+      else if (!readInputBytes(input, NULL, fieldSize)) {
+        return -1;
+      }
+    }
+    if (!readInputBytes(input, NULL, extraSize)) {
+      return -1;
+    }
+  }
+  for (int flag = GZIP_FLAG_NAME; flag <= GZIP_FLAG_COMMENT; flag <<= 1) {
+    if (fixed[3] & flag) {
+      int character;
+      do {
+        character = readInputByte(input);
+        header->headerSize++;
+      } while (character > 0);
+      if (character < 0) {
+        return -1;
+      }
+    }
+  }
+  if (fixed[3] & GZIP_FLAG_HEADER_CRC) {
+    header->headerSize += 2;
+    if (!readInputBytes(input, NULL, 2)) {
+      return -1;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : decodeMembersWorker
+// DESCRIPTION :
+//    Thread worker that decompresses every workerCount-th member of a group and checks its CRC-32.
+// PARAMETERS :
+//    void* argument: The MemberWork of this worker.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall decodeMembersWorker(void* argument) {
+  MemberWork* work = (MemberWork*)argument;
+  Decompressor* decompressor = work->decompressor;
+  Inflater inflater;
+  for (int i = work->workerIndex; i < decompressor->memberCount; i += work->workerCount) {
+    MemberSpan* member = &decompressor->members[i];
+    ByteInput input = { decompressor->memberInput + member->inputOffset, member->inputSize, 0, NULL, NULL };
+    unsigned char* output = decompressor->memberOutput + member->outputOffset;
+    initInflater(&inflater, &input, output, member->outputSize, 1);
+    member->isValid = inflateData(&inflater) == INFLATE_END && inflater.outputPosition == member->outputSize
+      && updateCrc32(0, output, member->outputSize) == member->crc;
+  }
+  return 0;
+}
+
+// FUNCTION : growBuffer
+// DESCRIPTION :
+//    Makes sure a buffer holds at least a number of bytes, keeping its contents.
+// PARAMETERS :
+//    unsigned char** buffer: The buffer, reallocated if needed.
+//    size_t* capacity: Its size, updated if reallocated.
+//    size_t size: The size needed.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int growBuffer(unsigned char** buffer, size_t* capacity, size_t size) {
+  if (size <= *capacity) {
+    return 1;
+  }
+  size_t newCapacity = *capacity == 0 ? GZIP_MAX_MEMBER_DATA : *capacity;
+  while (newCapacity < size) {
+    newCapacity *= 2;
+  }
+  unsigned char* newBuffer = (unsigned char*)realloc(*buffer, newCapacity);
+  if (newBuffer == NULL) {
+    return 0;
+  }
+  *buffer = newBuffer;
+  *capacity = newCapacity;
+  return 1;
+}
+
+// FUNCTION : decodeMemberGroup
+// DESCRIPTION :
+//    Reads up to GZIP_PARALLEL_MEMBERS members whose headers give their size, starting with the
+//    one whose header was just read, and decompresses them on worker threads. The group ends early
+//    at a member without a BC field, which is then decompressed in order.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+//    const GzipHeader* header: The header of the first member.
+// RETURNS :
+//    void
+static void decodeMemberGroup(Decompressor* decompressor, const GzipHeader* header) {
+  GzipHeader next = *header;
+  size_t inputSize = 0;
+  size_t outputSize = 0;
+  int isCorrupt = 0;
+  decompressor->memberCount = 0;
+  decompressor->stateAfterGroup = STREAM_MEMBER_START;
+  while (1) {
+    if (next.memberSize < next.headerSize + GZIP_TRAILER_BYTES) {
+      isCorrupt = 1;
+      break;
+    }
+    size_t dataSize = next.memberSize - next.headerSize;
+    if (!growBuffer(&decompressor->memberInput, &decompressor->memberInputCapacity, inputSize + dataSize)) {
+      logGeneric("Failed to allocate memory for decompressing a database file.");
+      isCorrupt = 1;
+      break;
+    }
+    unsigned char* data = decompressor->memberInput + inputSize;
+    if (!readInputBytes(&decompressor->input, data, dataSize)) {
+      isCorrupt = 1;
+      break;
+    }
+    MemberSpan* member = &decompressor->members[decompressor->memberCount++];
+    member->inputOffset = inputSize;
+    member->inputSize = dataSize - GZIP_TRAILER_BYTES;
+    member->crc = readLittleEndian(data + member->inputSize, 4);
+    member->outputOffset = outputSize;
+    member->outputSize = readLittleEndian(data + member->inputSize + 4, 4);
+    if (member->outputSize > GZIP_MAX_MEMBER_DATA) {
+      decompressor->memberCount--;
+      isCorrupt = 1;
+      break;
+    }
+    inputSize += dataSize;
+    outputSize += member->outputSize;
+    if (decompressor->memberCount == GZIP_PARALLEL_MEMBERS) {
+      break;
+    }
+    int result = readGzipHeader(&decompressor->input, &next);
+    if (result <= 0) {
+      isCorrupt = result < 0;
+      decompressor->stateAfterGroup = STREAM_END;
+      break;
+    }
+    if (next.memberSize == 0) {
+      decompressor->pendingHeader = next;
+      decompressor->hasPendingHeader = 1;
+      break;
+    }
+  }
+  if (!growBuffer(&decompressor->memberOutput, &decompressor->memberOutputCapacity, outputSize)) {
+    logGeneric("Failed to allocate memory for decompressing a database file.");
+    decompressor->memberCount = 0;
+    isCorrupt = 1;
+  }
+  MemberWork work[MAX_WORKER_THREADS];
+  int workerCount = getTaskWorkerCount(decompressor->memberCount);
+  for (int w = 0; w < workerCount; w++) {
+    work[w].decompressor = decompressor;
+    work[w].workerIndex = w;
+    work[w].workerCount = workerCount;
+  }
+  runWorkers(decodeMembersWorker, work, sizeof(MemberWork), workerCount);
+  // Hand out the members up to the first one that failed
+  decompressor->groupSize = 0;
+  for (int i = 0; i < decompressor->memberCount; i++) {
+    if (!decompressor->members[i].isValid) {
+      isCorrupt = 1;
+      break;
+    }
+    decompressor->groupSize += decompressor->members[i].outputSize;
+  }
+  if (isCorrupt) {
+    reportCorruptStream(decompressor);
+    decompressor->stateAfterGroup = STREAM_END;
+  }
+  decompressor->state = STREAM_MEMBER_GROUP;
+}
+
+// FUNCTION : startMember
+// DESCRIPTION :
+//    Reads the header of the next gzip member and gets ready to decompress it: in parallel with
+//    the members after it if its header gives its size, in order otherwise.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+// RETURNS :
+//    void
+static void startMember(Decompressor* decompressor) {
+  GzipHeader header = decompressor->pendingHeader;
+  if (!decompressor->hasPendingHeader) {
+    int result = readGzipHeader(&decompressor->input, &header);
+    if (result <= 0) {
+      if (result < 0) {
+        reportCorruptStream(decompressor);
+      }
+      decompressor->state = STREAM_END;
+      return;
+    }
+  }
+  decompressor->hasPendingHeader = 0;
+  if (header.memberSize > 0 && decompressor->isParallel) {
+    decodeMemberGroup(decompressor, &header);
+    return;
+  }
+  initInflater(&decompressor->inflater, &decompressor->input, decompressor->window, INFLATE_HISTORY_BYTES + COMPRESSED_CHUNK_BYTES, 0);
+  decompressor->memberCrc = 0;
+  decompressor->memberSize = 0;
+  decompressor->state = STREAM_IN_MEMBER;
+}
+
+// FUNCTION : readMemberData
+// DESCRIPTION :
+//    Decompresses the next chunk of the member being read in order. Once the member ends, its
+//    trailer is checked against the data.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+//    const char** data: Receives the chunk.
+// RETURNS :
+//    size_t : The size of the chunk, possibly 0 when a member ends.
+static size_t readMemberData(Decompressor* decompressor, const char** data) {
+  Inflater* inflater = &decompressor->inflater;
+  if (inflater->outputSize - inflater->outputPosition < INFLATE_MAX_MATCH) {
+    // The chunk before was handed out already, only keep what back-references can reach
+    memmove(decompressor->window, decompressor->window + inflater->outputPosition - INFLATE_HISTORY_BYTES, INFLATE_HISTORY_BYTES);
+    inflater->outputPosition = INFLATE_HISTORY_BYTES;
+  }
+  size_t start = inflater->outputPosition;
+  int result = inflateData(inflater);
+  size_t size = inflater->outputPosition - start;
+  decompressor->memberCrc = updateCrc32(decompressor->memberCrc, decompressor->window + start, size);
+  decompressor->memberSize += (unsigned long)size;
+  if (result == INFLATE_END) {
+    unsigned char trailer[GZIP_TRAILER_BYTES];
+    if (readInputBytes(&decompressor->input, trailer, sizeof(trailer)) && readLittleEndian(trailer, 4) == decompressor->memberCrc
+      && readLittleEndian(trailer + 4, 4) == (decompressor->memberSize & 0xFFFFFFFFUL)) {
+      decompressor->state = STREAM_MEMBER_START;
+    }
+    else {
+      reportCorruptStream(decompressor);
+    }
+  }
+  else if (result == INFLATE_ERROR) {
+    reportCorruptStream(decompressor);
+  }
+  *data = (const char*)decompressor->window + start;
+  return size;
+}
+
+#if ZSTD_ENABLED
+// FUNCTION : readZstdData
+// DESCRIPTION :
+//    Decompresses the next chunk of a zstd file, frame after frame.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+//    const char** data: Receives the chunk.
+// RETURNS :
+//    size_t : The size of the chunk, 0 at the end of the file.
+static size_t readZstdData(Decompressor* decompressor, const char** data) {
+  ByteInput* input = &decompressor->input;
+  while (1) {
+    if (input->position == input->size && !decompressor->hasZstdOutput) {
+      if (input->refill == NULL || !input->refill(input->context, &input->data, &input->size)) {
+        if (decompressor->zstdHint != 0) {
+          reportCorruptStream(decompressor); // Ends inside a frame
+        }
+        decompressor->state = STREAM_END;
+        return 0;
+      }
+      input->position = 0;
+    }
+    ZSTD_inBuffer in = { input->data, input->size, input->position };
+    ZSTD_outBuffer out = { decompressor->window, COMPRESSED_CHUNK_BYTES, 0 };
+    size_t result = ZSTD_decompressStream(decompressor->zstd, &out, &in);
+    input->position = in.pos;
+    if (ZSTD_isError(result)) {
+      reportCorruptStream(decompressor);
+      return 0;
+    }
+    decompressor->zstdHint = result;
+    decompressor->hasZstdOutput = out.pos == out.size;
+    if (out.pos > 0) {
+      *data = (const char*)decompressor->window;
+      return out.pos;
+    }
+  }
+}
+#endif
+
+// FUNCTION : openDecompressor
+// DESCRIPTION :
+//    Starts decompressing a file whose compressed bytes come from a refill callback.
+// PARAMETERS :
+//    int compression: COMPRESSION_GZIP or COMPRESSION_ZSTD.
+//    const char* fileName: The file, for error messages.
+//    const unsigned char* data: Compressed bytes already read, or NULL.
+//    size_t size: The number of bytes already read.
+//    InputRefillFunction refill: Supplies the rest of the compressed bytes.
+//    void* context: Passed to refill.
+// RETURNS :
+//    Decompressor* : The stream, or NULL if the format is not supported or memory could not be allocated.
+Decompressor* openDecompressor(int compression, const char* fileName, const unsigned char* data, size_t size,
+  InputRefillFunction refill, void* context) {
+  char errorMessage[400];
+#if !ZSTD_ENABLED
+  if (compression == COMPRESSION_ZSTD) {
+    snprintf(errorMessage, sizeof(errorMessage), "%s is zstd compressed, which this build cannot read (see ZSTD_ENABLED).", fileName);
+    logGeneric(errorMessage);
+    return NULL;
+  }
+#endif
+  Decompressor* decompressor = (Decompressor*)calloc(1, sizeof(Decompressor));
+  if (decompressor == NULL) {
+    return NULL;
+  }
+  strcpy_s(decompressor->fileName, sizeof(decompressor->fileName), fileName);
+  decompressor->input.data = data;
+  decompressor->input.size = data == NULL ? 0 : size;
+  decompressor->input.refill = refill;
+  decompressor->input.context = context;
+  decompressor->window = (unsigned char*)malloc(INFLATE_HISTORY_BYTES + COMPRESSED_CHUNK_BYTES);
+  int isReady = decompressor->window != NULL;
+  decompressor->state = STREAM_MEMBER_START;
+  decompressor->isParallel = getTaskWorkerCount(2) > 1;
+#if ZSTD_ENABLED
+  if (compression == COMPRESSION_ZSTD) {
+    decompressor->zstd = ZSTD_createDStream();
+    isReady = isReady && decompressor->zstd != NULL && !ZSTD_isError(ZSTD_initDStream(decompressor->zstd));
+    decompressor->state = STREAM_ZSTD;
+  }
+#endif
+  if (!isReady) {
+    snprintf(errorMessage, sizeof(errorMessage), "Failed to allocate memory for decompressing %s.", fileName);
+    logGeneric(errorMessage);
+    closeDecompressor(decompressor);
+    return NULL;
+  }
+  return decompressor;
+}
+
+// FUNCTION : readDecompressed
+// DESCRIPTION :
+//    Decompresses the next chunk of the file. The chunk stays valid until the next call.
+//    A corrupt or truncated file is logged and read as if it ended at the damage.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream.
+//    const char** data: Receives the chunk.
+// RETURNS :
+//    size_t : The size of the chunk, 0 at the end of the file.
+size_t readDecompressed(Decompressor* decompressor, const char** data) {
+  while (1) {
+    size_t size = 0;
+    switch (decompressor->state) {
+    case STREAM_MEMBER_START:
+      startMember(decompressor);
+      break;
+    case STREAM_IN_MEMBER:
+      size = readMemberData(decompressor, data);
+      break;
+    case STREAM_MEMBER_GROUP:
+      *data = (const char*)decompressor->memberOutput;
+      size = decompressor->groupSize;
+      decompressor->state = decompressor->stateAfterGroup;
+      break;
+#if ZSTD_ENABLED
+    case STREAM_ZSTD:
+      return readZstdData(decompressor, data);
+#endif
+    default:
+      return 0;
+    }
+    if (size > 0) {
+      return size;
+    }
+  }
+}
+
+// FUNCTION : closeDecompressor
+// DESCRIPTION :
+//    Frees a stream.
+// PARAMETERS :
+//    Decompressor* decompressor: The stream, or NULL.
+// RETURNS :
+//    void
+void closeDecompressor(Decompressor* decompressor) {
+  if (decompressor == NULL) {
+    return;
+  }
+#if ZSTD_ENABLED
+  if (decompressor->zstd != NULL) {
+    ZSTD_freeDStream(decompressor->zstd);
+  }
+#endif
+  free(decompressor->window);
+  free(decompressor->memberInput);
+  free(decompressor->memberOutput);
+  free(decompressor);
+}
+
+// FUNCTION : writeOutput
+// DESCRIPTION :
+//    Writes bytes to the file of a writer, noting a failure.
+// PARAMETERS :
+//    CompressedWriter* writer: The writer.
+//    const void* data: The bytes.
+//    size_t size: The number of bytes.
+// RETURNS :
+//    void
+static void writeOutput(CompressedWriter* writer, const void* data, size_t size) {
+  if (size > 0 && fwrite(data, 1, size, writer->file) != size) {
+    writer->isFailed = 1;
+  }
+}
+
+// FUNCTION : writeGzipMember
+// DESCRIPTION :
+//    Compresses the data gathered so far into one gzip member, whose header gives its size.
+// PARAMETERS :
+//    CompressedWriter* writer: The writer.
+// RETURNS :
+//    void
+static void writeGzipMember(CompressedWriter* writer) {
+  unsigned char* member = writer->output;
+  size_t deflatedSize = deflateData(writer->data, writer->dataSize, member + GZIP_HEADER_BYTES,
+    writer->outputSize - GZIP_HEADER_BYTES - GZIP_TRAILER_BYTES, writer->matchTable);
+  size_t memberSize = GZIP_HEADER_BYTES + deflatedSize + GZIP_TRAILER_BYTES;
+  static const unsigned char header[GZIP_HEADER_BYTES - 2] = {
+    0x1F, 0x8B, 8, GZIP_FLAG_EXTRA, 0, 0, 0, 0, 0, 0xFF, // No time stamp, unknown OS
+    6, 0, 'B', 'C', 2, 0 // One extra field, BC, holding the member size - 1
+  };
+  memcpy(member, header, sizeof(header));
+  writeLittleEndian(member + sizeof(header), (unsigned long)(memberSize - 1), 2);
+  writeLittleEndian(member + GZIP_HEADER_BYTES + deflatedSize, updateCrc32(0, writer->data, writer->dataSize), 4);
+  writeLittleEndian(member + GZIP_HEADER_BYTES + deflatedSize + 4, (unsigned long)writer->dataSize, 4);
+  writeOutput(writer, member, memberSize);
+  writer->dataSize = 0;
+  writer->hasMembers = 1;
+}
+
+#if ZSTD_ENABLED
+// FUNCTION : compressZstd
+// DESCRIPTION :
+//    Passes data through the zstd compressor, writing what comes out.
+// PARAMETERS :
+//    CompressedWriter* writer: The writer.
+//    const char* data: The data, or NULL when ending the frame.
+//    size_t size: The data size.
+//    ZSTD_EndDirective directive: ZSTD_e_continue, or ZSTD_e_end to end the frame.
+// RETURNS :
+//    void
+static void compressZstd(CompressedWriter* writer, const char* data, size_t size, ZSTD_EndDirective directive) {
+  ZSTD_inBuffer in = { data, size, 0 };
+  size_t remaining;
+  do {
+    ZSTD_outBuffer out = { writer->output, writer->outputSize, 0 };
+    remaining = ZSTD_compressStream2(writer->zstd, &out, &in, directive);
+    if (ZSTD_isError(remaining)) {
+      writer->isFailed = 1;
+      return;
+    }
+    writeOutput(writer, writer->output, out.pos);
+  } while (directive == ZSTD_e_end ? remaining != 0 : in.pos < in.size);
+}
+#endif
+
+// FUNCTION : openCompressedWriter
+// DESCRIPTION :
+//    Starts writing compressed data to an open file. The caller opens the file ("wb" unless
+//    compression is COMPRESSION_NONE) and closes it after closeCompressedWriter.
+// PARAMETERS :
+//    FILE* file: The file to write to.
+//    int compression: COMPRESSION_NONE to write the data as is, COMPRESSION_GZIP or COMPRESSION_ZSTD.
+// RETURNS :
+//    CompressedWriter* : The writer, or NULL if the format is not supported or memory could not be allocated.
+CompressedWriter* openCompressedWriter(FILE* file, int compression) {
+#if !ZSTD_ENABLED
+  if (compression == COMPRESSION_ZSTD) {
+    logGeneric("zstd output is not supported by this build (see ZSTD_ENABLED).");
+    return NULL;
+  }
+#endif
+  CompressedWriter* writer = (CompressedWriter*)calloc(1, sizeof(CompressedWriter));
+  if (writer == NULL) {
+    logGeneric("Failed to allocate memory for writing a compressed file.");
+    return NULL;
+  }
+  writer->file = file;
+  writer->compression = compression;
+  int isReady = 1;
+  if (compression == COMPRESSION_GZIP) {
+    writer->outputSize = GZIP_HEADER_BYTES + getDeflateBound(GZIP_MEMBER_BYTES) + GZIP_TRAILER_BYTES;
+    writer->data = (unsigned char*)malloc(GZIP_MEMBER_BYTES);
+    writer->output = (unsigned char*)malloc(writer->outputSize);
+    writer->matchTable = (int*)malloc(DEFLATE_MATCH_TABLE_ENTRIES * sizeof(int));
+    isReady = writer->data != NULL && writer->output != NULL && writer->matchTable != NULL;
+  }
+#if ZSTD_ENABLED
+  else if (compression == COMPRESSION_ZSTD) {
+    writer->outputSize = ZSTD_CStreamOutSize();
+    writer->output = (unsigned char*)malloc(writer->outputSize);
+    writer->zstd = ZSTD_createCCtx();
+    isReady = writer->output != NULL && writer->zstd != NULL;
+  }
+#endif
+  if (!isReady) {
+    logGeneric("Failed to allocate memory for writing a compressed file.");
+    writer->compression = COMPRESSION_NONE; // Nothing to flush
+    closeCompressedWriter(writer);
+    return NULL;
+  }
+  return writer;
+}
+
+// FUNCTION : writeCompressed
+// DESCRIPTION :
+//    Compresses and writes data. gzip data is gathered into members of GZIP_MEMBER_BYTES.
+// PARAMETERS :
+//    CompressedWriter* writer: The writer.
+//    const char* data: The data.
+//    size_t size: The data size.
+// RETURNS :
+//    int : 1 if everything so far was written, 0 after a write error.
+int writeCompressed(CompressedWriter* writer, const char* data, size_t size) {
+  if (writer->compression == COMPRESSION_GZIP) {
+    while (size > 0) {
+      size_t count = GZIP_MEMBER_BYTES - writer->dataSize;
+      if (count > size) {
+        count = size;
+      }
+      memcpy(writer->data + writer->dataSize, data, count);
+      writer->dataSize += count;
+      data += count;
+      size -= count;
+      if (writer->dataSize == GZIP_MEMBER_BYTES) {
+        writeGzipMember(writer);
+      }
+    }
+  }
+#if ZSTD_ENABLED
+  else if (writer->compression == COMPRESSION_ZSTD) {
+    compressZstd(writer, data, size, ZSTD_e_continue);
+  }
+#endif
+  else {
+    writeOutput(writer, data, size);
+  }
+  return !writer->isFailed;
+}
+
+// FUNCTION : closeCompressedWriter
+// DESCRIPTION :
+//    Writes the data still held by a writer and frees it. The file stays open.
+// PARAMETERS :
+//    CompressedWriter* writer: The writer.
+// RETURNS :
+//    int : 1 if all the data was written, 0 after a write error.
+int closeCompressedWriter(CompressedWriter* writer) {
+  if (writer->compression == COMPRESSION_GZIP && (writer->dataSize > 0 || !writer->hasMembers)) {
+    writeGzipMember(writer); // Empty data still makes one member, so the file is valid gzip
+  }
+#if ZSTD_ENABLED
+  if (writer->compression == COMPRESSION_ZSTD) {
+    compressZstd(writer, NULL, 0, ZSTD_e_end);
+  }
+  if (writer->zstd != NULL) {
+    ZSTD_freeCCtx(writer->zstd);
+  }
+#endif
+  int isWritten = !writer->isFailed && fflush(writer->file) == 0;
+  free(writer->data);
+  free(writer->output);
+  free(writer->matchTable);
+  free(writer);
+  return isWritten;
+}
@@ -0,0 +1,31 @@
+// FILE : Compression.h
+// DESCRIPTION : This header file defines the gzip and zstd streams that database files can be read from and written to.
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "Deflate.h"
+#include <stdio.h>
+#include <stddef.h>
+
+#define COMPRESSION_NONE 0
+#define COMPRESSION_GZIP 1 // .gz
+#define COMPRESSION_ZSTD 2 // .zst
+
+// Holds library state when zstd is enabled, so its fields stay in Compression.c
+typedef struct Decompressor Decompressor;
+typedef struct CompressedWriter CompressedWriter;
+
+int getCompressionByName(const char* fileName);
+int getCompressionByMagic(const unsigned char* data, size_t size);
+void resolveDatabaseFile(const char* fileName, char* sourceFileName, int size);
+
+Decompressor* openDecompressor(int compression, const char* fileName, const unsigned char* data, size_t size,
+  InputRefillFunction refill, void* context);
+size_t readDecompressed(Decompressor* decompressor, const char** data);
+void closeDecompressor(Decompressor* decompressor);
+
+CompressedWriter* openCompressedWriter(FILE* file, int compression);
+int writeCompressed(CompressedWriter* writer, const char* data, size_t size);
+int closeCompressedWriter(CompressedWriter* writer);
+
+#endif
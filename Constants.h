@@ -13,6 +13,56 @@
 #define CUSTOMERS_FILE "customers.db"
 #define PARTS_FILE "parts.db"
 #define ORDERS_FILE "orders.db"
+#define RECEIPTS_FILE "receipts.db" // partID|quantity| lines of stock received
+#define PAYMENTS_FILE "payments.db" // customerID|amount|date| lines applied to the customer balances
 #define LOG_FILE "runtimelog.txt"
+#define METRICS_FILE "metrics.prom" // Prometheus text file with the load metrics, written after each load and on exit
+#define ORDER_SHARD_FILE_FORMAT "orders.%03d.db" // Orders sharded by customerID, one file per shard
+#define ORDER_SHARD_COUNT 256
+#define ORDER_PAGE_FILE "orders.pages" // Work file of the paged order store, deleted when the store is closed
+
+#define FIELDS_LOADED 0 // All fields of a customer or part record are parsed
+#define FIELDS_PENDING 1 // Text fields are parsed from the database on first use
+#define FIELDS_INVALID -1 // Text fields failed validation when first used
+
+#define QUARANTINE_LINES_SUFFIX ".rejected.db" // Rejected lines of a database, e.g. orders.rejected.db
+#define QUARANTINE_REASONS_SUFFIX ".rejected.idx" // Why each quarantined line was rejected
+#define REINGEST_SUFFIX ".reingest.db" // Work file holding quarantined lines while they are loaded again
+#define QUARANTINE_BUFFER_BYTES (64 * 1024) // stdio buffer of each quarantine file
+#define CHECKSUM_SUFFIX ".crc32" // CRC-32 of a trusted database as 8 hex digits, e.g. orders.db.crc32
+#define CHECKSUM_BUFFER_BYTES (64 * 1024) // Read size when checksumming a trusted database
+
+#define WATCH_POLL_MS 250 // How often the watcher checks for a key press while waiting for changes
+#define WATCH_DEBOUNCE_MS 200 // Delay after a change notification so the writer can finish
+
+#define MAX_WORKER_THREADS 32 // Upper bound on threads used by parallel passes (at most 64 for WaitForMultipleObjects)
+#define PARALLEL_MIN_ITEMS 65536 // Inputs smaller than this are processed on the calling thread
+
+#define PICK_WAVE_ORDERS 25 // Number of fulfilled orders batched into one pick wave
+
+#define ASYNC_READ_BLOCK_BYTES (256 * 1024) // Size of each read of a database file, a multiple of the sector size
+#define ASYNC_READ_BUFFERS 4 // Reads of a database file kept in flight
+#define ASYNC_READ_NO_BUFFERING 0 // 1 to read database files around the file cache (FILE_FLAG_NO_BUFFERING)
+#define PIPELINE_BATCH_LINES 256 // Most lines passed between load pipeline stages at a time
+#define PIPELINE_BATCH_BYTES (64 * 1024) // Text of the lines in one batch, besides room for one more line
+#define PIPELINE_BATCH_COUNT 4 // Batches in flight between the stages of one load
+#define PIPELINE_SPIN_COUNT 1024 // Times a stage spins waiting for another before it sleeps
+#define STAGED_ORDERS_INITIAL_LINES 1024 // Order lines staged before the buffers first grow
+#define PAYMENTS_INITIAL_LINES 4096 // Payments read before the payment list first grows
+
+#define COMPRESSED_CHUNK_BYTES (256 * 1024) // Decompressed bytes handed out at a time when a gzip stream is read in order
+#define GZIP_MEMBER_BYTES 0xFF00 // Most bytes compressed into one gzip member, so each member stays under 64 KB
+#define GZIP_PARALLEL_MEMBERS 64 // Independent gzip members decompressed together on worker threads
+#define DEFLATE_CHAIN_LENGTH 32 // Earlier positions tried when looking for a repeated string
+#define ZSTD_ENABLED 1 // 1 to read and write .zst files, linking with libzstd (vcpkg.json); 0 to build without it
+
+#define SORT_MEMORY_BYTES (64 * 1024 * 1024) // Memory used for each sorted run when sorting order files
+#define MERGE_FAN_IN 64 // Most runs merged at once, which bounds the number of open files
+
+#define PAGE_STORE_PAGE_BYTES 8192 // Size of each page of a paged record store, a multiple of the sector size
+#define PAGE_POOL_FRAMES 64 // Pages of a paged record store held in memory, its fixed memory budget
+
+#define HEAVY_HITTER_SLOTS 256 // Keys tracked by each heavy-hitter summary of the order rankings
+#define TOP_RANKED_KEYS 100 // Customers and parts listed by the rankings report
 
 #endif
@@ -16,6 +16,10 @@ typedef struct {
   float currentAccountBalance; // Mandatory, >= 0.00
   char lastPaymentMade[11]; // Optional, YYYY-MM-DD format 
   char customerJoinDate[11]; // Mandatory, YYYY-MM-DD format 
+  int lastPaymentDay; // lastPaymentMade as a day number, NO_DAY if empty
+  int customerJoinDay; // customerJoinDate as a day number
+  int fieldState; // FIELDS_LOADED, or FIELDS_PENDING / FIELDS_INVALID for the text fields of a lazy load
+  long long lineOffset; // Byte offset of the customer's line in the database, for loading the text fields lazily
 } Customer;
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,292 @@
+// FILE : DateIndex.c
+// DESCRIPTION :
+//    Implements the packed day number representation of dates (days since 2000-01-01) and the
+//    indexes built on it: orders sorted by orderDate for range queries, and a block min/max zone
+//    map over lastPaymentMade so "no payment in N days" queries skip most of the customers.
+#include "DateIndex.h"
+#include "Logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DAYS_TO_2000 10957 // Days from 1970-01-01 to 2000-01-01
+
+// FUNCTION : daysFromCivil
+// DESCRIPTION :
+//    Converts a calendar date into days since 1970-01-01.
+// PARAMETERS :
+//    int year: The year.
+//    int month: The month (1-12).
+//    int day: The day of the month.
+// RETURNS :
+//    int : The number of days since 1970-01-01.
+static int daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  int era = year / 400;
+  int yearOfEra = year - era * 400;
+  int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// FUNCTION : dateToDayNumber
+// DESCRIPTION :
+//    Converts a validated YYYY-MM-DD date into its day number (days since 2000-01-01).
+// PARAMETERS :
+//    const char* date: The date string, already checked by validateDate, or an empty string.
+// RETURNS :
+//    int : The day number, or NO_DAY for an empty date.
+int dateToDayNumber(const char* date) {
+  if (date[0] == '\0') {
+    return NO_DAY;
+  }
+  int year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+  int month = (date[5] - '0') * 10 + (date[6] - '0');
+  int day = (date[8] - '0') * 10 + (date[9] - '0');
+  return daysFromCivil(year, month, day) - DAYS_TO_2000;
+}
+
+// FUNCTION : dayNumberToDate
+// DESCRIPTION :
+//    Formats a day number back into a YYYY-MM-DD string.
+// PARAMETERS :
+//    int dayNumber: The day number (days since 2000-01-01), or NO_DAY.
+//    char* buffer: Receives the date string (empty for NO_DAY).
+//    int size: The size of the buffer (at least 11).
+// RETURNS :
+//    void
+void dayNumberToDate(int dayNumber, char* buffer, int size) {
+  if (dayNumber == NO_DAY) {
+    buffer[0] = '\0';
+    return;
+  }
+  int days = dayNumber + DAYS_TO_2000 + 719468;
+  int era = days / 146097;
+  int dayOfEra = days - era * 146097;
+  int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  int monthIndex = (5 * dayOfYear + 2) / 153;
+  int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+  int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+  int year = yearOfEra + era * 400 + (month <= 2);
+  snprintf(buffer, size, "%04d-%02d-%02d", year, month, day);
+}
+
+// FUNCTION : getTodayDayNumber
+// DESCRIPTION :
+//    Gets the day number of the current local date.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    int : Today's day number.
+int getTodayDayNumber() {
+  time_t now = time(NULL);
+  struct tm localNow;
+  localtime_s(&localNow, &now);
+  return daysFromCivil(localNow.tm_year + 1900, localNow.tm_mon + 1, localNow.tm_mday) - DAYS_TO_2000;
+}
+
+// FUNCTION : initOrderDateIndex
+// DESCRIPTION :
+//    Creates an empty order date index for up to capacity orders.
+// PARAMETERS :
+//    OrderDateIndex* index: The index to initialize.
+//    int capacity: The maximum number of orders.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initOrderDateIndex(OrderDateIndex* index, int capacity) {
+  index->positions = (int*)malloc(capacity * sizeof(int));
+  index->count = 0;
+  index->capacity = capacity;
+  if (index->positions == NULL) {
+    logGeneric("Failed to allocate memory for the order date index.");
+    index->capacity = 0;
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : buildOrderDateIndex
+// DESCRIPTION :
+//    Sorts the order positions by orderDay with a counting sort over the day range,
+//    which is linear in the number of orders and keeps orders of the same day in file order.
+// PARAMETERS :
+//    OrderDateIndex* index: The index to rebuild.
+//    const Order* orders: The orders array.
+//    int orderCount: Number of orders (at most the index capacity).
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int buildOrderDateIndex(OrderDateIndex* index, const Order* orders, int orderCount) {
+  int* dayStarts = (int*)calloc(DAY_NUMBER_COUNT + 1, sizeof(int));
+  if (dayStarts == NULL) {
+    logGeneric("Failed to allocate memory for the order date index.");
+    index->count = 0;
+    return 0;
+  }
+  for (int i = 0; i < orderCount; i++) {
+    dayStarts[orders[i].orderDay + 1]++;
+  }
+  for (int day = 0; day < DAY_NUMBER_COUNT; day++) {
+    dayStarts[day + 1] += dayStarts[day];
+  }
+  for (int i = 0; i < orderCount; i++) {
+    index->positions[dayStarts[orders[i].orderDay]++] = i;
+  }
+  index->count = orderCount;
+  free(dayStarts);
+  return 1;
+}
+
+// FUNCTION : lowerBound
+// DESCRIPTION :
+//    Binary search for the first indexed order whose orderDay is not before day.
+// PARAMETERS :
+//    const OrderDateIndex* index: The order date index.
+//    const Order* orders: The orders array.
+//    int day: The day number to search for.
+// RETURNS :
+//    int : The position in the index of the first order on or after day.
+static int lowerBound(const OrderDateIndex* index, const Order* orders, int day) {
+  int low = 0;
+  int high = index->count;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (orders[index->positions[middle]].orderDay < day) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+// FUNCTION : findOrdersBetween
+// DESCRIPTION :
+//    Finds the orders dated between fromDay and toDay (inclusive) in O(log n).
+//    The matching orders are index->positions[*first] up to index->positions[*first + count - 1].
+// PARAMETERS :
+//    const OrderDateIndex* index: The order date index.
+//    const Order* orders: The orders array.
+//    int fromDay: The first day number of the range.
+//    int toDay: The last day number of the range.
+//    int* first: Receives the index position of the first matching order.
+// RETURNS :
+//    int : The number of matching orders.
+int findOrdersBetween(const OrderDateIndex* index, const Order* orders, int fromDay, int toDay, int* first) {
+  *first = lowerBound(index, orders, fromDay);
+  if (toDay < fromDay) {
+    return 0;
+  }
+  return lowerBound(index, orders, toDay + 1) - *first;
+}
+
+// FUNCTION : freeOrderDateIndex
+// DESCRIPTION :
+//    Frees the memory held by the order date index.
+// PARAMETERS :
+//    OrderDateIndex* index: The index to free.
+// RETURNS :
+//    void
+void freeOrderDateIndex(OrderDateIndex* index) {
+  free(index->positions);
+  index->positions = NULL;
+  index->count = 0;
+  index->capacity = 0;
+}
+
+// FUNCTION : initPaymentZoneMap
+// DESCRIPTION :
+//    Creates an empty zone map for up to customerCapacity customers.
+// PARAMETERS :
+//    PaymentZoneMap* zones: The zone map to initialize.
+//    int customerCapacity: The maximum number of customers.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initPaymentZoneMap(PaymentZoneMap* zones, int customerCapacity) {
+  zones->capacity = (customerCapacity + ZONE_BLOCK_SIZE - 1) / ZONE_BLOCK_SIZE;
+  zones->blockCount = 0;
+  zones->minDays = (int*)malloc(zones->capacity * sizeof(int));
+  zones->maxDays = (int*)malloc(zones->capacity * sizeof(int));
+  if (zones->minDays == NULL || zones->maxDays == NULL) {
+    logGeneric("Failed to allocate memory for the payment zone map.");
+    freePaymentZoneMap(zones);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : buildPaymentZoneMap
+// DESCRIPTION :
+//    Records the smallest and largest lastPaymentDay of each block of customers.
+//    Customers without a payment count as NO_DAY, which is smaller than every date.
+// PARAMETERS :
+//    PaymentZoneMap* zones: The zone map to rebuild.
+//    const Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+// RETURNS :
+//    void
+void buildPaymentZoneMap(PaymentZoneMap* zones, const Customer* customers, int customerCount) {
+  zones->blockCount = (customerCount + ZONE_BLOCK_SIZE - 1) / ZONE_BLOCK_SIZE;
+  for (int block = 0; block < zones->blockCount; block++) {
+    int start = block * ZONE_BLOCK_SIZE;
+    int end = start + ZONE_BLOCK_SIZE < customerCount ? start + ZONE_BLOCK_SIZE : customerCount;
+    zones->minDays[block] = customers[start].lastPaymentDay;
+    zones->maxDays[block] = customers[start].lastPaymentDay;
+    for (int i = start + 1; i < end; i++) {
+      if (customers[i].lastPaymentDay < zones->minDays[block]) {
+        zones->minDays[block] = customers[i].lastPaymentDay;
+      }
+      if (customers[i].lastPaymentDay > zones->maxDays[block]) {
+        zones->maxDays[block] = customers[i].lastPaymentDay;
+      }
+    }
+  }
+}
+
+// FUNCTION : findCustomersWithoutPaymentSince
+// DESCRIPTION :
+//    Finds the customers whose last payment is before cutoffDay, or who never paid.
+//    Blocks whose smallest payment day is on or after the cutoff are skipped without reading them.
+// PARAMETERS :
+//    const PaymentZoneMap* zones: The zone map built for the customers.
+//    const Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    int cutoffDay: The first day number that counts as a recent payment.
+//    int* positions: Output array of matching customer positions (room for customerCount).
+// RETURNS :
+//    int : The number of matching customers.
+int findCustomersWithoutPaymentSince(const PaymentZoneMap* zones, const Customer* customers, int customerCount,
+  int cutoffDay, int* positions) {
+  int found = 0;
+  for (int block = 0; block < zones->blockCount; block++) {
+    if (zones->minDays[block] >= cutoffDay) {
+      continue; // Every customer in the block paid recently
+    }
+    int start = block * ZONE_BLOCK_SIZE;
+    int end = start + ZONE_BLOCK_SIZE < customerCount ? start + ZONE_BLOCK_SIZE : customerCount;
+    for (int i = start; i < end; i++) {
+      if (customers[i].lastPaymentDay < cutoffDay) {
+        positions[found++] = i;
+      }
+    }
+  }
+  return found;
+}
+
+// FUNCTION : freePaymentZoneMap
+// DESCRIPTION :
+//    Frees the memory held by the zone map.
+// PARAMETERS :
+//    PaymentZoneMap* zones: The zone map to free.
+// RETURNS :
+//    void
+void freePaymentZoneMap(PaymentZoneMap* zones) {
+  free(zones->minDays);
+  free(zones->maxDays);
+  zones->minDays = NULL;
+  zones->maxDays = NULL;
+  zones->blockCount = 0;
+  zones->capacity = 0;
+}
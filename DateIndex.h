@@ -0,0 +1,41 @@
+// FILE : DateIndex.h
+// DESCRIPTION : This header file defines packed day numbers for dates and the indexes used for date range queries.
+#ifndef DATEINDEX_H
+#define DATEINDEX_H
+
+#include "Customer.h"
+#include "Order.h"
+
+#define NO_DAY -1 // Day number of an empty optional date (e.g. no lastPaymentMade)
+#define DAY_NUMBER_COUNT 36890 // Days from 2000-01-01 to 2100-12-31, the range accepted by isValidDate
+#define ZONE_BLOCK_SIZE 64 // Customers per zone map block
+
+typedef struct {
+  int* positions; // Order positions sorted by orderDay (ties keep file order)
+  int count;
+  int capacity;
+} OrderDateIndex;
+
+typedef struct {
+  int* minDays; // Smallest lastPaymentDay in each block of ZONE_BLOCK_SIZE customers
+  int* maxDays; // Largest lastPaymentDay in each block
+  int blockCount;
+  int capacity;
+} PaymentZoneMap;
+
+int dateToDayNumber(const char* date);
+void dayNumberToDate(int dayNumber, char* buffer, int size);
+int getTodayDayNumber();
+
+int initOrderDateIndex(OrderDateIndex* index, int capacity);
+int buildOrderDateIndex(OrderDateIndex* index, const Order* orders, int orderCount);
+int findOrdersBetween(const OrderDateIndex* index, const Order* orders, int fromDay, int toDay, int* first);
+void freeOrderDateIndex(OrderDateIndex* index);
+
+int initPaymentZoneMap(PaymentZoneMap* zones, int customerCapacity);
+void buildPaymentZoneMap(PaymentZoneMap* zones, const Customer* customers, int customerCount);
+int findCustomersWithoutPaymentSince(const PaymentZoneMap* zones, const Customer* customers, int customerCount,
+  int cutoffDay, int* positions);
+void freePaymentZoneMap(PaymentZoneMap* zones);
+
+#endif
@@ -0,0 +1,677 @@
+// FILE : Deflate.c
+// DESCRIPTION :
+//    Implements the raw DEFLATE format (RFC 1951) used inside gzip files. The decoder can stop
+//    between any two symbols when its output buffer runs low and pick up from there, so a file of
+//    any size is decoded a buffer at a time; input is pulled through a refill callback as needed.
+//    Codes of up to INFLATE_FAST_BITS bits are decoded with one table lookup and longer ones bit by
+//    bit. The encoder writes one block with the fixed Huffman codes, finding repeated strings through
+//    hash chains, and falls back to stored blocks for data that does not compress.
+#include "Deflate.h"
+#include "Constants.h"
+#include <string.h>
+
+#define STATE_BLOCK_HEADER 0
+#define STATE_STORED 1 // Copying a stored block
+#define STATE_CODES 2 // Decoding a block of Huffman codes
+#define STATE_DONE 3
+#define STATE_FAILED 4
+
+static const short LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115,
+  131, 163, 195, 227, 258 };
+static const short LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const int DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537,
+  2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const short DISTANCE_EXTRA_BITS[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12,
+  13, 13 };
+// Order in which a dynamic block lists the code lengths of its code length alphabet
+static const short CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+typedef struct {
+  unsigned char* output;
+  size_t size;
+  size_t position;
+  unsigned long long bits; // Bits not yet written, next bit lowest
+  int bitCount;
+  int isOverflowing; // 1 once the output is full
+} BitWriter;
+
+// FUNCTION : readInputByte
+// DESCRIPTION :
+//    Reads the next byte of an input, refilling it when the current piece is used up.
+// PARAMETERS :
+//    ByteInput* input: The input.
+// RETURNS :
+//    int : The byte, or -1 at the end of the input.
+int readInputByte(ByteInput* input) {
+  while (input->position == input->size) {
+    if (input->refill == NULL || !input->refill(input->context, &input->data, &input->size)) {
+      return -1;
+    }
+    input->position = 0;
+  }
+  return input->data[input->position++];
+}
+
+// FUNCTION : readInputBytes
+// DESCRIPTION :
+//    Reads a number of bytes of an input, across as many pieces as needed.
+// PARAMETERS :
+//    ByteInput* input: The input.
+//    unsigned char* data: Receives the bytes, or NULL to skip them.
+//    size_t size: The number of bytes.
+// RETURNS :
+//    int : 1 if all the bytes were read, 0 if the input ended first.
+int readInputBytes(ByteInput* input, unsigned char* data, size_t size) {
+  while (size > 0) {
+    if (input->position == input->size && readInputByte(input) >= 0) {
+      input->position--; // Refilled; the byte is copied below
+    }
+    size_t count = input->size - input->position;
+    if (count == 0) {
+      return 0;
+    }
+    if (count > size) {
+      count = size;
+    }
+    if (data != NULL) {
+      memcpy(data, input->data + input->position, count);
+      data += count;
+    }
+    input->position += count;
+    size -= count;
+  }
+  return 1;
+}
+
+// FUNCTION : fillBits
+// DESCRIPTION :
+//    Reads ahead as many whole bytes as fit in the bit buffer from the current piece of input,
+//    without refilling it. Bytes read ahead this way can still be handed back by releaseBits.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    void
+static void fillBits(Inflater* inflater) {
+  ByteInput* input = inflater->input;
+  while (inflater->bitCount <= 56 && input->position < input->size) {
+    inflater->bits |= (unsigned long long)input->data[input->position++] << inflater->bitCount;
+    inflater->bitCount += 8;
+  }
+}
+
+// FUNCTION : readBits
+// DESCRIPTION :
+//    Reads a number of bits, refilling the input if needed. Only as many bytes are taken as the
+//    bits need, so whole bytes left in the bit buffer always come from the current piece of input.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+//    int count: The number of bits, at most 16.
+// RETURNS :
+//    int : The bits, first bit lowest, or -1 if the input ended.
+static int readBits(Inflater* inflater, int count) {
+  while (inflater->bitCount < count) {
+    int value = readInputByte(inflater->input);
+    if (value < 0) {
+      return -1;
+    }
+    inflater->bits |= (unsigned long long)value << inflater->bitCount;
+    inflater->bitCount += 8;
+  }
+  int value = (int)(inflater->bits & ((1ULL << count) - 1));
+  inflater->bits >>= count;
+  inflater->bitCount -= count;
+  return value;
+}
+
+// FUNCTION : releaseBits
+// DESCRIPTION :
+//    Moves to the next byte boundary and hands the whole bytes still in the bit buffer back to
+//    the input, so what follows the compressed data (a stored block, a gzip trailer) is read from there.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    void
+static void releaseBits(Inflater* inflater) {
+  inflater->input->position -= (size_t)(inflater->bitCount / 8);
+  inflater->bits = 0;
+  inflater->bitCount = 0;
+}
+
+// FUNCTION : reverseBits
+// DESCRIPTION :
+//    Reverses the order of the low bits of a code, since Huffman codes are packed first bit highest.
+// PARAMETERS :
+//    unsigned int code: The code.
+//    int length: The number of bits.
+// RETURNS :
+//    unsigned int : The reversed code.
+static unsigned int reverseBits(unsigned int code, int length) {
+  unsigned int reversed = 0;
+  for (int i = 0; i < length; i++) {
+    reversed = (reversed << 1) | (code & 1);
+    code >>= 1;
+  }
+  return reversed;
+}
+
+// FUNCTION : buildHuffmanTable
+// DESCRIPTION :
+//    Builds the canonical Huffman code of an alphabet from the code length of each symbol, and the
+//    lookup table of its short codes. Incomplete codes are allowed (a missing code is an error when
+//    met); over-subscribed ones are not.
+// PARAMETERS :
+//    HuffmanTable* table: Receives the code.
+//    const unsigned char* lengths: The code length of each symbol, 0 for symbols not used.
+//    int symbolCount: The number of symbols.
+// RETURNS :
+//    int : 1 on success, 0 if the lengths do not make a code.
+static int buildHuffmanTable(HuffmanTable* table, const unsigned char* lengths, int symbolCount) {
+  short offsets[16];
+  memset(table->counts, 0, sizeof(table->counts));
+  memset(table->fastCodes, 0, sizeof(table->fastCodes));
+  for (int symbol = 0; symbol < symbolCount; symbol++) {
+    table->counts[lengths[symbol]]++;
+  }
+  table->counts[0] = 0;
+  int left = 1;
+  for (int length = 1; length < 16; length++) {
+    left = (left << 1) - table->counts[length];
+    if (left < 0) {
+      return 0;
+    }
+  }
+  offsets[1] = 0;
+  for (int length = 1; length < 15; length++) {
+    offsets[length + 1] = offsets[length] + table->counts[length];
+  }
+  for (int symbol = 0; symbol < symbolCount; symbol++) {
+    if (lengths[symbol] != 0) {
+      table->symbols[offsets[lengths[symbol]]++] = (short)symbol;
+    }
+  }
+  unsigned int code = 0;
+  int index = 0;
+  for (int length = 1; length <= INFLATE_FAST_BITS; length++) {
+    for (int i = 0; i < table->counts[length]; i++, index++, code++) {
+      unsigned short entry = (unsigned short)(table->symbols[index] << 4 | length);
+      for (unsigned int bits = reverseBits(code, length); bits < (1u << INFLATE_FAST_BITS); bits += 1u << length) {
+        table->fastCodes[bits] = entry;
+      }
+    }
+    code <<= 1;
+  }
+  return 1;
+}
+
+// FUNCTION : decodeSymbol
+// DESCRIPTION :
+//    Decodes the next symbol of a Huffman code: by table lookup when enough bits are buffered,
+//    otherwise one bit at a time through the canonical code.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+//    const HuffmanTable* table: The code.
+// RETURNS :
+//    int : The symbol, or -1 on a missing code or the end of the input.
+static int decodeSymbol(Inflater* inflater, const HuffmanTable* table) {
+  if (inflater->bitCount < 32) {
+    fillBits(inflater);
+  }
+  if (inflater->bitCount >= INFLATE_FAST_BITS) {
+    unsigned short entry = table->fastCodes[inflater->bits & ((1u << INFLATE_FAST_BITS) - 1)];
+    if (entry != 0) {
+      inflater->bits >>= entry & 15;
+      inflater->bitCount -= entry & 15;
+      return entry >> 4;
+    }
+  }
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (int length = 1; length < 16; length++) {
+    int bit = readBits(inflater, 1);
+    if (bit < 0) {
+      return -1;
+    }
+    code |= bit;
+    int count = table->counts[length];
+    if (code - count < first) {
+      return table->symbols[index + (code - first)];
+    }
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+// FUNCTION : readDynamicCodes
+// DESCRIPTION :
+//    Reads the Huffman codes at the start of a dynamic block.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    int : 1 on success, 0 if the codes are corrupt.
+static int readDynamicCodes(Inflater* inflater) {
+  unsigned char lengths[286 + 30];
+  int lengthCount = readBits(inflater, 5);
+  int distanceCount = readBits(inflater, 5);
+  int codeLengthCount = readBits(inflater, 4);
+  if (lengthCount < 0 || distanceCount < 0 || codeLengthCount < 0) {
+    return 0;
+  }
+  lengthCount += 257;
+  distanceCount += 1;
+  codeLengthCount += 4;
+  if (lengthCount > 286 || distanceCount > 30) {
+    return 0;
+  }
+  memset(lengths, 0, sizeof(lengths));
+  for (int i = 0; i < codeLengthCount; i++) {
+    int length = readBits(inflater, 3);
+    if (length < 0) {
+      return 0;
+    }
+    lengths[CODE_LENGTH_ORDER[i]] = (unsigned char)length;
+  }
+  // The code length code is used only here, so it borrows the distance table
+  if (!buildHuffmanTable(&inflater->distanceCodes, lengths, 19)) {
+    return 0;
+  }
+  int index = 0;
+  while (index < lengthCount + distanceCount) {
+    int symbol = decodeSymbol(inflater, &inflater->distanceCodes);
+    if (symbol < 0) {
+      return 0;
+    }
+    if (symbol < 16) {
+      lengths[index++] = (unsigned char)symbol;
+      continue;
+    }
+    unsigned char length = 0;
+    int repeat = 0;
+    if (symbol == 16) {
+      if (index == 0) {
+        return 0;
+      }
+      length = lengths[index - 1];
+      repeat = 3 + readBits(inflater, 2);
+    }
+    else if (symbol == 17) {
+      repeat = 3 + readBits(inflater, 3);
+    }
+    else {
+      repeat = 11 + readBits(inflater, 7);
+    }
+    if (repeat < 3 || index + repeat > lengthCount + distanceCount) {
+      return 0;
+    }
+    while (repeat-- > 0) {
+      lengths[index++] = length;
+    }
+  }
+  if (lengths[256] == 0) {
+    return 0; // No end-of-block code
+  }
+  return buildHuffmanTable(&inflater->lengthCodes, lengths, lengthCount)
+    && buildHuffmanTable(&inflater->distanceCodes, lengths + lengthCount, distanceCount);
+}
+
+// FUNCTION : readBlockHeader
+// DESCRIPTION :
+//    Reads the header of the next block and gets ready to decode its data.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    int : 1 on success, 0 if the header is corrupt.
+static int readBlockHeader(Inflater* inflater) {
+  int header = readBits(inflater, 3);
+  if (header < 0) {
+    return 0;
+  }
+  inflater->isLastBlock = header & 1;
+  int type = header >> 1;
+  if (type == 0) {
+    unsigned char lengths[4];
+    releaseBits(inflater);
+    if (!readInputBytes(inflater->input, lengths, sizeof(lengths))) {
+      return 0;
+    }
+    unsigned int length = lengths[0] | (unsigned int)lengths[1] << 8;
+    unsigned int complement = lengths[2] | (unsigned int)lengths[3] << 8;
+    if (length != (~complement & 0xFFFF)) {
+      return 0;
+    }
+    inflater->storedRemaining = length;
+    inflater->state = STATE_STORED;
+    return 1;
+  }
+  if (type == 1) {
+    unsigned char lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    buildHuffmanTable(&inflater->lengthCodes, lengths, 288);
+    memset(lengths, 5, 30);
+    buildHuffmanTable(&inflater->distanceCodes, lengths, 30);
+  }
+  else if (type != 2 || !readDynamicCodes(inflater)) {
+    return 0;
+  }
+  inflater->state = STATE_CODES;
+  return 1;
+}
+
+// FUNCTION : copyStored
+// DESCRIPTION :
+//    Copies the bytes of a stored block to the output, as far as there is room.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    int : 1 on success, 0 if the input ended or a whole output ran out of room.
+static int copyStored(Inflater* inflater) {
+  size_t room = inflater->outputSize - inflater->outputPosition;
+  size_t count = inflater->storedRemaining < room ? inflater->storedRemaining : room;
+  if (inflater->isWholeOutput && count < inflater->storedRemaining) {
+    return 0;
+  }
+  if (!readInputBytes(inflater->input, inflater->output + inflater->outputPosition, count)) {
+    return 0;
+  }
+  inflater->outputPosition += count;
+  inflater->storedRemaining -= count;
+  if (inflater->storedRemaining == 0) {
+    inflater->state = inflater->isLastBlock ? STATE_DONE : STATE_BLOCK_HEADER;
+  }
+  return 1;
+}
+
+// FUNCTION : decodeCodes
+// DESCRIPTION :
+//    Decodes literals and back-references of a Huffman block until the end of the block, or until
+//    the output has less than INFLATE_MAX_MATCH bytes of room.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    int : 1 on success, 0 if the data is corrupt.
+static int decodeCodes(Inflater* inflater) {
+  unsigned char* output = inflater->output;
+  while (inflater->isWholeOutput || inflater->outputSize - inflater->outputPosition >= INFLATE_MAX_MATCH) {
+    int symbol = decodeSymbol(inflater, &inflater->lengthCodes);
+    if (symbol < 256) {
+      if (symbol < 0 || inflater->outputPosition == inflater->outputSize) {
+        return 0;
+      }
+      output[inflater->outputPosition++] = (unsigned char)symbol;
+      continue;
+    }
+    if (symbol == 256) {
+      inflater->state = inflater->isLastBlock ? STATE_DONE : STATE_BLOCK_HEADER;
+      return 1;
+    }
+    symbol -= 257;
+    if (symbol >= 29) {
+      return 0;
+    }
+    int length = LENGTH_BASES[symbol] + readBits(inflater, LENGTH_EXTRA_BITS[symbol]);
+    int distanceSymbol = decodeSymbol(inflater, &inflater->distanceCodes);
+    if (length < LENGTH_BASES[symbol] || distanceSymbol < 0 || distanceSymbol >= 30) {
+      return 0;
+    }
+    int extra = readBits(inflater, DISTANCE_EXTRA_BITS[distanceSymbol]);
+    size_t distance = (size_t)DISTANCE_BASES[distanceSymbol] + extra;
+    if (extra < 0 || distance > inflater->outputPosition || (size_t)length > inflater->outputSize - inflater->outputPosition) {
+      return 0;
+    }
+    unsigned char* to = output + inflater->outputPosition;
+    const unsigned char* from = to - distance;
+    if (distance >= (size_t)length) {
+      memcpy(to, from, length);
+    }
+    else {
+      for (int i = 0; i < length; i++) {
+        to[i] = from[i]; // Overlapping copy repeats the last distance bytes
+      }
+    }
+    inflater->outputPosition += length;
+  }
+  return 1;
+}
+
+// FUNCTION : initInflater
+// DESCRIPTION :
+//    Prepares a decoder for a new DEFLATE stream.
+// PARAMETERS :
+//    Inflater* inflater: The decoder to initialize.
+//    ByteInput* input: Where the compressed data is read from.
+//    unsigned char* output: Receives the decoded bytes. The caller may move the last
+//      INFLATE_HISTORY_BYTES to the start of the buffer between calls to make room.
+//    size_t outputSize: The size of the output buffer.
+//    int isWholeOutput: 1 if the buffer has room for all the decoded data, 0 to decode a buffer at a time.
+// RETURNS :
+//    void
+void initInflater(Inflater* inflater, ByteInput* input, unsigned char* output, size_t outputSize, int isWholeOutput) {
+  inflater->input = input;
+  inflater->bits = 0;
+  inflater->bitCount = 0;
+  inflater->state = STATE_BLOCK_HEADER;
+  inflater->isLastBlock = 0;
+  inflater->storedRemaining = 0;
+  inflater->output = output;
+  inflater->outputSize = outputSize;
+  inflater->outputPosition = 0;
+  inflater->isWholeOutput = isWholeOutput;
+}
+
+// FUNCTION : inflateData
+// DESCRIPTION :
+//    Decodes as much of the stream as the output has room for. Once the last block is decoded,
+//    the input is left at the first byte after the compressed data.
+// PARAMETERS :
+//    Inflater* inflater: The decoder.
+// RETURNS :
+//    int : INFLATE_FULL to be called again once there is room, INFLATE_END or INFLATE_ERROR.
+int inflateData(Inflater* inflater) {
+  while (1) {
+    int isDecoded = 1;
+    if (inflater->state == STATE_DONE) {
+      releaseBits(inflater);
+      return INFLATE_END;
+    }
+    if (inflater->state == STATE_FAILED) {
+      return INFLATE_ERROR;
+    }
+    if (inflater->state == STATE_BLOCK_HEADER) {
+      isDecoded = readBlockHeader(inflater);
+    }
+    else if (!inflater->isWholeOutput && inflater->outputSize - inflater->outputPosition < INFLATE_MAX_MATCH) {
+      return INFLATE_FULL;
+    }
+    else if (inflater->state == STATE_STORED) {
+      isDecoded = copyStored(inflater);
+    }
+    else {
+      isDecoded = decodeCodes(inflater);
+    }
+    if (!isDecoded) {
+      inflater->state = STATE_FAILED;
+    }
+  }
+}
+
+// FUNCTION : putBits
+// DESCRIPTION :
+//    Appends bits to the output, first bit lowest.
+// PARAMETERS :
+//    BitWriter* writer: The output.
+//    unsigned int value: The bits.
+//    int count: The number of bits, at most 24.
+// RETURNS :
+//    void
+static void putBits(BitWriter* writer, unsigned int value, int count) {
+  writer->bits |= (unsigned long long)value << writer->bitCount;
+  writer->bitCount += count;
+  while (writer->bitCount >= 8) {
+    if (writer->position == writer->size) {
+      writer->isOverflowing = 1;
+      return;
+    }
+    writer->output[writer->position++] = (unsigned char)writer->bits;
+    writer->bits >>= 8;
+    writer->bitCount -= 8;
+  }
+}
+
+// FUNCTION : putFixedSymbol
+// DESCRIPTION :
+//    Writes a literal/length symbol with the fixed Huffman code.
+// PARAMETERS :
+//    BitWriter* writer: The output.
+//    int symbol: The symbol, from 0 to 287.
+// RETURNS :
+//    void
+static void putFixedSymbol(BitWriter* writer, int symbol) {
+  if (symbol < 144) {
+    putBits(writer, reverseBits(0x30 + symbol, 8), 8);
+  }
+  else if (symbol < 256) {
+    putBits(writer, reverseBits(0x190 + symbol - 144, 9), 9);
+  }
+  else if (symbol < 280) {
+    putBits(writer, reverseBits(symbol - 256, 7), 7);
+  }
+  else {
+    putBits(writer, reverseBits(0xC0 + symbol - 280, 8), 8);
+  }
+}
+
+// FUNCTION : putMatch
+// DESCRIPTION :
+//    Writes a back-reference with the fixed Huffman codes.
+// PARAMETERS :
+//    BitWriter* writer: The output.
+//    int length: The match length, from 3 to 258.
+//    int distance: The match distance, from 1 to 32768.
+// RETURNS :
+//    void
+static void putMatch(BitWriter* writer, int length, int distance) {
+  int lengthSymbol = 28;
+  while (LENGTH_BASES[lengthSymbol] > length) {
+    lengthSymbol--;
+  }
+  putFixedSymbol(writer, 257 + lengthSymbol);
+  putBits(writer, length - LENGTH_BASES[lengthSymbol], LENGTH_EXTRA_BITS[lengthSymbol]);
+  int distanceSymbol = 29;
+  while (DISTANCE_BASES[distanceSymbol] > distance) {
+    distanceSymbol--;
+  }
+  putBits(writer, reverseBits(distanceSymbol, 5), 5);
+  putBits(writer, distance - DISTANCE_BASES[distanceSymbol], DISTANCE_EXTRA_BITS[distanceSymbol]);
+}
+
+// FUNCTION : getDeflateBound
+// DESCRIPTION :
+//    Gives the most bytes deflateData can write for an input, the size of the input in stored blocks.
+// PARAMETERS :
+//    size_t size: The input size.
+// RETURNS :
+//    size_t : The output size to provide.
+size_t getDeflateBound(size_t size) {
+  return size + 5 * (size / 65535 + 1);
+}
+
+// FUNCTION : putStoredBlocks
+// DESCRIPTION :
+//    Writes data as stored blocks, the last one marked final.
+// PARAMETERS :
+//    const unsigned char* data: The data.
+//    size_t size: The data size.
+//    unsigned char* output: Receives the blocks, getDeflateBound(size) bytes.
+// RETURNS :
+//    size_t : The number of bytes written.
+static size_t putStoredBlocks(const unsigned char* data, size_t size, unsigned char* output) {
+  size_t position = 0;
+  do {
+    size_t count = size < 65535 ? size : 65535;
+    size -= count;
+    output[position++] = size == 0 ? 1 : 0;
+    output[position++] = (unsigned char)count;
+    output[position++] = (unsigned char)(count >> 8);
+    output[position++] = (unsigned char)~count;
+    output[position++] = (unsigned char)(~count >> 8);
+    memcpy(output + position, data, count);
+    position += count;
+    data += count;
+  } while (size > 0);
+  return position;
+}
+
+// FUNCTION : deflateData
+// DESCRIPTION :
+//    Compresses data into one DEFLATE stream. Each position is looked up in hash chains of the
+//    positions with the same next 3 bytes, up to DEFLATE_CHAIN_LENGTH of them, and the longest
+//    match within INFLATE_HISTORY_BYTES is taken. When that does not save space the data is stored.
+// PARAMETERS :
+//    const unsigned char* data: The data, at most DEFLATE_MAX_INPUT bytes.
+//    size_t size: The data size.
+//    unsigned char* output: Receives the stream.
+//    size_t outputSize: The size of the output, at least getDeflateBound(size).
+//    int* matchTable: Work space of DEFLATE_MATCH_TABLE_ENTRIES entries.
+// RETURNS :
+//    size_t : The stream size, or 0 if the input is too large or the output too small.
+size_t deflateData(const unsigned char* data, size_t size, unsigned char* output, size_t outputSize, int* matchTable) {
+  if (size > DEFLATE_MAX_INPUT || outputSize < getDeflateBound(size)) {
+    return 0;
+  }
+  BitWriter writer = { output, getDeflateBound(size), 0, 0, 0, 0 };
+  int* heads = matchTable;
+  int* previous = matchTable + DEFLATE_HASH_SIZE;
+  memset(heads, 0xFF, DEFLATE_HASH_SIZE * sizeof(int)); // -1, no earlier position
+  putBits(&writer, 1 | 1 << 1, 3); // Last block, fixed codes
+  int position = 0;
+  while (position < (int)size && !writer.isOverflowing) {
+    int bestLength = 0;
+    int bestDistance = 0;
+    if (position + 3 <= (int)size) {
+      unsigned int hash = ((data[position] << 10) ^ (data[position + 1] << 5) ^ data[position + 2]) & (DEFLATE_HASH_SIZE - 1);
+      int candidate = heads[hash];
+      previous[position] = candidate;
+      heads[hash] = position;
+      int maxLength = (int)size - position < INFLATE_MAX_MATCH ? (int)size - position : INFLATE_MAX_MATCH;
+      for (int chain = 0; candidate >= 0 && position - candidate <= INFLATE_HISTORY_BYTES && chain < DEFLATE_CHAIN_LENGTH; chain++) {
+        if (data[candidate + bestLength] == data[position + bestLength]) {
+          int length = 0;
+          while (length < maxLength && data[candidate + length] == data[position + length]) {
+            length++;
+          }
+          if (length > bestLength) {
+            bestLength = length;
+            bestDistance = position - candidate;
+            if (length == maxLength) {
+              break;
+            }
+          }
+        }
+        candidate = previous[candidate];
+      }
+    }
+    if (bestLength < 3) {
+      putFixedSymbol(&writer, data[position++]);
+      continue;
+    }
+    putMatch(&writer, bestLength, bestDistance);
+    // Later matches can start inside this one
+    for (int end = position + bestLength, next = position + 1; next < end && next + 3 <= (int)size; next++) {
+      unsigned int hash = ((data[next] << 10) ^ (data[next + 1] << 5) ^ data[next + 2]) & (DEFLATE_HASH_SIZE - 1);
+      previous[next] = heads[hash];
+      heads[hash] = next;
+    }
+    position += bestLength;
+  }
+  putFixedSymbol(&writer, 256);
+  putBits(&writer, 0, 7); // Flush the last partial byte
+  if (writer.isOverflowing) {
+    return putStoredBlocks(data, size, output);
+  }
+  return writer.position;
+}
@@ -0,0 +1,59 @@
+// FILE : Deflate.h
+// DESCRIPTION : This header file defines the raw DEFLATE (RFC 1951) decoder and encoder behind compressed database files.
+#ifndef DEFLATE_H
+#define DEFLATE_H
+
+#include <stddef.h>
+
+#define INFLATE_FAST_BITS 10 // Codes up to this long are decoded with one table lookup
+#define INFLATE_MAX_MATCH 258 // Longest back-reference, the room a decoder needs to go on
+#define INFLATE_HISTORY_BYTES (32 * 1024) // Farthest back-reference
+#define DEFLATE_MAX_INPUT (64 * 1024) // Most bytes deflateData compresses at once
+#define DEFLATE_HASH_SIZE (1 << 15) // Heads of the match chains, by a hash of the next 3 bytes
+#define DEFLATE_MATCH_TABLE_ENTRIES (DEFLATE_HASH_SIZE + DEFLATE_MAX_INPUT) // Work space of deflateData
+
+// Results of inflateData
+#define INFLATE_FULL 0 // The output has less than INFLATE_MAX_MATCH bytes of room left
+#define INFLATE_END 1 // The last block was decoded
+#define INFLATE_ERROR -1 // The data is corrupt or ends too soon
+
+// Supplies the next piece of input: returns 1 with data and size set, or 0 at the end of the input
+typedef int (*InputRefillFunction)(void* context, const unsigned char** data, size_t* size);
+
+typedef struct {
+  const unsigned char* data;
+  size_t size;
+  size_t position;
+  InputRefillFunction refill; // NULL when data holds all the input
+  void* context; // Passed to refill
+} ByteInput;
+
+typedef struct {
+  unsigned short fastCodes[1 << INFLATE_FAST_BITS]; // symbol << 4 | code length by the next bits, 0 for longer codes
+  short counts[16]; // Number of codes of each length
+  short symbols[288]; // Symbols in canonical code order
+} HuffmanTable;
+
+typedef struct {
+  ByteInput* input;
+  unsigned long long bits; // Bits read ahead from the input, next bit lowest
+  int bitCount;
+  int state;
+  int isLastBlock;
+  size_t storedRemaining; // Bytes left in the current stored block
+  unsigned char* output; // Decoded bytes; back-references reach into the bytes before outputPosition
+  size_t outputSize;
+  size_t outputPosition;
+  int isWholeOutput; // 1 if output has room for all the data, so running out of room is an error
+  HuffmanTable lengthCodes;
+  HuffmanTable distanceCodes;
+} Inflater;
+
+int readInputByte(ByteInput* input);
+int readInputBytes(ByteInput* input, unsigned char* data, size_t size);
+void initInflater(Inflater* inflater, ByteInput* input, unsigned char* output, size_t outputSize, int isWholeOutput);
+int inflateData(Inflater* inflater);
+size_t getDeflateBound(size_t size);
+size_t deflateData(const unsigned char* data, size_t size, unsigned char* output, size_t outputSize, int* matchTable);
+
+#endif
@@ -0,0 +1,187 @@
+// FILE : Demand.c
+// DESCRIPTION :
+//    Implements the inventory demand pass. Ordered quantities of all open orders are summed per part
+//    with a parallel reduction (one histogram per worker, merged at the end), and each part's
+//    partStatus is set to 0, 99 or the deficit against quantityOnHand.
+#include "Demand.h"
+#include "Index.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+typedef struct {
+  const Order* orders;
+  const unsigned char* orderValid;
+  int startOrder;
+  int endOrder;
+  const IdIndex* partIndex;
+  long long* histogram; // Demand per part position for this worker's orders
+} DemandWorker;
+
+// FUNCTION : isOpenOrder
+// DESCRIPTION :
+//    Checks whether an order still needs its parts: unprocessed (0) or waiting for parts (99).
+// PARAMETERS :
+//    const Order* order: The order to check.
+// RETURNS :
+//    int : 1 if the order is open, 0 otherwise.
+static int isOpenOrder(const Order* order) {
+  return order->orderStatus == 0 || order->orderStatus == 99;
+}
+
+// FUNCTION : accumulateDemand
+// DESCRIPTION :
+//    Worker that sums the ordered quantities of its range of orders into its private histogram.
+// PARAMETERS :
+//    void* argument: The worker's DemandWorker block.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall accumulateDemand(void* argument) {
+  DemandWorker* worker = (DemandWorker*)argument;
+  for (int i = worker->startOrder; i < worker->endOrder; i++) {
+    const Order* order = &worker->orders[i];
+    if ((worker->orderValid != NULL && !worker->orderValid[i]) || !isOpenOrder(order)) {
+      continue;
+    }
+    for (int j = 0; j < order->distinctParts; j++) {
+      int partPosition = findIdIndex(worker->partIndex, order->orderedParts[j].partID);
+      if (partPosition != ID_INDEX_NOT_FOUND) {
+        worker->histogram[partPosition] += order->orderedParts[j].quantityOrdered;
+      }
+    }
+  }
+  return 0;
+}
+
+// FUNCTION : calculatePartDemand
+// DESCRIPTION :
+//    Sums the demand of all open orders per part and sets each part's status:
+//    the negative shortage if demand exceeds quantityOnHand, otherwise 0 (more than 100 on hand) or 99.
+// PARAMETERS :
+//    Part* parts: The parts array, whose partStatus values are updated.
+//    int partCount: Number of parts.
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+//    long long* demand: Output array receiving the demand of each part position.
+// RETURNS :
+//    int : The number of parts in deficit, or -1 if memory could not be allocated.
+int calculatePartDemand(Part* parts, int partCount, const Order* orders, const unsigned char* orderValid, int orderCount,
+  long long* demand) {
+  IdIndex partIndex;
+  if (!initIdIndex(&partIndex, partCount)) {
+    return -1;
+  }
+  for (int i = 0; i < partCount; i++) {
+    setIdIndex(&partIndex, parts[i].partID, i);
+  }
+  int workerCount = getWorkerCount(orderCount);
+  DemandWorker* workers = (DemandWorker*)malloc(workerCount * sizeof(DemandWorker));
+  long long* histograms = (long long*)calloc((size_t)workerCount * partCount + 1, sizeof(long long));
+  if (workers == NULL || histograms == NULL) {
+    logGeneric("Failed to allocate memory for the part demand calculation.");
+    free(workers);
+    free(histograms);
+    freeIdIndex(&partIndex);
+    return -1;
+  }
+  int chunkSize = (orderCount + workerCount - 1) / workerCount;
+  for (int w = 0; w < workerCount; w++) {
+    workers[w].orders = orders;
+    workers[w].orderValid = orderValid;
+    workers[w].startOrder = w * chunkSize < orderCount ? w * chunkSize : orderCount;
+    workers[w].endOrder = (w + 1) * chunkSize < orderCount ? (w + 1) * chunkSize : orderCount;
+    workers[w].partIndex = &partIndex;
+    workers[w].histogram = histograms + (size_t)w * partCount;
+  }
+  runWorkers(accumulateDemand, workers, sizeof(DemandWorker), workerCount);
+
+  // Merge the per-worker histograms and derive the part statuses
+  int deficitCount = 0;
+  for (int i = 0; i < partCount; i++) {
+    long long total = 0;
+    for (int w = 0; w < workerCount; w++) {
+      total += workers[w].histogram[i];
+    }
+    demand[i] = total;
+    long long remaining = parts[i].quantityOnHand - total;
+    if (remaining < 0) {
+      parts[i].partStatus = remaining < INT_MIN ? INT_MIN : (int)remaining;
+      deficitCount++;
+    }
+    else {
+      parts[i].partStatus = parts[i].quantityOnHand > 100 ? 0 : 99;
+    }
+  }
+  free(workers);
+  free(histograms);
+  freeIdIndex(&partIndex);
+  return deficitCount;
+}
+
+// FUNCTION : compareShortages
+// DESCRIPTION :
+//    qsort comparator ordering shortages from largest to smallest, then by part position.
+// PARAMETERS :
+//    const void* first: The first PartShortage.
+//    const void* second: The second PartShortage.
+// RETURNS :
+//    int : Negative if first ranks before second, positive if after.
+static int compareShortages(const void* first, const void* second) {
+  const PartShortage* a = (const PartShortage*)first;
+  const PartShortage* b = (const PartShortage*)second;
+  if (a->shortage != b->shortage) {
+    return a->shortage > b->shortage ? -1 : 1;
+  }
+  return a->partPosition - b->partPosition;
+}
+
+// FUNCTION : rankPartShortages
+// DESCRIPTION :
+//    Lists the parts whose demand exceeds quantityOnHand, largest shortage first.
+// PARAMETERS :
+//    const Part* parts: The parts array.
+//    int partCount: Number of parts.
+//    const long long* demand: The demand of each part position from calculatePartDemand.
+//    PartShortage* shortages: Output array with room for partCount entries.
+// RETURNS :
+//    int : The number of parts in the ranking.
+int rankPartShortages(const Part* parts, int partCount, const long long* demand, PartShortage* shortages) {
+  int shortageCount = 0;
+  for (int i = 0; i < partCount; i++) {
+    if (demand[i] > parts[i].quantityOnHand) {
+      shortages[shortageCount].partPosition = i;
+      shortages[shortageCount].demand = demand[i];
+      shortages[shortageCount].shortage = demand[i] - parts[i].quantityOnHand;
+      shortageCount++;
+    }
+  }
+  qsort(shortages, shortageCount, sizeof(PartShortage), compareShortages);
+  return shortageCount;
+}
+
+// FUNCTION : printShortageReport
+// DESCRIPTION :
+//    Prints the ranked shortage report.
+// PARAMETERS :
+//    const Part* parts: The parts array.
+//    const PartShortage* shortages: The ranked shortages from rankPartShortages.
+//    int shortageCount: Number of shortages.
+// RETURNS :
+//    void
+void printShortageReport(const Part* parts, const PartShortage* shortages, int shortageCount) {
+  if (shortageCount == 0) {
+    printf("No part is short for the open orders.\n");
+    return;
+  }
+  printf("Rank  Part ID  Part Number          On Hand     Demand      Short\n");
+  for (int i = 0; i < shortageCount; i++) {
+    const Part* part = &parts[shortages[i].partPosition];
+    printf("%4d  %7d  %-18s %9d %10lld %10lld\n", i + 1, part->partID, part->partNumber,
+      part->quantityOnHand, shortages[i].demand, shortages[i].shortage);
+  }
+}
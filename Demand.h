@@ -0,0 +1,20 @@
+// FILE : Demand.h
+// DESCRIPTION : This header file defines the inventory demand and deficit calculation over open orders.
+#ifndef DEMAND_H
+#define DEMAND_H
+
+#include "Part.h"
+#include "Order.h"
+
+typedef struct {
+  int partPosition; // Position of the part in the parts array
+  long long demand; // Units ordered by open orders
+  long long shortage; // Units missing (demand - quantityOnHand)
+} PartShortage;
+
+int calculatePartDemand(Part* parts, int partCount, const Order* orders, const unsigned char* orderValid, int orderCount,
+  long long* demand);
+int rankPartShortages(const Part* parts, int partCount, const long long* demand, PartShortage* shortages);
+void printShortageReport(const Part* parts, const PartShortage* shortages, int shortageCount);
+
+#endif
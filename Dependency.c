@@ -0,0 +1,306 @@
+// FILE : Dependency.c
+// DESCRIPTION :
+//    Implements the reverse index from partIDs and customerIDs to the orders that reference them.
+//    Lets a change to one part or customer find its dependent orders without scanning every order.
+#include "Dependency.h"
+#include "Index.h"
+#include "Order.h"
+#include "Validation.h"
+#include "Logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : initOrderDependencies
+// DESCRIPTION :
+//    Creates an empty dependency index for up to orderCapacity orders.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index to initialize.
+//    int orderCapacity: The maximum number of orders that will be tracked.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initOrderDependencies(OrderDependencies* deps, int orderCapacity) {
+  memset(deps, 0, sizeof(OrderDependencies));
+  deps->orderCapacity = orderCapacity;
+  deps->edgeCapacity = orderCapacity * 2;
+  deps->edgeOrder = (int*)malloc(deps->edgeCapacity * sizeof(int));
+  deps->edgeNext = (int*)malloc(deps->edgeCapacity * sizeof(int));
+  deps->orderValid = (unsigned char*)calloc(orderCapacity, sizeof(unsigned char));
+  deps->orderMark = (unsigned char*)calloc(orderCapacity, sizeof(unsigned char));
+  if (deps->edgeOrder == NULL || deps->edgeNext == NULL || deps->orderValid == NULL || deps->orderMark == NULL ||
+      !initIdIndex(&deps->partHeads, orderCapacity) || !initIdIndex(&deps->customerHeads, orderCapacity)) {
+    logGeneric("Failed to allocate memory for order dependency index.");
+    freeOrderDependencies(deps);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : addEdge
+// DESCRIPTION :
+//    Prepends an order to the list of orders that depend on an ID.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    IdIndex* heads: The head index for the ID type (parts or customers).
+//    int id: The partID or customerID.
+//    int orderIndex: The position of the dependent order in the orders array.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int addEdge(OrderDependencies* deps, IdIndex* heads, int id, int orderIndex) {
+  if (deps->edgeCount == deps->edgeCapacity) {
+    int newCapacity = deps->edgeCapacity * 2;
+    int* newOrder = (int*)realloc(deps->edgeOrder, newCapacity * sizeof(int));
+    if (newOrder == NULL) {
+      logGeneric("Failed to grow order dependency index.");
+      return 0;
+    }
+    deps->edgeOrder = newOrder;
+    int* newNext = (int*)realloc(deps->edgeNext, newCapacity * sizeof(int));
+    if (newNext == NULL) {
+      logGeneric("Failed to grow order dependency index.");
+      return 0;
+    }
+    deps->edgeNext = newNext;
+    deps->edgeCapacity = newCapacity;
+  }
+  int edge = deps->edgeCount++;
+  deps->edgeOrder[edge] = orderIndex;
+  deps->edgeNext[edge] = findIdIndex(heads, id); // ID_INDEX_NOT_FOUND (-1) also ends the list
+  return setIdIndex(heads, id, edge);
+}
+
+// FUNCTION : addOrderDependencies
+// DESCRIPTION :
+//    Registers an order as dependent on its customer and each of its ordered parts.
+//    The order is marked valid, since only validated orders are added.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    const Order* order: The order to register.
+//    int orderIndex: The position of the order in the orders array.
+// RETURNS :
+//    int : 1 on success, 0 on failure.
+int addOrderDependencies(OrderDependencies* deps, const Order* order, int orderIndex) {
+  if (orderIndex < 0 || orderIndex >= deps->orderCapacity) {
+    return 0;
+  }
+  if (!addEdge(deps, &deps->customerHeads, order->customerID, orderIndex)) {
+    return 0;
+  }
+  for (int i = 0; i < order->distinctParts; i++) {
+    if (!addEdge(deps, &deps->partHeads, order->orderedParts[i].partID, orderIndex)) {
+      return 0;
+    }
+  }
+  deps->orderValid[orderIndex] = 1;
+  return 1;
+}
+
+// FUNCTION : buildOrderDependencies
+// DESCRIPTION :
+//    Rebuilds the dependency index from scratch for the given orders.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    const Order* orders: The array of loaded orders.
+//    int orderCount: Number of orders in the array.
+// RETURNS :
+//    int : 1 on success, 0 on failure.
+int buildOrderDependencies(OrderDependencies* deps, const Order* orders, int orderCount) {
+  clearIdIndex(&deps->partHeads);
+  clearIdIndex(&deps->customerHeads);
+  deps->edgeCount = 0;
+  memset(deps->orderValid, 0, deps->orderCapacity);
+  for (int i = 0; i < orderCount; i++) {
+    if (!addOrderDependencies(deps, &orders[i], i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : collectEdges
+// DESCRIPTION :
+//    Appends every not yet collected order on an ID's edge list to the output.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    const IdIndex* heads: The head index for the ID type (parts or customers).
+//    int id: The partID or customerID.
+//    int* orderIndexes: Output array of order positions.
+//    int found: Number of order positions already in the output.
+//    int maxOrders: Capacity of the output array.
+// RETURNS :
+//    int : The new number of order positions in the output.
+static int collectEdges(OrderDependencies* deps, const IdIndex* heads, int id, int* orderIndexes, int found, int maxOrders) {
+  for (int edge = findIdIndex(heads, id); edge != -1 && found < maxOrders; edge = deps->edgeNext[edge]) {
+    int orderIndex = deps->edgeOrder[edge];
+    if (!deps->orderMark[orderIndex]) {
+      deps->orderMark[orderIndex] = 1;
+      orderIndexes[found++] = orderIndex;
+    }
+  }
+  return found;
+}
+
+// FUNCTION : collectDependentOrders
+// DESCRIPTION :
+//    Finds every order that references at least one of the given parts or customers.
+//    Each order is reported once even when it references several of the IDs.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    const int* partIDs: The changed partIDs (may be NULL if partIDCount is 0).
+//    int partIDCount: Number of partIDs.
+//    const int* customerIDs: The changed customerIDs (may be NULL if customerIDCount is 0).
+//    int customerIDCount: Number of customerIDs.
+//    int* orderIndexes: Output array of dependent order positions.
+//    int maxOrders: Capacity of the output array.
+// RETURNS :
+//    int : The number of dependent orders written to orderIndexes.
+int collectDependentOrders(OrderDependencies* deps, const int* partIDs, int partIDCount,
+  const int* customerIDs, int customerIDCount, int* orderIndexes, int maxOrders) {
+  int found = 0;
+  for (int i = 0; i < partIDCount; i++) {
+    found = collectEdges(deps, &deps->partHeads, partIDs[i], orderIndexes, found, maxOrders);
+  }
+  for (int i = 0; i < customerIDCount; i++) {
+    found = collectEdges(deps, &deps->customerHeads, customerIDs[i], orderIndexes, found, maxOrders);
+  }
+  // Reset only the marks that were set, keeping the cost proportional to the result
+  for (int i = 0; i < found; i++) {
+    deps->orderMark[orderIndexes[i]] = 0;
+  }
+  return found;
+}
+
+// FUNCTION : revalidateDependentOrders
+// DESCRIPTION :
+//    Re-runs the order validation rules for only the orders that reference the changed parts or customers,
+//    and updates their validity flags. Orders that change validity are logged and recorded in flips.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index.
+//    const int* partIDs: The changed partIDs (added, removed or cost changed).
+//    int partIDCount: Number of partIDs.
+//    const int* customerIDs: The changed customerIDs (added or removed).
+//    int customerIDCount: Number of customerIDs.
+//    const Order* orders: The array of loaded orders.
+//    int orderCount: Number of orders in the array.
+//    const Part* parts: The current parts.
+//    int partCount: Number of parts.
+//    const Customer* customers: The current customers.
+//    int customerCount: Number of customers.
+//    ValidityFlips* flips: Receives the orders whose validity flipped (cleared first), or NULL.
+// RETURNS :
+//    int : The number of orders that were re-validated, or -1 if memory could not be allocated.
+int revalidateDependentOrders(OrderDependencies* deps, const int* partIDs, int partIDCount,
+  const int* customerIDs, int customerIDCount, const Order* orders, int orderCount,
+  const Part* parts, int partCount, const Customer* customers, int customerCount, ValidityFlips* flips) {
+  if (flips != NULL) {
+    flips->count = 0;
+  }
+  if (orderCount == 0) {
+    return 0;
+  }
+  int* orderIndexes = (int*)malloc(orderCount * sizeof(int));
+  if (orderIndexes == NULL) {
+    logGeneric("Failed to allocate memory for order revalidation.");
+    return -1;
+  }
+  IdIndex partIndex;
+  IdIndex customerIndex;
+  if (!indexOrderReferences(parts, partCount, customers, customerCount, &partIndex, &customerIndex)) {
+    logGeneric("Failed to allocate memory for order revalidation.");
+    free(orderIndexes);
+    return -1;
+  }
+  char message[256];
+  int dependentCount = collectDependentOrders(deps, partIDs, partIDCount, customerIDs, customerIDCount, orderIndexes, orderCount);
+  for (int i = 0; i < dependentCount; i++) {
+    int orderIndex = orderIndexes[i];
+    unsigned char isValid = (unsigned char)validateOrderRecord(&orders[orderIndex], parts, &partIndex, &customerIndex);
+    if (isValid != deps->orderValid[orderIndex]) {
+      snprintf(message, sizeof(message), isValid ? "Order %lld is valid again after a part or customer change." :
+        "Order %lld is no longer valid after a part or customer change.", orders[orderIndex].orderID);
+      logGeneric(message);
+      deps->orderValid[orderIndex] = isValid;
+      if (flips != NULL && flips->count < flips->capacity) {
+        flips->orderIndexes[flips->count] = orderIndex;
+        flips->isNowValid[flips->count] = isValid;
+        flips->count++;
+      }
+    }
+  }
+  freeIdIndex(&partIndex);
+  freeIdIndex(&customerIndex);
+  free(orderIndexes);
+  return dependentCount;
+}
+// FUNCTION : freeOrderDependencies
+// DESCRIPTION :
+//    Frees the memory held by the dependency index.
+// PARAMETERS :
+//    OrderDependencies* deps: The dependency index to free.
+// RETURNS :
+//    void
+void freeOrderDependencies(OrderDependencies* deps) {
+  freeIdIndex(&deps->partHeads);
+  freeIdIndex(&deps->customerHeads);
+  free(deps->edgeOrder);
+  free(deps->edgeNext);
+  free(deps->orderValid);
+  free(deps->orderMark);
+  memset(deps, 0, sizeof(OrderDependencies));
+}
+
+// FUNCTION : initValidityFlips
+// DESCRIPTION :
+//    Creates an empty list of validity flips able to hold up to capacity orders.
+// PARAMETERS :
+//    ValidityFlips* flips: The list to initialize.
+//    int capacity: The maximum number of flipped orders (normally the orders capacity).
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initValidityFlips(ValidityFlips* flips, int capacity) {
+  flips->orderIndexes = (int*)malloc(capacity * sizeof(int));
+  flips->isNowValid = (unsigned char*)malloc(capacity * sizeof(unsigned char));
+  flips->count = 0;
+  flips->capacity = capacity;
+  if (flips->orderIndexes == NULL || flips->isNowValid == NULL) {
+    logGeneric("Failed to allocate memory for validity flips.");
+    freeValidityFlips(flips);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : printValidityFlips
+// DESCRIPTION :
+//    Prints the exact set of orders whose validity flipped in the last revalidation.
+// PARAMETERS :
+//    const ValidityFlips* flips: The flips to print.
+//    const Order* orders: The orders array the flips refer to.
+// RETURNS :
+//    void
+void printValidityFlips(const ValidityFlips* flips, const Order* orders) {
+  if (flips->count == 0) {
+    printf("No order changed validity.\n");
+    return;
+  }
+  printf("%d order(s) changed validity:\n", flips->count);
+  for (int i = 0; i < flips->count; i++) {
+    printf("  Order %lld is now %s\n", orders[flips->orderIndexes[i]].orderID, flips->isNowValid[i] ? "valid" : "invalid");
+  }
+}
+
+// FUNCTION : freeValidityFlips
+// DESCRIPTION :
+//    Frees the memory held by a list of validity flips.
+// PARAMETERS :
+//    ValidityFlips* flips: The list to free.
+// RETURNS :
+//    void
+void freeValidityFlips(ValidityFlips* flips) {
+  free(flips->orderIndexes);
+  free(flips->isNowValid);
+  flips->orderIndexes = NULL;
+  flips->isNowValid = NULL;
+  flips->count = 0;
+  flips->capacity = 0;
+}
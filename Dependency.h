@@ -0,0 +1,44 @@
+// FILE : Dependency.h
+// DESCRIPTION : This header file defines the reverse index from parts and customers to the orders that reference them.
+#ifndef DEPENDENCY_H
+#define DEPENDENCY_H
+
+#include "Index.h"
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+
+typedef struct {
+  IdIndex partHeads; // partID -> first edge of the part's order list
+  IdIndex customerHeads; // customerID -> first edge of the customer's order list
+  int* edgeOrder; // Position in the orders array for each edge
+  int* edgeNext; // Next edge for the same part/customer, -1 ends the list
+  int edgeCount;
+  int edgeCapacity;
+  unsigned char* orderValid; // 1 while the order passes validation against the current parts and customers
+  unsigned char* orderMark; // Scratch flags used to report each dependent order once
+  int orderCapacity;
+} OrderDependencies;
+
+typedef struct {
+  int* orderIndexes; // Positions of the orders whose validity flipped
+  unsigned char* isNowValid; // New validity of each flipped order
+  int count;
+  int capacity;
+} ValidityFlips;
+
+int initOrderDependencies(OrderDependencies* deps, int orderCapacity);
+int buildOrderDependencies(OrderDependencies* deps, const Order* orders, int orderCount);
+int addOrderDependencies(OrderDependencies* deps, const Order* order, int orderIndex);
+int collectDependentOrders(OrderDependencies* deps, const int* partIDs, int partIDCount,
+  const int* customerIDs, int customerIDCount, int* orderIndexes, int maxOrders);
+int revalidateDependentOrders(OrderDependencies* deps, const int* partIDs, int partIDCount,
+  const int* customerIDs, int customerIDCount, const Order* orders, int orderCount,
+  const Part* parts, int partCount, const Customer* customers, int customerCount, ValidityFlips* flips);
+void freeOrderDependencies(OrderDependencies* deps);
+
+int initValidityFlips(ValidityFlips* flips, int capacity);
+void printValidityFlips(const ValidityFlips* flips, const Order* orders);
+void freeValidityFlips(ValidityFlips* flips);
+
+#endif
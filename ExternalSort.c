@@ -0,0 +1,449 @@
+// FILE : ExternalSort.c
+// DESCRIPTION :
+//    Implements an external merge sort of order database files keyed by orderID.
+//    The input is cut into sorted runs that fit in a fixed memory budget and spilled to temporary
+//    files, then the runs are combined with a k-way heap merge. Lines are copied verbatim, so the
+//    output can be loaded with loadOrders like any other orders database. Inputs may be gzip or
+//    zstd compressed, and an output named *.gz or *.zst is written compressed.
+#include "ExternalSort.h"
+#include "AsyncReader.h"
+#include "Compression.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  long long orderID;
+  int sequence; // Input order, keeps records with the same orderID in the order they were read
+  char* text; // The line, including its newline
+} SortEntry;
+
+typedef struct {
+  FILE** files;
+  int count;
+  int capacity;
+} RunList;
+
+typedef struct {
+  FILE* file;
+  long long orderID;
+  int runIndex; // Position of the run in the input order, used to break ties
+  char line[SORT_LINE_SIZE];
+} MergeSource;
+
+// FUNCTION : parseOrderKey
+// DESCRIPTION :
+//    Reads the orderID at the start of an order line.
+// PARAMETERS :
+//    const char* line: The order line.
+// RETURNS :
+//    long long : The orderID, or 0 if the line does not start with a number. Such lines have no key:
+//                they sort first and are never removed as duplicates.
+static long long parseOrderKey(const char* line) {
+  char* end = NULL;
+  long long orderID = strtoll(line, &end, 10);
+  if (end == line || *end != '|') {
+    return 0;
+  }
+  return orderID;
+}
+
+// FUNCTION : compareSortEntries
+// DESCRIPTION :
+//    qsort comparison of two entries by orderID, then by input order.
+// PARAMETERS :
+//    const void* first: The first SortEntry.
+//    const void* second: The second SortEntry.
+// RETURNS :
+//    int : Negative, zero or positive as first sorts before, with or after second.
+static int compareSortEntries(const void* first, const void* second) {
+  const SortEntry* a = (const SortEntry*)first;
+  const SortEntry* b = (const SortEntry*)second;
+  if (a->orderID != b->orderID) {
+    return a->orderID < b->orderID ? -1 : 1;
+  }
+  return a->sequence - b->sequence;
+}
+
+// FUNCTION : addRun
+// DESCRIPTION :
+//    Appends a run file to the list of runs, growing the list when needed.
+// PARAMETERS :
+//    RunList* runs: The list of runs.
+//    FILE* run: The run file, positioned at its start.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int addRun(RunList* runs, FILE* run) {
+  if (runs->count == runs->capacity) {
+    int capacity = runs->capacity == 0 ? 16 : runs->capacity * 2;
+    FILE** files = (FILE**)realloc(runs->files, capacity * sizeof(FILE*));
+    if (files == NULL) {
+      logGeneric("Failed to allocate memory for the sorted runs.");
+      return 0;
+    }
+    runs->files = files;
+    runs->capacity = capacity;
+  }
+  runs->files[runs->count++] = run;
+  return 1;
+}
+
+// FUNCTION : closeRuns
+// DESCRIPTION :
+//    Closes (and so deletes) every run file in the list and frees the list.
+// PARAMETERS :
+//    RunList* runs: The list of runs.
+// RETURNS :
+//    void
+static void closeRuns(RunList* runs) {
+  for (int i = 0; i < runs->count; i++) {
+    fclose(runs->files[i]);
+  }
+  free(runs->files);
+  runs->files = NULL;
+  runs->count = 0;
+  runs->capacity = 0;
+}
+
+// FUNCTION : spillRun
+// DESCRIPTION :
+//    Sorts the entries held in memory and writes them to a new temporary run file.
+// PARAMETERS :
+//    SortEntry* entries: The entries read since the last run.
+//    int entryCount: Number of entries.
+//    RunList* runs: The list of runs, receives the new run.
+// RETURNS :
+//    int : 1 on success, 0 on failure.
+static int spillRun(SortEntry* entries, int entryCount, RunList* runs) {
+  FILE* run = NULL;
+  if (tmpfile_s(&run) != 0 || run == NULL) {
+    logGeneric("Failed to create a temporary file for a sorted run.");
+    return 0;
+  }
+  qsort(entries, entryCount, sizeof(SortEntry), compareSortEntries);
+  int isWritten = 1;
+  for (int i = 0; i < entryCount && isWritten; i++) {
+    isWritten = fputs(entries[i].text, run) != EOF;
+  }
+  if (!isWritten || fflush(run) != 0 || ferror(run)) {
+    logGeneric("Failed to write a sorted run to its temporary file.");
+    fclose(run);
+    return 0;
+  }
+  rewind(run);
+  if (!addRun(runs, run)) {
+    fclose(run);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : skipRestOfLine
+// DESCRIPTION :
+//    Reads past the rest of a line that was too long to keep.
+// PARAMETERS :
+//    AsyncReader* reader: The input, in the middle of the line.
+// RETURNS :
+//    void
+static void skipRestOfLine(AsyncReader* reader) {
+  char rest[256];
+  while (readAsyncLine(reader, rest, sizeof(rest)) != NULL && rest[strlen(rest) - 1] != '\n') {
+  }
+}
+
+// FUNCTION : createSortedRuns
+// DESCRIPTION :
+//    Reads the input files in order and cuts them into sorted runs of at most memoryBytes each.
+//    Empty lines are skipped and lines longer than SORT_LINE_SIZE are dropped, as loadOrders would.
+// PARAMETERS :
+//    const char** inputFiles: The order files to read.
+//    int inputCount: Number of input files.
+//    size_t memoryBytes: Memory available for one run.
+//    RunList* runs: Receives the runs, in input order.
+// RETURNS :
+//    int : 1 on success, 0 on failure.
+static int createSortedRuns(const char** inputFiles, int inputCount, size_t memoryBytes, RunList* runs) {
+  int entryCapacity = (int)(memoryBytes / 4 / sizeof(SortEntry));
+  size_t textCapacity = memoryBytes - entryCapacity * sizeof(SortEntry);
+  SortEntry* entries = (SortEntry*)malloc(entryCapacity * sizeof(SortEntry));
+  char* text = (char*)malloc(textCapacity);
+  if (entries == NULL || text == NULL || entryCapacity == 0 || textCapacity < SORT_LINE_SIZE + 1) {
+    logGeneric("Failed to allocate memory for sorting the order files.");
+    free(entries);
+    free(text);
+    return 0;
+  }
+  int entryCount = 0;
+  size_t textUsed = 0;
+  int sequence = 0;
+  int isSuccessful = 1;
+  char errorMessage[300];
+  for (int i = 0; i < inputCount && isSuccessful; i++) {
+    char sourceFileName[260];
+    resolveDatabaseFile(inputFiles[i], sourceFileName, sizeof(sourceFileName));
+    AsyncReader* reader = openAsyncReader(sourceFileName);
+    if (reader == NULL) {
+      snprintf(errorMessage, sizeof(errorMessage), "Failed to open %s for sorting.", inputFiles[i]);
+      logGeneric(errorMessage);
+      isSuccessful = 0;
+      break;
+    }
+    int lineNumber = 0;
+    while (1) {
+      // Leave room for the longest line plus an added newline
+      if (entryCount == entryCapacity || textCapacity - textUsed < SORT_LINE_SIZE + 1) {
+        if (!spillRun(entries, entryCount, runs)) {
+          isSuccessful = 0;
+          break;
+        }
+        entryCount = 0;
+        textUsed = 0;
+      }
+      char* line = text + textUsed;
+      if (readAsyncLine(reader, line, SORT_LINE_SIZE) == NULL) {
+        break;
+      }
+      if (line[0] == '\n' || line[0] == '\r') {
+        continue;
+      }
+      lineNumber++;
+      size_t length = strlen(line);
+      if (length >= 2 && line[length - 2] == '\r' && line[length - 1] == '\n') {
+        line[--length - 1] = '\n'; // Read as binary, so "\r\n" endings are still there
+        line[length] = '\0';
+      }
+      if (line[length - 1] != '\n') {
+        if (length == SORT_LINE_SIZE - 1) {
+          snprintf(errorMessage, sizeof(errorMessage), "In %s line %d: Line is too long, not sorted.", inputFiles[i], lineNumber);
+          logGeneric(errorMessage);
+          skipRestOfLine(reader);
+          continue;
+        }
+        line[length++] = '\n'; // Last line of a file without a trailing newline
+        line[length] = '\0';
+      }
+      entries[entryCount].orderID = parseOrderKey(line);
+      entries[entryCount].sequence = sequence++;
+      entries[entryCount].text = line;
+      entryCount++;
+      textUsed += length + 1;
+    }
+    closeAsyncReader(reader);
+  }
+  if (isSuccessful && entryCount > 0) {
+    isSuccessful = spillRun(entries, entryCount, runs);
+  }
+  free(entries);
+  free(text);
+  return isSuccessful;
+}
+
+// FUNCTION : isSourceBefore
+// DESCRIPTION :
+//    Heap ordering of merge sources: smaller orderID first, earlier run first on ties.
+// PARAMETERS :
+//    const MergeSource* a: The first source.
+//    const MergeSource* b: The second source.
+// RETURNS :
+//    int : 1 if a comes before b, 0 otherwise.
+static int isSourceBefore(const MergeSource* a, const MergeSource* b) {
+  if (a->orderID != b->orderID) {
+    return a->orderID < b->orderID;
+  }
+  return a->runIndex < b->runIndex;
+}
+
+// FUNCTION : siftDown
+// DESCRIPTION :
+//    Restores the min-heap property from a position downwards.
+// PARAMETERS :
+//    MergeSource** heap: The heap of sources.
+//    int heapSize: Number of sources in the heap.
+//    int position: The position to sift down from.
+// RETURNS :
+//    void
+static void siftDown(MergeSource** heap, int heapSize, int position) {
+  while (1) {
+    int smallest = position;
+    int left = position * 2 + 1;
+    int right = left + 1;
+    if (left < heapSize && isSourceBefore(heap[left], heap[smallest])) {
+      smallest = left;
+    }
+    if (right < heapSize && isSourceBefore(heap[right], heap[smallest])) {
+      smallest = right;
+    }
+    if (smallest == position) {
+      return;
+    }
+    MergeSource* swap = heap[position];
+    heap[position] = heap[smallest];
+    heap[smallest] = swap;
+    position = smallest;
+  }
+}
+
+// FUNCTION : readNextLine
+// DESCRIPTION :
+//    Reads the next line of a merge source and its orderID.
+// PARAMETERS :
+//    MergeSource* source: The source to advance.
+// RETURNS :
+//    int : 1 if a line was read, 0 at the end of the run, -1 if the run could not be read.
+static int readNextLine(MergeSource* source) {
+  if (fgets(source->line, sizeof(source->line), source->file) == NULL) {
+    return ferror(source->file) ? -1 : 0;
+  }
+  source->orderID = parseOrderKey(source->line);
+  return 1;
+}
+
+// FUNCTION : mergeRuns
+// DESCRIPTION :
+//    Merges up to MERGE_FAN_IN sorted runs into one sorted output with a min-heap.
+//    When removing duplicates, only the first line of each orderID (in input order) is written;
+//    lines without an orderID are all written.
+// PARAMETERS :
+//    FILE** runFiles: The runs to merge, in input order.
+//    int runCount: Number of runs.
+//    CompressedWriter* output: Receives the merged lines. Closed when done; the file stays open.
+//    int isRemovingDuplicates: 1 to drop repeated orderIDs, 0 to keep them.
+//    int* duplicateCount: Incremented for each dropped line.
+// RETURNS :
+//    int : The number of lines written, or -1 on failure.
+static int mergeRuns(FILE** runFiles, int runCount, CompressedWriter* output, int isRemovingDuplicates, int* duplicateCount) {
+  MergeSource* sources = (MergeSource*)malloc(runCount * sizeof(MergeSource));
+  MergeSource** heap = (MergeSource**)malloc(runCount * sizeof(MergeSource*));
+  if (sources == NULL || heap == NULL) {
+    logGeneric("Failed to allocate memory for merging the sorted runs.");
+    free(sources);
+    free(heap);
+    closeCompressedWriter(output);
+    return -1;
+  }
+  int heapSize = 0;
+  int isRead = 1;
+  for (int i = 0; i < runCount; i++) {
+    sources[i].file = runFiles[i];
+    sources[i].runIndex = i;
+    int result = readNextLine(&sources[i]);
+    if (result > 0) {
+      heap[heapSize++] = &sources[i];
+    }
+    else if (result < 0) {
+      isRead = 0;
+    }
+  }
+  for (int i = heapSize / 2 - 1; i >= 0; i--) {
+    siftDown(heap, heapSize, i);
+  }
+  int writtenCount = 0;
+  int hasWritten = 0;
+  long long lastOrderID = 0;
+  while (heapSize > 0 && isRead) {
+    MergeSource* next = heap[0];
+    if (isRemovingDuplicates && hasWritten && next->orderID != 0 && next->orderID == lastOrderID) {
+      (*duplicateCount)++;
+    }
+    else {
+      if (!writeCompressed(output, next->line, strlen(next->line))) {
+        break;
+      }
+      lastOrderID = next->orderID;
+      hasWritten = 1;
+      writtenCount++;
+    }
+    int result = readNextLine(next);
+    if (result <= 0) {
+      isRead = result == 0;
+      heap[0] = heap[--heapSize];
+    }
+    siftDown(heap, heapSize, 0);
+  }
+  free(sources);
+  free(heap);
+  if (!isRead) {
+    logGeneric("Failed to read a sorted run back from its temporary file.");
+    closeCompressedWriter(output);
+    return -1;
+  }
+  if (!closeCompressedWriter(output)) {
+    logGeneric("Failed to write the merged orders.");
+    return -1;
+  }
+  return writtenCount;
+}
+
+// FUNCTION : sortOrderFiles
+// DESCRIPTION :
+//    Sorts one or more order database files by orderID into a single output file, using at most
+//    memoryBytes for records at a time so files larger than RAM can be sorted. When there are more
+//    runs than MERGE_FAN_IN, groups of runs are merged into longer runs first.
+//    Records with the same orderID keep their input order (earlier files first).
+// PARAMETERS :
+//    const char** inputFiles: The order files to sort. The output may be one of them.
+//    int inputCount: Number of input files.
+//    const char* outputFile: The file to write the sorted orders to.
+//    size_t memoryBytes: Memory available for one sorted run.
+//    int isRemovingDuplicates: 1 to keep only the first record of each orderID, 0 to keep all records.
+//    int* duplicateCount: Receives the number of records dropped as duplicates.
+// RETURNS :
+//    int : The number of records written, or -1 on failure.
+int sortOrderFiles(const char** inputFiles, int inputCount, const char* outputFile, size_t memoryBytes,
+  int isRemovingDuplicates, int* duplicateCount) {
+  RunList runs = { NULL, 0, 0 };
+  *duplicateCount = 0;
+  if (!createSortedRuns(inputFiles, inputCount, memoryBytes, &runs)) {
+    closeRuns(&runs);
+    return -1;
+  }
+  // Merge groups of runs into longer runs until one merge can take all of them
+  while (runs.count > MERGE_FAN_IN) {
+    RunList mergedRuns = { NULL, 0, 0 };
+    for (int first = 0; first < runs.count; first += MERGE_FAN_IN) {
+      int groupSize = runs.count - first < MERGE_FAN_IN ? runs.count - first : MERGE_FAN_IN;
+      FILE* mergedRun = NULL;
+      if (tmpfile_s(&mergedRun) != 0 || mergedRun == NULL) {
+        logGeneric("Failed to create a temporary file for a sorted run.");
+        closeRuns(&mergedRuns);
+        closeRuns(&runs);
+        return -1;
+      }
+      CompressedWriter* runWriter = openCompressedWriter(mergedRun, COMPRESSION_NONE);
+      if (runWriter == NULL || mergeRuns(runs.files + first, groupSize, runWriter, 0, duplicateCount) < 0 || !addRun(&mergedRuns, mergedRun)) {
+        fclose(mergedRun);
+        closeRuns(&mergedRuns);
+        closeRuns(&runs);
+        return -1;
+      }
+      rewind(mergedRun);
+    }
+    closeRuns(&runs);
+    runs = mergedRuns;
+  }
+  FILE* output = NULL;
+  int compression = getCompressionByName(outputFile);
+  errno_t err = fopen_s(&output, outputFile, compression == COMPRESSION_NONE ? "w" : "wb");
+  if (err != 0 || output == NULL) {
+    logGeneric("Failed to open the sorted orders file for writing.");
+    closeRuns(&runs);
+    return -1;
+  }
+  CompressedWriter* writer = openCompressedWriter(output, compression);
+  int writtenCount = writer == NULL ? -1 : mergeRuns(runs.files, runs.count, writer, isRemovingDuplicates, duplicateCount);
+  if (fclose(output) != 0 && writtenCount >= 0) {
+    logGeneric("Failed to write the sorted orders file.");
+    writtenCount = -1;
+  }
+  closeRuns(&runs);
+  if (*duplicateCount > 0) {
+    char message[200];
+    snprintf(message, sizeof(message), "Sorting orders into %s removed %d record(s) with a repeated order ID.",
+      outputFile, *duplicateCount);
+    logGeneric(message);
+  }
+  return writtenCount;
+}
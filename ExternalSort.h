@@ -0,0 +1,13 @@
+// FILE : ExternalSort.h
+// DESCRIPTION : This header file defines the external merge sort used to sort and merge order database files by orderID.
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include <stddef.h>
+
+#define SORT_LINE_SIZE 2048 // Longest line kept, same as the orders loader
+
+int sortOrderFiles(const char** inputFiles, int inputCount, const char* outputFile, size_t memoryBytes,
+  int isRemovingDuplicates, int* duplicateCount);
+
+#endif
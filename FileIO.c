@@ -9,188 +9,585 @@
 #include "Validation.h"
 #include "Logger.h"
 #include "Constants.h"
+#include "Index.h"
+#include "Rollup.h"
+#include "PickList.h"
+#include "DateIndex.h"
+#include "OrderId.h"
+#include "Metrics.h"
+#include "Quarantine.h"
+#include "LazyFields.h"
+#include "Checksum.h"
+#include "LinePipeline.h"
+#include "Compression.h"
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// FUNCTION : loadCustomers
-// DESCRIPTION : 
-//    Reads customer data from a file and populates the customers array.
-//    Includes error handling for file operations and calling data validation functions.
+static const LoadOptions DEFAULT_LOAD_OPTIONS = { .duplicatePolicy = DUPLICATE_KEEP_FIRST }; // Every other field is zero
+
+typedef struct {
+  IdIndex seen; // ID -> position of the record kept for that ID
+  unsigned char* isRejected; // Positions dropped at the end under DUPLICATE_REJECT
+  int rejectedCount;
+  int duplicateCount;
+  int omittedCount; // Duplicates that did not fit in the bulk log message
+  char logMessage[4096];
+  const char* sourceType;
+  const LoadOptions* options;
+} DuplicateTracker;
+
+// State of a customers load, shared by its pipeline stages
+typedef struct {
+  Customer* customers;
+  int customerCount;
+  int lineCount; // Non-empty lines read before the load finished or stopped
+  int isLazy;
+  int isTrusted;
+  DuplicateTracker duplicates;
+  QuarantineWriter quarantine;
+} CustomerLoad;
+
+// State of a parts load, shared by its pipeline stages
+typedef struct {
+  Part* parts;
+  int partCount;
+  int lineCount; // Non-empty lines read before the load finished or stopped
+  int isLazy;
+  int isTrusted;
+  DuplicateTracker duplicates;
+  QuarantineWriter quarantine;
+} PartLoad;
+
+// FUNCTION : initDuplicateTracker
+// DESCRIPTION :
+//    Prepares duplicate ID detection for one load. Detection is O(1) per record using an ID hash index.
 // PARAMETERS :
-//    Customer* customers: Pointer to an array of Customer structures to be filled.
-//    const char* fileName: Name of the file to read customer data from.
+//    DuplicateTracker* tracker: The tracker to initialize.
+//    const char* sourceType: The record type ("Customer", "Part" or "Order").
+//    const char* fileName: The file being loaded, used in the bulk report.
+//    int limit: The maximum number of records that can be loaded.
+//    const LoadOptions* options: The load options.
 // RETURNS :
-//    int : The number of customers successfully loaded.
-int loadCustomers(Customer* customers, const char* fileName) {
-  int customerCount = 0;
-  int lineNumber = 0; // For error reporting
-  FILE* file = NULL;
-  errno_t err = fopen_s(&file, fileName, "r");
-  if (err != 0 || file == NULL) {
-    logGeneric("Failed to open customers database.");
+//    int : 1 on success, 0 if memory could not be allocated.
+static int initDuplicateTracker(DuplicateTracker* tracker, const char* sourceType, const char* fileName, int limit, const LoadOptions* options) {
+  memset(tracker, 0, sizeof(DuplicateTracker));
+  tracker->sourceType = sourceType;
+  tracker->options = options;
+  snprintf(tracker->logMessage, sizeof(tracker->logMessage), "Duplicate %s IDs in %s (policy: %s):", sourceType, fileName,
+    options->duplicatePolicy == DUPLICATE_REJECT ? "reject" : options->duplicatePolicy == DUPLICATE_KEEP_LAST ? "keep last" : "keep first");
+  tracker->isRejected = (unsigned char*)calloc(limit, sizeof(unsigned char));
+  if (tracker->isRejected == NULL || !initIdIndex(&tracker->seen, limit)) {
+    free(tracker->isRejected);
+    logGeneric("Failed to allocate memory for duplicate ID detection.");
     return 0;
   }
-  char errorMessage[256];
-  char line[1024];
-  customerCount = 0;
-  // Read each line from the file
-  while (fgets(line, sizeof(line), file) != NULL) {
-    // Skip empty lines
-    if (line[0] == '\n' || line[0] == '\r') {
-      continue; // Read next line
-    }
-    lineNumber++;
-    // Check if over limit 
-    if (customerCount >= CUSTOMERS_LIMIT) {
-      logGeneric("Customer limit reached when loading from database, cannot load more customers.");
-      break;
+  return 1;
+}
+
+// FUNCTION : resolveDuplicate
+// DESCRIPTION :
+//    Checks a validated record's ID against the IDs already loaded and applies the duplicate policy.
+// PARAMETERS :
+//    DuplicateTracker* tracker: The tracker for the current load.
+//    long long id: The ID of the new record.
+//    int count: Number of records loaded so far (the position a new ID is appended at).
+//    int lineNumber: The line number of the new record for reporting.
+// RETURNS :
+//    int : The position to store the record at, or -1 if the record must be skipped.
+static int resolveDuplicate(DuplicateTracker* tracker, long long id, int count, int lineNumber) {
+  int position = findIdIndex(&tracker->seen, id);
+  if (position == ID_INDEX_NOT_FOUND) {
+    setIdIndex(&tracker->seen, id, count);
+    return count;
+  }
+  tracker->duplicateCount++;
+  char entry[64];
+  snprintf(entry, sizeof(entry), " %lld (line %d),", id, lineNumber);
+  if (strlen(tracker->logMessage) + strlen(entry) < sizeof(tracker->logMessage) - 32) {
+    strcat_s(tracker->logMessage, sizeof(tracker->logMessage), entry);
+  }
+  else {
+    tracker->omittedCount++;
+  }
+  DuplicateReport* report = tracker->options->duplicates;
+  if (report != NULL && report->count < report->capacity) {
+    report->sourceTypes[report->count] = tracker->sourceType;
+    report->ids[report->count] = id;
+    report->lineNumbers[report->count] = lineNumber;
+    report->count++;
+  }
+  if (tracker->options->duplicatePolicy == DUPLICATE_KEEP_LAST) {
+    return position;
+  }
+  if (tracker->options->duplicatePolicy == DUPLICATE_REJECT && !tracker->isRejected[position]) {
+    tracker->isRejected[position] = 1;
+    tracker->rejectedCount++;
+  }
+  return -1;
+}
+
+// FUNCTION : finishDuplicateTracker
+// DESCRIPTION :
+//    Logs all duplicates of the load in one message, removes the records rejected by
+//    DUPLICATE_REJECT while keeping the order of the others, and frees the tracker.
+// PARAMETERS :
+//    DuplicateTracker* tracker: The tracker for the current load.
+//    void* records: The loaded records array.
+//    size_t recordSize: The size of one record.
+//    int count: Number of records loaded.
+// RETURNS :
+//    int : The number of records left after removing rejected ones.
+static int finishDuplicateTracker(DuplicateTracker* tracker, void* records, size_t recordSize, int count) {
+  if (tracker->duplicateCount > 0) {
+    size_t length = strlen(tracker->logMessage);
+    tracker->logMessage[length - 1] = '\0'; // Drop the trailing comma
+    if (tracker->omittedCount > 0) {
+      char more[32];
+      snprintf(more, sizeof(more), " and %d more", tracker->omittedCount);
+      strcat_s(tracker->logMessage, sizeof(tracker->logMessage), more);
     }
-    // Check if line is too long
-    if (strlen(line) == sizeof(line) - 1) {
-      snprintf(errorMessage, sizeof(errorMessage), "In customers database line %d: Line is too long.", lineNumber);
-      logGeneric(errorMessage);
-      // Discard rest of the line
-      while (1) {
-        char extra = fgetc(file);
-        if (extra == '\n' || extra == EOF) {
-          break;
+    logGeneric(tracker->logMessage);
+  }
+  int keptCount = count;
+  if (tracker->rejectedCount > 0) {
+    char* bytes = (char*)records;
+    keptCount = 0;
+    for (int i = 0; i < count; i++) {
+      if (!tracker->isRejected[i]) {
+        if (keptCount != i) {
+          memcpy(bytes + keptCount * recordSize, bytes + i * recordSize, recordSize);
         }
+        keptCount++;
       }
-      continue; // Read next line
     }
-    // Split line into fields
-    char* fields[NUMBER_OF_CUSTOMER_FIELDS];
-    int fieldCount = splitLine(line, fields, NUMBER_OF_CUSTOMER_FIELDS, '|');
-    if (fieldCount != NUMBER_OF_CUSTOMER_FIELDS) {
+  }
+  freeIdIndex(&tracker->seen);
+  free(tracker->isRejected);
+  return keptCount;
+}
+
+// FUNCTION : reportQuarantine
+// DESCRIPTION :
+//    Closes the quarantine of a load and logs how many lines it received.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The quarantine of the load.
+//    const char* databaseName: "customers", "parts" or "orders", for the log message.
+// RETURNS :
+//    void
+static void reportQuarantine(QuarantineWriter* quarantine, const char* databaseName) {
+  int quarantinedCount = closeQuarantine(quarantine);
+  if (quarantinedCount > 0) {
+    char message[512];
+    snprintf(message, sizeof(message), "%d rejected lines of the %s database were quarantined in %s.", quarantinedCount, databaseName,
+      quarantine->linesFileName);
+    logGeneric(message);
+  }
+}
+// FUNCTION : checkCustomerLine
+// DESCRIPTION :
+//    Check stage of a customers load: checks the field count and the fields of a line, without logging.
+// PARAMETERS :
+//    char** fields: The fields of the line.
+//    int fieldCount: The number of fields split from the line.
+//    void* context: The CustomerLoad.
+// RETURNS :
+//    int : The LINE_* state of the line.
+static int checkCustomerLine(char** fields, int fieldCount, void* context) {
+  const CustomerLoad* load = (const CustomerLoad*)context;
+  if (fieldCount != NUMBER_OF_CUSTOMER_FIELDS) {
+    return LINE_FIELD_COUNT_INVALID;
+  }
+  if (load->isTrusted) {
+    return isCustomerParseSafe(fields, load->isLazy) ? LINE_VALID : LINE_INVALID;
+  }
+  METRIC_TIMER_START(validateTimer);
+  int isValid = isCustomerValid(fields, load->isLazy);
+  METRIC_TIMER_STOP(STAGE_VALIDATE, validateTimer);
+  return isValid ? LINE_VALID : LINE_INVALID;
+}
+// FUNCTION : buildCustomerLine
+// DESCRIPTION :
+//    Build stage of a customers load: reports and quarantines a rejected line, or stores its
+//    customer, resolving a duplicate ID by the load's policy.
+// PARAMETERS :
+//    const LineSpan* line: The line and the outcome of its checks.
+//    const char* rawLine: The line as read, for the quarantine.
+//    char** fields: The fields of the line.
+//    void* context: The CustomerLoad.
+// RETURNS :
+//    int : 1 to carry on, 0 when the customer limit is reached.
+static int buildCustomerLine(const LineSpan* line, const char* rawLine, char** fields, void* context) {
+  CustomerLoad* load = (CustomerLoad*)context;
+  int lineNumber = line->lineNumber; // For error reporting
+  char errorMessage[256];
+  char reason[1024];
+  load->lineCount = lineNumber;
+  // Check if over limit 
+  if (load->customerCount >= CUSTOMERS_LIMIT) {
+    logGeneric("Customer limit reached when loading from database, cannot load more customers.");
+    return 0;
+  }
+  switch (line->state) {
+    case LINE_TOO_LONG:
+      snprintf(errorMessage, sizeof(errorMessage), "In customers database line %d: Line is too long.", lineNumber);
+      logGeneric(errorMessage);
+      quarantineLine(&load->quarantine, rawLine, lineNumber, "Line is too long.");
+      return 1;
+    case LINE_FIELD_COUNT_INVALID:
       snprintf(errorMessage, sizeof(errorMessage), "In customers database line %d: Incorrect number of fields (%d expected, found %d)", 
-        lineNumber, NUMBER_OF_CUSTOMER_FIELDS, fieldCount);
+        lineNumber, NUMBER_OF_CUSTOMER_FIELDS, line->fieldCount);
       logGeneric(errorMessage);
-      continue; // Read next line
-    }
-    if (!validateCustomerFields(fields, lineNumber)) {
-      // No need to log here since validate already did
-      continue;
-    }
-    // Fields should be all valid at this point
-    customers[customerCount] = parseFieldsToCustomer(fields);
-    customerCount++;
+      snprintf(reason, sizeof(reason), "Incorrect number of fields (%d expected, found %d)", NUMBER_OF_CUSTOMER_FIELDS, line->fieldCount);
+      quarantineLine(&load->quarantine, rawLine, lineNumber, reason);
+      return 1;
+    case LINE_INVALID:
+      // Validate again to log the errors
+      if (load->isLazy) {
+        validateCustomerKeyFields(fields, lineNumber, reason, sizeof(reason));
+      }
+      else {
+        validateCustomerFields(fields, lineNumber, reason, sizeof(reason));
+      }
+      quarantineLine(&load->quarantine, rawLine, lineNumber, reason);
+      return 1;
+  }
+  // Fields should be all valid at this point
+  Customer newCustomer = load->isLazy ? parseKeyFieldsToCustomer(fields, line->fileOffset) : parseFieldsToCustomer(fields);
+  int position = resolveDuplicate(&load->duplicates, newCustomer.customerID, load->customerCount, lineNumber);
+  if (position == -1) {
+    quarantineLine(&load->quarantine, rawLine, lineNumber, "Duplicate customer ID.");
+    return 1;
+  }
+  load->customers[position] = newCustomer;
+  if (position == load->customerCount) {
+    load->customerCount++;
+  }
+  return 1;
+}
+// FUNCTION : loadCustomers
+// DESCRIPTION : 
+//    Reads customer data from a file and populates the customers array.
+//    Includes error handling for file operations and calling data validation functions.
+//    The lines go through the load pipeline (see LinePipeline.c).
+// PARAMETERS :
+//    Customer* customers: Pointer to an array of Customer structures to be filled.
+//    const char* fileName: Name of the file to read customer data from.
+//    const LoadOptions* options: Duplicate handling options, or NULL for the defaults.
+// RETURNS :
+//    int : The number of customers successfully loaded, or -1 if the file could not be opened or memory
+//          could not be allocated. The customers array is left as it was in that case.
+int loadCustomers(Customer* customers, const char* fileName, const LoadOptions* options) {
+  if (options == NULL) {
+    options = &DEFAULT_LOAD_OPTIONS;
+  }
+  CustomerLoad load;
+  load.customers = customers;
+  load.lineCount = 0;
+  char sourceFileName[260];
+  resolveDatabaseFile(fileName, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* reader = openAsyncReader(sourceFileName);
+  if (reader == NULL) {
+    logGeneric("Failed to open customers database.");
+    return -1;
+  }
+  // Lines are read as binary, so their offsets are byte offsets that lazy loads can seek to later.
+  // Lines of a compressed file cannot be read back that way, so all its fields are loaded at once.
+  load.isLazy = options->lazy != NULL && options->existingCount == 0 && !isAsyncReaderCompressed(reader);
+  // A trusted file whose checksum does not match is validated field by field instead
+  load.isTrusted = (options->trustedFiles & TRUSTED_CUSTOMERS) && verifyFileChecksum(sourceFileName);
+  if (!initDuplicateTracker(&load.duplicates, "Customer", fileName, CUSTOMERS_LIMIT, options)) {
+    closeAsyncReader(reader);
+    return -1;
+  }
+  // Records already loaded count as seen, so appended lines cannot repeat their IDs
+  for (load.customerCount = 0; load.customerCount < options->existingCount; load.customerCount++) {
+    setIdIndex(&load.duplicates.seen, customers[load.customerCount].customerID, load.customerCount);
+  }
+  openQuarantine(&load.quarantine, fileName, options->isQuarantining);
+  if (load.isLazy) {
+    setLazySource(&options->lazy->customers, sourceFileName);
   }
-  fclose(file);
+  LinePipeline pipeline = { reader, 1024, NUMBER_OF_CUSTOMER_FIELDS, checkCustomerLine, buildCustomerLine, &load };
+  runLinePipeline(&pipeline);
+  closeAsyncReader(reader);
+  int customerCount = finishDuplicateTracker(&load.duplicates, customers, sizeof(Customer), load.customerCount);
+  reportQuarantine(&load.quarantine, "customers");
+  if (options->paymentZones != NULL) {
+    buildPaymentZoneMap(options->paymentZones, customers, customerCount);
+  }
+  METRIC_LINES(METRIC_SOURCE_CUSTOMERS, load.lineCount, customerCount - options->existingCount);
   return customerCount;
 }
+// FUNCTION : parseCustomerKeyFields
+// DESCRIPTION :
+//    Fills the ID, numeric and date fields of a Customer structure from validated fields.
+// PARAMETERS :
+//    Customer* customer: The customer to fill.
+//    char* const* fields: Array of strings containing customer data.
+// RETURNS :
+//    void
+static void parseCustomerKeyFields(Customer* customer, char* const* fields) {
+  sscanf_s(fields[7], "%d", &customer->customerID);
+  sscanf_s(fields[8], "%f", &customer->customerCreditLimit);
+  sscanf_s(fields[9], "%f", &customer->currentAccountBalance);
+  strcpy_s(customer->lastPaymentMade, sizeof(customer->lastPaymentMade), fields[10]);
+  strcpy_s(customer->customerJoinDate, sizeof(customer->customerJoinDate), fields[11]);
+  customer->lastPaymentDay = dateToDayNumber(customer->lastPaymentMade);
+  customer->customerJoinDay = dateToDayNumber(customer->customerJoinDate);
+}
+// FUNCTION : parseCustomerTextFields
+// DESCRIPTION :
+//    Fills the text fields of a Customer structure from validated fields and marks them loaded.
+// PARAMETERS :
+//    Customer* customer: The customer to fill.
+//    char* const* fields: Array of strings containing customer data.
+// RETURNS :
+//    void
+void parseCustomerTextFields(Customer* customer, char* const* fields) {
+  strcpy_s(customer->customerName, sizeof(customer->customerName), fields[0]);
+  strcpy_s(customer->customerAddress, sizeof(customer->customerAddress), fields[1]);
+  strcpy_s(customer->customerCity, sizeof(customer->customerCity), fields[2]);
+  strcpy_s(customer->customerProvince, sizeof(customer->customerProvince), fields[3]);
+  strcpy_s(customer->customerPostalCode, sizeof(customer->customerPostalCode), fields[4]);
+  strcpy_s(customer->customerPhone, sizeof(customer->customerPhone), fields[5]);
+  strcpy_s(customer->customerEmail, sizeof(customer->customerEmail), fields[6]);
+  customer->fieldState = FIELDS_LOADED;
+}
 // FUNCTION : parseFieldsToCustomer
 // DESCRIPTION :
 //    Converts an array of strings (fields) into a Customer structure.
 //    Assumes that the fields are in the correct order and format as defined in the Customer structure.
 //    Assumes that the fields are validated.
 // PARAMETERS :
-//    const char** fields: Array of strings containing customer data.
+//    char* const* fields: Array of strings containing customer data.
 // RETURNS :
 //    Customer : An instance of a Customer struct populated with the data from the fields.
-Customer parseFieldsToCustomer(const char** fields) {
+Customer parseFieldsToCustomer(char* const* fields) {
+  METRIC_TIMER_START(parseTimer);
+  Customer newCustomer;
+  parseCustomerTextFields(&newCustomer, fields);
+  parseCustomerKeyFields(&newCustomer, fields);
+  newCustomer.lineOffset = -1;
+  METRIC_TIMER_STOP(STAGE_PARSE, parseTimer);
+  return newCustomer;
+}
+// FUNCTION : parseKeyFieldsToCustomer
+// DESCRIPTION :
+//    Converts the ID, numeric and date fields into a Customer structure for a lazy load. The text
+//    fields are left empty until materializeCustomer reads them back from the line at lineOffset.
+// PARAMETERS :
+//    char* const* fields: Array of strings containing customer data, with the key fields validated.
+//    long long lineOffset: Byte offset of the customer's line in the database.
+// RETURNS :
+//    Customer : The customer, with its text fields pending.
+Customer parseKeyFieldsToCustomer(char* const* fields, long long lineOffset) {
+  METRIC_TIMER_START(parseTimer);
   Customer newCustomer;
-  strcpy_s(newCustomer.customerName, sizeof(newCustomer.customerName), fields[0]);
-  strcpy_s(newCustomer.customerAddress, sizeof(newCustomer.customerAddress), fields[1]);
-  strcpy_s(newCustomer.customerCity, sizeof(newCustomer.customerCity), fields[2]);
-  strcpy_s(newCustomer.customerProvince, sizeof(newCustomer.customerProvince), fields[3]);
-  strcpy_s(newCustomer.customerPostalCode, sizeof(newCustomer.customerPostalCode), fields[4]);
-  strcpy_s(newCustomer.customerPhone, sizeof(newCustomer.customerPhone), fields[5]);
-  strcpy_s(newCustomer.customerEmail, sizeof(newCustomer.customerEmail), fields[6]);
-  sscanf_s(fields[7], "%d", &newCustomer.customerID);
-  sscanf_s(fields[8], "%f", &newCustomer.customerCreditLimit);
-  sscanf_s(fields[9], "%f", &newCustomer.currentAccountBalance);
-  strcpy_s(newCustomer.lastPaymentMade, sizeof(newCustomer.lastPaymentMade), fields[10]);
-  strcpy_s(newCustomer.customerJoinDate, sizeof(newCustomer.customerJoinDate), fields[11]);
+  memset(&newCustomer, 0, sizeof(Customer));
+  parseCustomerKeyFields(&newCustomer, fields);
+  newCustomer.fieldState = FIELDS_PENDING;
+  newCustomer.lineOffset = lineOffset;
+  METRIC_TIMER_STOP(STAGE_PARSE, parseTimer);
   return newCustomer;
 }
+// FUNCTION : checkPartLine
+// DESCRIPTION :
+//    Check stage of a parts load: checks the field count and the fields of a line, without logging.
+// PARAMETERS :
+//    char** fields: The fields of the line.
+//    int fieldCount: The number of fields split from the line.
+//    void* context: The PartLoad.
+// RETURNS :
+//    int : The LINE_* state of the line.
+static int checkPartLine(char** fields, int fieldCount, void* context) {
+  const PartLoad* load = (const PartLoad*)context;
+  if (fieldCount != NUMBER_OF_PART_FIELDS) {
+    return LINE_FIELD_COUNT_INVALID;
+  }
+  if (load->isTrusted) {
+    return isPartParseSafe(fields, load->isLazy) ? LINE_VALID : LINE_INVALID;
+  }
+  METRIC_TIMER_START(validateTimer);
+  int isValid = isPartValid(fields, load->isLazy);
+  METRIC_TIMER_STOP(STAGE_VALIDATE, validateTimer);
+  return isValid ? LINE_VALID : LINE_INVALID;
+}
+// FUNCTION : buildPartLine
+// DESCRIPTION :
+//    Build stage of a parts load: reports and quarantines a rejected line, or stores its part,
+//    resolving a duplicate ID by the load's policy.
+// PARAMETERS :
+//    const LineSpan* line: The line and the outcome of its checks.
+//    const char* rawLine: The line as read, for the quarantine.
+//    char** fields: The fields of the line.
+//    void* context: The PartLoad.
+// RETURNS :
+//    int : 1 to carry on, 0 when the part limit is reached.
+static int buildPartLine(const LineSpan* line, const char* rawLine, char** fields, void* context) {
+  PartLoad* load = (PartLoad*)context;
+  int lineNumber = line->lineNumber; // For error reporting
+  char reason[1024];
+  char errorMessage[256];
+  load->lineCount = lineNumber;
+  // Check if over limit 
+  if (load->partCount >= PARTS_LIMIT) {
+    logGeneric("Part limit reached when loading from database, cannot load more parts.");
+    return 0;
+  }
+  switch (line->state) {
+    case LINE_TOO_LONG:
+      snprintf(errorMessage, sizeof(errorMessage), "In parts database line %d: Line is too long.", lineNumber);
+      logGeneric(errorMessage);
+      quarantineLine(&load->quarantine, rawLine, lineNumber, "Line is too long.");
+      return 1;
+    case LINE_FIELD_COUNT_INVALID:
+      snprintf(errorMessage, sizeof(errorMessage), "In parts database line %d: Incorrect number of fields (%d expected, found %d)", 
+        lineNumber, NUMBER_OF_PART_FIELDS, line->fieldCount);
+      logGeneric(errorMessage);
+      snprintf(reason, sizeof(reason), "Incorrect number of fields (%d expected, found %d)", NUMBER_OF_PART_FIELDS, line->fieldCount);
+      quarantineLine(&load->quarantine, rawLine, lineNumber, reason);
+      return 1;
+    case LINE_INVALID:
+      // Validate again to log the errors
+      if (load->isLazy) {
+        validatePartKeyFields(fields, lineNumber, reason, sizeof(reason));
+      }
+      else {
+        validatePartFields(fields, lineNumber, reason, sizeof(reason));
+      }
+      quarantineLine(&load->quarantine, rawLine, lineNumber, reason);
+      return 1;
+  }
+  // Fields should be all valid at this point
+  Part newPart = load->isLazy ? parseKeyFieldsToPart(fields, line->fileOffset) : parseFieldsToPart(fields);
+  int position = resolveDuplicate(&load->duplicates, newPart.partID, load->partCount, lineNumber);
+  if (position == -1) {
+    quarantineLine(&load->quarantine, rawLine, lineNumber, "Duplicate part ID.");
+    return 1;
+  }
+  load->parts[position] = newPart;
+  if (position == load->partCount) {
+    load->partCount++;
+  }
+  return 1;
+}
 // FUNCTION : loadParts
 // DESCRIPTION :
 //    Reads part data from a file and populates the parts array.
 //    Includes error handling for file operations and calling data validation functions.
+//    The lines go through the load pipeline (see LinePipeline.c).
 // PARAMETERS :
 //    Part* parts: Pointer to an array of Part structures to be filled.
 //    const char* fileName: Name of the file to read part data from.
+//    const LoadOptions* options: Duplicate handling options, or NULL for the defaults.
 // RETURNS :
-//    int : The number of parts successfully loaded.
-int loadParts(Part* parts, const char* fileName) {
-  int partCount = 0;
-  int lineNumber = 0; // For error reporting
-  FILE* file = NULL;
-  errno_t err = fopen_s(&file, fileName, "r");
-  if (err != 0 || file == NULL) {
-    partCount = 0;
+//    int : The number of parts successfully loaded, or -1 if the file could not be opened or memory
+//          could not be allocated. The parts array is left as it was in that case.
+int loadParts(Part* parts, const char* fileName, const LoadOptions* options) {
+  if (options == NULL) {
+    options = &DEFAULT_LOAD_OPTIONS;
+  }
+  PartLoad load;
+  load.parts = parts;
+  load.lineCount = 0;
+  char sourceFileName[260];
+  resolveDatabaseFile(fileName, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* reader = openAsyncReader(sourceFileName);
+  if (reader == NULL) {
     logGeneric("Failed to open parts database.");
-    return 0;
+    return -1;
   }
-  char line[1024];
-  char errorMessage[256];
-  partCount = 0;
-  // Read each line from the file
-  while (fgets(line, sizeof(line), file) != NULL) {
-    // Skip empty lines
-    if (line[0] == '\n' || line[0] == '\r') {
-      continue; // Read next line
-    }
-    lineNumber++;
-    // Check if over limit 
-    if (partCount >= PARTS_LIMIT) {
-      logGeneric("Part limit reached when loading from database, cannot load more parts.");
-      break;
-    }
-    // Check if line is too long
-    if (strlen(line) == sizeof(line) - 1) {
-      snprintf(errorMessage, sizeof(errorMessage), "In parts database line %d: Line is too long.", lineNumber);
-      logGeneric(errorMessage);
-      // Discard rest of the line
-      while (1) {
-        char extra = fgetc(file);
-        if (extra == '\n' || extra == EOF) {
-          break;
-        }
-      }
-      continue; // Read next line
-    }
-    // Split line into fields
-    char* fields[NUMBER_OF_PART_FIELDS];
-    int fieldCount = splitLine(line, fields, NUMBER_OF_PART_FIELDS, '|');
-    if (fieldCount != NUMBER_OF_PART_FIELDS) {
-      snprintf(errorMessage, sizeof(errorMessage), "In parts database line %d: Incorrect number of fields (%d expected, found %d)", 
-        lineNumber, NUMBER_OF_PART_FIELDS, fieldCount);
-      logGeneric(errorMessage);
-      continue; // Read next line
-    }
-    if (!validatePartFields(fields, lineNumber)) {
-      // No need to log here since validate already did
-      continue;
-    }
-    // Fields should be all valid at this point
-    parts[partCount] = parseFieldsToPart(fields);
-    partCount++;
+  // Lines are read as binary, so their offsets are byte offsets that lazy loads can seek to later.
+  // Lines of a compressed file cannot be read back that way, so all its fields are loaded at once.
+  load.isLazy = options->lazy != NULL && options->existingCount == 0 && !isAsyncReaderCompressed(reader);
+  // A trusted file whose checksum does not match is validated field by field instead
+  load.isTrusted = (options->trustedFiles & TRUSTED_PARTS) && verifyFileChecksum(sourceFileName);
+  if (!initDuplicateTracker(&load.duplicates, "Part", fileName, PARTS_LIMIT, options)) {
+    closeAsyncReader(reader);
+    return -1;
   }
-
-  fclose(file);
+  // Records already loaded count as seen, so appended lines cannot repeat their IDs
+  for (load.partCount = 0; load.partCount < options->existingCount; load.partCount++) {
+    setIdIndex(&load.duplicates.seen, parts[load.partCount].partID, load.partCount);
+  }
+  openQuarantine(&load.quarantine, fileName, options->isQuarantining);
+  if (load.isLazy) {
+    setLazySource(&options->lazy->parts, sourceFileName);
+  }
+  LinePipeline pipeline = { reader, 1024, NUMBER_OF_PART_FIELDS, checkPartLine, buildPartLine, &load };
+  runLinePipeline(&pipeline);
+  closeAsyncReader(reader);
+  int partCount = finishDuplicateTracker(&load.duplicates, parts, sizeof(Part), load.partCount);
+  reportQuarantine(&load.quarantine, "parts");
+  METRIC_LINES(METRIC_SOURCE_PARTS, load.lineCount, partCount - options->existingCount);
   return partCount;
 }
+// FUNCTION : parsePartKeyFields
+// DESCRIPTION :
+//    Fills every field of a Part structure except the name and number from validated fields.
+// PARAMETERS :
+//    Part* part: The part to fill.
+//    char* const* fields: Array of strings containing part data.
+// RETURNS :
+//    void
+static void parsePartKeyFields(Part* part, char* const* fields) {
+  strcpy_s(part->partLocation, sizeof(part->partLocation), fields[2]);
+  sscanf_s(fields[3], "%f", &part->partCost);
+  sscanf_s(fields[4], "%d", &part->quantityOnHand);
+  sscanf_s(fields[5], "%d", &part->partStatus);
+  sscanf_s(fields[6], "%d", &part->partID);
+  part->partLocationCode = packPartLocation(part->partLocation);
+}
+// FUNCTION : parsePartTextFields
+// DESCRIPTION :
+//    Fills the name and number of a Part structure from validated fields and marks them loaded.
+// PARAMETERS :
+//    Part* part: The part to fill.
+//    char* const* fields: Array of strings containing part data.
+// RETURNS :
+//    void
+void parsePartTextFields(Part* part, char* const* fields) {
+  strcpy_s(part->partName, sizeof(part->partName), fields[0]);
+  strcpy_s(part->partNumber, sizeof(part->partNumber), fields[1]);
+  part->fieldState = FIELDS_LOADED;
+}
 // FUNCTION : parseFieldsToPart
 // DESCRIPTION :
 //    Converts an array of strings (fields) into a Part structure.
 //    Assumes that the fields are in the correct order and format as defined in the Part structure.
 //    Assumes that the fields are validated.
 // PARAMETERS :
-//    const char** fields: Array of strings containing part data.
+//    char* const* fields: Array of strings containing part data.
 // RETURNS :
 //    Part : An instance of a Part struct populated with the data from the fields.
-Part parseFieldsToPart(const char** fields) {
+Part parseFieldsToPart(char* const* fields) {
+  METRIC_TIMER_START(parseTimer);
+  Part newPart;
+  parsePartTextFields(&newPart, fields);
+  parsePartKeyFields(&newPart, fields);
+  newPart.lineOffset = -1;
+  METRIC_TIMER_STOP(STAGE_PARSE, parseTimer);
+  return newPart;
+}
+// FUNCTION : parseKeyFieldsToPart
+// DESCRIPTION :
+//    Converts every field except the name and number into a Part structure for a lazy load. The
+//    name and number are left empty until materializePart reads them back from the line at lineOffset.
+// PARAMETERS :
+//    char* const* fields: Array of strings containing part data, with the key fields validated.
+//    long long lineOffset: Byte offset of the part's line in the database.
+// RETURNS :
+//    Part : The part, with its name and number pending.
+Part parseKeyFieldsToPart(char* const* fields, long long lineOffset) {
+  METRIC_TIMER_START(parseTimer);
   Part newPart;
-  strcpy_s(newPart.partName, sizeof(newPart.partName), fields[0]);
-  strcpy_s(newPart.partNumber, sizeof(newPart.partNumber), fields[1]);
-  strcpy_s(newPart.partLocation, sizeof(newPart.partLocation), fields[2]);
-  sscanf_s(fields[3], "%f", &newPart.partCost);
-  sscanf_s(fields[4], "%d", &newPart.quantityOnHand);
-  sscanf_s(fields[5], "%d", &newPart.partStatus);
-  sscanf_s(fields[6], "%d", &newPart.partID);
+  memset(&newPart, 0, sizeof(Part));
+  parsePartKeyFields(&newPart, fields);
+  newPart.fieldState = FIELDS_PENDING;
+  newPart.lineOffset = lineOffset;
+  METRIC_TIMER_STOP(STAGE_PARSE, parseTimer);
   return newPart;
 }
 // FUNCTION : loadOrders
@@ -199,85 +596,308 @@ Part parseFieldsToPart(const char** fields) {
 //    It uses the parts and customers arrays to validate their IDs in the order.
 //    Includes error handling for file operations and calling data validation functions.
 // PARAMETERS :
-//    Order* orders: Pointer to an array of Order structures to be filled.
+//    Order* orders: Pointer to an array of Order structures to be filled, of options->orderCapacity orders.
 //    const Part* parts: Pointer to an array of Part structures for validation.
 //    int partCount: Number of parts in the parts array.
 //    const Customer* customers: Pointer to an array of Customer structures for validation.
 //    int customerCount: Number of customers in the customers array.
 //    const char* fileName: Name of the file to read order data from.
+//    const LoadOptions* options: Duplicate handling, rollup and index options, or NULL for the defaults.
 // RETURNS :
 //    int : The number of orders successfully loaded.
-int loadOrders(Order* orders, const Part* parts, int partCount, const Customer* customers, int customerCount, const char* fileName) {
-  int orderCount = 0;
-  int lineNumber = 0; // For error reporting
-  FILE* file = NULL;
-  errno_t err = fopen_s(&file, fileName, "r");
-  if (err != 0 || file == NULL) {
-    orderCount = 0;
+int loadOrders(Order* orders, const Part* parts, int partCount, const Customer* customers, int customerCount, const char* fileName,
+  const LoadOptions* options) {
+  if (options == NULL) {
+    options = &DEFAULT_LOAD_OPTIONS;
+  }
+  StagedOrders staged;
+  if (!readOrderLines(&staged, fileName, options)) {
+    return options->existingCount;
+  }
+  int orderCount = loadStagedOrders(orders, &staged, parts, partCount, customers, customerCount, fileName, options);
+  freeStagedOrders(&staged);
+  return orderCount;
+}
+// FUNCTION : checkOrderLine
+// DESCRIPTION :
+//    Check stage of reading the orders: checks the field count and the format of a line, without logging.
+// PARAMETERS :
+//    char** fields: The fields of the line.
+//    int fieldCount: The number of fields split from the line.
+//    void* context: The StagedOrders.
+// RETURNS :
+//    int : The LINE_* state of the line.
+static int checkOrderLine(char** fields, int fieldCount, void* context) {
+  const StagedOrders* staged = (const StagedOrders*)context;
+  // Check if the number of fields is valid
+  if (fieldCount < NUMBER_OF_ORDER_FIELDS + 2 || fieldCount % 2 == 0) {
+    return LINE_FIELD_COUNT_INVALID;
+  }
+  if (staged->isTrusted) {
+    return isOrderParseSafe(fields, fieldCount) ? LINE_VALID : LINE_INVALID;
+  }
+  METRIC_TIMER_START(validateTimer);
+  int isValid = isOrderFormatValid(fields, fieldCount);
+  METRIC_TIMER_STOP(STAGE_VALIDATE, validateTimer);
+  return isValid ? LINE_VALID : LINE_INVALID;
+}
+// FUNCTION : stageOrderLine
+// DESCRIPTION :
+//    Build stage of reading the orders: adds a line and the outcome of its checks to the staged
+//    order lines, growing the buffers as needed.
+// PARAMETERS :
+//    const LineSpan* line: The line and the outcome of its checks.
+//    const char* rawLine: The line as read.
+//    char** fields: The fields of the line (unused, they are split again once the references can be checked).
+//    void* context: The StagedOrders.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int stageOrderLine(const LineSpan* line, const char* rawLine, char** fields, void* context) {
+  StagedOrders* staged = (StagedOrders*)context;
+  (void)fields;
+  staged->lineCount = line->lineNumber;
+  size_t length = strlen(rawLine) + 1;
+  if (staged->textSize + length > staged->textCapacity) {
+    size_t newCapacity = staged->textCapacity * 2 > staged->textSize + length ? staged->textCapacity * 2 : staged->textSize + length;
+    char* newText = (char*)realloc(staged->text, newCapacity);
+    if (newText == NULL) {
+      logGeneric("Failed to allocate memory for reading the orders database.");
+      return 0;
+    }
+    staged->text = newText;
+    staged->textCapacity = newCapacity;
+  }
+  if (staged->count == staged->capacity) {
+    int newCapacity = staged->capacity * 2;
+    size_t* newLineStarts = (size_t*)realloc(staged->lineStarts, newCapacity * sizeof(size_t));
+    if (newLineStarts != NULL) {
+      staged->lineStarts = newLineStarts;
+    }
+    int* newLineNumbers = (int*)realloc(staged->lineNumbers, newCapacity * sizeof(int));
+    if (newLineNumbers != NULL) {
+      staged->lineNumbers = newLineNumbers;
+    }
+    unsigned char* newStates = (unsigned char*)realloc(staged->states, newCapacity);
+    if (newStates != NULL) {
+      staged->states = newStates;
+    }
+    if (newLineStarts == NULL || newLineNumbers == NULL || newStates == NULL) {
+      logGeneric("Failed to allocate memory for reading the orders database.");
+      return 0;
+    }
+    staged->capacity = newCapacity;
+  }
+  memcpy(staged->text + staged->textSize, rawLine, length);
+  staged->lineStarts[staged->count] = staged->textSize;
+  staged->lineNumbers[staged->count] = line->lineNumber;
+  staged->states[staged->count] = (unsigned char)line->state;
+  staged->textSize += length;
+  staged->count++;
+  return 1;
+}
+// FUNCTION : readOrderLines
+// DESCRIPTION :
+//    First half of loading orders, which needs neither the customers nor the parts, so it can run
+//    while they load: reads the orders file through the load pipeline, which splits each line and
+//    checks its field count and format, and stages the lines with the outcome for
+//    loadStagedOrders. Nothing is logged or quarantined yet.
+// PARAMETERS :
+//    StagedOrders* staged: Receives the staged order lines. Free with freeStagedOrders.
+//    const char* fileName: Name of the file to read order data from.
+//    const LoadOptions* options: The load options, or NULL for the defaults.
+// RETURNS :
+//    int : 1 on success, 0 if the file could not be opened or memory could not be allocated.
+int readOrderLines(StagedOrders* staged, const char* fileName, const LoadOptions* options) {
+  memset(staged, 0, sizeof(StagedOrders));
+  if (options == NULL) {
+    options = &DEFAULT_LOAD_OPTIONS;
+  }
+  char sourceFileName[260];
+  resolveDatabaseFile(fileName, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* reader = openAsyncReader(sourceFileName);
+  if (reader == NULL) {
     logGeneric("Failed to open orders database.");
     return 0;
   }
+  staged->capacity = STAGED_ORDERS_INITIAL_LINES;
+  staged->textCapacity = STAGED_ORDERS_INITIAL_LINES * 64;
+  staged->text = (char*)malloc(staged->textCapacity);
+  staged->lineStarts = (size_t*)malloc(staged->capacity * sizeof(size_t));
+  staged->lineNumbers = (int*)malloc(staged->capacity * sizeof(int));
+  staged->states = (unsigned char*)malloc(staged->capacity);
+  if (staged->text == NULL || staged->lineStarts == NULL || staged->lineNumbers == NULL || staged->states == NULL) {
+    logGeneric("Failed to allocate memory for reading the orders database.");
+    freeStagedOrders(staged);
+    closeAsyncReader(reader);
+    return 0;
+  }
+  // A trusted file whose checksum does not match is validated field by field instead
+  staged->isTrusted = (options->trustedFiles & TRUSTED_ORDERS) && verifyFileChecksum(sourceFileName);
+  LinePipeline pipeline = { reader, 2048, NUMBER_OF_ORDER_FIELDS + PARTS_LIMIT * 2, checkOrderLine, stageOrderLine, staged };
+  runLinePipeline(&pipeline);
+  closeAsyncReader(reader);
+  return 1;
+}
+// FUNCTION : loadStagedOrders
+// DESCRIPTION :
+//    Second half of loading orders: reports the lines rejected while staging, checks the others
+//    against the customers and parts, resolves duplicate IDs and fills the orders array, the
+//    rollups and the order indexes.
+// PARAMETERS :
+//    Order* orders: Pointer to an array of Order structures to be filled, of options->orderCapacity orders.
+//    StagedOrders* staged: The order lines from readOrderLines.
+//    const Part* parts: Pointer to an array of Part structures for validation.
+//    int partCount: Number of parts in the parts array.
+//    const Customer* customers: Pointer to an array of Customer structures for validation.
+//    int customerCount: Number of customers in the customers array.
+//    const char* fileName: Name of the file the lines were read from.
+//    const LoadOptions* options: Duplicate handling, rollup and index options, or NULL for the defaults.
+// RETURNS :
+//    int : The number of orders successfully loaded.
+int loadStagedOrders(Order* orders, StagedOrders* staged, const Part* parts, int partCount, const Customer* customers, int customerCount,
+  const char* fileName, const LoadOptions* options) {
+  int orderCount = 0;
+  if (options == NULL) {
+    options = &DEFAULT_LOAD_OPTIONS;
+  }
+  int orderCapacity = options->orderCapacity > 0 ? options->orderCapacity : ORDERS_LIMIT;
+  DuplicateTracker duplicates;
+  if (!initDuplicateTracker(&duplicates, "Order", fileName, orderCapacity, options)) {
+    return options->existingCount;
+  }
+  // Records already loaded count as seen, so appended lines cannot repeat their IDs
+  for (orderCount = 0; orderCount < options->existingCount; orderCount++) {
+    setIdIndex(&duplicates.seen, orders[orderCount].orderID, orderCount);
+  }
+  QuarantineWriter quarantine;
+  openQuarantine(&quarantine, fileName, options->isQuarantining);
+  // Rollups and ID sequences start over unless orders are appended to the ones already loaded
+  if (options->rollups != NULL && options->existingCount == 0) {
+    clearCustomerRollups(options->rollups);
+  }
+  if (options->orderIds != NULL && options->existingCount == 0) {
+    resetOrderIdAllocator(options->orderIds);
+  }
+  if (options->rankings != NULL && options->existingCount == 0) {
+    clearOrderRankings(options->rankings);
+  }
   char errorMessage[256];
   char line[2048];
-  // Read each line from the file
-  while (fgets(line, sizeof(line), file) != NULL) {
-    // Skip empty lines
-    if (line[0] == '\n' || line[0] == '\r') {
-      continue; // Read next line
-    }
-    lineNumber++;
+  char reason[4096];
+  for (int i = 0; i < staged->count; i++) {
+    const char* rawLine = staged->text + staged->lineStarts[i]; // Kept unsplit for the quarantine
+    int lineNumber = staged->lineNumbers[i];
     // Check if over limit 
-    if (orderCount >= ORDERS_LIMIT) {
-      logGeneric("Order limit reached when loading from database, cannot load more orders.");
+    if (orderCount >= orderCapacity) {
+      snprintf(errorMessage, sizeof(errorMessage),
+        "Order limit of %d reached when loading %s, cannot load more orders: lines %d to %d were not loaded.",
+        orderCapacity, fileName, lineNumber, staged->lineNumbers[staged->count - 1]);
+      logGeneric(errorMessage);
       break;
     }
-    // Check if line is too long
-    if (strlen(line) == sizeof(line) - 1) {
+    if (staged->states[i] == LINE_TOO_LONG) {
       snprintf(errorMessage, sizeof(errorMessage), "In orders database line %d: Line is too long.", lineNumber);
       logGeneric(errorMessage);
-      // Discard rest of the line
-      while (1) {
-        char extra = fgetc(file);
-        if (extra == '\n' || extra == EOF) {
-          break;
-        }
-      }
+      quarantineLine(&quarantine, rawLine, lineNumber, "Line is too long.");
       continue; // Read next line
     }
-    // Split line into fields
-    char* fields[NUMBER_OF_ORDER_FIELDS + PARTS_LIMIT * 2];
-    int fieldCount = splitLine(line, fields, NUMBER_OF_ORDER_FIELDS + PARTS_LIMIT * 2, '|');
-    
-    // Check if the number of fields is valid
-    if (fieldCount < NUMBER_OF_ORDER_FIELDS + 2 || fieldCount % 2 == 0) { 
+    if (staged->states[i] == LINE_FIELD_COUNT_INVALID) {
       logGeneric("Incorrect number of fields in orders database.");
       logGeneric("Each order must have at least 9 fields and an odd number of fields to be valid.");
+      quarantineLine(&quarantine, rawLine, lineNumber, "Incorrect number of fields (at least 9 and an odd number expected)");
       continue; // Read next line
     }
-    if (!validateOrderFields(fields, fieldCount, lineNumber, parts, partCount, customers, customerCount)) {
+    strcpy_s(line, sizeof(line), rawLine);
+    char* fields[NUMBER_OF_ORDER_FIELDS + PARTS_LIMIT * 2];
+    int fieldCount = splitLine(line, fields, NUMBER_OF_ORDER_FIELDS + PARTS_LIMIT * 2, '|');
+    METRIC_TIMER_START(validateTimer);
+    // The format was checked while staging; lines that failed are validated in full so all their errors are reported together
+    int isValid = staged->states[i] == LINE_VALID
+      ? validateOrderReferences(fields, fieldCount, lineNumber, parts, partCount, customers, customerCount, reason, sizeof(reason))
+      : validateOrderFields(fields, fieldCount, lineNumber, parts, partCount, customers, customerCount, reason, sizeof(reason));
+    METRIC_TIMER_STOP(STAGE_VALIDATE, validateTimer);
+    if (!isValid) {
       // No need to log here since validate already did
+      quarantineLine(&quarantine, rawLine, lineNumber, reason);
       continue;
     }
     // Fields should be all valid at this point
-    orders[orderCount] = parseFieldsToOrder(fields);
-    orderCount++;
+    Order newOrder = parseFieldsToOrder(fields);
+    if (options->orderIds != NULL) {
+      noteOrderID(options->orderIds, &newOrder); // Even a rejected duplicate keeps its ID from being reused
+    }
+    int position = resolveDuplicate(&duplicates, newOrder.orderID, orderCount, lineNumber);
+    if (position == -1) {
+      quarantineLine(&quarantine, rawLine, lineNumber, "Duplicate order ID.");
+      continue;
+    }
+    if (options->rollups != NULL) {
+      if (position != orderCount) {
+        rollupRemoveOrder(options->rollups, &orders[position]); // Replaced under DUPLICATE_KEEP_LAST
+      }
+      rollupAddOrder(options->rollups, &newOrder);
+    }
+    if (options->rankings != NULL) {
+      if (position != orderCount) {
+        rankingsRemoveOrder(options->rankings, &orders[position]);
+      }
+      rankingsAddOrder(options->rankings, &newOrder);
+    }
+    orders[position] = newOrder;
+    if (position == orderCount) {
+      orderCount++;
+    }
   }
-  
+
+  for (int i = 0; i < orderCount && duplicates.rejectedCount > 0; i++) {
+    if (duplicates.isRejected[i] && options->rollups != NULL) {
+      rollupRemoveOrder(options->rollups, &orders[i]);
+    }
+    if (duplicates.isRejected[i] && options->rankings != NULL) {
+      rankingsRemoveOrder(options->rankings, &orders[i]);
+    }
+  }
+  orderCount = finishDuplicateTracker(&duplicates, orders, sizeof(Order), orderCount);
+  reportQuarantine(&quarantine, "orders");
+  if (options->orderDates != NULL) {
+    buildOrderDateIndex(options->orderDates, orders, orderCount);
+  }
+  METRIC_LINES(METRIC_SOURCE_ORDERS, staged->lineCount, orderCount - options->existingCount);
   return orderCount;
 }
+// FUNCTION : freeStagedOrders
+// DESCRIPTION :
+//    Frees the staged order lines.
+// PARAMETERS :
+//    StagedOrders* staged: The staged order lines to free.
+// RETURNS :
+//    void
+void freeStagedOrders(StagedOrders* staged) {
+  free(staged->text);
+  free(staged->lineStarts);
+  free(staged->lineNumbers);
+  free(staged->states);
+  staged->text = NULL;
+  staged->lineStarts = NULL;
+  staged->lineNumbers = NULL;
+  staged->states = NULL;
+  staged->count = 0;
+}
 // FUNCTION : parseFieldsToOrder
 // DESCRIPTION :
 //    Converts an array of strings (fields) into an Order structure.
 //    Assumes that the fields are in the correct order and format as defined in the Order structure.
 //    Assumes that the fields are validated.
 // PARAMETERS :
-//    const char** fields: Array of strings containing order data.
+//    char* const* fields: Array of strings containing order data.
 // RETURNS :
 //    Order : An instance of an Order struct populated with the data from the fields.
-Order parseFieldsToOrder(const char** fields) {
+Order parseFieldsToOrder(char* const* fields) {
+  METRIC_TIMER_START(parseTimer);
   Order newOrder;
   sscanf_s(fields[0], "%lld", &newOrder.orderID);
   strcpy_s(newOrder.orderDate, sizeof(newOrder.orderDate), fields[1]);
+  newOrder.orderDay = dateToDayNumber(newOrder.orderDate);
   sscanf_s(fields[2], "%d", &newOrder.orderStatus);
   sscanf_s(fields[3], "%d", &newOrder.customerID);
   sscanf_s(fields[4], "%f", &newOrder.orderTotal);
@@ -289,6 +909,7 @@ Order parseFieldsToOrder(const char** fields) {
     sscanf_s(fields[8 + i * 2], "%d", &newOrder.orderedParts[i].quantityOrdered);
   }
   
+  METRIC_TIMER_STOP(STAGE_PARSE, parseTimer);
   return newOrder;
 }
 // FUNCTION : splitLine
@@ -306,6 +927,7 @@ Order parseFieldsToOrder(const char** fields) {
 // RETURNS :
 //    int : The number of fields successfully split from the line. Returns -1 if fieldLimit is exceeded.
 int splitLine(char* line, char** fields, int fieldLimit, char delimiter) {
+  METRIC_TIMER_START(splitTimer);
   int fieldCount = 0;
   char* tokenStartPointer = line;
   char *cursor = line;
@@ -318,6 +940,7 @@ int splitLine(char* line, char** fields, int fieldLimit, char delimiter) {
       cursor++;               
       tokenStartPointer = cursor;
       if (fieldCount > fieldLimit) {
+        METRIC_TIMER_STOP(STAGE_SPLIT_LINE, splitTimer);
         return -1;
       }
     }
@@ -325,5 +948,44 @@ int splitLine(char* line, char** fields, int fieldLimit, char delimiter) {
       cursor++;
     }
   }
+  METRIC_TIMER_STOP(STAGE_SPLIT_LINE, splitTimer);
   return fieldCount;
+}
+// FUNCTION : initDuplicateReport
+// DESCRIPTION :
+//    Creates an empty duplicate report able to hold up to capacity duplicates.
+// PARAMETERS :
+//    DuplicateReport* report: The report to initialize.
+//    int capacity: The maximum number of duplicates recorded.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initDuplicateReport(DuplicateReport* report, int capacity) {
+  report->sourceTypes = (const char**)malloc(capacity * sizeof(const char*));
+  report->ids = (long long*)malloc(capacity * sizeof(long long));
+  report->lineNumbers = (int*)malloc(capacity * sizeof(int));
+  report->count = 0;
+  report->capacity = capacity;
+  if (report->sourceTypes == NULL || report->ids == NULL || report->lineNumbers == NULL) {
+    logGeneric("Failed to allocate memory for duplicate report.");
+    freeDuplicateReport(report);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : freeDuplicateReport
+// DESCRIPTION :
+//    Frees the memory held by a duplicate report.
+// PARAMETERS :
+//    DuplicateReport* report: The report to free.
+// RETURNS :
+//    void
+void freeDuplicateReport(DuplicateReport* report) {
+  free(report->sourceTypes);
+  free(report->ids);
+  free(report->lineNumbers);
+  report->sourceTypes = NULL;
+  report->ids = NULL;
+  report->lineNumbers = NULL;
+  report->count = 0;
+  report->capacity = 0;
 }
\ No newline at end of file
@@ -6,16 +6,85 @@
 #include "Customer.h"
 #include "Part.h"
 #include "Order.h"
+#include "Rollup.h"
+#include "DateIndex.h"
+#include "OrderId.h"
+#include "LazyFields.h"
+#include "Ranking.h"
+#include <stddef.h>
 
-int loadCustomers(Customer* customers, const char* fileName);
-Customer parseFieldsToCustomer(const char** fields);
+// How to treat records that repeat a customerID, partID or orderID already seen in the same file
+typedef enum {
+  DUPLICATE_REJECT, // Reject every record sharing the ID, including the first one
+  DUPLICATE_KEEP_FIRST, // Keep the first record with the ID, reject the later ones
+  DUPLICATE_KEEP_LAST // Keep the last record with the ID, replacing the earlier one
+} DuplicatePolicy;
 
-int loadParts(Part* parts, const char* fileName);
-Part parseFieldsToPart(const char** fields);
+// Databases whose format is guaranteed upstream; only a whole-file checksum and, for orders, the
+// references and totals are checked when loading them
+#define TRUSTED_CUSTOMERS 0x1
+#define TRUSTED_PARTS 0x2
+#define TRUSTED_ORDERS 0x4
 
-int loadOrders(Order* orders, const Part* parts, int partCount, const Customer* customers, int customerCount, const char* fileName);
-Order parseFieldsToOrder(const char** fields);
+typedef struct {
+  const char** sourceTypes; // "Customer", "Part" or "Order" for each duplicate
+  long long* ids; // The repeated ID
+  int* lineNumbers; // Line number of the repeating record
+  int count;
+  int capacity;
+} DuplicateReport;
+
+typedef struct {
+  DuplicatePolicy duplicatePolicy;
+  DuplicateReport* duplicates; // Optional, receives every duplicate found
+  CustomerRollups* rollups; // Optional, rebuilt from the accepted orders while orders load
+  OrderDateIndex* orderDates; // Optional, rebuilt after orders load
+  PaymentZoneMap* paymentZones; // Optional, rebuilt after customers load
+  OrderIdAllocator* orderIds; // Optional, reseeded with the sequence numbers used by the orders file
+  int isQuarantining; // 1 to copy rejected lines to <database>.rejected.db with their reasons in <database>.rejected.idx
+  int existingCount; // Records already in the array; the file's records are appended after them (0 to replace them)
+  LazyRecords* lazy; // Optional, customer and part text fields are then loaded on first use (not when appending)
+  int trustedFiles; // TRUSTED_* flags of the databases loaded in trusted-input mode
+  OrderRankings* rankings; // Optional, the top customers and parts, counted from the accepted orders while orders load
+  int orderCapacity; // Size of the orders array loaded into, or 0 for ORDERS_LIMIT
+} LoadOptions;
+
+// Order lines read and format checked, waiting for the reference checks (see loadStagedOrders).
+// Rejected lines are staged too, so they are reported and quarantined in file order.
+typedef struct {
+  char* text; // The staged lines one after another, each ending with '\0'
+  size_t textSize;
+  size_t textCapacity;
+  size_t* lineStarts; // Offset of each staged line in text
+  int* lineNumbers;
+  unsigned char* states; // LINE_* outcome of the checks on each line (see LinePipeline.h)
+  int count;
+  int capacity;
+  int lineCount; // Non-empty lines read
+  int isTrusted;
+} StagedOrders;
+
+int loadCustomers(Customer* customers, const char* fileName, const LoadOptions* options);
+Customer parseFieldsToCustomer(char* const* fields);
+Customer parseKeyFieldsToCustomer(char* const* fields, long long lineOffset);
+void parseCustomerTextFields(Customer* customer, char* const* fields);
+
+int loadParts(Part* parts, const char* fileName, const LoadOptions* options);
+Part parseFieldsToPart(char* const* fields);
+Part parseKeyFieldsToPart(char* const* fields, long long lineOffset);
+void parsePartTextFields(Part* part, char* const* fields);
+
+int loadOrders(Order* orders, const Part* parts, int partCount, const Customer* customers, int customerCount, const char* fileName,
+  const LoadOptions* options);
+Order parseFieldsToOrder(char* const* fields);
+int readOrderLines(StagedOrders* staged, const char* fileName, const LoadOptions* options);
+int loadStagedOrders(Order* orders, StagedOrders* staged, const Part* parts, int partCount, const Customer* customers, int customerCount,
+  const char* fileName, const LoadOptions* options);
+void freeStagedOrders(StagedOrders* staged);
 
 int splitLine(char* line, char** fields, int fieldLimit, char delimiter);
 
+int initDuplicateReport(DuplicateReport* report, int capacity);
+void freeDuplicateReport(DuplicateReport* report);
+
 #endif 
@@ -0,0 +1,166 @@
+// FILE : Index.c
+// DESCRIPTION :
+//    Implements an open addressing hash index from record IDs to array positions.
+//    Used to replace linear scans over the customers, parts and orders arrays with O(1) lookups.
+#include "Index.h"
+#include "Logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : hashId
+// DESCRIPTION :
+//    Scrambles an ID with a multiplicative hash so that sequential IDs spread across the table.
+// PARAMETERS :
+//    long long key: The ID to hash.
+//    int capacity: The table capacity (power of two).
+// RETURNS :
+//    int : The starting slot for the key.
+static int hashId(long long key, int capacity) {
+  unsigned long long hash = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+  return (int)((hash ^ (hash >> 32)) & (unsigned long long)(capacity - 1));
+}
+
+// FUNCTION : allocateSlots
+// DESCRIPTION :
+//    Allocates an empty slot table of the given capacity.
+// PARAMETERS :
+//    IdIndex* index: The index to allocate slots for.
+//    int capacity: The number of slots (power of two).
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int allocateSlots(IdIndex* index, int capacity) {
+  index->keys = (long long*)calloc(capacity, sizeof(long long));
+  index->values = (int*)malloc(capacity * sizeof(int));
+  if (index->keys == NULL || index->values == NULL) {
+    free(index->keys);
+    free(index->values);
+    index->keys = NULL;
+    index->values = NULL;
+    index->capacity = 0;
+    logGeneric("Failed to allocate memory for ID index.");
+    return 0;
+  }
+  index->capacity = capacity;
+  index->count = 0;
+  return 1;
+}
+
+// FUNCTION : initIdIndex
+// DESCRIPTION :
+//    Creates an empty index sized so that expectedCount IDs fit without growing.
+// PARAMETERS :
+//    IdIndex* index: The index to initialize.
+//    int expectedCount: The number of IDs expected to be stored.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initIdIndex(IdIndex* index, int expectedCount) {
+  int capacity = 16;
+  while (capacity < expectedCount * 2) {
+    capacity *= 2;
+  }
+  return allocateSlots(index, capacity);
+}
+
+// FUNCTION : growIdIndex
+// DESCRIPTION :
+//    Doubles the capacity of the index and re-inserts all existing entries.
+// PARAMETERS :
+//    IdIndex* index: The index to grow.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated (the index is left unchanged).
+static int growIdIndex(IdIndex* index) {
+  IdIndex grown;
+  if (!allocateSlots(&grown, index->capacity * 2)) {
+    return 0;
+  }
+  for (int i = 0; i < index->capacity; i++) {
+    if (index->keys[i] != ID_INDEX_EMPTY_KEY) {
+      setIdIndex(&grown, index->keys[i], index->values[i]);
+    }
+  }
+  free(index->keys);
+  free(index->values);
+  *index = grown;
+  return 1;
+}
+
+// FUNCTION : setIdIndex
+// DESCRIPTION :
+//    Maps an ID to an array position, overwriting the position if the ID is already present.
+//    Grows the table when it becomes more than 70% full.
+// PARAMETERS :
+//    IdIndex* index: The index to update.
+//    long long key: The record ID (must be > 0).
+//    int value: The array position of the record.
+// RETURNS :
+//    int : 1 on success, 0 if the key is invalid or memory could not be allocated.
+int setIdIndex(IdIndex* index, long long key, int value) {
+  if (key == ID_INDEX_EMPTY_KEY) {
+    return 0;
+  }
+  if ((index->count + 1) * 10 > index->capacity * 7 && !growIdIndex(index)) {
+    return 0;
+  }
+  int slot = hashId(key, index->capacity);
+  while (index->keys[slot] != ID_INDEX_EMPTY_KEY && index->keys[slot] != key) {
+    slot = (slot + 1) & (index->capacity - 1);
+  }
+  if (index->keys[slot] == ID_INDEX_EMPTY_KEY) {
+    index->keys[slot] = key;
+    index->count++;
+  }
+  index->values[slot] = value;
+  return 1;
+}
+
+// FUNCTION : findIdIndex
+// DESCRIPTION :
+//    Looks up the array position stored for an ID.
+// PARAMETERS :
+//    const IdIndex* index: The index to search.
+//    long long key: The record ID to look up.
+// RETURNS :
+//    int : The stored array position, or ID_INDEX_NOT_FOUND if the ID is not in the index.
+int findIdIndex(const IdIndex* index, long long key) {
+  if (index->capacity == 0 || key == ID_INDEX_EMPTY_KEY) {
+    return ID_INDEX_NOT_FOUND;
+  }
+  int slot = hashId(key, index->capacity);
+  while (index->keys[slot] != ID_INDEX_EMPTY_KEY) {
+    if (index->keys[slot] == key) {
+      return index->values[slot];
+    }
+    slot = (slot + 1) & (index->capacity - 1);
+  }
+  return ID_INDEX_NOT_FOUND;
+}
+
+// FUNCTION : clearIdIndex
+// DESCRIPTION :
+//    Removes all entries from the index while keeping its memory for reuse.
+// PARAMETERS :
+//    IdIndex* index: The index to clear.
+// RETURNS :
+//    void
+void clearIdIndex(IdIndex* index) {
+  if (index->keys != NULL) {
+    memset(index->keys, 0, index->capacity * sizeof(long long));
+  }
+  index->count = 0;
+}
+
+// FUNCTION : freeIdIndex
+// DESCRIPTION :
+//    Frees the memory held by the index.
+// PARAMETERS :
+//    IdIndex* index: The index to free.
+// RETURNS :
+//    void
+void freeIdIndex(IdIndex* index) {
+  free(index->keys);
+  free(index->values);
+  index->keys = NULL;
+  index->values = NULL;
+  index->capacity = 0;
+  index->count = 0;
+}
@@ -0,0 +1,22 @@
+// FILE : Index.h
+// DESCRIPTION : This header file defines a hash index mapping record IDs (customerID, partID, orderID) to array positions.
+#ifndef INDEX_H
+#define INDEX_H
+
+#define ID_INDEX_EMPTY_KEY 0 // IDs are always > 0, so 0 marks a free slot
+#define ID_INDEX_NOT_FOUND -1
+
+typedef struct {
+  long long* keys; // Record IDs, ID_INDEX_EMPTY_KEY for free slots
+  int* values; // Array position of the record with that ID
+  int capacity; // Number of slots, always a power of two
+  int count; // Number of occupied slots
+} IdIndex;
+
+int initIdIndex(IdIndex* index, int expectedCount);
+int setIdIndex(IdIndex* index, long long key, int value);
+int findIdIndex(const IdIndex* index, long long key);
+void clearIdIndex(IdIndex* index);
+void freeIdIndex(IdIndex* index);
+
+#endif
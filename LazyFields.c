@@ -0,0 +1,173 @@
+// FILE : LazyFields.c
+// DESCRIPTION :
+//    Implements lazy loading of customer and part text fields. Order validation only needs IDs,
+//    costs and balances, so a lazy load parses and validates just those and keeps the byte offset
+//    of each line. Names, addresses, emails and phones are read back from the database, validated
+//    and stored in the record the first time they are needed; later uses find them in place.
+#include "LazyFields.h"
+#include "FileIO.h"
+#include "Validation.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+// FUNCTION : initLazyRecords
+// DESCRIPTION :
+//    Prepares the lazy sources of customers and parts. Nothing is pending until a lazy load.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources to initialize.
+// RETURNS :
+//    void
+void initLazyRecords(LazyRecords* lazy) {
+  memset(lazy, 0, sizeof(LazyRecords));
+}
+
+// FUNCTION : setLazySource
+// DESCRIPTION :
+//    Points a lazy source at the database being loaded, closing the file of the previous load.
+// PARAMETERS :
+//    LazySource* source: The source to update.
+//    const char* fileName: The database file being loaded lazily.
+// RETURNS :
+//    void
+void setLazySource(LazySource* source, const char* fileName) {
+  if (source->file != NULL) {
+    fclose(source->file);
+    source->file = NULL;
+  }
+  strcpy_s(source->fileName, sizeof(source->fileName), fileName);
+}
+
+// FUNCTION : readLazyLine
+// DESCRIPTION :
+//    Reads the database line starting at a byte offset, opening the database on first use.
+// PARAMETERS :
+//    LazySource* source: The database to read from.
+//    long long lineOffset: Byte offset of the line.
+//    char* line: Receives the line.
+//    int size: The size of the line buffer.
+// RETURNS :
+//    int : 1 if the line was read, 0 otherwise.
+static int readLazyLine(LazySource* source, long long lineOffset, char* line, int size) {
+  if (source->file == NULL) {
+    errno_t err = fopen_s(&source->file, source->fileName, "rb");
+    if (err != 0 || source->file == NULL) {
+      source->file = NULL;
+      return 0;
+    }
+  }
+  return _fseeki64(source->file, lineOffset, SEEK_SET) == 0 && fgets(line, size, source->file) != NULL;
+}
+
+// FUNCTION : materializeCustomer
+// DESCRIPTION :
+//    Makes sure the text fields of a customer are loaded. A pending customer's line is read back
+//    and its text fields validated; if the line no longer holds the customer (the database changed
+//    since it was loaded) or a field is invalid, the error is logged and the customer is marked
+//    FIELDS_INVALID so it is not read again.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources.
+//    Customer* customer: The customer whose text fields are needed.
+// RETURNS :
+//    int : 1 if the text fields are loaded, 0 if they are invalid.
+int materializeCustomer(LazyRecords* lazy, Customer* customer) {
+  if (customer->fieldState != FIELDS_PENDING) {
+    return customer->fieldState == FIELDS_LOADED;
+  }
+  char line[1024];
+  char* fields[NUMBER_OF_CUSTOMER_FIELDS];
+  int customerID = 0;
+  if (!readLazyLine(&lazy->customers, customer->lineOffset, line, sizeof(line))
+    || splitLine(line, fields, NUMBER_OF_CUSTOMER_FIELDS, '|') != NUMBER_OF_CUSTOMER_FIELDS
+    || sscanf_s(fields[7], "%d", &customerID) != 1 || customerID != customer->customerID) {
+    char errorMessage[256];
+    snprintf(errorMessage, sizeof(errorMessage), "The details of customer %d could not be read back, %s changed since it was loaded.",
+      customer->customerID, lazy->customers.fileName);
+    logGeneric(errorMessage);
+    customer->fieldState = FIELDS_INVALID;
+    return 0;
+  }
+  if (!validateCustomerTextFields(fields, customer->customerID)) {
+    customer->fieldState = FIELDS_INVALID;
+    return 0;
+  }
+  parseCustomerTextFields(customer, fields);
+  return 1;
+}
+
+// FUNCTION : materializePart
+// DESCRIPTION :
+//    Makes sure the name and number of a part are loaded, in the same way as materializeCustomer.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources.
+//    Part* part: The part whose name and number are needed.
+// RETURNS :
+//    int : 1 if the name and number are loaded, 0 if they are invalid.
+int materializePart(LazyRecords* lazy, Part* part) {
+  if (part->fieldState != FIELDS_PENDING) {
+    return part->fieldState == FIELDS_LOADED;
+  }
+  char line[1024];
+  char* fields[NUMBER_OF_PART_FIELDS];
+  int partID = 0;
+  if (!readLazyLine(&lazy->parts, part->lineOffset, line, sizeof(line))
+    || splitLine(line, fields, NUMBER_OF_PART_FIELDS, '|') != NUMBER_OF_PART_FIELDS
+    || sscanf_s(fields[6], "%d", &partID) != 1 || partID != part->partID) {
+    char errorMessage[256];
+    snprintf(errorMessage, sizeof(errorMessage), "The details of part %d could not be read back, %s changed since it was loaded.",
+      part->partID, lazy->parts.fileName);
+    logGeneric(errorMessage);
+    part->fieldState = FIELDS_INVALID;
+    return 0;
+  }
+  if (!validatePartTextFields(fields, part->partID)) {
+    part->fieldState = FIELDS_INVALID;
+    return 0;
+  }
+  parsePartTextFields(part, fields);
+  return 1;
+}
+
+// FUNCTION : materializeCustomers
+// DESCRIPTION :
+//    Loads the text fields of every pending customer, e.g. before listing them all.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources.
+//    Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+// RETURNS :
+//    void
+void materializeCustomers(LazyRecords* lazy, Customer* customers, int customerCount) {
+  for (int i = 0; i < customerCount; i++) {
+    materializeCustomer(lazy, &customers[i]);
+  }
+}
+
+// FUNCTION : materializeParts
+// DESCRIPTION :
+//    Loads the name and number of every pending part, e.g. before listing them all.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources.
+//    Part* parts: The parts array.
+//    int partCount: Number of parts.
+// RETURNS :
+//    void
+void materializeParts(LazyRecords* lazy, Part* parts, int partCount) {
+  for (int i = 0; i < partCount; i++) {
+    materializePart(lazy, &parts[i]);
+  }
+}
+
+// FUNCTION : freeLazyRecords
+// DESCRIPTION :
+//    Closes the database files kept open for lazy reads.
+// PARAMETERS :
+//    LazyRecords* lazy: The lazy sources.
+// RETURNS :
+//    void
+void freeLazyRecords(LazyRecords* lazy) {
+  setLazySource(&lazy->customers, "");
+  setLazySource(&lazy->parts, "");
+}
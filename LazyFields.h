@@ -0,0 +1,30 @@
+// FILE : LazyFields.h
+// DESCRIPTION : This header file defines lazy loading of the text fields of customers and parts.
+#ifndef LAZYFIELDS_H
+#define LAZYFIELDS_H
+
+#include "Customer.h"
+#include "Part.h"
+#include <stdio.h>
+
+#define LAZY_FILE_NAME_SIZE 260
+
+typedef struct {
+  char fileName[LAZY_FILE_NAME_SIZE]; // Database the line offsets of pending records refer to
+  FILE* file; // Opened in binary mode on the first read, kept open for later ones
+} LazySource;
+
+typedef struct {
+  LazySource customers;
+  LazySource parts;
+} LazyRecords;
+
+void initLazyRecords(LazyRecords* lazy);
+void setLazySource(LazySource* source, const char* fileName);
+int materializeCustomer(LazyRecords* lazy, Customer* customer);
+int materializePart(LazyRecords* lazy, Part* part);
+void materializeCustomers(LazyRecords* lazy, Customer* customers, int customerCount);
+void materializeParts(LazyRecords* lazy, Part* parts, int partCount);
+void freeLazyRecords(LazyRecords* lazy);
+
+#endif
@@ -0,0 +1,393 @@
+// FILE : LinePipeline.c
+// DESCRIPTION :
+//    Implements the staged line pipeline used by the database loads. A load runs as three stages:
+//    read (lines from the read-ahead reader into batches), check (split each line and validate
+//    its fields without logging) and build (log and quarantine rejected lines, resolve duplicates
+//    and store the records, in file order). Each stage runs on its own thread so the file is read while earlier
+//    lines are validated. Batches move between the stages through bounded single-producer,
+//    single-consumer rings: read to check, check to build, and build back to read once a batch
+//    is done with, so a load never holds more than PIPELINE_BATCH_COUNT batches. A file that fits
+//    in one batch, or a machine without a processor for each stage, runs the stages in turn on
+//    the calling thread instead. Lines the read and check threads log are held until the load is
+//    done and then passed on as if the calling thread logged them, so a load whose lines are
+//    captured (see beginLogCapture) keeps them all together.
+#include "LinePipeline.h"
+#include "FileIO.h"
+#include "Parallel.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PIPELINE_STAGE_READ 0
+#define PIPELINE_STAGE_CHECK 1
+#define PIPELINE_STAGE_BUILD 2
+#define PIPELINE_STAGE_COUNT 3
+
+// Single-producer, single-consumer ring of batches. NULL marks the end of the input.
+typedef struct {
+  LineBatch* slots[PIPELINE_BATCH_COUNT];
+  volatile LONG head; // Next slot to take, only advanced by the consumer
+  volatile LONG tail; // Next slot to fill, only advanced by the producer
+} BatchRing;
+
+typedef struct {
+  const LinePipeline* pipeline;
+  LineBatch batches[PIPELINE_BATCH_COUNT];
+  BatchRing freeBatches; // Build stage to read stage
+  BatchRing readBatches; // Read stage to check stage
+  BatchRing checkedBatches; // Check stage to build stage
+  volatile LONG isStopping; // Set by the build stage to stop reading early
+  int lineNumber;
+  long long nextLineOffset;
+  int isAtEnd;
+} PipelineState;
+
+typedef struct {
+  PipelineState* state;
+  int stage; // PIPELINE_STAGE_*
+  LogBuffer log; // Lines logged by a read or check stage thread
+} PipelineStageWork;
+
+// FUNCTION : waitForStage
+// DESCRIPTION :
+//    Waits a little for another stage to catch up: spins at first, then sleeps so a stage waiting
+//    on a slow disk does not keep a processor busy.
+// PARAMETERS :
+//    int* spinCount: The number of times the caller waited so far, 0 at first.
+// RETURNS :
+//    void
+static void waitForStage(int* spinCount) {
+  if (*spinCount < PIPELINE_SPIN_COUNT) {
+    (*spinCount)++;
+    YieldProcessor();
+  }
+  else {
+    Sleep(1);
+  }
+}
+
+// FUNCTION : pushBatch
+// DESCRIPTION :
+//    Adds a batch to a ring, waiting while it is full. Only one thread may push to a ring.
+// PARAMETERS :
+//    BatchRing* ring: The ring.
+//    LineBatch* batch: The batch, or NULL to mark the end of the input.
+// RETURNS :
+//    void
+static void pushBatch(BatchRing* ring, LineBatch* batch) {
+  LONG tail = ring->tail;
+  int spinCount = 0;
+  while (tail - ring->head == PIPELINE_BATCH_COUNT) {
+    waitForStage(&spinCount);
+  }
+  ring->slots[tail % PIPELINE_BATCH_COUNT] = batch;
+  InterlockedExchange(&ring->tail, tail + 1); // Full barrier, so the slot is written before it is published
+}
+
+// FUNCTION : popBatch
+// DESCRIPTION :
+//    Takes the oldest batch from a ring, waiting while it is empty. Only one thread may pop from a ring.
+// PARAMETERS :
+//    BatchRing* ring: The ring.
+// RETURNS :
+//    LineBatch* : The batch, or NULL at the end of the input.
+static LineBatch* popBatch(BatchRing* ring) {
+  LONG head = ring->head;
+  int spinCount = 0;
+  while (ring->tail == head) {
+    waitForStage(&spinCount);
+  }
+  MemoryBarrier(); // Read the slot only after seeing it published
+  LineBatch* batch = ring->slots[head % PIPELINE_BATCH_COUNT];
+  InterlockedExchange(&ring->head, head + 1);
+  return batch;
+}
+
+// FUNCTION : growBatchText
+// DESCRIPTION :
+//    Makes room in a batch for at least extra more bytes of text, e.g. for a line longer than the line size.
+// PARAMETERS :
+//    LineBatch* batch: The batch.
+//    size_t extra: The number of bytes needed.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int growBatchText(LineBatch* batch, size_t extra) {
+  if (batch->textSize + extra <= batch->textCapacity) {
+    return 1;
+  }
+  size_t newCapacity = batch->textCapacity * 2 > batch->textSize + extra ? batch->textCapacity * 2 : batch->textSize + extra;
+  char* newText = (char*)realloc(batch->text, newCapacity);
+  if (newText != NULL) {
+    batch->text = newText;
+  }
+  char* newSplitText = (char*)realloc(batch->splitText, newCapacity);
+  if (newSplitText != NULL) {
+    batch->splitText = newSplitText;
+  }
+  if (newText == NULL || newSplitText == NULL) {
+    return 0;
+  }
+  batch->textCapacity = newCapacity;
+  return 1;
+}
+
+// FUNCTION : readRestOfLine
+// DESCRIPTION :
+//    Appends the rest of a line longer than the line size to the line read last, so reading can
+//    continue with the next line and the whole line can be quarantined.
+// PARAMETERS :
+//    LineBatch* batch: The batch, ending with the first part of the long line.
+//    const LinePipeline* pipeline: The pipeline, whose reader is positioned just after the first part.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int readRestOfLine(LineBatch* batch, const LinePipeline* pipeline) {
+  batch->textSize--; // Append over the '\0' of the first part
+  int isRead = 1;
+  char part[1024];
+  while (readAsyncLine(pipeline->reader, part, sizeof(part)) != NULL) {
+    size_t length = strlen(part);
+    isRead = isRead && growBatchText(batch, length + 1); // Out of memory, keep reading to the end of the line
+    if (isRead) {
+      memcpy(batch->text + batch->textSize, part, length);
+      batch->textSize += length;
+    }
+    if (part[length - 1] == '\n') {
+      break;
+    }
+  }
+  batch->text[batch->textSize++] = '\0';
+  return isRead;
+}
+
+// FUNCTION : readBatch
+// DESCRIPTION :
+//    Read stage: fills a batch with the next non-empty lines of the file.
+// PARAMETERS :
+//    PipelineState* state: The pipeline.
+//    LineBatch* batch: The batch to fill.
+// RETURNS :
+//    void
+static void readBatch(PipelineState* state, LineBatch* batch) {
+  const LinePipeline* pipeline = state->pipeline;
+  batch->count = 0;
+  batch->textSize = 0;
+  while (batch->count < PIPELINE_BATCH_LINES && batch->textSize + pipeline->lineSize <= batch->textCapacity) {
+    char* line = batch->text + batch->textSize;
+    METRIC_TIMER_START(readTimer);
+    char* result = readAsyncLine(pipeline->reader, line, pipeline->lineSize);
+    METRIC_TIMER_STOP(STAGE_READ_LINE, readTimer);
+    if (result == NULL) {
+      state->isAtEnd = 1;
+      break;
+    }
+    size_t length = strlen(line);
+    long long lineOffset = state->nextLineOffset;
+    state->nextLineOffset += length;
+    if (length >= 2 && line[length - 2] == '\r' && line[length - 1] == '\n') {
+      line[length - 2] = '\n'; // The "\n" that text mode gives
+      line[--length] = '\0';
+    }
+    // Skip empty lines
+    if (line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    LineSpan* span = &batch->lines[batch->count++];
+    span->fileOffset = lineOffset;
+    span->start = batch->textSize;
+    span->lineNumber = ++state->lineNumber;
+    span->fieldCount = 0;
+    span->state = LINE_VALID;
+    batch->textSize += length + 1;
+    if (length == (size_t)pipeline->lineSize - 1) {
+      span->state = LINE_TOO_LONG;
+      if (!readRestOfLine(batch, pipeline)) {
+        logGeneric("Failed to allocate memory for a long line, only its beginning will be quarantined.");
+      }
+      state->nextLineOffset = getAsyncReadOffset(pipeline->reader);
+    }
+  }
+}
+
+// FUNCTION : checkBatch
+// DESCRIPTION :
+//    Check stage: splits each line of a batch into fields and records the outcome of its checks.
+// PARAMETERS :
+//    const LinePipeline* pipeline: The pipeline.
+//    LineBatch* batch: The batch to check.
+// RETURNS :
+//    void
+static void checkBatch(const LinePipeline* pipeline, LineBatch* batch) {
+  for (int i = 0; i < batch->count; i++) {
+    LineSpan* span = &batch->lines[i];
+    if (span->state == LINE_TOO_LONG) {
+      continue;
+    }
+    // Split a copy, the line as read is kept for the quarantine
+    char* line = batch->splitText + span->start;
+    strcpy_s(line, batch->textCapacity - span->start, batch->text + span->start);
+    // splitLine may store one pointer past the limit before giving up, hence the extra slot per line
+    char** fields = batch->fields + (size_t)i * (pipeline->fieldLimit + 1);
+    span->fieldCount = splitLine(line, fields, pipeline->fieldLimit, '|');
+    span->state = pipeline->check(fields, span->fieldCount, pipeline->context);
+  }
+}
+
+// FUNCTION : buildBatch
+// DESCRIPTION :
+//    Build stage: hands each line of a batch to the load, in file order.
+// PARAMETERS :
+//    const LinePipeline* pipeline: The pipeline.
+//    LineBatch* batch: The checked batch.
+// RETURNS :
+//    int : 1 to carry on, 0 if the load stopped.
+static int buildBatch(const LinePipeline* pipeline, LineBatch* batch) {
+  for (int i = 0; i < batch->count; i++) {
+    const LineSpan* span = &batch->lines[i];
+    char** fields = batch->fields + (size_t)i * (pipeline->fieldLimit + 1);
+    if (!pipeline->build(span, batch->text + span->start, fields, pipeline->context)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : runPipelineStage
+// DESCRIPTION :
+//    Runs one stage of a threaded pipeline until the end of the input reaches it.
+// PARAMETERS :
+//    void* argument: The PipelineStageWork of the stage.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall runPipelineStage(void* argument) {
+  PipelineStageWork* work = (PipelineStageWork*)argument;
+  PipelineState* state = work->state;
+  LineBatch* batch = NULL;
+  if (work->stage != PIPELINE_STAGE_BUILD) {
+    beginLogCapture(&work->log); // The build stage runs on the calling thread and logs as it does
+  }
+  switch (work->stage) {
+    case PIPELINE_STAGE_READ:
+      while (!state->isAtEnd && !state->isStopping) {
+        batch = popBatch(&state->freeBatches);
+        readBatch(state, batch);
+        if (batch->count > 0) {
+          pushBatch(&state->readBatches, batch);
+        }
+      }
+      pushBatch(&state->readBatches, NULL);
+      break;
+    case PIPELINE_STAGE_CHECK:
+      while ((batch = popBatch(&state->readBatches)) != NULL) {
+        checkBatch(state->pipeline, batch);
+        pushBatch(&state->checkedBatches, batch);
+      }
+      pushBatch(&state->checkedBatches, NULL);
+      break;
+    default:
+      // Batches still arriving after the load stopped are only handed back
+      while ((batch = popBatch(&state->checkedBatches)) != NULL) {
+        if (!state->isStopping && !buildBatch(state->pipeline, batch)) {
+          InterlockedExchange(&state->isStopping, 1);
+        }
+        pushBatch(&state->freeBatches, batch);
+      }
+      break;
+  }
+  if (work->stage != PIPELINE_STAGE_BUILD) {
+    endLogCapture();
+  }
+  return 0;
+}
+
+// FUNCTION : freeBatches
+// DESCRIPTION :
+//    Frees the batches of a pipeline.
+// PARAMETERS :
+//    PipelineState* state: The pipeline.
+// RETURNS :
+//    void
+static void freeBatches(PipelineState* state) {
+  for (int i = 0; i < PIPELINE_BATCH_COUNT; i++) {
+    free(state->batches[i].text);
+    free(state->batches[i].splitText);
+    free(state->batches[i].lines);
+    free(state->batches[i].fields);
+  }
+}
+
+// FUNCTION : runLinePipeline
+// DESCRIPTION :
+//    Reads every line of a database file through the read, check and build stages. The build
+//    function sees the lines in file order whether or not the stages run on their own threads.
+// PARAMETERS :
+//    const LinePipeline* pipeline: The file, the check and build functions and their context.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int runLinePipeline(const LinePipeline* pipeline) {
+  PipelineState* state = (PipelineState*)calloc(1, sizeof(PipelineState));
+  if (state == NULL) {
+    logGeneric("Failed to allocate memory for the load pipeline.");
+    return 0;
+  }
+  state->pipeline = pipeline;
+  int isAllocated = 1;
+  for (int i = 0; i < PIPELINE_BATCH_COUNT; i++) {
+    LineBatch* batch = &state->batches[i];
+    batch->textCapacity = PIPELINE_BATCH_BYTES + pipeline->lineSize;
+    batch->text = (char*)malloc(batch->textCapacity);
+    batch->splitText = (char*)malloc(batch->textCapacity);
+    batch->lines = (LineSpan*)malloc(PIPELINE_BATCH_LINES * sizeof(LineSpan));
+    batch->fields = (char**)malloc((size_t)PIPELINE_BATCH_LINES * (pipeline->fieldLimit + 1) * sizeof(char*));
+    isAllocated = isAllocated && batch->text != NULL && batch->splitText != NULL && batch->lines != NULL && batch->fields != NULL;
+  }
+  if (!isAllocated) {
+    logGeneric("Failed to allocate memory for the load pipeline.");
+    freeBatches(state);
+    free(state);
+    return 0;
+  }
+
+  // The first batch is read before deciding whether the stages get threads of their own
+  LineBatch* firstBatch = &state->batches[0];
+  readBatch(state, firstBatch);
+  checkBatch(pipeline, firstBatch);
+  if (!buildBatch(pipeline, firstBatch)) {
+    state->isStopping = 1;
+  }
+  if (state->isAtEnd || state->isStopping) {
+    // Nothing more to read, or the load already stopped
+  }
+  else if (getTaskWorkerCount(PIPELINE_STAGE_COUNT) < PIPELINE_STAGE_COUNT) {
+    while (!state->isAtEnd) {
+      readBatch(state, firstBatch);
+      checkBatch(pipeline, firstBatch);
+      if (!buildBatch(pipeline, firstBatch)) {
+        break;
+      }
+    }
+  }
+  else {
+    for (int i = 0; i < PIPELINE_BATCH_COUNT; i++) {
+      pushBatch(&state->freeBatches, &state->batches[i]);
+    }
+    PipelineStageWork work[PIPELINE_STAGE_COUNT];
+    memset(work, 0, sizeof(work));
+    // The calling thread runs the build stage, so the load's state is only touched on its own thread
+    work[0].state = state;
+    work[0].stage = PIPELINE_STAGE_BUILD;
+    work[1].state = state;
+    work[1].stage = PIPELINE_STAGE_READ;
+    work[2].state = state;
+    work[2].stage = PIPELINE_STAGE_CHECK;
+    runWorkers(runPipelineStage, work, sizeof(PipelineStageWork), PIPELINE_STAGE_COUNT);
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; i++) {
+      flushLogBuffer(&work[i].log);
+    }
+  }
+  freeBatches(state);
+  free(state);
+  return 1;
+}
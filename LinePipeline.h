@@ -0,0 +1,51 @@
+// FILE : LinePipeline.h
+// DESCRIPTION : This header file defines the staged pipeline that database loads read their lines through.
+#ifndef LINE_PIPELINE_H
+#define LINE_PIPELINE_H
+
+#include "AsyncReader.h"
+#include <stddef.h>
+
+// Outcome of the checks run on a line by the check stage
+#define LINE_VALID 0
+#define LINE_INVALID 1 // Validated again by the build stage to report its errors
+#define LINE_FIELD_COUNT_INVALID 2
+#define LINE_TOO_LONG 3 // Not split or checked
+
+typedef struct {
+  long long fileOffset; // Byte offset of the line in the file
+  size_t start; // Offset of the line in the batch text
+  int lineNumber; // Counting non-empty lines from 1
+  int fieldCount; // As returned by splitLine
+  int state; // LINE_*
+} LineSpan;
+
+// Lines passed from one stage to the next
+typedef struct {
+  char* text; // The lines as read, one after another, each ending with '\0'
+  char* splitText; // Copy of text cut up into fields by the check stage
+  size_t textSize;
+  size_t textCapacity;
+  LineSpan* lines;
+  char** fields; // Field pointers of each line, into splitText
+  int count;
+} LineBatch;
+
+// Check stage: returns the LINE_* state of a line from its fields. Runs on its own thread, whose lines are only
+// logged after the load's, so it should not log.
+typedef int (*LineCheckFunction)(char** fields, int fieldCount, void* context);
+// Build stage: handles one line in file order on the calling thread. Returns 0 to stop the load.
+typedef int (*LineBuildFunction)(const LineSpan* line, const char* rawLine, char** fields, void* context);
+
+typedef struct {
+  AsyncReader* reader; // The file, read as binary; "\r\n" endings are read as "\n"
+  int lineSize; // Lines of lineSize - 1 characters or more are LINE_TOO_LONG, as with an fgets buffer of this size
+  int fieldLimit; // Most fields split from a line
+  LineCheckFunction check;
+  LineBuildFunction build;
+  void* context; // Passed to check and build
+} LinePipeline;
+
+int runLinePipeline(const LinePipeline* pipeline);
+
+#endif
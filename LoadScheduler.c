@@ -0,0 +1,143 @@
+// FILE : LoadScheduler.c
+// DESCRIPTION :
+//    Implements the loading of customers.db, parts.db and orders.db as a small dependency graph.
+//    Customers and parts do not depend on anything, and reading, splitting and format checking the
+//    orders does not depend on them either, so those three tasks run on worker threads at the same
+//    time. Only the order checks against customer and part IDs, the duplicate resolution and the
+//    rollups wait for both loads; they run on the calling thread once the workers have joined.
+#include "LoadScheduler.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <string.h>
+
+#define LOAD_TASK_CUSTOMERS 0
+#define LOAD_TASK_PARTS 1
+#define LOAD_TASK_ORDER_LINES 2
+#define LOAD_TASK_COUNT 3
+
+typedef struct {
+  int task; // LOAD_TASK_*
+  Customer* customers;
+  Part* parts;
+  StagedOrders* staged;
+  LoadOptions options; // Each task gets its own copy, see loadDatabases
+  int count; // Records loaded, or 1 if the order lines were read
+  LogBuffer log; // Lines logged by the task, written in file order once all tasks are done
+} LoadTaskWork;
+
+// FUNCTION : runLoadTask
+// DESCRIPTION :
+//    Runs one of the independent load tasks.
+// PARAMETERS :
+//    LoadTaskWork* work: The task and its options.
+// RETURNS :
+//    void
+static void runLoadTask(LoadTaskWork* work) {
+  beginLogCapture(&work->log);
+  switch (work->task) {
+    case LOAD_TASK_CUSTOMERS:
+      work->count = loadCustomers(work->customers, CUSTOMERS_FILE, &work->options);
+      break;
+    case LOAD_TASK_PARTS:
+      work->count = loadParts(work->parts, PARTS_FILE, &work->options);
+      break;
+    default:
+      work->count = readOrderLines(work->staged, ORDERS_FILE, &work->options);
+      break;
+  }
+  endLogCapture();
+}
+
+// FUNCTION : loadTaskWorker
+// DESCRIPTION :
+//    Worker thread entry point for runLoadTask.
+// PARAMETERS :
+//    void* argument: The LoadTaskWork of the task.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall loadTaskWorker(void* argument) {
+  runLoadTask((LoadTaskWork*)argument);
+  return 0;
+}
+
+// FUNCTION : mergeDuplicateReport
+// DESCRIPTION :
+//    Appends the duplicates found by one task to the shared report, as far as it has room.
+// PARAMETERS :
+//    DuplicateReport* report: The shared report.
+//    const DuplicateReport* taskReport: The report of the task.
+// RETURNS :
+//    void
+static void mergeDuplicateReport(DuplicateReport* report, const DuplicateReport* taskReport) {
+  for (int i = 0; i < taskReport->count && report->count < report->capacity; i++) {
+    report->sourceTypes[report->count] = taskReport->sourceTypes[i];
+    report->ids[report->count] = taskReport->ids[i];
+    report->lineNumbers[report->count] = taskReport->lineNumbers[i];
+    report->count++;
+  }
+}
+
+// FUNCTION : loadDatabases
+// DESCRIPTION :
+//    Loads customers, parts and orders, running the customers load, the parts load and the reading
+//    of the order lines concurrently, then checking and storing the orders once both are loaded.
+//    The results, log and duplicate report are the same as loading the three files one after the
+//    other: each task holds its log lines back and they are written task by task after the join,
+//    before the orders are checked. Shared sinks that are not thread safe are kept to one task: the customers load uses
+//    the duplicate report and the parts load gets a report of its own that is merged afterwards.
+// PARAMETERS :
+//    Customer* customers: Receives the customers.
+//    int* customerCount: Receives the number of customers loaded.
+//    Part* parts: Receives the parts.
+//    int* partCount: Receives the number of parts loaded.
+//    Order* orders: Receives the orders.
+//    int* orderCount: Receives the number of orders loaded.
+//    const LoadOptions* options: The load options, applied to all three files.
+// RETURNS :
+//    int : The total number of records loaded.
+int loadDatabases(Customer* customers, int* customerCount, Part* parts, int* partCount, Order* orders, int* orderCount,
+  const LoadOptions* options) {
+  StagedOrders staged;
+  DuplicateReport partDuplicates;
+  memset(&staged, 0, sizeof(StagedOrders));
+  memset(&partDuplicates, 0, sizeof(DuplicateReport));
+  int hasPartReport = options->duplicates != NULL && initDuplicateReport(&partDuplicates, options->duplicates->capacity);
+
+  LoadTaskWork work[LOAD_TASK_COUNT];
+  for (int i = 0; i < LOAD_TASK_COUNT; i++) {
+    work[i].task = i;
+    work[i].customers = customers;
+    work[i].parts = parts;
+    work[i].staged = &staged;
+    work[i].options = *options;
+    work[i].count = 0;
+  }
+  work[LOAD_TASK_PARTS].options.duplicates = hasPartReport ? &partDuplicates : NULL;
+
+  if (getTaskWorkerCount(LOAD_TASK_COUNT) < LOAD_TASK_COUNT) {
+    // Not enough processors for the tasks to overlap, so avoid the thread start-up
+    for (int i = 0; i < LOAD_TASK_COUNT; i++) {
+      runLoadTask(&work[i]);
+    }
+  }
+  else {
+    runWorkers(loadTaskWorker, work, sizeof(LoadTaskWork), LOAD_TASK_COUNT);
+  }
+  for (int i = 0; i < LOAD_TASK_COUNT; i++) {
+    flushLogBuffer(&work[i].log);
+  }
+  if (hasPartReport) {
+    mergeDuplicateReport(options->duplicates, &partDuplicates);
+    freeDuplicateReport(&partDuplicates);
+  }
+  // A file that could not be opened loads nothing
+  *customerCount = work[LOAD_TASK_CUSTOMERS].count >= 0 ? work[LOAD_TASK_CUSTOMERS].count : options->existingCount;
+  *partCount = work[LOAD_TASK_PARTS].count >= 0 ? work[LOAD_TASK_PARTS].count : options->existingCount;
+  *orderCount = 0;
+  if (work[LOAD_TASK_ORDER_LINES].count) {
+    *orderCount = loadStagedOrders(orders, &staged, parts, *partCount, customers, *customerCount, ORDERS_FILE, options);
+    freeStagedOrders(&staged);
+  }
+  return *customerCount + *partCount + *orderCount;
+}
@@ -0,0 +1,11 @@
+// FILE : LoadScheduler.h
+// DESCRIPTION : This header file defines the loading of all three databases with their independent stages run concurrently.
+#ifndef LOAD_SCHEDULER_H
+#define LOAD_SCHEDULER_H
+
+#include "FileIO.h"
+
+int loadDatabases(Customer* customers, int* customerCount, Part* parts, int* partCount, Order* orders, int* orderCount,
+  const LoadOptions* options);
+
+#endif
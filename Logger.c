@@ -2,9 +2,16 @@
 // DESCRIPTION : Implements logging functionality for the system.
 #include "Logger.h"
 #include "Constants.h"
+#include "Metrics.h"
+#include <windows.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 
+static SRWLOCK logLock = SRWLOCK_INIT; // Keeps lines from worker threads (e.g. shard loads) from interleaving
+static __declspec(thread) LogBuffer* capturedLog = NULL; // Set between beginLogCapture and endLogCapture
+
 #  // Name of the runtime log file
 
 // FUNCTION     : getTimestamp
@@ -15,8 +22,43 @@
 // RETURNS      : void
 static void getTimestamp(char* buffer, int size) {
   time_t now = time(NULL);                 // Get current system time
-  struct tm* t = localtime(&now);          // Convert to local time
-  strftime(buffer, size, "%Y-%m-%d %H:%M:%S", t);  // Format the time string
+  struct tm t;
+  localtime_s(&t, &now);                   // Convert to local time (thread-safe)
+  strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &t);  // Format the time string
+}
+
+// FUNCTION     : captureLogLine
+// DESCRIPTION  : Appends a formatted log line to the buffer of the calling thread, if it is capturing.
+// PARAMETERS   :
+//   format     : The printf format of the line, ending with '\n'
+//   ...        : The values of the line
+// RETURNS      : int : 1 if the line was held in the buffer, 0 if it must be written to the file
+static int captureLogLine(const char* format, ...) {
+  LogBuffer* buffer = capturedLog;
+  if (buffer == NULL) {
+    return 0;
+  }
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(NULL, 0, format, arguments);
+  va_end(arguments);
+  if (length < 0) {
+    return 0;
+  }
+  if (buffer->size + length + 1 > buffer->capacity) {
+    size_t newCapacity = buffer->capacity * 2 > buffer->size + length + 1 ? buffer->capacity * 2 : buffer->size + length + 1024;
+    char* newText = (char*)realloc(buffer->text, newCapacity);
+    if (newText == NULL) {
+      return 0; // Written straight away instead, only out of order
+    }
+    buffer->text = newText;
+    buffer->capacity = newCapacity;
+  }
+  va_start(arguments, format);
+  vsnprintf(buffer->text + buffer->size, buffer->capacity - buffer->size, format, arguments);
+  va_end(arguments);
+  buffer->size += length;
+  return 1;
 }
 
 // FUNCTION     : logError
@@ -29,16 +71,26 @@ static void getTimestamp(char* buffer, int size) {
 //   message    : The error message to be logged
 // RETURNS      : void
 void logError(const char* sourceType, int id, const char* fieldName, const char* message) {
-  FILE* file = fopen(LOG_FILE, "a");  // Open the log file in append mode
-  if (!file) return;  // If file can't be opened, exit silently
-
+  METRIC_TIMER_START(logTimer);
   char timestamp[20];
   getTimestamp(timestamp, sizeof(timestamp));  // Get current timestamp
+  if (captureLogLine("%s | %s ID: %d | Field: %s | Error: %s\n", timestamp, sourceType, id, fieldName, message)) {
+    METRIC_TIMER_STOP(STAGE_LOG, logTimer);
+    return;
+  }
+  AcquireSRWLockExclusive(&logLock);
+  FILE* file = fopen(LOG_FILE, "a");  // Open the log file in append mode
+  if (!file) {
+    ReleaseSRWLockExclusive(&logLock);
+    return;  // If file can't be opened, exit silently
+  }
 
   // Write the error message to the log file
   fprintf(file, "%s | %s ID: %d | Field: %s | Error: %s\n", timestamp, sourceType, id, fieldName, message);
 
   fclose(file);  // Close the file
+  ReleaseSRWLockExclusive(&logLock);
+  METRIC_TIMER_STOP(STAGE_LOG, logTimer);
 }
 
 // FUNCTION     : logGeneric
@@ -48,16 +100,69 @@ void logError(const char* sourceType, int id, const char* fieldName, const char*
 //   message    : The general message to be logged
 // RETURNS      : void
 void logGeneric(const char* message) {
-  FILE* file = fopen(LOG_FILE, "a");  // Open the log file in append mode
-  if (!file) return;  // Exit silently if file can't be opened
-
+  METRIC_TIMER_START(logTimer);
   char timestamp[20];
   getTimestamp(timestamp, sizeof(timestamp));  // Get current timestamp
+  if (captureLogLine("%s | %s\n", timestamp, message)) {
+    METRIC_TIMER_STOP(STAGE_LOG, logTimer);
+    return;
+  }
+  AcquireSRWLockExclusive(&logLock);
+  FILE* file = fopen(LOG_FILE, "a");  // Open the log file in append mode
+  if (!file) {
+    ReleaseSRWLockExclusive(&logLock);
+    return;  // Exit silently if file can't be opened
+  }
 
   // Write the general message to the log
   fprintf(file, "%s | %s\n", timestamp, message);
 
   fclose(file);  // Close the file
+  ReleaseSRWLockExclusive(&logLock);
+  METRIC_TIMER_STOP(STAGE_LOG, logTimer);
+}
+
+// FUNCTION     : beginLogCapture
+// DESCRIPTION  : Holds the lines the calling thread logs in a buffer instead of writing them, so
+//                tasks running at the same time can have their lines written one task after the other.
+// PARAMETERS   :
+//   buffer     : The buffer to hold the lines, emptied first
+// RETURNS      : void
+void beginLogCapture(LogBuffer* buffer) {
+  buffer->text = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
+  capturedLog = buffer;
+}
+
+// FUNCTION     : endLogCapture
+// DESCRIPTION  : Writes the lines the calling thread logs from now on to the log file again.
+// PARAMETERS   : None
+// RETURNS      : void
+void endLogCapture(void) {
+  capturedLog = NULL;
+}
+
+// FUNCTION     : flushLogBuffer
+// DESCRIPTION  : Appends the lines held in a buffer to the log file in one write and frees them.
+//                If the calling thread is capturing, the lines go to its own buffer instead.
+// PARAMETERS   :
+//   buffer     : The buffer, no longer capturing
+// RETURNS      : void
+void flushLogBuffer(LogBuffer* buffer) {
+  if (buffer->size > 0 && !captureLogLine("%.*s", (int)buffer->size, buffer->text)) {
+    AcquireSRWLockExclusive(&logLock);
+    FILE* file = fopen(LOG_FILE, "a");
+    if (file) {
+      fwrite(buffer->text, 1, buffer->size, file);
+      fclose(file);
+    }
+    ReleaseSRWLockExclusive(&logLock);
+  }
+  free(buffer->text);
+  buffer->text = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
 }
 
 // FUNCTION     : clearLog
@@ -65,8 +170,10 @@ void logGeneric(const char* message) {
 // PARAMETERS   : None
 // RETURNS      : void
 void clearLog() {
+  AcquireSRWLockExclusive(&logLock);
   FILE* file = fopen(LOG_FILE, "w");  // Open the file in write mode (truncates it)
   if (file) {
     fclose(file);  // Close immediately to save empty file
   }
+  ReleaseSRWLockExclusive(&logLock);
 }
@@ -3,6 +3,8 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <stddef.h>
+
 // Logs an error for a specific record like Customer, Part, or Order
 void logError(const char* sourceType, int id, const char* fieldName, const char* message);
 
@@ -12,4 +14,18 @@ void logGeneric(const char* message);
 // Clears the content of the log file empties runtime_log.txt
 void clearLog();
 
+// Log lines held back by a thread so they can be written after other threads' lines
+typedef struct {
+  char* text; // Formatted lines, each ending with '\n'
+  size_t size;
+  size_t capacity;
+} LogBuffer;
+
+// Holds the lines the calling thread logs in the buffer until endLogCapture
+void beginLogCapture(LogBuffer* buffer);
+void endLogCapture(void);
+
+// Writes the held lines to the log file, or to the calling thread's capture, and frees them
+void flushLogBuffer(LogBuffer* buffer);
+
 #endif
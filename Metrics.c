@@ -0,0 +1,165 @@
+// FILE : Metrics.c
+// DESCRIPTION :
+//    Implements the load instrumentation. Stage timings are taken with the timestamp counter (rdtsc)
+//    and converted to seconds when written, by comparing the ticks elapsed since initMetrics with
+//    the monotonic performance counter. Counters are updated with interlocked adds so shard loads
+//    on worker threads can record at the same time. The results are written as a Prometheus text file.
+#include "Metrics.h"
+
+#if METRICS_ENABLED
+#include "Logger.h"
+#include <windows.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  volatile LONG64 ticks;
+  volatile LONG64 calls;
+  volatile LONG64 buckets[METRIC_LATENCY_BUCKETS];
+} StageMetrics;
+
+static StageMetrics stageMetrics[STAGE_COUNT];
+static volatile LONG64 linesRead[METRIC_SOURCE_COUNT];
+static volatile LONG64 linesAccepted[METRIC_SOURCE_COUNT];
+static volatile LONG64 fieldErrors[METRIC_SOURCE_COUNT][METRIC_FIELD_SLOTS];
+static LARGE_INTEGER startCounter;
+static unsigned long long startTicks;
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = { "read_line", "split_line", "validate", "parse", "log" };
+static const char* const SOURCE_NAMES[METRIC_SOURCE_COUNT] = { "customers", "parts", "orders" };
+
+// FUNCTION : initMetrics
+// DESCRIPTION :
+//    Clears all metrics and records the reference point used to convert ticks to seconds.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void initMetrics() {
+  memset((void*)stageMetrics, 0, sizeof(stageMetrics));
+  memset((void*)linesRead, 0, sizeof(linesRead));
+  memset((void*)linesAccepted, 0, sizeof(linesAccepted));
+  memset((void*)fieldErrors, 0, sizeof(fieldErrors));
+  QueryPerformanceCounter(&startCounter);
+  startTicks = __rdtsc();
+}
+
+// FUNCTION : recordStageTime
+// DESCRIPTION :
+//    Adds one timed call of a stage to its total and latency histogram.
+// PARAMETERS :
+//    MetricStage stage: The stage that was timed.
+//    unsigned long long ticks: The duration in timestamp counter ticks.
+// RETURNS :
+//    void
+void recordStageTime(MetricStage stage, unsigned long long ticks) {
+  int bucket = 0;
+  while (ticks >> (bucket + 1) != 0 && bucket < METRIC_LATENCY_BUCKETS - 1) {
+    bucket++;
+  }
+  InterlockedExchangeAdd64(&stageMetrics[stage].ticks, (LONG64)ticks);
+  InterlockedExchangeAdd64(&stageMetrics[stage].calls, 1);
+  InterlockedExchangeAdd64(&stageMetrics[stage].buckets[bucket], 1);
+}
+
+// FUNCTION : recordLines
+// DESCRIPTION :
+//    Adds the outcome of loading one file.
+// PARAMETERS :
+//    MetricSource source: The kind of file loaded.
+//    int readCount: The number of non-empty lines read.
+//    int acceptedCount: The number of records kept.
+// RETURNS :
+//    void
+void recordLines(MetricSource source, int readCount, int acceptedCount) {
+  InterlockedExchangeAdd64(&linesRead[source], readCount);
+  InterlockedExchangeAdd64(&linesAccepted[source], acceptedCount);
+}
+
+// FUNCTION : recordFieldErrors
+// DESCRIPTION :
+//    Counts each "Field #N" error in a validation message built by a validate*Fields function.
+// PARAMETERS :
+//    MetricSource source: The kind of record validated.
+//    const char* errorMessage: The validation error message.
+// RETURNS :
+//    void
+void recordFieldErrors(MetricSource source, const char* errorMessage) {
+  const char* cursor = errorMessage;
+  while ((cursor = strstr(cursor, "Field #")) != NULL) {
+    cursor += strlen("Field #");
+    int field = atoi(cursor);
+    if (field >= METRIC_FIELD_SLOTS || (source == METRIC_SOURCE_ORDERS && field > 8)) {
+      field = source == METRIC_SOURCE_ORDERS ? 8 : 0; // Ordered parts fields, or unknown fields in slot 0
+    }
+    InterlockedExchangeAdd64(&fieldErrors[source][field < 0 ? 0 : field], 1);
+  }
+}
+
+// FUNCTION : writeMetricsFile
+// DESCRIPTION :
+//    Writes all metrics in the Prometheus text exposition format.
+// PARAMETERS :
+//    const char* fileName: The file to write.
+// RETURNS :
+//    int : 1 on success, 0 if the file could not be written.
+int writeMetricsFile(const char* fileName) {
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER nowCounter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&nowCounter);
+  double elapsedSeconds = (double)(nowCounter.QuadPart - startCounter.QuadPart) / (double)frequency.QuadPart;
+  double secondsPerTick = elapsedSeconds > 0.0 ? elapsedSeconds / (double)(__rdtsc() - startTicks) : 0.0;
+
+  FILE* file = NULL;
+  errno_t err = fopen_s(&file, fileName, "w");
+  if (err != 0 || file == NULL) {
+    logGeneric("Failed to write the metrics file.");
+    return 0;
+  }
+  fprintf(file, "# HELP sef_stage_seconds_total Time spent in each load stage.\n");
+  fprintf(file, "# TYPE sef_stage_seconds_total counter\n");
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    fprintf(file, "sef_stage_seconds_total{stage=\"%s\"} %.9f\n", STAGE_NAMES[s], stageMetrics[s].ticks * secondsPerTick);
+  }
+  fprintf(file, "# HELP sef_stage_latency_seconds Latency of one call of each load stage.\n");
+  fprintf(file, "# TYPE sef_stage_latency_seconds histogram\n");
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    long long cumulative = 0;
+    // Only the buckets from the first to the last non-empty one are written, the others add nothing
+    for (int b = 0; b < METRIC_LATENCY_BUCKETS && cumulative < stageMetrics[s].calls; b++) {
+      if (stageMetrics[s].buckets[b] == 0 && cumulative == 0) {
+        continue;
+      }
+      cumulative += stageMetrics[s].buckets[b];
+      fprintf(file, "sef_stage_latency_seconds_bucket{stage=\"%s\",le=\"%.9g\"} %lld\n", STAGE_NAMES[s],
+        (double)(2ULL << b) * secondsPerTick, cumulative);
+    }
+    fprintf(file, "sef_stage_latency_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %lld\n", STAGE_NAMES[s], (long long)stageMetrics[s].calls);
+    fprintf(file, "sef_stage_latency_seconds_sum{stage=\"%s\"} %.9f\n", STAGE_NAMES[s], stageMetrics[s].ticks * secondsPerTick);
+    fprintf(file, "sef_stage_latency_seconds_count{stage=\"%s\"} %lld\n", STAGE_NAMES[s], (long long)stageMetrics[s].calls);
+  }
+  fprintf(file, "# HELP sef_lines_total Non-empty lines read from each database, by outcome.\n");
+  fprintf(file, "# TYPE sef_lines_total counter\n");
+  for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+    fprintf(file, "sef_lines_total{source=\"%s\",result=\"read\"} %lld\n", SOURCE_NAMES[source], (long long)linesRead[source]);
+    fprintf(file, "sef_lines_total{source=\"%s\",result=\"accepted\"} %lld\n", SOURCE_NAMES[source], (long long)linesAccepted[source]);
+    fprintf(file, "sef_lines_total{source=\"%s\",result=\"rejected\"} %lld\n", SOURCE_NAMES[source],
+      (long long)(linesRead[source] - linesAccepted[source]));
+  }
+  fprintf(file, "# HELP sef_field_errors_total Validation errors per database field (field 0 = unknown, order field 8 = ordered parts).\n");
+  fprintf(file, "# TYPE sef_field_errors_total counter\n");
+  for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+    for (int field = 0; field < METRIC_FIELD_SLOTS; field++) {
+      if (fieldErrors[source][field] > 0) {
+        fprintf(file, "sef_field_errors_total{source=\"%s\",field=\"%d\"} %lld\n", SOURCE_NAMES[source], field,
+          (long long)fieldErrors[source][field]);
+      }
+    }
+  }
+  fclose(file);
+  return 1;
+}
+#endif
@@ -0,0 +1,52 @@
+// FILE : Metrics.h
+// DESCRIPTION : This header file defines the load instrumentation: per-stage timers, line and field error counters, and latency histograms.
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 1 // Build with /DMETRICS_ENABLED=0 to compile all instrumentation out
+#endif
+
+typedef enum {
+  STAGE_READ_LINE, // fgets
+  STAGE_SPLIT_LINE, // splitLine
+  STAGE_VALIDATE, // validate*Fields
+  STAGE_PARSE, // parseFieldsTo*
+  STAGE_LOG, // logError and logGeneric
+  STAGE_COUNT
+} MetricStage;
+
+typedef enum {
+  METRIC_SOURCE_CUSTOMERS,
+  METRIC_SOURCE_PARTS,
+  METRIC_SOURCE_ORDERS,
+  METRIC_SOURCE_COUNT
+} MetricSource;
+
+#define METRIC_FIELD_SLOTS 13 // Slots 1-12 count "Field #N" errors; order fields from #8 on (ordered parts) share slot 8
+#define METRIC_LATENCY_BUCKETS 40 // Bucket b counts calls taking [2^b, 2^(b+1)) timestamp counter ticks
+
+#if METRICS_ENABLED
+#include <intrin.h>
+#define METRIC_INIT() initMetrics()
+#define METRIC_TIMER_START(timer) unsigned long long timer = __rdtsc()
+#define METRIC_TIMER_STOP(stage, timer) recordStageTime((stage), __rdtsc() - (timer))
+#define METRIC_LINES(source, readCount, acceptedCount) recordLines((source), (readCount), (acceptedCount))
+#define METRIC_FIELD_ERRORS(source, errorMessage) recordFieldErrors((source), (errorMessage))
+#define METRIC_WRITE(fileName) writeMetricsFile(fileName)
+
+void initMetrics();
+void recordStageTime(MetricStage stage, unsigned long long ticks);
+void recordLines(MetricSource source, int readCount, int acceptedCount);
+void recordFieldErrors(MetricSource source, const char* errorMessage);
+int writeMetricsFile(const char* fileName);
+#else
+#define METRIC_INIT() ((void)0)
+#define METRIC_TIMER_START(timer) ((void)0)
+#define METRIC_TIMER_STOP(stage, timer) ((void)0)
+#define METRIC_LINES(source, readCount, acceptedCount) ((void)0)
+#define METRIC_FIELD_ERRORS(source, errorMessage) ((void)0)
+#define METRIC_WRITE(fileName) ((void)0)
+#endif
+
+#endif
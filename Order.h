@@ -12,6 +12,7 @@ typedef struct {
 typedef struct {
   long long orderID; // Mandatory, format YYYYMMDDSSS as int (e.g., 20241113034)
   char orderDate[11]; // Mandatory, YYYY-MM-DD format 
+  int orderDay; // orderDate as a day number (days since 2000-01-01)
   int orderStatus; // Mandatory, 0 (unprocessed), 1 (fulfilled), 99 (insufficient parts), 500 (credit exceeded)
   int customerID; // Mandatory, > 0 (must link to existing customer)
   float orderTotal; // Mandatory, > 0.00
@@ -0,0 +1,105 @@
+// FILE : OrderId.c
+// DESCRIPTION :
+//    Implements the order ID allocator. Each day keeps its own sequence counter, bumped with an
+//    interlocked increment, so several threads can create orders at the same time without
+//    handing out the same YYYYMMDDSSS ID twice.
+#include "OrderId.h"
+#include "DateIndex.h"
+#include "Logger.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// FUNCTION : initOrderIdAllocator
+// DESCRIPTION :
+//    Creates an allocator with no sequence numbers used on any day.
+// PARAMETERS :
+//    OrderIdAllocator* allocator: The allocator to initialize.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initOrderIdAllocator(OrderIdAllocator* allocator) {
+  allocator->daySequences = (volatile long*)calloc(DAY_NUMBER_COUNT, sizeof(long));
+  if (allocator->daySequences == NULL) {
+    logGeneric("Failed to allocate memory for the order ID allocator.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : resetOrderIdAllocator
+// DESCRIPTION :
+//    Forgets every sequence number used so far. Called before the orders are reloaded.
+// PARAMETERS :
+//    OrderIdAllocator* allocator: The allocator to reset.
+// RETURNS :
+//    void
+void resetOrderIdAllocator(OrderIdAllocator* allocator) {
+  for (int day = 0; day < DAY_NUMBER_COUNT; day++) {
+    allocator->daySequences[day] = 0;
+  }
+}
+
+// FUNCTION : noteOrderID
+// DESCRIPTION :
+//    Records that an existing order uses its sequence number, so it is never allocated again.
+//    The order ID must already be checked against orderDate. An order dated outside the days the
+//    allocator covers is ignored.
+// PARAMETERS :
+//    OrderIdAllocator* allocator: The allocator.
+//    const Order* order: The loaded order.
+// RETURNS :
+//    void
+void noteOrderID(OrderIdAllocator* allocator, const Order* order) {
+  if (order->orderDay < 0 || order->orderDay >= DAY_NUMBER_COUNT) {
+    return;
+  }
+  long sequence = (long)(order->orderID % 1000);
+  volatile long* daySequence = &allocator->daySequences[order->orderDay];
+  long current = *daySequence;
+  // Raise the counter to the sequence unless another thread already raised it further
+  while (current < sequence) {
+    long previous = InterlockedCompareExchange((volatile LONG*)daySequence, sequence, current);
+    if (previous == current) {
+      break;
+    }
+    current = previous;
+  }
+}
+
+// FUNCTION : allocateOrderID
+// DESCRIPTION :
+//    Hands out the next unused order ID for a day. Safe to call from several threads at once.
+// PARAMETERS :
+//    OrderIdAllocator* allocator: The allocator.
+//    int dayNumber: The order date as a day number.
+// RETURNS :
+//    long long : The new order ID, or 0 if the day is out of range or all 999 sequences are used.
+long long allocateOrderID(OrderIdAllocator* allocator, int dayNumber) {
+  if (dayNumber < 0 || dayNumber >= DAY_NUMBER_COUNT) {
+    return 0;
+  }
+  long sequence = InterlockedIncrement((volatile LONG*)&allocator->daySequences[dayNumber]);
+  char date[11];
+  dayNumberToDate(dayNumber, date, sizeof(date));
+  if (sequence > ORDER_SEQUENCE_LIMIT) {
+    char errorMessage[100];
+    snprintf(errorMessage, sizeof(errorMessage), "No order IDs left for %s.", date);
+    logGeneric(errorMessage);
+    return 0;
+  }
+  long long yearMonthDay = ((date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0')) * 10000LL
+    + ((date[5] - '0') * 10 + (date[6] - '0')) * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+  return yearMonthDay * 1000 + sequence;
+}
+
+// FUNCTION : freeOrderIdAllocator
+// DESCRIPTION :
+//    Frees the memory held by the allocator.
+// PARAMETERS :
+//    OrderIdAllocator* allocator: The allocator to free.
+// RETURNS :
+//    void
+void freeOrderIdAllocator(OrderIdAllocator* allocator) {
+  free((void*)allocator->daySequences);
+  allocator->daySequences = NULL;
+}
@@ -0,0 +1,20 @@
+// FILE : OrderId.h
+// DESCRIPTION : This header file defines the allocator for new YYYYMMDDSSS order IDs.
+#ifndef ORDERID_H
+#define ORDERID_H
+
+#include "Order.h"
+
+#define ORDER_SEQUENCE_LIMIT 999 // Largest SSS part of an order ID
+
+typedef struct {
+  volatile long* daySequences; // Last sequence number used on each day, indexed by day number
+} OrderIdAllocator;
+
+int initOrderIdAllocator(OrderIdAllocator* allocator);
+void resetOrderIdAllocator(OrderIdAllocator* allocator);
+void noteOrderID(OrderIdAllocator* allocator, const Order* order);
+long long allocateOrderID(OrderIdAllocator* allocator, int dayNumber);
+void freeOrderIdAllocator(OrderIdAllocator* allocator);
+
+#endif
@@ -0,0 +1,101 @@
+// FILE : OrderStore.c
+// DESCRIPTION :
+//    Implements the paged order store. Orders are appended to a PageStore and only their orderIDs
+//    stay in memory, in an IdIndex giving the record number of each order, so a lookup by orderID
+//    reads at most the one page holding the order.
+#include "OrderStore.h"
+#include "Logger.h"
+#include <string.h>
+
+// FUNCTION : openOrderStore
+// DESCRIPTION :
+//    Creates an empty order store in a new page file.
+// PARAMETERS :
+//    OrderStore* store: The store to set up.
+//    const char* fileName: The page file.
+//    int frameCount: Pages of orders held in memory at most.
+// RETURNS :
+//    int : 1 if the store is ready, 0 on failure.
+int openOrderStore(OrderStore* store, const char* fileName, int frameCount) {
+  memset(store, 0, sizeof(OrderStore));
+  if (!openPageStore(&store->pages, fileName, sizeof(Order), frameCount)) {
+    return 0;
+  }
+  if (!initIdIndex(&store->orderIds, 0)) {
+    logGeneric("Failed to allocate memory for the order store index.");
+    closePageStore(&store->pages);
+    return 0;
+  }
+  store->isOpen = 1;
+  return 1;
+}
+
+// FUNCTION : addStoredOrder
+// DESCRIPTION :
+//    Appends an order to the store. An order whose orderID is already stored is not added.
+// PARAMETERS :
+//    OrderStore* store: The store.
+//    const Order* order: The order.
+// RETURNS :
+//    int : 1 if the order was added, 0 if its orderID is already stored, -1 on failure.
+int addStoredOrder(OrderStore* store, const Order* order) {
+  if (findIdIndex(&store->orderIds, order->orderID) != ID_INDEX_NOT_FOUND) {
+    return 0;
+  }
+  int recordNumber = appendPageRecord(&store->pages, order);
+  if (recordNumber < 0) {
+    return -1;
+  }
+  if (!setIdIndex(&store->orderIds, order->orderID, recordNumber)) {
+    logGeneric("Failed to allocate memory for the order store index.");
+    return -1;
+  }
+  return 1;
+}
+
+// FUNCTION : findStoredOrder
+// DESCRIPTION :
+//    Reads the order with an orderID, faulting in only the page that holds it.
+// PARAMETERS :
+//    OrderStore* store: The store.
+//    long long orderID: The order to find.
+//    Order* order: Receives the order.
+// RETURNS :
+//    int : 1 if the order was found, 0 if it is not stored or could not be read.
+int findStoredOrder(OrderStore* store, long long orderID, Order* order) {
+  if (!store->isOpen) {
+    return 0;
+  }
+  int recordNumber = findIdIndex(&store->orderIds, orderID);
+  if (recordNumber == ID_INDEX_NOT_FOUND) {
+    return 0;
+  }
+  return readPageRecord(&store->pages, recordNumber, order);
+}
+
+// FUNCTION : countStoredOrders
+// DESCRIPTION :
+//    Counts the orders in the store.
+// PARAMETERS :
+//    const OrderStore* store: The store.
+// RETURNS :
+//    int : The number of orders stored.
+int countStoredOrders(const OrderStore* store) {
+  return store->isOpen ? store->pages.recordCount : 0;
+}
+
+// FUNCTION : closeOrderStore
+// DESCRIPTION :
+//    Frees the index and buffer pool and deletes the page file.
+// PARAMETERS :
+//    OrderStore* store: The store.
+// RETURNS :
+//    void
+void closeOrderStore(OrderStore* store) {
+  if (!store->isOpen) {
+    return;
+  }
+  closePageStore(&store->pages);
+  freeIdIndex(&store->orderIds);
+  store->isOpen = 0;
+}
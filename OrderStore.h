@@ -0,0 +1,22 @@
+// FILE : OrderStore.h
+// DESCRIPTION : This header file defines the order history kept in a paged store on disk, found by orderID through an in-memory index.
+#ifndef ORDER_STORE_H
+#define ORDER_STORE_H
+
+#include "Order.h"
+#include "PageStore.h"
+#include "Index.h"
+
+typedef struct {
+  PageStore pages; // Order records, PAGE_POOL_FRAMES pages of them in memory at most
+  IdIndex orderIds; // orderID -> record number in pages
+  int isOpen;
+} OrderStore;
+
+int openOrderStore(OrderStore* store, const char* fileName, int frameCount);
+int addStoredOrder(OrderStore* store, const Order* order);
+int findStoredOrder(OrderStore* store, long long orderID, Order* order);
+int countStoredOrders(const OrderStore* store);
+void closeOrderStore(OrderStore* store);
+
+#endif
@@ -0,0 +1,291 @@
+// FILE : PageStore.c
+// DESCRIPTION :
+//    Implements the paged record store. Records of one fixed size are packed into pages of
+//    PAGE_STORE_PAGE_BYTES in a work file, record n in page n / recordsPerPage, and only the pages
+//    held by the buffer pool are in memory. The pool has a fixed number of frames, so the memory
+//    used does not grow with the number of records. When a page is needed and every frame is taken,
+//    a frame is chosen with the CLOCK algorithm, an approximation of LRU: the hand sweeps the frames
+//    and clears their reference bits, and takes the first frame that was not used since the hand
+//    last passed it. Changed pages are written back when they leave the pool.
+//    The work file is deleted when the store is closed.
+#include "PageStore.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : transferPage
+// DESCRIPTION :
+//    Reads or writes one whole page of the work file at its offset.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    int pageNumber: The page.
+//    char* data: The page in memory.
+//    int isWrite: 1 to write the page, 0 to read it.
+// RETURNS :
+//    int : 1 if the whole page was transferred, 0 otherwise.
+static int transferPage(PageStore* store, int pageNumber, char* data, int isWrite) {
+  long long offset = (long long)pageNumber * PAGE_STORE_PAGE_BYTES;
+  OVERLAPPED request = { 0 };
+  request.Offset = (DWORD)(offset & 0xFFFFFFFF);
+  request.OffsetHigh = (DWORD)(offset >> 32);
+  DWORD transferred = 0;
+  BOOL isDone = isWrite ? WriteFile((HANDLE)store->file, data, PAGE_STORE_PAGE_BYTES, &transferred, &request)
+    : ReadFile((HANDLE)store->file, data, PAGE_STORE_PAGE_BYTES, &transferred, &request);
+  if (!isDone || transferred != PAGE_STORE_PAGE_BYTES) {
+    logGeneric(isWrite ? "Failed to write a page of the page store." : "Failed to read a page of the page store.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : evictFrame
+// DESCRIPTION :
+//    Empties a frame, writing its page back first if it changed.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    int frameIndex: The frame.
+// RETURNS :
+//    int : 1 if the frame is free, 0 if its page could not be written back.
+static int evictFrame(PageStore* store, int frameIndex) {
+  PageFrame* frame = &store->frames[frameIndex];
+  if (frame->pageNumber == PAGE_FRAME_FREE) {
+    return 1;
+  }
+  if (frame->isDirty) {
+    if (!transferPage(store, frame->pageNumber, store->frameData + (size_t)frameIndex * PAGE_STORE_PAGE_BYTES, 1)) {
+      return 0;
+    }
+    store->writeBacks++;
+    frame->isDirty = 0;
+  }
+  store->pageFrames[frame->pageNumber] = PAGE_NOT_CACHED;
+  frame->pageNumber = PAGE_FRAME_FREE;
+  return 1;
+}
+
+// FUNCTION : chooseVictimFrame
+// DESCRIPTION :
+//    Advances the clock hand to the first free frame, or the first frame not used since the hand
+//    last passed it, clearing the reference bits it passes over.
+// PARAMETERS :
+//    PageStore* store: The store.
+// RETURNS :
+//    int : The frame to reuse.
+static int chooseVictimFrame(PageStore* store) {
+  for (;;) {
+    int frameIndex = store->clockHand;
+    PageFrame* frame = &store->frames[frameIndex];
+    store->clockHand = (store->clockHand + 1) % store->frameCount;
+    if (frame->pageNumber == PAGE_FRAME_FREE || !frame->isReferenced) {
+      return frameIndex;
+    }
+    frame->isReferenced = 0; // Second chance
+  }
+}
+
+// FUNCTION : fixPage
+// DESCRIPTION :
+//    Finds the frame holding a page, bringing the page into the pool if it is not there. A page past
+//    the last one is started empty instead of being read.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    int pageNumber: The page, at most pageCount.
+// RETURNS :
+//    char* : The page in memory, or NULL if it could not be brought in.
+static char* fixPage(PageStore* store, int pageNumber) {
+  int frameIndex = pageNumber < store->pageCount ? store->pageFrames[pageNumber] : PAGE_NOT_CACHED;
+  if (frameIndex != PAGE_NOT_CACHED) {
+    store->hits++;
+    store->frames[frameIndex].isReferenced = 1;
+    return store->frameData + (size_t)frameIndex * PAGE_STORE_PAGE_BYTES;
+  }
+  if (pageNumber >= store->pageCapacity) {
+    int capacity = store->pageCapacity > 0 ? store->pageCapacity * 2 : 1024;
+    int* pageFrames = (int*)realloc(store->pageFrames, (size_t)capacity * sizeof(int));
+    if (pageFrames == NULL) {
+      logGeneric("Failed to allocate memory for the page table of the page store.");
+      return NULL;
+    }
+    store->pageFrames = pageFrames;
+    store->pageCapacity = capacity;
+  }
+  store->faults++;
+  frameIndex = chooseVictimFrame(store);
+  if (!evictFrame(store, frameIndex)) {
+    return NULL;
+  }
+  char* data = store->frameData + (size_t)frameIndex * PAGE_STORE_PAGE_BYTES;
+  PageFrame* frame = &store->frames[frameIndex];
+  if (pageNumber < store->pageCount) {
+    if (!transferPage(store, pageNumber, data, 0)) {
+      return NULL;
+    }
+    frame->isDirty = 0;
+  }
+  else {
+    memset(data, 0, PAGE_STORE_PAGE_BYTES);
+    frame->isDirty = 1; // Not on disk yet
+    store->pageCount = pageNumber + 1;
+  }
+  frame->pageNumber = pageNumber;
+  frame->isReferenced = 1;
+  store->pageFrames[pageNumber] = frameIndex;
+  return data;
+}
+
+// FUNCTION : openPageStore
+// DESCRIPTION :
+//    Creates an empty store in a new work file, replacing any file of that name.
+// PARAMETERS :
+//    PageStore* store: The store to set up.
+//    const char* fileName: The work file.
+//    size_t recordSize: The size of each record, at most PAGE_STORE_PAGE_BYTES.
+//    int frameCount: Pages held in memory at most.
+// RETURNS :
+//    int : 1 if the store is ready, 0 on failure.
+int openPageStore(PageStore* store, const char* fileName, size_t recordSize, int frameCount) {
+  memset(store, 0, sizeof(PageStore));
+  store->file = INVALID_HANDLE_VALUE;
+  if (recordSize == 0 || recordSize > PAGE_STORE_PAGE_BYTES || frameCount <= 0) {
+    logGeneric("Invalid record size or buffer pool size for the page store.");
+    return 0;
+  }
+  store->recordSize = recordSize;
+  store->recordsPerPage = (int)(PAGE_STORE_PAGE_BYTES / recordSize);
+  store->frameCount = frameCount;
+  // Pages are page aligned, so the file could also be opened with FILE_FLAG_NO_BUFFERING
+  store->frameData = (char*)VirtualAlloc(NULL, (SIZE_T)frameCount * PAGE_STORE_PAGE_BYTES, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  store->frames = (PageFrame*)malloc((size_t)frameCount * sizeof(PageFrame));
+  if (store->frameData == NULL || store->frames == NULL) {
+    logGeneric("Failed to allocate the buffer pool of the page store.");
+    closePageStore(store);
+    return 0;
+  }
+  for (int i = 0; i < frameCount; i++) {
+    store->frames[i].pageNumber = PAGE_FRAME_FREE;
+    store->frames[i].isReferenced = 0;
+    store->frames[i].isDirty = 0;
+  }
+  store->file = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+    FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_RANDOM_ACCESS | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+  if (store->file == INVALID_HANDLE_VALUE) {
+    char errorMessage[300];
+    snprintf(errorMessage, sizeof(errorMessage), "Failed to create the page file %s.", fileName);
+    logGeneric(errorMessage);
+    closePageStore(store);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : appendPageRecord
+// DESCRIPTION :
+//    Adds a record after the last one.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    const void* record: The record, recordSize bytes.
+// RETURNS :
+//    int : The record number, or -1 on failure.
+int appendPageRecord(PageStore* store, const void* record) {
+  int recordNumber = store->recordCount;
+  char* page = fixPage(store, recordNumber / store->recordsPerPage);
+  if (page == NULL) {
+    return -1;
+  }
+  memcpy(page + (size_t)(recordNumber % store->recordsPerPage) * store->recordSize, record, store->recordSize);
+  store->frames[store->pageFrames[recordNumber / store->recordsPerPage]].isDirty = 1;
+  store->recordCount++;
+  return recordNumber;
+}
+
+// FUNCTION : readPageRecord
+// DESCRIPTION :
+//    Copies a record out of its page, faulting the page in if it is not in the pool.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    int recordNumber: The record.
+//    void* record: Receives the record, recordSize bytes.
+// RETURNS :
+//    int : 1 if the record was read, 0 if it does not exist or its page could not be read.
+int readPageRecord(PageStore* store, int recordNumber, void* record) {
+  if (recordNumber < 0 || recordNumber >= store->recordCount) {
+    return 0;
+  }
+  char* page = fixPage(store, recordNumber / store->recordsPerPage);
+  if (page == NULL) {
+    return 0;
+  }
+  memcpy(record, page + (size_t)(recordNumber % store->recordsPerPage) * store->recordSize, store->recordSize);
+  return 1;
+}
+
+// FUNCTION : writePageRecord
+// DESCRIPTION :
+//    Replaces a record in its page, faulting the page in if it is not in the pool. The page is
+//    written to disk when it leaves the pool or the store is flushed.
+// PARAMETERS :
+//    PageStore* store: The store.
+//    int recordNumber: The record.
+//    const void* record: The new record, recordSize bytes.
+// RETURNS :
+//    int : 1 if the record was replaced, 0 if it does not exist or its page could not be read.
+int writePageRecord(PageStore* store, int recordNumber, const void* record) {
+  if (recordNumber < 0 || recordNumber >= store->recordCount) {
+    return 0;
+  }
+  char* page = fixPage(store, recordNumber / store->recordsPerPage);
+  if (page == NULL) {
+    return 0;
+  }
+  memcpy(page + (size_t)(recordNumber % store->recordsPerPage) * store->recordSize, record, store->recordSize);
+  store->frames[store->pageFrames[recordNumber / store->recordsPerPage]].isDirty = 1;
+  return 1;
+}
+
+// FUNCTION : flushPageStore
+// DESCRIPTION :
+//    Writes every changed page in the pool to disk. The pages stay in the pool.
+// PARAMETERS :
+//    PageStore* store: The store.
+// RETURNS :
+//    int : 1 if all pages were written, 0 otherwise.
+int flushPageStore(PageStore* store) {
+  int isSuccessful = 1;
+  for (int i = 0; i < store->frameCount; i++) {
+    PageFrame* frame = &store->frames[i];
+    if (frame->pageNumber == PAGE_FRAME_FREE || !frame->isDirty) {
+      continue;
+    }
+    if (transferPage(store, frame->pageNumber, store->frameData + (size_t)i * PAGE_STORE_PAGE_BYTES, 1)) {
+      store->writeBacks++;
+      frame->isDirty = 0;
+    }
+    else {
+      isSuccessful = 0;
+    }
+  }
+  return isSuccessful;
+}
+
+// FUNCTION : closePageStore
+// DESCRIPTION :
+//    Frees the buffer pool and closes the work file, which deletes it.
+// PARAMETERS :
+//    PageStore* store: The store.
+// RETURNS :
+//    void
+void closePageStore(PageStore* store) {
+  if (store->file != NULL && store->file != INVALID_HANDLE_VALUE) {
+    CloseHandle((HANDLE)store->file);
+  }
+  if (store->frameData != NULL) {
+    VirtualFree(store->frameData, 0, MEM_RELEASE);
+  }
+  free(store->frames);
+  free(store->pageFrames);
+  memset(store, 0, sizeof(PageStore));
+  store->file = INVALID_HANDLE_VALUE;
+}
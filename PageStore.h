@@ -0,0 +1,41 @@
+// FILE : PageStore.h
+// DESCRIPTION : This header file defines the disk-backed store of fixed-size records kept in fixed-size pages, and the buffer pool caching those pages.
+#ifndef PAGE_STORE_H
+#define PAGE_STORE_H
+
+#include <stddef.h>
+
+#define PAGE_NOT_CACHED -1 // Page has no frame in the buffer pool
+#define PAGE_FRAME_FREE -1 // Frame holds no page
+
+typedef struct {
+  int pageNumber; // Page in the frame, PAGE_FRAME_FREE if none
+  int isReferenced; // Set on each use, cleared as the clock hand passes
+  int isDirty; // 1 if the frame changed since it was read, so it is written back on eviction
+} PageFrame;
+
+typedef struct {
+  void* file; // HANDLE of the page file
+  size_t recordSize;
+  int recordsPerPage;
+  int recordCount;
+  int pageCount; // Pages holding records, on disk or only in the pool so far
+  int* pageFrames; // Frame of each page, PAGE_NOT_CACHED if it is only on disk
+  int pageCapacity; // Entries allocated in pageFrames
+  char* frameData; // frameCount pages of PAGE_STORE_PAGE_BYTES
+  PageFrame* frames;
+  int frameCount;
+  int clockHand; // Next frame considered for eviction
+  long long hits; // Record reads and writes whose page was in the pool
+  long long faults; // Record reads and writes that had to bring their page into the pool
+  long long writeBacks; // Dirty pages written to disk
+} PageStore;
+
+int openPageStore(PageStore* store, const char* fileName, size_t recordSize, int frameCount);
+int appendPageRecord(PageStore* store, const void* record);
+int readPageRecord(PageStore* store, int recordNumber, void* record);
+int writePageRecord(PageStore* store, int recordNumber, const void* record);
+int flushPageStore(PageStore* store);
+void closePageStore(PageStore* store);
+
+#endif
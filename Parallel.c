@@ -0,0 +1,82 @@
+// FILE : Parallel.c
+// DESCRIPTION :
+//    Implements a small fork/join helper on top of Windows threads.
+//    Each worker receives its own argument block, and the call returns once all workers finished.
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <process.h>
+
+// FUNCTION : getWorkerCount
+// DESCRIPTION :
+//    Chooses how many workers to use for a pass over itemCount items.
+//    Small inputs run on the calling thread, since starting threads would cost more than the work.
+// PARAMETERS :
+//    int itemCount: The number of items the pass will process.
+// RETURNS :
+//    int : The number of workers, between 1 and MAX_WORKER_THREADS.
+int getWorkerCount(int itemCount) {
+  if (itemCount < PARALLEL_MIN_ITEMS) {
+    return 1;
+  }
+  int workerCount = getTaskWorkerCount(MAX_WORKER_THREADS);
+  if (workerCount > itemCount / (PARALLEL_MIN_ITEMS / 4)) {
+    workerCount = itemCount / (PARALLEL_MIN_ITEMS / 4); // Keep enough items per worker
+  }
+  return workerCount < 1 ? 1 : workerCount;
+}
+
+// FUNCTION : getTaskWorkerCount
+// DESCRIPTION :
+//    Chooses how many workers to use for taskCount independent tasks that are each worth a thread
+//    (e.g. loading one file), regardless of how many records they hold.
+// PARAMETERS :
+//    int taskCount: The number of tasks.
+// RETURNS :
+//    int : The number of workers, between 1 and the smaller of taskCount, the processor count and MAX_WORKER_THREADS.
+int getTaskWorkerCount(int taskCount) {
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  int workerCount = (int)systemInfo.dwNumberOfProcessors;
+  if (workerCount > MAX_WORKER_THREADS) {
+    workerCount = MAX_WORKER_THREADS;
+  }
+  if (workerCount > taskCount) {
+    workerCount = taskCount;
+  }
+  return workerCount < 1 ? 1 : workerCount;
+}
+
+// FUNCTION : runWorkers
+// DESCRIPTION :
+//    Runs worker once per argument block, using workerCount - 1 new threads plus the calling thread,
+//    and waits for all of them. A worker whose thread cannot be started runs on the calling thread.
+// PARAMETERS :
+//    WorkerFunction worker: The function to run.
+//    void* arguments: Array of workerCount argument blocks.
+//    size_t argumentSize: The size of one argument block.
+//    int workerCount: The number of workers (at most MAX_WORKER_THREADS).
+// RETURNS :
+//    void
+void runWorkers(WorkerFunction worker, void* arguments, size_t argumentSize, int workerCount) {
+  HANDLE threads[MAX_WORKER_THREADS];
+  int threadCount = 0;
+  char* argumentBytes = (char*)arguments;
+  for (int i = 1; i < workerCount; i++) {
+    HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, worker, argumentBytes + i * argumentSize, 0, NULL);
+    if (thread == 0) {
+      logGeneric("Failed to start a worker thread, running its work on the calling thread.");
+      worker(argumentBytes + i * argumentSize);
+      continue;
+    }
+    threads[threadCount++] = thread;
+  }
+  worker(argumentBytes);
+  if (threadCount > 0) {
+    WaitForMultipleObjects((DWORD)threadCount, threads, TRUE, INFINITE);
+  }
+  for (int i = 0; i < threadCount; i++) {
+    CloseHandle(threads[i]);
+  }
+}
@@ -0,0 +1,14 @@
+// FILE : Parallel.h
+// DESCRIPTION : This header file defines helpers for running a function on several worker threads.
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+typedef unsigned (__stdcall *WorkerFunction)(void* argument);
+
+int getWorkerCount(int itemCount);
+int getTaskWorkerCount(int taskCount);
+void runWorkers(WorkerFunction worker, void* arguments, size_t argumentSize, int workerCount);
+
+#endif
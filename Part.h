@@ -16,6 +16,9 @@ typedef struct {
       - Negative: deficit (e.g., -180 if short 180 parts for customer orders)
   */
   int partID; // Mandatory, > 0
+  unsigned long long partLocationCode; // Derived from partLocation when loaded (packed aisle, shelf, level and bin, see PickList.h)
+  int fieldState; // FIELDS_LOADED, or FIELDS_PENDING / FIELDS_INVALID for the name and number of a lazy load
+  long long lineOffset; // Byte offset of the part's line in the database, for loading the name and number lazily
 } Part;
 
 #endif 
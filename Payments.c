@@ -0,0 +1,433 @@
+// FILE : Payments.c
+// DESCRIPTION :
+//    Implements the bulk payments feed. Each line of payments.db is customerID|amount|date| and
+//    pays amount off the customer's currentAccountBalance, moving lastPaymentMade forward when the
+//    payment is newer. Instead of looking up the customer of every line, the valid payments are
+//    read into one array, sorted by customerID (then by date and line, so each customer's payments
+//    apply in the order they were made) and merge-joined with the customers sorted by customerID,
+//    so the whole feed is applied in a single pass over both.
+//    Rejected lines are logged as they are found and quarantined like those of the other databases,
+//    verbatim and in file order, once the merge is done.
+#include "Payments.h"
+#include "FileIO.h"
+#include "Validation.h"
+#include "AsyncReader.h"
+#include "Compression.h"
+#include "Quarantine.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  int customerID;
+  int position; // Position of the customer in the customers array
+} CustomerKey;
+
+typedef struct {
+  int lineNumber;
+  size_t lineStart; // Offset of the line in the text of the payment list
+  size_t reasonStart; // Offset of the reason in the text of the payment list
+} RejectedPayment;
+
+typedef struct {
+  Payment* items;
+  int count;
+  int capacity;
+  char* text; // The lines as read, and the reasons of the rejected ones, each ending with '\0'
+  size_t textSize;
+  size_t textCapacity;
+  RejectedPayment* rejected; // Quarantined in file order once the payments are applied
+  int rejectedCount;
+  int rejectedCapacity;
+} PaymentList;
+
+// FUNCTION : comparePayments
+// DESCRIPTION :
+//    qsort comparison of two payments by customerID, then by date, then by line.
+// PARAMETERS :
+//    const void* first: The first Payment.
+//    const void* second: The second Payment.
+// RETURNS :
+//    int : Negative, zero or positive as first sorts before, with or after second.
+static int comparePayments(const void* first, const void* second) {
+  const Payment* a = (const Payment*)first;
+  const Payment* b = (const Payment*)second;
+  if (a->customerID != b->customerID) {
+    return a->customerID < b->customerID ? -1 : 1;
+  }
+  if (a->paymentDay != b->paymentDay) {
+    return a->paymentDay < b->paymentDay ? -1 : 1;
+  }
+  return a->lineNumber - b->lineNumber;
+}
+
+// FUNCTION : compareCustomerKeys
+// DESCRIPTION :
+//    qsort comparison of two customer keys by customerID.
+// PARAMETERS :
+//    const void* first: The first CustomerKey.
+//    const void* second: The second CustomerKey.
+// RETURNS :
+//    int : Negative, zero or positive as first sorts before, with or after second.
+static int compareCustomerKeys(const void* first, const void* second) {
+  const CustomerKey* a = (const CustomerKey*)first;
+  const CustomerKey* b = (const CustomerKey*)second;
+  if (a->customerID != b->customerID) {
+    return a->customerID < b->customerID ? -1 : 1;
+  }
+  return a->position - b->position;
+}
+
+// FUNCTION : addPaymentText
+// DESCRIPTION :
+//    Appends a line or a reason to the text of the payment list, growing it when needed.
+// PARAMETERS :
+//    PaymentList* list: The list.
+//    const char* text: The text to keep.
+//    size_t* start: Receives the offset of the text in the list.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int addPaymentText(PaymentList* list, const char* text, size_t* start) {
+  size_t length = strlen(text) + 1;
+  if (list->textSize + length > list->textCapacity) {
+    size_t capacity = list->textCapacity > 0 ? list->textCapacity * 2 : PAYMENTS_INITIAL_LINES * 32;
+    while (capacity < list->textSize + length) {
+      capacity *= 2;
+    }
+    char* newText = (char*)realloc(list->text, capacity);
+    if (newText == NULL) {
+      return 0;
+    }
+    list->text = newText;
+    list->textCapacity = capacity;
+  }
+  memcpy(list->text + list->textSize, text, length);
+  *start = list->textSize;
+  list->textSize += length;
+  return 1;
+}
+
+// FUNCTION : addPayment
+// DESCRIPTION :
+//    Appends a payment and its line to the list, growing the list when needed.
+// PARAMETERS :
+//    PaymentList* list: The list.
+//    Payment* payment: The payment, its lineStart is set.
+//    const char* rawLine: The line of the payment as read.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int addPayment(PaymentList* list, Payment* payment, const char* rawLine) {
+  if (list->count == list->capacity) {
+    int capacity = list->capacity > 0 ? list->capacity * 2 : PAYMENTS_INITIAL_LINES;
+    Payment* items = (Payment*)realloc(list->items, (size_t)capacity * sizeof(Payment));
+    if (items == NULL) {
+      return 0;
+    }
+    list->items = items;
+    list->capacity = capacity;
+  }
+  if (!addPaymentText(list, rawLine, &payment->lineStart)) {
+    return 0;
+  }
+  list->items[list->count++] = *payment;
+  return 1;
+}
+
+// FUNCTION : addRejectedPayment
+// DESCRIPTION :
+//    Keeps a rejected line and its reason for the quarantine, growing the list when needed.
+// PARAMETERS :
+//    PaymentList* list: The list.
+//    int lineNumber: The line number of the line.
+//    size_t lineStart: Offset of the line in the text of the list.
+//    const char* reason: Why the line was rejected.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int addRejectedPayment(PaymentList* list, int lineNumber, size_t lineStart, const char* reason) {
+  if (list->rejectedCount == list->rejectedCapacity) {
+    int capacity = list->rejectedCapacity > 0 ? list->rejectedCapacity * 2 : 64;
+    RejectedPayment* rejected = (RejectedPayment*)realloc(list->rejected, (size_t)capacity * sizeof(RejectedPayment));
+    if (rejected == NULL) {
+      return 0;
+    }
+    list->rejected = rejected;
+    list->rejectedCapacity = capacity;
+  }
+  RejectedPayment* entry = &list->rejected[list->rejectedCount];
+  if (!addPaymentText(list, reason, &entry->reasonStart)) {
+    return 0;
+  }
+  entry->lineNumber = lineNumber;
+  entry->lineStart = lineStart;
+  list->rejectedCount++;
+  return 1;
+}
+
+// FUNCTION : rejectPaymentLine
+// DESCRIPTION :
+//    Keeps a line that failed its checks for the quarantine and counts it.
+// PARAMETERS :
+//    PaymentList* list: The list.
+//    const char* rawLine: The line as read.
+//    int lineNumber: The line number of the line.
+//    const char* reason: Why the line was rejected.
+//    PaymentSummary* summary: Counts the rejected line.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int rejectPaymentLine(PaymentList* list, const char* rawLine, int lineNumber, const char* reason, PaymentSummary* summary) {
+  size_t lineStart;
+  summary->rejectedCount++;
+  return addPaymentText(list, rawLine, &lineStart) && addRejectedPayment(list, lineNumber, lineStart, reason);
+}
+
+// FUNCTION : freePaymentList
+// DESCRIPTION :
+//    Frees the memory held by a payment list.
+// PARAMETERS :
+//    PaymentList* list: The list.
+// RETURNS :
+//    void
+static void freePaymentList(PaymentList* list) {
+  free(list->items);
+  free(list->text);
+  free(list->rejected);
+  memset(list, 0, sizeof(PaymentList));
+}
+
+// FUNCTION : readPaymentLines
+// DESCRIPTION :
+//    Reads and validates every line of the payments database into a list. Invalid lines are
+//    logged and kept in the list for the quarantine.
+// PARAMETERS :
+//    AsyncReader* reader: The payments database.
+//    PaymentList* list: Receives the valid payments and the invalid lines.
+//    PaymentSummary* summary: Counts the lines read and rejected.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int readPaymentLines(AsyncReader* reader, PaymentList* list, PaymentSummary* summary) {
+  char line[256];
+  char rawLine[256];
+  char* fields[NUMBER_OF_PAYMENT_FIELDS + 1];
+  char errorMessage[300];
+  char reason[1024];
+  int lineNumber = 0;
+  while (readAsyncLine(reader, line, sizeof(line)) != NULL) {
+    if (line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    lineNumber++;
+    summary->lineCount++;
+    size_t length = strlen(line);
+    if (length >= 2 && line[length - 2] == '\r' && line[length - 1] == '\n') {
+      line[--length - 1] = '\n'; // Read as binary, so "\r\n" endings are still there
+      line[length] = '\0';
+    }
+    strcpy_s(rawLine, sizeof(rawLine), line);
+    if (line[length - 1] != '\n' && length == sizeof(line) - 1) {
+      snprintf(errorMessage, sizeof(errorMessage), "In payments database line %d: Line is too long.", lineNumber);
+      logGeneric(errorMessage);
+      if (!rejectPaymentLine(list, rawLine, lineNumber, "Line is too long.", summary)) {
+        logGeneric("Failed to allocate memory for the payments.");
+        return 0;
+      }
+      while (readAsyncLine(reader, line, sizeof(line)) != NULL && line[strlen(line) - 1] != '\n') {
+      }
+      continue;
+    }
+    if (line[length - 1] == '\n') {
+      line[--length] = '\0';
+    }
+    int fieldCount = splitLine(line, fields, NUMBER_OF_PAYMENT_FIELDS, '|');
+    if (fieldCount != NUMBER_OF_PAYMENT_FIELDS) {
+      snprintf(errorMessage, sizeof(errorMessage), "In payments database line %d: Incorrect number of fields (%d expected, found %d)",
+        lineNumber, NUMBER_OF_PAYMENT_FIELDS, fieldCount);
+      logGeneric(errorMessage);
+      snprintf(reason, sizeof(reason), "Incorrect number of fields (%d expected, found %d)", NUMBER_OF_PAYMENT_FIELDS, fieldCount);
+    }
+    else if (validatePaymentFields(fields, lineNumber, reason, sizeof(reason))) {
+      reason[0] = '\0';
+    }
+    if (reason[0] != '\0') {
+      if (!rejectPaymentLine(list, rawLine, lineNumber, reason, summary)) {
+        logGeneric("Failed to allocate memory for the payments.");
+        return 0;
+      }
+      continue;
+    }
+    Payment payment;
+    sscanf_s(fields[0], "%d", &payment.customerID);
+    sscanf_s(fields[1], "%f", &payment.amount);
+    payment.paymentDay = dateToDayNumber(fields[2]);
+    payment.lineNumber = lineNumber;
+    if (!addPayment(list, &payment, rawLine)) {
+      logGeneric("Failed to allocate memory for the payments.");
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : rejectPayment
+// DESCRIPTION :
+//    Logs a payment that could not be applied and keeps its line for the quarantine.
+// PARAMETERS :
+//    PaymentList* list: The list holding the payment's line.
+//    const Payment* payment: The payment.
+//    const char* reason: Why the payment was not applied.
+//    PaymentSummary* summary: Counts the rejected payment.
+// RETURNS :
+//    void
+static void rejectPayment(PaymentList* list, const Payment* payment, const char* reason, PaymentSummary* summary) {
+  char errorMessage[300];
+  snprintf(errorMessage, sizeof(errorMessage), "In payments database line %d: %s", payment->lineNumber, reason);
+  logGeneric(errorMessage);
+  if (!addRejectedPayment(list, payment->lineNumber, payment->lineStart, reason)) {
+    logGeneric("Failed to allocate memory for the payments, a rejected payment was not quarantined.");
+  }
+  summary->rejectedCount++;
+}
+
+// FUNCTION : compareRejectedPayments
+// DESCRIPTION :
+//    qsort comparison of two rejected lines by line number.
+// PARAMETERS :
+//    const void* first: The first RejectedPayment.
+//    const void* second: The second RejectedPayment.
+// RETURNS :
+//    int : Negative, zero or positive as first sorts before, with or after second.
+static int compareRejectedPayments(const void* first, const void* second) {
+  return ((const RejectedPayment*)first)->lineNumber - ((const RejectedPayment*)second)->lineNumber;
+}
+
+// FUNCTION : quarantineRejectedPayments
+// DESCRIPTION :
+//    Writes the rejected lines to the quarantine verbatim and in file order, whether they failed
+//    their checks while reading or could not be applied in the merge.
+// PARAMETERS :
+//    PaymentList* list: The list holding the rejected lines.
+//    QuarantineWriter* quarantine: Receives the lines.
+// RETURNS :
+//    void
+static void quarantineRejectedPayments(PaymentList* list, QuarantineWriter* quarantine) {
+  if (list->rejectedCount == 0) {
+    return;
+  }
+  qsort(list->rejected, list->rejectedCount, sizeof(RejectedPayment), compareRejectedPayments);
+  for (int i = 0; i < list->rejectedCount; i++) {
+    const RejectedPayment* entry = &list->rejected[i];
+    quarantineLine(quarantine, list->text + entry->lineStart, entry->lineNumber, list->text + entry->reasonStart);
+  }
+}
+
+// FUNCTION : mergePayments
+// DESCRIPTION :
+//    Applies sorted payments to the customers by walking both in customerID order.
+// PARAMETERS :
+//    Customer* customers: The customers.
+//    const CustomerKey* keys: The customers sorted by customerID.
+//    int keyCount: Number of keys.
+//    PaymentList* list: The payments sorted by customerID. Receives the payments that cannot be applied.
+//    PaymentSummary* summary: Counts the payments applied and rejected.
+// RETURNS :
+//    void
+static void mergePayments(Customer* customers, const CustomerKey* keys, int keyCount, PaymentList* list,
+  PaymentSummary* summary) {
+  char reason[200];
+  int k = 0;
+  int lastPaidKey = -1;
+  for (int p = 0; p < list->count; p++) {
+    const Payment* payment = &list->items[p];
+    while (k < keyCount && keys[k].customerID < payment->customerID) {
+      k++;
+    }
+    if (k == keyCount || keys[k].customerID != payment->customerID) {
+      snprintf(reason, sizeof(reason), "Customer %d is not in the customers database.", payment->customerID);
+      rejectPayment(list, payment, reason, summary);
+      continue;
+    }
+    Customer* customer = &customers[keys[k].position];
+    if (payment->amount - customer->currentAccountBalance > 0.005f) {
+      snprintf(reason, sizeof(reason), "Payment of %.2f is larger than the balance of customer %d (%.2f).", payment->amount,
+        payment->customerID, customer->currentAccountBalance);
+      rejectPayment(list, payment, reason, summary);
+      continue;
+    }
+    customer->currentAccountBalance -= payment->amount;
+    if (customer->currentAccountBalance < 0.0f) {
+      customer->currentAccountBalance = 0.0f; // Paid off, less a rounding error
+    }
+    if (payment->paymentDay > customer->lastPaymentDay) {
+      customer->lastPaymentDay = payment->paymentDay;
+      dayNumberToDate(payment->paymentDay, customer->lastPaymentMade, sizeof(customer->lastPaymentMade));
+    }
+    summary->appliedCount++;
+    summary->appliedTotal += payment->amount;
+    if (k != lastPaidKey) {
+      summary->customerCount++;
+      lastPaidKey = k;
+    }
+  }
+}
+
+// FUNCTION : applyPaymentsFile
+// DESCRIPTION :
+//    Applies every payment of a payments database to the customers in one sorted pass.
+// PARAMETERS :
+//    Customer* customers: The customers, updated.
+//    int customerCount: Number of customers.
+//    const char* fileName: The payments database.
+//    PaymentZoneMap* paymentZones: Optional, rebuilt from the new last payment dates.
+//    int isQuarantining: 1 to quarantine rejected payments lines.
+//    PaymentSummary* summary: Receives the counts of the payments read, applied and rejected.
+// RETURNS :
+//    int : 1 if the payments were applied, 0 if the file could not be read or memory could not be allocated.
+int applyPaymentsFile(Customer* customers, int customerCount, const char* fileName, PaymentZoneMap* paymentZones,
+  int isQuarantining, PaymentSummary* summary) {
+  memset(summary, 0, sizeof(PaymentSummary));
+  char errorMessage[300];
+  char sourceFileName[260];
+  resolveDatabaseFile(fileName, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* reader = openAsyncReader(sourceFileName);
+  if (reader == NULL) {
+    logGeneric("Failed to open payments database.");
+    return 0;
+  }
+  PaymentList list = { 0 };
+  int isRead = readPaymentLines(reader, &list, summary);
+  closeAsyncReader(reader);
+  CustomerKey* keys = (CustomerKey*)malloc((size_t)(customerCount > 0 ? customerCount : 1) * sizeof(CustomerKey));
+  if (!isRead || keys == NULL) {
+    if (keys == NULL) {
+      logGeneric("Failed to allocate memory for the payments.");
+    }
+    free(keys);
+    freePaymentList(&list);
+    return 0;
+  }
+  for (int i = 0; i < customerCount; i++) {
+    keys[i].customerID = customers[i].customerID;
+    keys[i].position = i;
+  }
+  qsort(keys, customerCount, sizeof(CustomerKey), compareCustomerKeys);
+  if (list.count > 0) {
+    qsort(list.items, list.count, sizeof(Payment), comparePayments); // No list is allocated for a file with no payments
+  }
+  mergePayments(customers, keys, customerCount, &list, summary);
+  free(keys);
+  QuarantineWriter quarantine;
+  openQuarantine(&quarantine, fileName, isQuarantining);
+  quarantineRejectedPayments(&list, &quarantine);
+  freePaymentList(&list);
+  int quarantinedCount = closeQuarantine(&quarantine);
+  if (quarantinedCount > 0) {
+    snprintf(errorMessage, sizeof(errorMessage), "%d rejected lines of the payments database were quarantined in %s.",
+      quarantinedCount, quarantine.linesFileName);
+    logGeneric(errorMessage);
+  }
+  if (paymentZones != NULL) {
+    buildPaymentZoneMap(paymentZones, customers, customerCount);
+  }
+  return 1;
+}
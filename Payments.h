@@ -0,0 +1,31 @@
+// FILE : Payments.h
+// DESCRIPTION : This header file defines the bulk payments feed that updates customer balances and last payment dates.
+#ifndef PAYMENTS_H
+#define PAYMENTS_H
+
+#include "Customer.h"
+#include "DateIndex.h"
+#include <stddef.h>
+
+#define NUMBER_OF_PAYMENT_FIELDS 3 // customerID|amount|date|
+
+typedef struct {
+  int customerID;
+  int paymentDay; // Payment date as a day number
+  int lineNumber; // Line in the payments database; keeps payments of one day in file order
+  float amount;
+  size_t lineStart; // Offset of the line as read in the text of the payment list, quarantined verbatim if rejected
+} Payment;
+
+typedef struct {
+  int lineCount; // Payment lines read
+  int appliedCount;
+  int rejectedCount; // Invalid lines, unknown customers and payments larger than the balance
+  int customerCount; // Customers with at least one payment applied
+  double appliedTotal;
+} PaymentSummary;
+
+int applyPaymentsFile(Customer* customers, int customerCount, const char* fileName, PaymentZoneMap* paymentZones,
+  int isQuarantining, PaymentSummary* summary);
+
+#endif
@@ -0,0 +1,251 @@
+// FILE : PickList.c
+// DESCRIPTION :
+//    Implements the pick list generator. Fulfilled orders are batched into waves, and the pick lines
+//    of each wave are ordered by aisle, shelf, level and bin in a serpentine walk (shelves run up
+//    even aisles and back down odd ones), using a parallel LSD radix sort on packed location keys.
+#include "PickList.h"
+#include "Index.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct {
+  const PickLine* source;
+  PickLine* destination;
+  int startLine;
+  int endLine;
+  int shift;
+  int* counts; // RADIX_BUCKETS counts, turned into this worker's scatter offsets
+} RadixWorker;
+
+// FUNCTION : packPartLocation
+// DESCRIPTION :
+//    Parses a validated A###-S###-L##-B## location once into a packed integer,
+//    so sorting and comparing locations never has to look at the string again.
+// PARAMETERS :
+//    const char* partLocation: The location string (already validated by validatePartLocation).
+// RETURNS :
+//    unsigned long long : The packed aisle, shelf, level and bin.
+unsigned long long packPartLocation(const char* partLocation) {
+  unsigned long long aisle = (partLocation[1] - '0') * 100 + (partLocation[2] - '0') * 10 + (partLocation[3] - '0');
+  unsigned long long shelf = (partLocation[6] - '0') * 100 + (partLocation[7] - '0') * 10 + (partLocation[8] - '0');
+  unsigned long long level = (partLocation[11] - '0') * 10 + (partLocation[12] - '0');
+  unsigned long long bin = (partLocation[15] - '0') * 10 + (partLocation[16] - '0');
+  return (aisle << 24) | (shelf << 14) | (level << 7) | bin;
+}
+
+// FUNCTION : getWalkPosition
+// DESCRIPTION :
+//    Converts a packed location into its position along the serpentine walk:
+//    aisles ascending, shelves ascending in even aisles and descending in odd aisles.
+// PARAMETERS :
+//    unsigned long long location: The packed location.
+// RETURNS :
+//    unsigned long long : A key that sorts in walk order.
+static unsigned long long getWalkPosition(unsigned long long location) {
+  unsigned long long aisle = LOCATION_AISLE(location);
+  unsigned long long shelf = LOCATION_SHELF(location);
+  if (aisle % 2 == 1) {
+    shelf = 0x3FF - shelf;
+  }
+  return (aisle << 24) | (shelf << 14) | (location & 0x3FFF);
+}
+
+// FUNCTION : buildPickList
+// DESCRIPTION :
+//    Creates one pick line per ordered part of every valid fulfilled order, batching the orders into
+//    waves of waveSize orders, and sorts the lines into walk order within each wave.
+// PARAMETERS :
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+//    const Part* parts: The parts array (for locations).
+//    int partCount: Number of parts.
+//    int waveSize: Number of orders per wave.
+//    PickLine** lines: Receives the allocated pick lines; the caller frees them.
+// RETURNS :
+//    int : The number of pick lines, or -1 if memory could not be allocated.
+int buildPickList(const Order* orders, const unsigned char* orderValid, int orderCount, const Part* parts, int partCount,
+  int waveSize, PickLine** lines) {
+  IdIndex partIndex;
+  if (!initIdIndex(&partIndex, partCount)) {
+    return -1;
+  }
+  for (int i = 0; i < partCount; i++) {
+    setIdIndex(&partIndex, parts[i].partID, i);
+  }
+  int lineCapacity = 0;
+  for (int i = 0; i < orderCount; i++) {
+    lineCapacity += orders[i].distinctParts;
+  }
+  *lines = (PickLine*)malloc((lineCapacity + 1) * sizeof(PickLine));
+  if (*lines == NULL) {
+    logGeneric("Failed to allocate memory for the pick list.");
+    freeIdIndex(&partIndex);
+    return -1;
+  }
+  int lineCount = 0;
+  int waveOrderCount = 0;
+  int wave = 0;
+  for (int i = 0; i < orderCount; i++) {
+    const Order* order = &orders[i];
+    if ((orderValid != NULL && !orderValid[i]) || order->orderStatus != 1) {
+      continue;
+    }
+    if (waveOrderCount == waveSize) {
+      wave++;
+      waveOrderCount = 0;
+    }
+    waveOrderCount++;
+    for (int j = 0; j < order->distinctParts; j++) {
+      int partPosition = findIdIndex(&partIndex, order->orderedParts[j].partID);
+      if (partPosition == ID_INDEX_NOT_FOUND) {
+        continue;
+      }
+      PickLine* line = &(*lines)[lineCount++];
+      line->orderID = order->orderID;
+      line->partID = order->orderedParts[j].partID;
+      line->quantity = order->orderedParts[j].quantityOrdered;
+      line->location = parts[partPosition].partLocationCode;
+      line->wave = wave;
+      line->sortKey = ((unsigned long long)wave << LOCATION_BITS) | getWalkPosition(line->location);
+    }
+  }
+  freeIdIndex(&partIndex);
+  if (!sortPickLines(*lines, lineCount)) {
+    free(*lines);
+    *lines = NULL;
+    return -1;
+  }
+  return lineCount;
+}
+
+// FUNCTION : countDigits
+// DESCRIPTION :
+//    Radix sort worker that counts the keys of its range per digit for the current pass.
+// PARAMETERS :
+//    void* argument: The worker's RadixWorker block.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall countDigits(void* argument) {
+  RadixWorker* worker = (RadixWorker*)argument;
+  memset(worker->counts, 0, RADIX_BUCKETS * sizeof(int));
+  for (int i = worker->startLine; i < worker->endLine; i++) {
+    worker->counts[(worker->source[i].sortKey >> worker->shift) & (RADIX_BUCKETS - 1)]++;
+  }
+  return 0;
+}
+
+// FUNCTION : scatterLines
+// DESCRIPTION :
+//    Radix sort worker that moves the lines of its range to their place for the current pass.
+//    Each worker owns a disjoint slice of every bucket, so no synchronization is needed.
+// PARAMETERS :
+//    void* argument: The worker's RadixWorker block with counts turned into offsets.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall scatterLines(void* argument) {
+  RadixWorker* worker = (RadixWorker*)argument;
+  for (int i = worker->startLine; i < worker->endLine; i++) {
+    int digit = (int)((worker->source[i].sortKey >> worker->shift) & (RADIX_BUCKETS - 1));
+    worker->destination[worker->counts[digit]++] = worker->source[i];
+  }
+  return 0;
+}
+
+// FUNCTION : sortPickLines
+// DESCRIPTION :
+//    Sorts pick lines by sortKey with a stable parallel LSD radix sort, 8 bits per pass.
+//    Passes above the highest set bit of the largest key are skipped.
+// PARAMETERS :
+//    PickLine* lines: The lines to sort in place.
+//    int lineCount: Number of lines.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int sortPickLines(PickLine* lines, int lineCount) {
+  if (lineCount < 2) {
+    return 1;
+  }
+  unsigned long long maxKey = 0;
+  for (int i = 0; i < lineCount; i++) {
+    if (lines[i].sortKey > maxKey) {
+      maxKey = lines[i].sortKey;
+    }
+  }
+  int workerCount = getWorkerCount(lineCount);
+  PickLine* buffer = (PickLine*)malloc(lineCount * sizeof(PickLine));
+  RadixWorker* workers = (RadixWorker*)malloc(workerCount * sizeof(RadixWorker));
+  int* counts = (int*)malloc((size_t)workerCount * RADIX_BUCKETS * sizeof(int));
+  if (buffer == NULL || workers == NULL || counts == NULL) {
+    logGeneric("Failed to allocate memory for sorting the pick list.");
+    free(buffer);
+    free(workers);
+    free(counts);
+    return 0;
+  }
+  int chunkSize = (lineCount + workerCount - 1) / workerCount;
+  PickLine* source = lines;
+  PickLine* destination = buffer;
+  for (int shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += RADIX_BITS) {
+    for (int w = 0; w < workerCount; w++) {
+      workers[w].source = source;
+      workers[w].destination = destination;
+      workers[w].startLine = w * chunkSize < lineCount ? w * chunkSize : lineCount;
+      workers[w].endLine = (w + 1) * chunkSize < lineCount ? (w + 1) * chunkSize : lineCount;
+      workers[w].shift = shift;
+      workers[w].counts = counts + (size_t)w * RADIX_BUCKETS;
+    }
+    runWorkers(countDigits, workers, sizeof(RadixWorker), workerCount);
+    // Offsets are digit-major, worker-minor, which keeps the sort stable
+    int offset = 0;
+    for (int digit = 0; digit < RADIX_BUCKETS; digit++) {
+      for (int w = 0; w < workerCount; w++) {
+        int count = workers[w].counts[digit];
+        workers[w].counts[digit] = offset;
+        offset += count;
+      }
+    }
+    runWorkers(scatterLines, workers, sizeof(RadixWorker), workerCount);
+    PickLine* swap = source;
+    source = destination;
+    destination = swap;
+  }
+  if (source != lines) {
+    memcpy(lines, source, lineCount * sizeof(PickLine));
+  }
+  free(buffer);
+  free(workers);
+  free(counts);
+  return 1;
+}
+
+// FUNCTION : printPickList
+// DESCRIPTION :
+//    Prints the pick lines wave by wave in walk order.
+// PARAMETERS :
+//    const PickLine* lines: The sorted pick lines.
+//    int lineCount: Number of lines.
+// RETURNS :
+//    void
+void printPickList(const PickLine* lines, int lineCount) {
+  if (lineCount == 0) {
+    printf("No fulfilled orders to pick.\n");
+    return;
+  }
+  for (int i = 0; i < lineCount; i++) {
+    if (i == 0 || lines[i].wave != lines[i - 1].wave) {
+      printf("Wave %d\n", lines[i].wave + 1);
+      printf("  Location             Part ID   Quantity  Order ID\n");
+    }
+    printf("  A%03d-S%03d-L%02d-B%02d  %8d  %9d  %lld\n",
+      LOCATION_AISLE(lines[i].location), LOCATION_SHELF(lines[i].location),
+      LOCATION_LEVEL(lines[i].location), LOCATION_BIN(lines[i].location),
+      lines[i].partID, lines[i].quantity, lines[i].orderID);
+  }
+}
@@ -0,0 +1,31 @@
+// FILE : PickList.h
+// DESCRIPTION : This header file defines packed part locations and the pick list generator for fulfilled orders.
+#ifndef PICKLIST_H
+#define PICKLIST_H
+
+#include "Part.h"
+#include "Order.h"
+
+// Packed partLocation layout: aisle (10 bits) | shelf (10 bits) | level (7 bits) | bin (7 bits)
+#define LOCATION_AISLE(code) ((int)(((code) >> 24) & 0x3FF))
+#define LOCATION_SHELF(code) ((int)(((code) >> 14) & 0x3FF))
+#define LOCATION_LEVEL(code) ((int)(((code) >> 7) & 0x7F))
+#define LOCATION_BIN(code) ((int)((code) & 0x7F))
+#define LOCATION_BITS 34
+
+typedef struct {
+  unsigned long long sortKey; // Wave number above LOCATION_BITS, then the serpentine walk position
+  long long orderID;
+  int partID;
+  int quantity;
+  unsigned long long location; // Packed partLocation of the part
+  int wave;
+} PickLine;
+
+unsigned long long packPartLocation(const char* partLocation);
+int buildPickList(const Order* orders, const unsigned char* orderValid, int orderCount, const Part* parts, int partCount,
+  int waveSize, PickLine** lines);
+int sortPickLines(PickLine* lines, int lineCount);
+void printPickList(const PickLine* lines, int lineCount);
+
+#endif
@@ -0,0 +1,177 @@
+// FILE : Quarantine.c
+// DESCRIPTION :
+//    Implements the quarantine side writer. Lines rejected while loading a database are copied
+//    verbatim into <database>.rejected.db, so once fixed they can be loaded again without
+//    reprocessing the whole database, and the reason for each one is written to a parallel
+//    <database>.rejected.idx file. Both files are opened on the first rejected line and written
+//    through large stdio buffers; a load with no rejected lines removes the files of the last load.
+#include "Quarantine.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+// FUNCTION : getQuarantineFileName
+// DESCRIPTION :
+//    Builds the name of a quarantine file from the database file name by replacing its ".db"
+//    (and the ".reingest" of a re-ingest work file) with the given suffix.
+// PARAMETERS :
+//    const char* fileName: The database file name, e.g. "orders.db".
+//    const char* suffix: QUARANTINE_LINES_SUFFIX, QUARANTINE_REASONS_SUFFIX or REINGEST_SUFFIX.
+//    char* quarantineFileName: Receives the file name, e.g. "orders.rejected.db".
+//    int size: The size of the quarantineFileName buffer.
+// RETURNS :
+//    void
+void getQuarantineFileName(const char* fileName, const char* suffix, char* quarantineFileName, int size) {
+  strcpy_s(quarantineFileName, size, fileName);
+  size_t length = strlen(quarantineFileName);
+  if (length >= strlen(".db") && strcmp(quarantineFileName + length - strlen(".db"), ".db") == 0) {
+    length -= strlen(".db");
+    quarantineFileName[length] = '\0';
+  }
+  if (length >= strlen(".reingest") && strcmp(quarantineFileName + length - strlen(".reingest"), ".reingest") == 0) {
+    quarantineFileName[length - strlen(".reingest")] = '\0';
+  }
+  strcat_s(quarantineFileName, size, suffix);
+}
+
+// FUNCTION : openQuarantine
+// DESCRIPTION :
+//    Prepares the quarantine of one database load. No file is created until a line is rejected.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The writer to initialize.
+//    const char* sourceFileName: The database file being loaded.
+//    int isEnabled: 1 to quarantine rejected lines, 0 to only discard them.
+// RETURNS :
+//    void
+void openQuarantine(QuarantineWriter* quarantine, const char* sourceFileName, int isEnabled) {
+  memset(quarantine, 0, sizeof(QuarantineWriter));
+  quarantine->isEnabled = isEnabled;
+  strcpy_s(quarantine->sourceFileName, sizeof(quarantine->sourceFileName), sourceFileName);
+  getQuarantineFileName(sourceFileName, QUARANTINE_LINES_SUFFIX, quarantine->linesFileName, sizeof(quarantine->linesFileName));
+  getQuarantineFileName(sourceFileName, QUARANTINE_REASONS_SUFFIX, quarantine->reasonsFileName, sizeof(quarantine->reasonsFileName));
+}
+
+// FUNCTION : openQuarantineFiles
+// DESCRIPTION :
+//    Creates both quarantine files with QUARANTINE_BUFFER_BYTES stdio buffers. On failure
+//    quarantining is turned off for the rest of the load and the load itself carries on.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The writer.
+// RETURNS :
+//    int : 1 if the files are open, 0 otherwise.
+static int openQuarantineFiles(QuarantineWriter* quarantine) {
+  errno_t linesErr = fopen_s(&quarantine->lines, quarantine->linesFileName, "w");
+  errno_t reasonsErr = fopen_s(&quarantine->reasons, quarantine->reasonsFileName, "w");
+  if (linesErr != 0 || reasonsErr != 0 || quarantine->lines == NULL || quarantine->reasons == NULL) {
+    if (quarantine->lines != NULL) {
+      fclose(quarantine->lines);
+    }
+    if (quarantine->reasons != NULL) {
+      fclose(quarantine->reasons);
+    }
+    quarantine->lines = NULL;
+    quarantine->reasons = NULL;
+    quarantine->isEnabled = 0;
+    logGeneric("Failed to create the quarantine files, rejected lines will not be kept.");
+    return 0;
+  }
+  setvbuf(quarantine->lines, NULL, _IOFBF, QUARANTINE_BUFFER_BYTES);
+  setvbuf(quarantine->reasons, NULL, _IOFBF, QUARANTINE_BUFFER_BYTES);
+  return 1;
+}
+
+// FUNCTION : writeQuarantineReason
+// DESCRIPTION :
+//    Writes the index entry of the line just quarantined and counts it.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The writer.
+//    int sourceLineNumber: The line number of the rejected line in the database.
+//    const char* reason: Why the line was rejected.
+// RETURNS :
+//    void
+static void writeQuarantineReason(QuarantineWriter* quarantine, int sourceLineNumber, const char* reason) {
+  quarantine->count++;
+  fprintf(quarantine->reasons, "%d|%s|%d|%s\n", quarantine->count, quarantine->sourceFileName, sourceLineNumber, reason);
+}
+
+// FUNCTION : quarantineLine
+// DESCRIPTION :
+//    Copies a rejected line verbatim to the quarantine file and records why it was rejected.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The writer.
+//    const char* rawLine: The line as read from the database, before it was split.
+//    int sourceLineNumber: The line number of the rejected line in the database.
+//    const char* reason: Why the line was rejected.
+// RETURNS :
+//    void
+void quarantineLine(QuarantineWriter* quarantine, const char* rawLine, int sourceLineNumber, const char* reason) {
+  if (!quarantine->isEnabled || (quarantine->lines == NULL && !openQuarantineFiles(quarantine))) {
+    return;
+  }
+  size_t length = strlen(rawLine);
+  fwrite(rawLine, 1, length, quarantine->lines);
+  if (length == 0 || rawLine[length - 1] != '\n') {
+    fputc('\n', quarantine->lines); // The last line of the database may not end with a newline
+  }
+  writeQuarantineReason(quarantine, sourceLineNumber, reason);
+}
+
+// FUNCTION : closeQuarantine
+// DESCRIPTION :
+//    Flushes and closes the quarantine files. When nothing was quarantined, the files left by an
+//    earlier load are deleted so they never hold lines that now load fine.
+// PARAMETERS :
+//    QuarantineWriter* quarantine: The writer.
+// RETURNS :
+//    int : The number of lines quarantined.
+int closeQuarantine(QuarantineWriter* quarantine) {
+  if (quarantine->lines != NULL) {
+    fclose(quarantine->lines);
+    fclose(quarantine->reasons);
+    quarantine->lines = NULL;
+    quarantine->reasons = NULL;
+  }
+  else if (quarantine->isEnabled) {
+    DeleteFileA(quarantine->linesFileName);
+    DeleteFileA(quarantine->reasonsFileName);
+  }
+  return quarantine->count;
+}
+
+// FUNCTION : beginReingest
+// DESCRIPTION :
+//    Moves the quarantine file of a database to a re-ingest work file, so it can be loaded while a
+//    fresh quarantine file collects the lines that are still rejected.
+// PARAMETERS :
+//    const char* fileName: The database file name, e.g. "orders.db".
+//    char* workFileName: Receives the work file name, e.g. "orders.reingest.db".
+//    int size: The size of the workFileName buffer.
+// RETURNS :
+//    int : 1 if the work file is ready to load, 0 if there are no quarantined lines or the move failed.
+int beginReingest(const char* fileName, char* workFileName, int size) {
+  char linesFileName[QUARANTINE_FILE_NAME_SIZE];
+  getQuarantineFileName(fileName, QUARANTINE_LINES_SUFFIX, linesFileName, sizeof(linesFileName));
+  getQuarantineFileName(fileName, REINGEST_SUFFIX, workFileName, size);
+  if (GetFileAttributesA(linesFileName) == INVALID_FILE_ATTRIBUTES) {
+    return 0;
+  }
+  if (!MoveFileExA(linesFileName, workFileName, MOVEFILE_REPLACE_EXISTING)) {
+    logGeneric("Failed to move a quarantine file for re-ingesting.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : endReingest
+// DESCRIPTION :
+//    Deletes the re-ingest work file once loaded; its lines were either accepted or quarantined again.
+// PARAMETERS :
+//    const char* workFileName: The work file from beginReingest.
+// RETURNS :
+//    void
+void endReingest(const char* workFileName) {
+  DeleteFileA(workFileName);
+}
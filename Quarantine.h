@@ -0,0 +1,28 @@
+// FILE : Quarantine.h
+// DESCRIPTION : This header file defines the side writer that keeps rejected database lines for reprocessing.
+#ifndef QUARANTINE_H
+#define QUARANTINE_H
+
+#include <stdio.h>
+
+#define QUARANTINE_FILE_NAME_SIZE 260
+
+typedef struct {
+  FILE* lines; // Rejected lines, verbatim, in the same format as the source database
+  FILE* reasons; // One "quarantineLine|sourceFile|sourceLine|reason" entry per rejected line
+  char sourceFileName[QUARANTINE_FILE_NAME_SIZE];
+  char linesFileName[QUARANTINE_FILE_NAME_SIZE];
+  char reasonsFileName[QUARANTINE_FILE_NAME_SIZE];
+  int count; // Lines quarantined so far
+  int isEnabled;
+} QuarantineWriter;
+
+void getQuarantineFileName(const char* fileName, const char* suffix, char* quarantineFileName, int size);
+void openQuarantine(QuarantineWriter* quarantine, const char* sourceFileName, int isEnabled);
+void quarantineLine(QuarantineWriter* quarantine, const char* rawLine, int sourceLineNumber, const char* reason);
+int closeQuarantine(QuarantineWriter* quarantine);
+
+int beginReingest(const char* fileName, char* workFileName, int size);
+void endReingest(const char* workFileName);
+
+#endif
@@ -0,0 +1,447 @@
+// FILE : Ranking.c
+// DESCRIPTION :
+//    Implements the order rankings: the customers by the total of their orders and the parts by
+//    the quantity ordered, summarized while the orders load so the top customers and parts can be
+//    listed without another pass over the orders or a sort of them.
+//    Each ranking is a weighted Space-Saving summary: a fixed number of slots kept as a min-heap by
+//    weight. A key that is tracked has its weight increased in place; a new key takes over the
+//    lightest slot, inheriting its weight as the error of its own. A key's weight is therefore
+//    never underestimated and is exact while there are fewer keys than slots; a key that is not
+//    tracked weighs at most the lightest slot, which bounds the long tail.
+//    The top K are picked from the slots with a bounded min-heap of K keys. Summaries built on
+//    different threads (e.g. one per order shard) are merged with the Space-Saving merge.
+#include "Ranking.h"
+#include "Logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : initHeavyHitters
+// DESCRIPTION :
+//    Creates an empty summary.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary to initialize.
+//    int slotCount: The number of keys tracked.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int initHeavyHitters(HeavyHitters* hitters, int slotCount) {
+  memset(hitters, 0, sizeof(HeavyHitters));
+  hitters->entries = (RankedKey*)malloc((size_t)slotCount * sizeof(RankedKey));
+  if (hitters->entries == NULL || !initIdIndex(&hitters->positions, slotCount)) {
+    free(hitters->entries);
+    hitters->entries = NULL;
+    return 0;
+  }
+  hitters->capacity = slotCount;
+  return 1;
+}
+
+// FUNCTION : findHeavyHitter
+// DESCRIPTION :
+//    Finds the slot of a tracked key.
+// PARAMETERS :
+//    const HeavyHitters* hitters: The summary.
+//    long long key: The key.
+// RETURNS :
+//    int : The position of the key in entries, or -1 if it is not tracked.
+static int findHeavyHitter(const HeavyHitters* hitters, long long key) {
+  int position = findIdIndex(&hitters->positions, key);
+  if (position == ID_INDEX_NOT_FOUND || position >= hitters->count || hitters->entries[position].key != key) {
+    return -1; // The key was replaced by another one since it was indexed
+  }
+  return position;
+}
+
+// FUNCTION : placeHeavyHitter
+// DESCRIPTION :
+//    Stores an entry at a heap position and indexes its key there.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+//    int position: The position.
+//    const RankedKey* entry: The entry.
+// RETURNS :
+//    void
+static void placeHeavyHitter(HeavyHitters* hitters, int position, const RankedKey* entry) {
+  hitters->entries[position] = *entry;
+  setIdIndex(&hitters->positions, entry->key, position);
+}
+
+// FUNCTION : siftHeavyHitterUp
+// DESCRIPTION :
+//    Moves an entry whose weight decreased towards the root of the min-heap.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+//    int position: The position of the entry.
+// RETURNS :
+//    void
+static void siftHeavyHitterUp(HeavyHitters* hitters, int position) {
+  RankedKey entry = hitters->entries[position];
+  while (position > 0) {
+    int parent = (position - 1) / 2;
+    if (hitters->entries[parent].weight <= entry.weight) {
+      break;
+    }
+    placeHeavyHitter(hitters, position, &hitters->entries[parent]);
+    position = parent;
+  }
+  placeHeavyHitter(hitters, position, &entry);
+}
+
+// FUNCTION : siftHeavyHitterDown
+// DESCRIPTION :
+//    Moves an entry whose weight increased away from the root of the min-heap.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+//    int position: The position of the entry.
+// RETURNS :
+//    void
+static void siftHeavyHitterDown(HeavyHitters* hitters, int position) {
+  RankedKey entry = hitters->entries[position];
+  while (1) {
+    int child = 2 * position + 1;
+    if (child >= hitters->count) {
+      break;
+    }
+    if (child + 1 < hitters->count && hitters->entries[child + 1].weight < hitters->entries[child].weight) {
+      child++;
+    }
+    if (hitters->entries[child].weight >= entry.weight) {
+      break;
+    }
+    placeHeavyHitter(hitters, position, &hitters->entries[child]);
+    position = child;
+  }
+  placeHeavyHitter(hitters, position, &entry);
+}
+
+// FUNCTION : reindexHeavyHitters
+// DESCRIPTION :
+//    Rebuilds the key index from the tracked keys, dropping the keys that were replaced.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+// RETURNS :
+//    void
+static void reindexHeavyHitters(HeavyHitters* hitters) {
+  clearIdIndex(&hitters->positions);
+  for (int i = 0; i < hitters->count; i++) {
+    setIdIndex(&hitters->positions, hitters->entries[i].key, i);
+  }
+}
+
+// FUNCTION : addHeavyHitter
+// DESCRIPTION :
+//    Counts a weight for a key, taking over the lightest slot if the key is not tracked and the
+//    summary is full.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+//    long long key: The key, > 0.
+//    double weight: The weight to add.
+// RETURNS :
+//    void
+static void addHeavyHitter(HeavyHitters* hitters, long long key, double weight) {
+  if (key <= 0 || hitters->capacity == 0) {
+    return;
+  }
+  int position = findHeavyHitter(hitters, key);
+  if (position >= 0) {
+    hitters->entries[position].weight += weight;
+    siftHeavyHitterDown(hitters, position);
+    return;
+  }
+  if (hitters->count < hitters->capacity) {
+    RankedKey entry = { key, weight, 0.0 };
+    hitters->entries[hitters->count++] = entry;
+    siftHeavyHitterUp(hitters, hitters->count - 1);
+    return;
+  }
+  // Replaced keys stay in the index until it holds too many of them
+  if (hitters->positions.count >= hitters->capacity * 4) {
+    reindexHeavyHitters(hitters);
+  }
+  RankedKey entry = { key, hitters->entries[0].weight + weight, hitters->entries[0].weight };
+  placeHeavyHitter(hitters, 0, &entry);
+  siftHeavyHitterDown(hitters, 0);
+}
+
+// FUNCTION : removeHeavyHitter
+// DESCRIPTION :
+//    Takes back a weight counted for a key, for an order that was replaced or became invalid.
+//    A key that is no longer tracked keeps the weight in the error of the key that replaced it.
+// PARAMETERS :
+//    HeavyHitters* hitters: The summary.
+//    long long key: The key.
+//    double weight: The weight to take back.
+// RETURNS :
+//    void
+static void removeHeavyHitter(HeavyHitters* hitters, long long key, double weight) {
+  int position = findHeavyHitter(hitters, key);
+  if (position < 0) {
+    return;
+  }
+  RankedKey* entry = &hitters->entries[position];
+  entry->weight = entry->weight > weight ? entry->weight - weight : 0.0;
+  entry->error = entry->error < entry->weight ? entry->error : entry->weight;
+  siftHeavyHitterUp(hitters, position);
+}
+
+// FUNCTION : getLightestWeight
+// DESCRIPTION :
+//    Gets the most a key that is not tracked can weigh.
+// PARAMETERS :
+//    const HeavyHitters* hitters: The summary.
+// RETURNS :
+//    double : The weight of the lightest slot when the summary is full, otherwise 0.
+static double getLightestWeight(const HeavyHitters* hitters) {
+  return hitters->count == hitters->capacity && hitters->count > 0 ? hitters->entries[0].weight : 0.0;
+}
+
+// FUNCTION : mergeHeavyHitters
+// DESCRIPTION :
+//    Merges a summary into another. Each key weighs the sum of its weights in both, a summary that
+//    does not track the key counting its lightest weight, and the heaviest keys are kept.
+// PARAMETERS :
+//    HeavyHitters* merged: The summary merged into.
+//    const HeavyHitters* hitters: The summary to merge.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int mergeHeavyHitters(HeavyHitters* merged, const HeavyHitters* hitters) {
+  RankedKey* combined = (RankedKey*)malloc((size_t)(merged->count + hitters->count + 1) * sizeof(RankedKey));
+  if (combined == NULL) {
+    return 0;
+  }
+  double mergedLightest = getLightestWeight(merged);
+  double lightest = getLightestWeight(hitters);
+  int combinedCount = 0;
+  for (int i = 0; i < merged->count; i++) {
+    RankedKey entry = merged->entries[i];
+    int position = findHeavyHitter(hitters, entry.key);
+    entry.weight += position >= 0 ? hitters->entries[position].weight : lightest;
+    entry.error += position >= 0 ? hitters->entries[position].error : lightest;
+    combined[combinedCount++] = entry;
+  }
+  for (int i = 0; i < hitters->count; i++) {
+    if (findHeavyHitter(merged, hitters->entries[i].key) >= 0) {
+      continue; // Already combined above
+    }
+    RankedKey entry = hitters->entries[i];
+    entry.weight += mergedLightest;
+    entry.error += mergedLightest;
+    combined[combinedCount++] = entry;
+  }
+  // Keep the heaviest keys: the combined keys go through a min-heap bounded by the capacity
+  merged->count = 0;
+  clearIdIndex(&merged->positions);
+  for (int i = 0; i < combinedCount; i++) {
+    if (merged->count < merged->capacity) {
+      merged->entries[merged->count++] = combined[i];
+      siftHeavyHitterUp(merged, merged->count - 1);
+    }
+    else if (combined[i].weight > merged->entries[0].weight) {
+      placeHeavyHitter(merged, 0, &combined[i]);
+      siftHeavyHitterDown(merged, 0);
+    }
+  }
+  free(combined);
+  reindexHeavyHitters(merged);
+  return 1;
+}
+
+// FUNCTION : initOrderRankings
+// DESCRIPTION :
+//    Creates empty customer and part rankings.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings to initialize.
+//    int slotCount: The number of customers and of parts each ranking tracks.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initOrderRankings(OrderRankings* rankings, int slotCount) {
+  memset(rankings, 0, sizeof(OrderRankings));
+  if (!initHeavyHitters(&rankings->customerTotals, slotCount) || !initHeavyHitters(&rankings->partQuantities, slotCount)) {
+    logGeneric("Failed to allocate memory for the order rankings.");
+    freeOrderRankings(rankings);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : clearOrderRankings
+// DESCRIPTION :
+//    Empties the rankings, keeping their memory.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings.
+// RETURNS :
+//    void
+void clearOrderRankings(OrderRankings* rankings) {
+  rankings->customerTotals.count = 0;
+  clearIdIndex(&rankings->customerTotals.positions);
+  rankings->partQuantities.count = 0;
+  clearIdIndex(&rankings->partQuantities.positions);
+}
+
+// FUNCTION : rankingsAddOrder
+// DESCRIPTION :
+//    Counts an order's total for its customer and each ordered quantity for its part.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings.
+//    const Order* order: The order.
+// RETURNS :
+//    void
+void rankingsAddOrder(OrderRankings* rankings, const Order* order) {
+  addHeavyHitter(&rankings->customerTotals, order->customerID, order->orderTotal);
+  for (int i = 0; i < order->distinctParts; i++) {
+    addHeavyHitter(&rankings->partQuantities, order->orderedParts[i].partID, order->orderedParts[i].quantityOrdered);
+  }
+}
+
+// FUNCTION : rankingsRemoveOrder
+// DESCRIPTION :
+//    Takes back what rankingsAddOrder counted for an order.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings.
+//    const Order* order: The order.
+// RETURNS :
+//    void
+void rankingsRemoveOrder(OrderRankings* rankings, const Order* order) {
+  removeHeavyHitter(&rankings->customerTotals, order->customerID, order->orderTotal);
+  for (int i = 0; i < order->distinctParts; i++) {
+    removeHeavyHitter(&rankings->partQuantities, order->orderedParts[i].partID, order->orderedParts[i].quantityOrdered);
+  }
+}
+
+// FUNCTION : rankingsApplyValidityFlips
+// DESCRIPTION :
+//    Counts the orders that became valid and takes back the ones that became invalid.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings.
+//    const ValidityFlips* flips: The orders whose validity flipped.
+//    const Order* orders: The orders array.
+// RETURNS :
+//    void
+void rankingsApplyValidityFlips(OrderRankings* rankings, const ValidityFlips* flips, const Order* orders) {
+  for (int i = 0; i < flips->count; i++) {
+    const Order* order = &orders[flips->orderIndexes[i]];
+    if (flips->isNowValid[i]) {
+      rankingsAddOrder(rankings, order);
+    }
+    else {
+      rankingsRemoveOrder(rankings, order);
+    }
+  }
+}
+
+// FUNCTION : mergeOrderRankings
+// DESCRIPTION :
+//    Merges rankings built separately, e.g. on another thread, into other rankings.
+// PARAMETERS :
+//    OrderRankings* merged: The rankings merged into.
+//    const OrderRankings* rankings: The rankings to merge.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int mergeOrderRankings(OrderRankings* merged, const OrderRankings* rankings) {
+  if (!mergeHeavyHitters(&merged->customerTotals, &rankings->customerTotals) ||
+    !mergeHeavyHitters(&merged->partQuantities, &rankings->partQuantities)) {
+    logGeneric("Failed to allocate memory for the order rankings.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : getTopRankedKeys
+// DESCRIPTION :
+//    Picks the k heaviest keys of a summary with a min-heap bounded to k keys.
+// PARAMETERS :
+//    const HeavyHitters* hitters: The summary.
+//    int k: The number of keys wanted.
+//    RankedKey* top: Receives up to k keys, heaviest first.
+// RETURNS :
+//    int : The number of keys returned.
+int getTopRankedKeys(const HeavyHitters* hitters, int k, RankedKey* top) {
+  int topCount = 0;
+  for (int i = 0; i < hitters->count && k > 0; i++) {
+    RankedKey entry = hitters->entries[i];
+    int position;
+    if (topCount < k) {
+      position = topCount++;
+      while (position > 0 && top[(position - 1) / 2].weight > entry.weight) { // Sift up
+        top[position] = top[(position - 1) / 2];
+        position = (position - 1) / 2;
+      }
+    }
+    else if (entry.weight > top[0].weight) {
+      position = 0;
+      while (2 * position + 1 < topCount) { // Sift down from the root being replaced
+        int child = 2 * position + 1;
+        if (child + 1 < topCount && top[child + 1].weight < top[child].weight) {
+          child++;
+        }
+        if (top[child].weight >= entry.weight) {
+          break;
+        }
+        top[position] = top[child];
+        position = child;
+      }
+    }
+    else {
+      continue;
+    }
+    top[position] = entry;
+  }
+  // Pop the lightest to the end so the keys come out heaviest first
+  for (int end = topCount - 1; end > 0; end--) {
+    RankedKey lightest = top[0];
+    RankedKey entry = top[end];
+    int position = 0;
+    while (2 * position + 1 < end) {
+      int child = 2 * position + 1;
+      if (child + 1 < end && top[child + 1].weight < top[child].weight) {
+        child++;
+      }
+      if (top[child].weight >= entry.weight) {
+        break;
+      }
+      top[position] = top[child];
+      position = child;
+    }
+    top[position] = entry;
+    top[end] = lightest;
+  }
+  return topCount;
+}
+
+// FUNCTION : estimateRankedKey
+// DESCRIPTION :
+//    Estimates the weight of any key. A key that is not tracked may weigh anything from 0 up to the
+//    lightest tracked weight.
+// PARAMETERS :
+//    const HeavyHitters* hitters: The summary.
+//    long long key: The key.
+//    RankedKey* estimate: Receives the key, its upper-bound weight and how much of it may be overcounted.
+// RETURNS :
+//    void
+void estimateRankedKey(const HeavyHitters* hitters, long long key, RankedKey* estimate) {
+  int position = findHeavyHitter(hitters, key);
+  if (position >= 0) {
+    *estimate = hitters->entries[position];
+    return;
+  }
+  estimate->key = key;
+  estimate->weight = getLightestWeight(hitters);
+  estimate->error = estimate->weight;
+}
+
+// FUNCTION : freeOrderRankings
+// DESCRIPTION :
+//    Frees the memory held by the rankings.
+// PARAMETERS :
+//    OrderRankings* rankings: The rankings.
+// RETURNS :
+//    void
+void freeOrderRankings(OrderRankings* rankings) {
+  HeavyHitters* summaries[] = { &rankings->customerTotals, &rankings->partQuantities };
+  for (int i = 0; i < 2; i++) {
+    free(summaries[i]->entries);
+    summaries[i]->entries = NULL;
+    freeIdIndex(&summaries[i]->positions);
+    summaries[i]->count = 0;
+    summaries[i]->capacity = 0;
+  }
+}
@@ -0,0 +1,38 @@
+// FILE : Ranking.h
+// DESCRIPTION : This header file defines the streaming top-K and heavy-hitter summaries of customers and parts kept while orders load.
+#ifndef RANKING_H
+#define RANKING_H
+
+#include "Order.h"
+#include "Index.h"
+#include "Dependency.h"
+
+typedef struct {
+  long long key; // customerID or partID
+  double weight; // Weight counted for the key, an overestimate by at most error
+  double error; // Weight inherited from the key it replaced in the summary
+} RankedKey;
+
+typedef struct {
+  RankedKey* entries; // Space-Saving summary, a min-heap by weight
+  IdIndex positions; // key -> position in entries; stale for keys that were replaced
+  int count;
+  int capacity;
+} HeavyHitters;
+
+typedef struct {
+  HeavyHitters customerTotals; // customerID weighted by orderTotal
+  HeavyHitters partQuantities; // partID weighted by quantityOrdered
+} OrderRankings;
+
+int initOrderRankings(OrderRankings* rankings, int slotCount);
+void clearOrderRankings(OrderRankings* rankings);
+void rankingsAddOrder(OrderRankings* rankings, const Order* order);
+void rankingsRemoveOrder(OrderRankings* rankings, const Order* order);
+void rankingsApplyValidityFlips(OrderRankings* rankings, const ValidityFlips* flips, const Order* orders);
+int mergeOrderRankings(OrderRankings* merged, const OrderRankings* rankings);
+int getTopRankedKeys(const HeavyHitters* hitters, int k, RankedKey* top);
+void estimateRankedKey(const HeavyHitters* hitters, long long key, RankedKey* estimate);
+void freeOrderRankings(OrderRankings* rankings);
+
+#endif
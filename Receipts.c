@@ -0,0 +1,514 @@
+// FILE : Receipts.c
+// DESCRIPTION :
+//    Implements the stock receipts feed. Each line of receipts.db is partID|quantity| and adds to
+//    the part's quantityOnHand. Orders waiting for parts (status 99) are kept in one waitlist per
+//    part they order, a min-heap by orderDay then orderID, built with the order dependencies after
+//    each load. When receipts arrive, only the waitlists of the restocked parts are walked,
+//    oldest order first across all of them, and each waiting order that can now get all of its
+//    parts is fulfilled: its quantities come off the shelves and its status becomes 1. Orders that
+//    still cannot be filled stay on their waitlists. Waitlists are not updated when an order leaves
+//    status 99, such entries are dropped when they reach the top of a heap.
+#include "Receipts.h"
+#include "FileIO.h"
+#include "Validation.h"
+#include "AsyncReader.h"
+#include "Compression.h"
+#include "Quarantine.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  int waitlist;
+  int position;
+} SetAsideOrder;
+
+typedef struct {
+  Part* parts;
+  int partCount;
+  IdIndex partIndex; // partID -> part position
+  long long* unitsReceived; // Per part position
+  unsigned char* isTouched; // Per part position, 1 if quantityOnHand changed
+  int* restocked; // Positions of the parts received, in the order first received
+  int restockedCount;
+} ReceiptWork;
+
+// FUNCTION : isWaitingBefore
+// DESCRIPTION :
+//    Orders two backordered orders by orderDay, then by orderID.
+// PARAMETERS :
+//    const Order* orders: The orders array.
+//    int first: Position of the first order.
+//    int second: Position of the second order.
+// RETURNS :
+//    int : 1 if the first order has been waiting longer, 0 otherwise.
+static int isWaitingBefore(const Order* orders, int first, int second) {
+  if (orders[first].orderDay != orders[second].orderDay) {
+    return orders[first].orderDay < orders[second].orderDay;
+  }
+  return orders[first].orderID < orders[second].orderID;
+}
+
+// FUNCTION : pushWaitlist
+// DESCRIPTION :
+//    Adds an order to a waitlist heap.
+// PARAMETERS :
+//    OrderWaitlist* waitlist: The waitlist.
+//    const Order* orders: The orders array.
+//    int position: Position of the order.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int pushWaitlist(OrderWaitlist* waitlist, const Order* orders, int position) {
+  if (waitlist->count == waitlist->capacity) {
+    int capacity = waitlist->capacity > 0 ? waitlist->capacity * 2 : 8;
+    int* positions = (int*)realloc(waitlist->positions, (size_t)capacity * sizeof(int));
+    if (positions == NULL) {
+      return 0;
+    }
+    waitlist->positions = positions;
+    waitlist->capacity = capacity;
+  }
+  int slot = waitlist->count++;
+  while (slot > 0) {
+    int parent = (slot - 1) / 2;
+    if (!isWaitingBefore(orders, position, waitlist->positions[parent])) {
+      break;
+    }
+    waitlist->positions[slot] = waitlist->positions[parent];
+    slot = parent;
+  }
+  waitlist->positions[slot] = position;
+  return 1;
+}
+
+// FUNCTION : popWaitlist
+// DESCRIPTION :
+//    Removes the order that has been waiting longest from a non-empty waitlist heap.
+// PARAMETERS :
+//    OrderWaitlist* waitlist: The waitlist.
+//    const Order* orders: The orders array.
+// RETURNS :
+//    int : Position of the removed order.
+static int popWaitlist(OrderWaitlist* waitlist, const Order* orders) {
+  int top = waitlist->positions[0];
+  int last = waitlist->positions[--waitlist->count];
+  int slot = 0;
+  for (;;) {
+    int child = slot * 2 + 1;
+    if (child >= waitlist->count) {
+      break;
+    }
+    if (child + 1 < waitlist->count && isWaitingBefore(orders, waitlist->positions[child + 1], waitlist->positions[child])) {
+      child++;
+    }
+    if (!isWaitingBefore(orders, waitlist->positions[child], last)) {
+      break;
+    }
+    waitlist->positions[slot] = waitlist->positions[child];
+    slot = child;
+  }
+  if (waitlist->count > 0) {
+    waitlist->positions[slot] = last;
+  }
+  return top;
+}
+
+// FUNCTION : initBackorderWaitlists
+// DESCRIPTION :
+//    Creates empty waitlists.
+// PARAMETERS :
+//    BackorderWaitlists* waitlists: The waitlists to initialize.
+//    int partCapacity: The number of parts expected to have backorders.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initBackorderWaitlists(BackorderWaitlists* waitlists, int partCapacity) {
+  memset(waitlists, 0, sizeof(BackorderWaitlists));
+  if (!initIdIndex(&waitlists->partWaitlists, partCapacity)) {
+    logGeneric("Failed to allocate memory for the backorder waitlists.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : getPartWaitlist
+// DESCRIPTION :
+//    Finds the waitlist of a part, creating an empty one if the part has none.
+// PARAMETERS :
+//    BackorderWaitlists* waitlists: The waitlists.
+//    int partID: The part.
+// RETURNS :
+//    int : The waitlist number, or -1 if memory could not be allocated.
+static int getPartWaitlist(BackorderWaitlists* waitlists, int partID) {
+  int number = findIdIndex(&waitlists->partWaitlists, partID);
+  if (number != ID_INDEX_NOT_FOUND) {
+    return number;
+  }
+  if (waitlists->waitlistCount == waitlists->waitlistCapacity) {
+    int capacity = waitlists->waitlistCapacity > 0 ? waitlists->waitlistCapacity * 2 : 16;
+    OrderWaitlist* grown = (OrderWaitlist*)realloc(waitlists->waitlists, (size_t)capacity * sizeof(OrderWaitlist));
+    if (grown == NULL) {
+      return -1;
+    }
+    memset(grown + waitlists->waitlistCapacity, 0, (size_t)(capacity - waitlists->waitlistCapacity) * sizeof(OrderWaitlist));
+    waitlists->waitlists = grown;
+    waitlists->waitlistCapacity = capacity;
+  }
+  number = waitlists->waitlistCount++;
+  waitlists->waitlists[number].count = 0; // Reused from an earlier build, keeps its memory
+  if (!setIdIndex(&waitlists->partWaitlists, partID, number)) {
+    return -1;
+  }
+  return number;
+}
+
+// FUNCTION : buildBackorderWaitlists
+// DESCRIPTION :
+//    Rebuilds the waitlists from the orders: every valid order with status 99 is put on the
+//    waitlist of each part it orders.
+// PARAMETERS :
+//    BackorderWaitlists* waitlists: The waitlists.
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+// RETURNS :
+//    int : The number of backordered orders, or -1 if memory could not be allocated.
+int buildBackorderWaitlists(BackorderWaitlists* waitlists, const Order* orders, const unsigned char* orderValid, int orderCount) {
+  clearIdIndex(&waitlists->partWaitlists);
+  waitlists->waitlistCount = 0;
+  int backorderedCount = 0;
+  for (int i = 0; i < orderCount; i++) {
+    if (orders[i].orderStatus != 99 || (orderValid != NULL && !orderValid[i])) {
+      continue;
+    }
+    if (!addBackorderedOrder(waitlists, orders, i)) {
+      return -1;
+    }
+    backorderedCount++;
+  }
+  return backorderedCount;
+}
+
+// FUNCTION : addBackorderedOrder
+// DESCRIPTION :
+//    Puts one order with status 99 on the waitlist of each part it orders, for an order added
+//    after the waitlists were built.
+// PARAMETERS :
+//    BackorderWaitlists* waitlists: The waitlists.
+//    const Order* orders: The orders array.
+//    int position: Position of the backordered order in the orders array.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int addBackorderedOrder(BackorderWaitlists* waitlists, const Order* orders, int position) {
+  for (int p = 0; p < orders[position].distinctParts; p++) {
+    int number = getPartWaitlist(waitlists, orders[position].orderedParts[p].partID);
+    if (number < 0 || !pushWaitlist(&waitlists->waitlists[number], orders, position)) {
+      logGeneric("Failed to allocate memory for the backorder waitlists.");
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : readReceiptLines
+// DESCRIPTION :
+//    Reads the receipts database and adds each valid receipt to its part's quantityOnHand.
+//    Invalid lines, unknown parts and receipts that would overflow the quantity are logged and
+//    quarantined.
+// PARAMETERS :
+//    AsyncReader* reader: The receipts database.
+//    ReceiptWork* work: The parts and the per-part receipt totals.
+//    QuarantineWriter* quarantine: Receives the rejected lines.
+//    ReceiptSummary* summary: Counts the lines read, applied and rejected.
+// RETURNS :
+//    void
+static void readReceiptLines(AsyncReader* reader, ReceiptWork* work, QuarantineWriter* quarantine, ReceiptSummary* summary) {
+  char line[256];
+  char rawLine[256];
+  char* fields[NUMBER_OF_RECEIPT_FIELDS + 1];
+  char errorMessage[300];
+  char reason[1024];
+  int lineNumber = 0;
+  while (readAsyncLine(reader, line, sizeof(line)) != NULL) {
+    if (line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    lineNumber++;
+    summary->lineCount++;
+    size_t length = strlen(line);
+    if (length >= 2 && line[length - 2] == '\r' && line[length - 1] == '\n') {
+      line[--length - 1] = '\n'; // Read as binary, so "\r\n" endings are still there
+      line[length] = '\0';
+    }
+    strcpy_s(rawLine, sizeof(rawLine), line);
+    if (line[length - 1] != '\n' && length == sizeof(line) - 1) {
+      snprintf(errorMessage, sizeof(errorMessage), "In receipts database line %d: Line is too long.", lineNumber);
+      logGeneric(errorMessage);
+      quarantineLine(quarantine, rawLine, lineNumber, "Line is too long.");
+      summary->rejectedCount++;
+      while (readAsyncLine(reader, line, sizeof(line)) != NULL && line[strlen(line) - 1] != '\n') {
+      }
+      continue;
+    }
+    if (line[length - 1] == '\n') {
+      line[--length] = '\0';
+    }
+    int fieldCount = splitLine(line, fields, NUMBER_OF_RECEIPT_FIELDS, '|');
+    if (fieldCount != NUMBER_OF_RECEIPT_FIELDS) {
+      snprintf(errorMessage, sizeof(errorMessage), "In receipts database line %d: Incorrect number of fields (%d expected, found %d)",
+        lineNumber, NUMBER_OF_RECEIPT_FIELDS, fieldCount);
+      logGeneric(errorMessage);
+      snprintf(reason, sizeof(reason), "Incorrect number of fields (%d expected, found %d)", NUMBER_OF_RECEIPT_FIELDS, fieldCount);
+      quarantineLine(quarantine, rawLine, lineNumber, reason);
+      summary->rejectedCount++;
+      continue;
+    }
+    if (!validateReceiptFields(fields, lineNumber, reason, sizeof(reason))) {
+      quarantineLine(quarantine, rawLine, lineNumber, reason);
+      summary->rejectedCount++;
+      continue;
+    }
+    int partID = 0;
+    int quantity = 0;
+    sscanf_s(fields[0], "%d", &partID);
+    sscanf_s(fields[1], "%d", &quantity);
+    int position = findIdIndex(&work->partIndex, partID);
+    if (position == ID_INDEX_NOT_FOUND) {
+      snprintf(reason, sizeof(reason), "Part %d is not in the parts database.", partID);
+    }
+    else if (work->parts[position].quantityOnHand > INT_MAX - quantity) {
+      snprintf(reason, sizeof(reason), "Receipt of %d would overflow the quantity on hand of part %d.", quantity, partID);
+    }
+    else {
+      if (work->unitsReceived[position] == 0) {
+        work->restocked[work->restockedCount++] = position;
+      }
+      work->parts[position].quantityOnHand += quantity;
+      work->unitsReceived[position] += quantity;
+      work->isTouched[position] = 1;
+      summary->receivedCount++;
+      summary->unitsReceived += quantity;
+      continue;
+    }
+    snprintf(errorMessage, sizeof(errorMessage), "In receipts database line %d: %s", lineNumber, reason);
+    logGeneric(errorMessage);
+    quarantineLine(quarantine, rawLine, lineNumber, reason);
+    summary->rejectedCount++;
+  }
+}
+
+// FUNCTION : fulfillOrder
+// DESCRIPTION :
+//    Takes the parts of an order off the shelves if every one of them is on hand.
+// PARAMETERS :
+//    ReceiptWork* work: The parts.
+//    const Order* order: The order.
+// RETURNS :
+//    int : 1 if the order was filled, 0 if a part is short and nothing was taken.
+static int fulfillOrder(ReceiptWork* work, const Order* order) {
+  for (int p = 0; p < order->distinctParts; p++) {
+    int position = findIdIndex(&work->partIndex, order->orderedParts[p].partID);
+    if (position == ID_INDEX_NOT_FOUND || work->parts[position].quantityOnHand < order->orderedParts[p].quantityOrdered) {
+      return 0;
+    }
+  }
+  for (int p = 0; p < order->distinctParts; p++) {
+    int position = findIdIndex(&work->partIndex, order->orderedParts[p].partID);
+    work->parts[position].quantityOnHand -= order->orderedParts[p].quantityOrdered;
+    work->isTouched[position] = 1;
+  }
+  return 1;
+}
+
+// FUNCTION : refulfillBackorders
+// DESCRIPTION :
+//    Walks the waitlists of the restocked parts together, oldest order first, and fulfills each
+//    waiting order whose parts are now all on hand. An order on several of these waitlists is
+//    evaluated once; orders left waiting are put back on the waitlists they were taken from.
+// PARAMETERS :
+//    ReceiptWork* work: The parts and the restocked part positions.
+//    Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+//    BackorderWaitlists* waitlists: The waitlists.
+//    CustomerRollups* rollups: Optional, moves the fulfilled orders between status aggregates.
+//    ReceiptSummary* summary: Counts the orders retried and fulfilled.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int refulfillBackorders(ReceiptWork* work, Order* orders, const unsigned char* orderValid, int orderCount,
+  BackorderWaitlists* waitlists, CustomerRollups* rollups, ReceiptSummary* summary) {
+  int* restockedWaitlists = (int*)malloc((size_t)(work->restockedCount > 0 ? work->restockedCount : 1) * sizeof(int));
+  unsigned char* isEvaluated = (unsigned char*)calloc(orderCount > 0 ? orderCount : 1, sizeof(unsigned char));
+  SetAsideOrder* setAside = NULL;
+  int setAsideCount = 0;
+  int setAsideCapacity = 0;
+  int isSuccessful = restockedWaitlists != NULL && isEvaluated != NULL;
+  int waitlistCount = 0;
+  for (int r = 0; r < work->restockedCount && isSuccessful; r++) {
+    int number = findIdIndex(&waitlists->partWaitlists, work->parts[work->restocked[r]].partID);
+    if (number != ID_INDEX_NOT_FOUND) {
+      restockedWaitlists[waitlistCount++] = number;
+    }
+  }
+  while (isSuccessful) {
+    // The restocked parts are few, so the oldest top is found by comparing the tops directly
+    int best = -1;
+    for (int w = 0; w < waitlistCount; w++) {
+      OrderWaitlist* waitlist = &waitlists->waitlists[restockedWaitlists[w]];
+      if (waitlist->count > 0 && (best < 0 ||
+          isWaitingBefore(orders, waitlist->positions[0], waitlists->waitlists[best].positions[0]))) {
+        best = restockedWaitlists[w];
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+    int position = popWaitlist(&waitlists->waitlists[best], orders);
+    if (position >= orderCount || orders[position].orderStatus != 99 || (orderValid != NULL && !orderValid[position])) {
+      continue; // No longer waiting
+    }
+    if (!isEvaluated[position]) {
+      isEvaluated[position] = 1;
+      summary->retriedCount++;
+      if (fulfillOrder(work, &orders[position])) {
+        setOrderStatus(rollups, &orders[position], 1);
+        summary->fulfilledCount++;
+        continue;
+      }
+    }
+    if (setAsideCount == setAsideCapacity) {
+      int capacity = setAsideCapacity > 0 ? setAsideCapacity * 2 : 64;
+      SetAsideOrder* grown = (SetAsideOrder*)realloc(setAside, (size_t)capacity * sizeof(SetAsideOrder));
+      if (grown == NULL) {
+        pushWaitlist(&waitlists->waitlists[best], orders, position); // Back where it was, no room needed
+        isSuccessful = 0;
+        break;
+      }
+      setAside = grown;
+      setAsideCapacity = capacity;
+    }
+    setAside[setAsideCount].waitlist = best;
+    setAside[setAsideCount].position = position;
+    setAsideCount++;
+  }
+  for (int i = 0; i < setAsideCount; i++) {
+    // Popped from this heap, so it has room for the order again
+    pushWaitlist(&waitlists->waitlists[setAside[i].waitlist], orders, setAside[i].position);
+  }
+  if (!isSuccessful) {
+    logGeneric("Failed to allocate memory for re-fulfilling backordered orders.");
+  }
+  free(setAside);
+  free(isEvaluated);
+  free(restockedWaitlists);
+  return isSuccessful;
+}
+
+// FUNCTION : updateTouchedPartStatuses
+// DESCRIPTION :
+//    Recomputes the partStatus of each part whose quantityOnHand changed. Fulfilling an order
+//    takes the same units off the shelf and off the open demand, so a deficit only shrinks by the
+//    units received; otherwise the status follows quantityOnHand (0 above 100, 99 otherwise).
+// PARAMETERS :
+//    ReceiptWork* work: The parts and their receipt totals.
+// RETURNS :
+//    void
+static void updateTouchedPartStatuses(ReceiptWork* work) {
+  for (int i = 0; i < work->partCount; i++) {
+    if (!work->isTouched[i]) {
+      continue;
+    }
+    Part* part = &work->parts[i];
+    long long remaining = (long long)part->partStatus + work->unitsReceived[i];
+    if (part->partStatus < 0 && remaining < 0) {
+      part->partStatus = (int)remaining;
+    }
+    else {
+      part->partStatus = part->quantityOnHand > 100 ? 0 : 99;
+    }
+  }
+}
+
+// FUNCTION : applyReceiptsFile
+// DESCRIPTION :
+//    Adds the stock of a receipts database to the parts, then re-fulfills the backordered orders
+//    waiting for the restocked parts.
+// PARAMETERS :
+//    Part* parts: The parts, updated.
+//    int partCount: Number of parts.
+//    Order* orders: The orders, whose fulfilled backorders get status 1.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+//    BackorderWaitlists* waitlists: The waitlists built from the orders.
+//    CustomerRollups* rollups: Optional, moves the fulfilled orders between status aggregates.
+//    const char* fileName: The receipts database.
+//    int isQuarantining: 1 to quarantine rejected receipts lines.
+//    ReceiptSummary* summary: Receives the counts of the receipts and orders handled.
+// RETURNS :
+//    int : 1 if the receipts were applied, 0 if the file could not be read or memory could not be allocated.
+int applyReceiptsFile(Part* parts, int partCount, Order* orders, const unsigned char* orderValid, int orderCount,
+  BackorderWaitlists* waitlists, CustomerRollups* rollups, const char* fileName, int isQuarantining, ReceiptSummary* summary) {
+  memset(summary, 0, sizeof(ReceiptSummary));
+  ReceiptWork work;
+  memset(&work, 0, sizeof(ReceiptWork));
+  work.parts = parts;
+  work.partCount = partCount;
+  work.unitsReceived = (long long*)calloc(partCount > 0 ? partCount : 1, sizeof(long long));
+  work.isTouched = (unsigned char*)calloc(partCount > 0 ? partCount : 1, sizeof(unsigned char));
+  work.restocked = (int*)malloc((size_t)(partCount > 0 ? partCount : 1) * sizeof(int));
+  if (work.unitsReceived == NULL || work.isTouched == NULL || work.restocked == NULL || !initIdIndex(&work.partIndex, partCount)) {
+    logGeneric("Failed to allocate memory for the receipts.");
+    free(work.unitsReceived);
+    free(work.isTouched);
+    free(work.restocked);
+    return 0;
+  }
+  for (int i = 0; i < partCount; i++) {
+    setIdIndex(&work.partIndex, parts[i].partID, i);
+  }
+  char sourceFileName[260];
+  resolveDatabaseFile(fileName, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* reader = openAsyncReader(sourceFileName);
+  int isSuccessful = reader != NULL;
+  if (reader == NULL) {
+    logGeneric("Failed to open receipts database.");
+  }
+  else {
+    QuarantineWriter quarantine;
+    openQuarantine(&quarantine, fileName, isQuarantining);
+    readReceiptLines(reader, &work, &quarantine, summary);
+    closeAsyncReader(reader);
+    int quarantinedCount = closeQuarantine(&quarantine);
+    if (quarantinedCount > 0) {
+      char message[512];
+      snprintf(message, sizeof(message), "%d rejected lines of the receipts database were quarantined in %s.",
+        quarantinedCount, quarantine.linesFileName);
+      logGeneric(message);
+    }
+    isSuccessful = refulfillBackorders(&work, orders, orderValid, orderCount, waitlists, rollups, summary);
+    updateTouchedPartStatuses(&work);
+  }
+  freeIdIndex(&work.partIndex);
+  free(work.unitsReceived);
+  free(work.isTouched);
+  free(work.restocked);
+  return isSuccessful;
+}
+
+// FUNCTION : freeBackorderWaitlists
+// DESCRIPTION :
+//    Frees the waitlists.
+// PARAMETERS :
+//    BackorderWaitlists* waitlists: The waitlists.
+// RETURNS :
+//    void
+void freeBackorderWaitlists(BackorderWaitlists* waitlists) {
+  for (int i = 0; i < waitlists->waitlistCapacity; i++) {
+    free(waitlists->waitlists[i].positions);
+  }
+  free(waitlists->waitlists);
+  freeIdIndex(&waitlists->partWaitlists);
+  memset(waitlists, 0, sizeof(BackorderWaitlists));
+}
@@ -0,0 +1,42 @@
+// FILE : Receipts.h
+// DESCRIPTION : This header file defines the stock receipts feed and the per-part waitlists of backordered orders it re-fulfills.
+#ifndef RECEIPTS_H
+#define RECEIPTS_H
+
+#include "Index.h"
+#include "Part.h"
+#include "Order.h"
+#include "Rollup.h"
+
+#define NUMBER_OF_RECEIPT_FIELDS 2 // partID|quantity|
+
+typedef struct {
+  int* positions; // Positions of backordered orders, a min-heap by orderDay then orderID
+  int count;
+  int capacity;
+} OrderWaitlist;
+
+typedef struct {
+  IdIndex partWaitlists; // partID -> waitlist number
+  OrderWaitlist* waitlists;
+  int waitlistCount;
+  int waitlistCapacity;
+} BackorderWaitlists;
+
+typedef struct {
+  int lineCount; // Receipt lines read
+  int receivedCount; // Receipt lines applied
+  int rejectedCount;
+  long long unitsReceived;
+  int retriedCount; // Backordered orders re-evaluated
+  int fulfilledCount; // Backordered orders now fulfilled
+} ReceiptSummary;
+
+int initBackorderWaitlists(BackorderWaitlists* waitlists, int partCapacity);
+int buildBackorderWaitlists(BackorderWaitlists* waitlists, const Order* orders, const unsigned char* orderValid, int orderCount);
+int addBackorderedOrder(BackorderWaitlists* waitlists, const Order* orders, int position);
+int applyReceiptsFile(Part* parts, int partCount, Order* orders, const unsigned char* orderValid, int orderCount,
+  BackorderWaitlists* waitlists, CustomerRollups* rollups, const char* fileName, int isQuarantining, ReceiptSummary* summary);
+void freeBackorderWaitlists(BackorderWaitlists* waitlists);
+
+#endif
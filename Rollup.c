@@ -0,0 +1,253 @@
+// FILE : Rollup.c
+// DESCRIPTION :
+//    Implements per-customer order aggregates (open and fulfilled totals, counts per orderStatus).
+//    The aggregates are built while orders load and updated as orders are added, removed or change
+//    status, so credit checks and customer reports do not need to scan the orders array.
+#include "Rollup.h"
+#include "Index.h"
+#include "Logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : initCustomerRollups
+// DESCRIPTION :
+//    Creates an empty set of customer aggregates.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates to initialize.
+//    int capacity: The initial number of customers that fit without growing.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initCustomerRollups(CustomerRollups* rollups, int capacity) {
+  rollups->rollups = (CustomerRollup*)malloc(capacity * sizeof(CustomerRollup));
+  rollups->count = 0;
+  rollups->capacity = capacity;
+  if (rollups->rollups == NULL || !initIdIndex(&rollups->index, capacity)) {
+    logGeneric("Failed to allocate memory for customer order rollups.");
+    free(rollups->rollups);
+    rollups->rollups = NULL;
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : clearCustomerRollups
+// DESCRIPTION :
+//    Removes all aggregates while keeping the memory for reuse.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates to clear.
+// RETURNS :
+//    void
+void clearCustomerRollups(CustomerRollups* rollups) {
+  clearIdIndex(&rollups->index);
+  rollups->count = 0;
+}
+
+// FUNCTION : getOrCreateRollup
+// DESCRIPTION :
+//    Finds the aggregate of a customer, creating an empty one if the customer has none yet.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates.
+//    int customerID: The customer to find.
+// RETURNS :
+//    CustomerRollup* : The customer's aggregate, or NULL if memory could not be allocated.
+static CustomerRollup* getOrCreateRollup(CustomerRollups* rollups, int customerID) {
+  int position = findIdIndex(&rollups->index, customerID);
+  if (position != ID_INDEX_NOT_FOUND) {
+    return &rollups->rollups[position];
+  }
+  if (rollups->count == rollups->capacity) {
+    int newCapacity = rollups->capacity * 2;
+    CustomerRollup* grown = (CustomerRollup*)realloc(rollups->rollups, newCapacity * sizeof(CustomerRollup));
+    if (grown == NULL) {
+      logGeneric("Failed to grow customer order rollups.");
+      return NULL;
+    }
+    rollups->rollups = grown;
+    rollups->capacity = newCapacity;
+  }
+  position = rollups->count;
+  if (!setIdIndex(&rollups->index, customerID, position)) {
+    return NULL;
+  }
+  rollups->count++;
+  CustomerRollup* rollup = &rollups->rollups[position];
+  memset(rollup, 0, sizeof(CustomerRollup));
+  rollup->customerID = customerID;
+  return rollup;
+}
+
+// FUNCTION : applyOrder
+// DESCRIPTION :
+//    Adds (sign 1) or subtracts (sign -1) an order's contribution to its customer's aggregate.
+// PARAMETERS :
+//    CustomerRollup* rollup: The customer's aggregate.
+//    int orderStatus: The status the order is counted under.
+//    float orderTotal: The order total.
+//    int sign: 1 to add the order, -1 to remove it.
+// RETURNS :
+//    void
+static void applyOrder(CustomerRollup* rollup, int orderStatus, float orderTotal, int sign) {
+  rollup->orderCount += sign;
+  if (orderStatus == 0) {
+    rollup->unprocessedCount += sign;
+    rollup->openTotal += sign * (double)orderTotal;
+  }
+  else if (orderStatus == 1) {
+    rollup->fulfilledCount += sign;
+    rollup->fulfilledTotal += sign * (double)orderTotal;
+  }
+  else if (orderStatus == 99) {
+    rollup->insufficientPartsCount += sign;
+    rollup->openTotal += sign * (double)orderTotal;
+  }
+  else if (orderStatus == 500) {
+    rollup->creditExceededCount += sign;
+  }
+}
+
+// FUNCTION : rollupAddOrder
+// DESCRIPTION :
+//    Adds an order to its customer's aggregate.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates.
+//    const Order* order: The order to add.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int rollupAddOrder(CustomerRollups* rollups, const Order* order) {
+  CustomerRollup* rollup = getOrCreateRollup(rollups, order->customerID);
+  if (rollup == NULL) {
+    return 0;
+  }
+  applyOrder(rollup, order->orderStatus, order->orderTotal, 1);
+  return 1;
+}
+
+// FUNCTION : rollupRemoveOrder
+// DESCRIPTION :
+//    Removes an order previously added with rollupAddOrder from its customer's aggregate.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates.
+//    const Order* order: The order to remove.
+// RETURNS :
+//    void
+void rollupRemoveOrder(CustomerRollups* rollups, const Order* order) {
+  int position = findIdIndex(&rollups->index, order->customerID);
+  if (position != ID_INDEX_NOT_FOUND) {
+    applyOrder(&rollups->rollups[position], order->orderStatus, order->orderTotal, -1);
+  }
+}
+
+// FUNCTION : rollupApplyValidityFlips
+// DESCRIPTION :
+//    Removes orders that became invalid and re-adds orders that became valid again
+//    after a part or customer change.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates.
+//    const ValidityFlips* flips: The orders whose validity flipped.
+//    const Order* orders: The orders array the flips refer to.
+// RETURNS :
+//    void
+void rollupApplyValidityFlips(CustomerRollups* rollups, const ValidityFlips* flips, const Order* orders) {
+  for (int i = 0; i < flips->count; i++) {
+    const Order* order = &orders[flips->orderIndexes[i]];
+    if (flips->isNowValid[i]) {
+      rollupAddOrder(rollups, order);
+    }
+    else {
+      rollupRemoveOrder(rollups, order);
+    }
+  }
+}
+
+// FUNCTION : setOrderStatus
+// DESCRIPTION :
+//    Changes the status of an order and moves it between the status aggregates of its customer.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates, or NULL to only change the order.
+//    Order* order: The order to update.
+//    int newStatus: The new orderStatus (0, 1, 99 or 500).
+// RETURNS :
+//    void
+void setOrderStatus(CustomerRollups* rollups, Order* order, int newStatus) {
+  if (rollups != NULL) {
+    rollupRemoveOrder(rollups, order);
+  }
+  order->orderStatus = newStatus;
+  if (rollups != NULL) {
+    rollupAddOrder(rollups, order);
+  }
+}
+
+// FUNCTION : buildCustomerRollups
+// DESCRIPTION :
+//    Rebuilds all aggregates from the orders array in one pass.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates.
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int buildCustomerRollups(CustomerRollups* rollups, const Order* orders, const unsigned char* orderValid, int orderCount) {
+  clearCustomerRollups(rollups);
+  for (int i = 0; i < orderCount; i++) {
+    if ((orderValid == NULL || orderValid[i]) && !rollupAddOrder(rollups, &orders[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : findCustomerRollup
+// DESCRIPTION :
+//    Looks up the aggregate of a customer in O(1).
+// PARAMETERS :
+//    const CustomerRollups* rollups: The aggregates.
+//    int customerID: The customer to find.
+// RETURNS :
+//    const CustomerRollup* : The customer's aggregate, or NULL if the customer has no orders.
+const CustomerRollup* findCustomerRollup(const CustomerRollups* rollups, int customerID) {
+  int position = findIdIndex(&rollups->index, customerID);
+  return position == ID_INDEX_NOT_FOUND ? NULL : &rollups->rollups[position];
+}
+
+// FUNCTION : getCustomerExposure
+// DESCRIPTION :
+//    Calculates what a customer owes plus the value of their open orders.
+// PARAMETERS :
+//    const CustomerRollups* rollups: The aggregates.
+//    const Customer* customer: The customer.
+// RETURNS :
+//    double : The current account balance plus the open order total.
+double getCustomerExposure(const CustomerRollups* rollups, const Customer* customer) {
+  const CustomerRollup* rollup = findCustomerRollup(rollups, customer->customerID);
+  return customer->currentAccountBalance + (rollup == NULL ? 0.0 : rollup->openTotal);
+}
+
+// FUNCTION : isWithinCreditLimit
+// DESCRIPTION :
+//    Checks whether a customer can take on an additional amount without exceeding their credit limit.
+// PARAMETERS :
+//    const CustomerRollups* rollups: The aggregates.
+//    const Customer* customer: The customer.
+//    double additionalAmount: The amount of a new order (0 to check the current exposure).
+// RETURNS :
+//    int : 1 if the exposure stays within customerCreditLimit, 0 otherwise.
+int isWithinCreditLimit(const CustomerRollups* rollups, const Customer* customer, double additionalAmount) {
+  return getCustomerExposure(rollups, customer) + additionalAmount <= customer->customerCreditLimit;
+}
+
+// FUNCTION : freeCustomerRollups
+// DESCRIPTION :
+//    Frees the memory held by the aggregates.
+// PARAMETERS :
+//    CustomerRollups* rollups: The aggregates to free.
+// RETURNS :
+//    void
+void freeCustomerRollups(CustomerRollups* rollups) {
+  freeIdIndex(&rollups->index);
+  free(rollups->rollups);
+  rollups->rollups = NULL;
+  rollups->count = 0;
+  rollups->capacity = 0;
+}
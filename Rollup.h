@@ -0,0 +1,41 @@
+// FILE : Rollup.h
+// DESCRIPTION : This header file defines per-customer order aggregates that are maintained incrementally.
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include "Customer.h"
+#include "Order.h"
+#include "Index.h"
+#include "Dependency.h"
+
+typedef struct {
+  int customerID;
+  double openTotal; // Orders not yet fulfilled (unprocessed or waiting for parts)
+  double fulfilledTotal;
+  int orderCount;
+  int unprocessedCount; // orderStatus 0
+  int fulfilledCount; // orderStatus 1
+  int insufficientPartsCount; // orderStatus 99
+  int creditExceededCount; // orderStatus 500
+} CustomerRollup;
+
+typedef struct {
+  IdIndex index; // customerID -> position in rollups
+  CustomerRollup* rollups;
+  int count;
+  int capacity;
+} CustomerRollups;
+
+int initCustomerRollups(CustomerRollups* rollups, int capacity);
+void clearCustomerRollups(CustomerRollups* rollups);
+int buildCustomerRollups(CustomerRollups* rollups, const Order* orders, const unsigned char* orderValid, int orderCount);
+int rollupAddOrder(CustomerRollups* rollups, const Order* order);
+void rollupRemoveOrder(CustomerRollups* rollups, const Order* order);
+void rollupApplyValidityFlips(CustomerRollups* rollups, const ValidityFlips* flips, const Order* orders);
+void setOrderStatus(CustomerRollups* rollups, Order* order, int newStatus);
+const CustomerRollup* findCustomerRollup(const CustomerRollups* rollups, int customerID);
+double getCustomerExposure(const CustomerRollups* rollups, const Customer* customer);
+int isWithinCreditLimit(const CustomerRollups* rollups, const Customer* customer, double additionalAmount);
+void freeCustomerRollups(CustomerRollups* rollups);
+
+#endif
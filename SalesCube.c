@@ -0,0 +1,372 @@
+// FILE : SalesCube.c
+// DESCRIPTION :
+//    Implements the sales cubes. For each part and each customer with sales there is a Fenwick
+//    tree over the day numbers holding the units, amount and orders of each day, so the total of
+//    any date range is two prefix sums of O(log DAY_NUMBER_COUNT) cells instead of a scan over the
+//    orders and their ordered parts. A new order is added with one point update per tree it touches.
+//    The trees are committed with VirtualAlloc, so only the pages holding the days actually sold on
+//    take memory. The build splits the order lines by tree first, then fills the trees in parallel,
+//    each tree by one worker, so no two workers write the same tree.
+#include "SalesCube.h"
+#include "DateIndex.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  int task; // Tree number across both cubes: part trees first, then customer trees
+  int day;
+  SalesCell cell;
+} SalesContribution;
+
+typedef struct {
+  SalesCell** trees; // Trees of both cubes, indexed by task
+  const SalesContribution* contributions; // Grouped by task
+  const int* taskStarts; // First contribution of each task, taskCount + 1 entries
+  int firstTask;
+  int taskStep;
+  int taskCount;
+} SalesCubeWork;
+
+// FUNCTION : initSalesCube
+// DESCRIPTION :
+//    Creates an empty cube.
+// PARAMETERS :
+//    SalesCube* cube: The cube to initialize.
+//    int keyCapacity: The number of keys expected.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int initSalesCube(SalesCube* cube, int keyCapacity) {
+  memset(cube, 0, sizeof(SalesCube));
+  cube->trees = (SalesCell**)calloc(keyCapacity, sizeof(SalesCell*));
+  if (cube->trees == NULL || !initIdIndex(&cube->keys, keyCapacity)) {
+    free(cube->trees);
+    cube->trees = NULL;
+    return 0;
+  }
+  cube->treeCapacity = keyCapacity;
+  return 1;
+}
+
+// FUNCTION : initSalesCubes
+// DESCRIPTION :
+//    Creates empty part and customer sales cubes.
+// PARAMETERS :
+//    SalesCubes* cubes: The cubes to initialize.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int initSalesCubes(SalesCubes* cubes) {
+  if (!initSalesCube(&cubes->partSales, PARTS_LIMIT) || !initSalesCube(&cubes->customerSales, CUSTOMERS_LIMIT)) {
+    logGeneric("Failed to allocate memory for the sales cubes.");
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : clearSalesCube
+// DESCRIPTION :
+//    Releases the trees of a cube, leaving it empty.
+// PARAMETERS :
+//    SalesCube* cube: The cube.
+// RETURNS :
+//    void
+static void clearSalesCube(SalesCube* cube) {
+  for (int i = 0; i < cube->treeCount; i++) {
+    VirtualFree(cube->trees[i], 0, MEM_RELEASE);
+    cube->trees[i] = NULL;
+  }
+  cube->treeCount = 0;
+  clearIdIndex(&cube->keys);
+}
+
+// FUNCTION : getSalesTree
+// DESCRIPTION :
+//    Finds the tree of a key, creating an empty one if the key has none.
+// PARAMETERS :
+//    SalesCube* cube: The cube.
+//    int key: The partID or customerID.
+// RETURNS :
+//    int : The tree number, or -1 if the cube is full or memory could not be allocated.
+static int getSalesTree(SalesCube* cube, int key) {
+  int number = findIdIndex(&cube->keys, key);
+  if (number != ID_INDEX_NOT_FOUND) {
+    return number;
+  }
+  if (cube->treeCount == cube->treeCapacity) {
+    return -1;
+  }
+  // Fresh pages are zero, and untouched ones are never backed by memory
+  SalesCell* tree = (SalesCell*)VirtualAlloc(NULL, (SIZE_T)DAY_NUMBER_COUNT * sizeof(SalesCell), MEM_RESERVE | MEM_COMMIT,
+    PAGE_READWRITE);
+  if (tree == NULL) {
+    return -1;
+  }
+  number = cube->treeCount;
+  if (!setIdIndex(&cube->keys, key, number)) {
+    VirtualFree(tree, 0, MEM_RELEASE);
+    return -1;
+  }
+  cube->trees[cube->treeCount++] = tree;
+  return number;
+}
+
+// FUNCTION : addSalesCell
+// DESCRIPTION :
+//    Adds a day's sales to a tree.
+// PARAMETERS :
+//    SalesCell* tree: The tree.
+//    int day: The day number.
+//    const SalesCell* cell: The sales to add.
+// RETURNS :
+//    void
+static void addSalesCell(SalesCell* tree, int day, const SalesCell* cell) {
+  if (day < 0 || day >= DAY_NUMBER_COUNT) {
+    return;
+  }
+  for (int i = day + 1; i <= DAY_NUMBER_COUNT; i += i & -i) {
+    tree[i - 1].units += cell->units;
+    tree[i - 1].amount += cell->amount;
+    tree[i - 1].orderCount += cell->orderCount;
+  }
+}
+
+// FUNCTION : sumSalesCells
+// DESCRIPTION :
+//    Adds the sales of the days up to and including a day to a total, or subtracts them.
+// PARAMETERS :
+//    const SalesCell* tree: The tree.
+//    int day: The last day of the prefix, -1 for an empty prefix.
+//    int sign: 1 to add the prefix, -1 to subtract it.
+//    SalesCell* total: The total to update.
+// RETURNS :
+//    void
+static void sumSalesCells(const SalesCell* tree, int day, int sign, SalesCell* total) {
+  for (int i = day + 1; i > 0; i -= i & -i) {
+    total->units += sign * tree[i - 1].units;
+    total->amount += sign * tree[i - 1].amount;
+    total->orderCount += sign * tree[i - 1].orderCount;
+  }
+}
+
+// FUNCTION : fillSalesTrees
+// DESCRIPTION :
+//    Worker that adds the contributions of every taskStep-th tree to that tree.
+// PARAMETERS :
+//    void* argument: The worker's SalesCubeWork.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall fillSalesTrees(void* argument) {
+  SalesCubeWork* work = (SalesCubeWork*)argument;
+  for (int task = work->firstTask; task < work->taskCount; task += work->taskStep) {
+    for (int i = work->taskStarts[task]; i < work->taskStarts[task + 1]; i++) {
+      addSalesCell(work->trees[task], work->contributions[i].day, &work->contributions[i].cell);
+    }
+  }
+  return 0;
+}
+
+// FUNCTION : addContribution
+// DESCRIPTION :
+//    Records one order's sales for the tree of a key, creating the tree if needed.
+// PARAMETERS :
+//    SalesCube* cube: The cube of the key.
+//    int key: The partID or customerID.
+//    int day: The order day.
+//    long long units: Parts ordered.
+//    double amount: The amount.
+//    SalesContribution* contribution: Receives the contribution; its task is the tree number in the cube.
+// RETURNS :
+//    int : 1 on success, 0 if the tree could not be created.
+static int addContribution(SalesCube* cube, int key, int day, long long units, double amount, SalesContribution* contribution) {
+  contribution->task = getSalesTree(cube, key);
+  contribution->day = day;
+  contribution->cell.units = units;
+  contribution->cell.amount = amount;
+  contribution->cell.orderCount = 1;
+  return contribution->task >= 0;
+}
+
+// FUNCTION : buildSalesCubes
+// DESCRIPTION :
+//    Rebuilds both cubes from the valid orders. A part's amount is its current cost times the
+//    quantity ordered.
+// PARAMETERS :
+//    SalesCubes* cubes: The cubes.
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
+//    int orderCount: Number of orders.
+//    const Part* parts: The parts array, for the part costs.
+//    int partCount: Number of parts.
+// RETURNS :
+//    int : The number of orders aggregated, or -1 if memory could not be allocated.
+int buildSalesCubes(SalesCubes* cubes, const Order* orders, const unsigned char* orderValid, int orderCount,
+  const Part* parts, int partCount) {
+  clearSalesCube(&cubes->partSales);
+  clearSalesCube(&cubes->customerSales);
+  IdIndex partIndex;
+  if (!initIdIndex(&partIndex, partCount)) {
+    logGeneric("Failed to allocate memory for the sales cubes.");
+    return -1;
+  }
+  int contributionCount = 0;
+  for (int i = 0; i < partCount; i++) {
+    setIdIndex(&partIndex, parts[i].partID, i);
+  }
+  for (int i = 0; i < orderCount; i++) {
+    contributionCount += orderValid == NULL || orderValid[i] ? 1 + orders[i].distinctParts : 0;
+  }
+  SalesContribution* contributions = (SalesContribution*)malloc((size_t)(contributionCount + 1) * sizeof(SalesContribution));
+  SalesContribution* grouped = (SalesContribution*)malloc((size_t)(contributionCount + 1) * sizeof(SalesContribution));
+  int* taskStarts = (int*)calloc(PARTS_LIMIT + CUSTOMERS_LIMIT + 1, sizeof(int));
+  int* nextSlot = (int*)malloc((PARTS_LIMIT + CUSTOMERS_LIMIT) * sizeof(int));
+  if (contributions == NULL || grouped == NULL || taskStarts == NULL || nextSlot == NULL) {
+    logGeneric("Failed to allocate memory for the sales cubes.");
+    free(contributions);
+    free(grouped);
+    free(taskStarts);
+    free(nextSlot);
+    freeIdIndex(&partIndex);
+    return -1;
+  }
+  // Split the order lines by tree, creating the trees of the keys sold
+  int isBuilt = 1;
+  int aggregatedCount = 0;
+  contributionCount = 0;
+  for (int i = 0; i < orderCount && isBuilt; i++) {
+    const Order* order = &orders[i];
+    if (orderValid != NULL && !orderValid[i]) {
+      continue;
+    }
+    isBuilt &= addContribution(&cubes->customerSales, order->customerID, order->orderDay, order->totalParts,
+      order->orderTotal, &contributions[contributionCount]);
+    contributions[contributionCount++].task += PARTS_LIMIT; // Customer trees follow the part trees
+    for (int p = 0; p < order->distinctParts && isBuilt; p++) {
+      int position = findIdIndex(&partIndex, order->orderedParts[p].partID);
+      int quantity = order->orderedParts[p].quantityOrdered;
+      isBuilt &= addContribution(&cubes->partSales, order->orderedParts[p].partID, order->orderDay, quantity,
+        position != ID_INDEX_NOT_FOUND ? (double)parts[position].partCost * quantity : 0.0, &contributions[contributionCount++]);
+    }
+    aggregatedCount++;
+  }
+  freeIdIndex(&partIndex);
+  if (!isBuilt) {
+    logGeneric("Failed to allocate memory for the sales cubes.");
+    free(contributions);
+    free(grouped);
+    free(taskStarts);
+    free(nextSlot);
+    clearSalesCube(&cubes->partSales);
+    clearSalesCube(&cubes->customerSales);
+    return -1;
+  }
+  // Group the contributions by tree with a counting sort
+  int taskCount = PARTS_LIMIT + CUSTOMERS_LIMIT;
+  SalesCell* trees[PARTS_LIMIT + CUSTOMERS_LIMIT] = { 0 };
+  memcpy(trees, cubes->partSales.trees, cubes->partSales.treeCount * sizeof(SalesCell*));
+  memcpy(trees + PARTS_LIMIT, cubes->customerSales.trees, cubes->customerSales.treeCount * sizeof(SalesCell*));
+  for (int i = 0; i < contributionCount; i++) {
+    taskStarts[contributions[i].task + 1]++;
+  }
+  for (int task = 0; task < taskCount; task++) {
+    taskStarts[task + 1] += taskStarts[task];
+  }
+  memcpy(nextSlot, taskStarts, taskCount * sizeof(int));
+  for (int i = 0; i < contributionCount; i++) {
+    grouped[nextSlot[contributions[i].task]++] = contributions[i];
+  }
+  free(nextSlot);
+  free(contributions);
+  int workerCount = getWorkerCount(contributionCount);
+  SalesCubeWork work[MAX_WORKER_THREADS];
+  for (int w = 0; w < workerCount; w++) {
+    work[w].trees = trees;
+    work[w].contributions = grouped;
+    work[w].taskStarts = taskStarts;
+    work[w].firstTask = w;
+    work[w].taskStep = workerCount;
+    work[w].taskCount = taskCount;
+  }
+  runWorkers(fillSalesTrees, work, sizeof(SalesCubeWork), workerCount);
+  free(grouped);
+  free(taskStarts);
+  return aggregatedCount;
+}
+
+// FUNCTION : salesCubesAddOrder
+// DESCRIPTION :
+//    Adds a new valid order to both cubes.
+// PARAMETERS :
+//    SalesCubes* cubes: The cubes.
+//    const Order* order: The order, with its orderDay set.
+//    const Part* parts: The parts array, for the part costs.
+//    const IdIndex* partIndex: partID -> position in parts.
+// RETURNS :
+//    int : 1 on success, 0 if a tree could not be created.
+int salesCubesAddOrder(SalesCubes* cubes, const Order* order, const Part* parts, const IdIndex* partIndex) {
+  SalesContribution contribution;
+  if (!addContribution(&cubes->customerSales, order->customerID, order->orderDay, order->totalParts, order->orderTotal,
+    &contribution)) {
+    logGeneric("Failed to allocate memory for the sales cubes.");
+    return 0;
+  }
+  addSalesCell(cubes->customerSales.trees[contribution.task], contribution.day, &contribution.cell);
+  for (int p = 0; p < order->distinctParts; p++) {
+    int position = findIdIndex(partIndex, order->orderedParts[p].partID);
+    int quantity = order->orderedParts[p].quantityOrdered;
+    if (!addContribution(&cubes->partSales, order->orderedParts[p].partID, order->orderDay, quantity,
+      position != ID_INDEX_NOT_FOUND ? (double)parts[position].partCost * quantity : 0.0, &contribution)) {
+      logGeneric("Failed to allocate memory for the sales cubes.");
+      return 0;
+    }
+    addSalesCell(cubes->partSales.trees[contribution.task], contribution.day, &contribution.cell);
+  }
+  return 1;
+}
+
+// FUNCTION : querySales
+// DESCRIPTION :
+//    Totals the sales of one part or customer between two days, both included.
+// PARAMETERS :
+//    const SalesCube* cube: The part or customer cube.
+//    int key: The partID or customerID.
+//    int fromDay: The first day number.
+//    int toDay: The last day number.
+//    SalesCell* total: Receives the total, zero when there were no sales.
+// RETURNS :
+//    int : 1 if the key has sales on any day, 0 otherwise.
+int querySales(const SalesCube* cube, int key, int fromDay, int toDay, SalesCell* total) {
+  memset(total, 0, sizeof(SalesCell));
+  int number = findIdIndex(&cube->keys, key);
+  if (number == ID_INDEX_NOT_FOUND) {
+    return 0;
+  }
+  fromDay = fromDay < 0 ? 0 : fromDay;
+  toDay = toDay >= DAY_NUMBER_COUNT ? DAY_NUMBER_COUNT - 1 : toDay;
+  if (fromDay > toDay) {
+    return 1;
+  }
+  sumSalesCells(cube->trees[number], toDay, 1, total);
+  sumSalesCells(cube->trees[number], fromDay - 1, -1, total);
+  return 1;
+}
+
+// FUNCTION : freeSalesCubes
+// DESCRIPTION :
+//    Frees the memory held by both cubes.
+// PARAMETERS :
+//    SalesCubes* cubes: The cubes.
+// RETURNS :
+//    void
+void freeSalesCubes(SalesCubes* cubes) {
+  SalesCube* cubeList[] = { &cubes->partSales, &cubes->customerSales };
+  for (int i = 0; i < 2; i++) {
+    clearSalesCube(cubeList[i]);
+    freeIdIndex(&cubeList[i]->keys);
+    free(cubeList[i]->trees);
+    cubeList[i]->trees = NULL;
+    cubeList[i]->treeCapacity = 0;
+  }
+}
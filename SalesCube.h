@@ -0,0 +1,35 @@
+// FILE : SalesCube.h
+// DESCRIPTION : This header file defines the pre-aggregated sales by (day, partID) and (day, customerID) for date range totals.
+#ifndef SALESCUBE_H
+#define SALESCUBE_H
+
+#include "Order.h"
+#include "Part.h"
+#include "Index.h"
+
+typedef struct {
+  long long units; // Parts ordered
+  double amount; // Part cost times quantity for a part, orderTotal for a customer
+  long long orderCount; // Orders (or order lines, for a part)
+} SalesCell;
+
+typedef struct {
+  IdIndex keys; // partID or customerID -> tree number
+  SalesCell** trees; // One Fenwick tree over day numbers per key, DAY_NUMBER_COUNT cells
+  int treeCount;
+  int treeCapacity;
+} SalesCube;
+
+typedef struct {
+  SalesCube partSales; // (day, partID)
+  SalesCube customerSales; // (day, customerID)
+} SalesCubes;
+
+int initSalesCubes(SalesCubes* cubes);
+int buildSalesCubes(SalesCubes* cubes, const Order* orders, const unsigned char* orderValid, int orderCount,
+  const Part* parts, int partCount);
+int salesCubesAddOrder(SalesCubes* cubes, const Order* order, const Part* parts, const IdIndex* partIndex);
+int querySales(const SalesCube* cube, int key, int fromDay, int toDay, SalesCell* total);
+void freeSalesCubes(SalesCubes* cubes);
+
+#endif
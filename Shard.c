@@ -0,0 +1,648 @@
+// FILE : Shard.c
+// DESCRIPTION :
+//    Implements the sharded orders data set. orders.db can be split into ORDER_SHARD_COUNT files
+//    by a hash of customerID. Each shard file loads on its own, in parallel with the others, and
+//    only shards whose file changed are reloaded. Queries are scattered over the shards and the
+//    results gathered in shard order; queries by customerID go straight to the one shard that
+//    can hold the customer's orders.
+#include "Shard.h"
+#include "FileIO.h"
+#include "Index.h"
+#include "AsyncReader.h"
+#include "Compression.h"
+#include "Parallel.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  ShardedOrders* sharded;
+  const int* shardNumbers; // Shards to load
+  const unsigned long long* writeTimes; // Write time of each shard file to load, recorded once it loads
+  int shardCount;
+  int workerIndex;
+  int workerCount;
+  const Part* parts;
+  int partCount;
+  const Customer* customers;
+  int customerCount;
+  int failedCount; // Shards of this worker whose file could not be read
+} ShardLoadWork;
+
+typedef struct {
+  const ShardedOrders* sharded;
+  int firstShard;
+  int lastShard; // Exclusive
+  OrderPredicate predicate;
+  const void* context;
+  ShardHit* hits; // Buffer of maxHits hits owned by this worker
+  int maxHits;
+  int matchCount;
+} ShardQueryWork;
+
+// FUNCTION : getOrderShard
+// DESCRIPTION :
+//    Chooses the shard of a customer's orders. Sequential IDs are scrambled so they spread across shards.
+// PARAMETERS :
+//    int customerID: The customer ID of the order.
+// RETURNS :
+//    int : The shard number, from 0 to ORDER_SHARD_COUNT - 1.
+int getOrderShard(int customerID) {
+  unsigned int hash = (unsigned int)customerID * 0x9E3779B1u;
+  return (int)((hash >> 16) % ORDER_SHARD_COUNT);
+}
+
+// FUNCTION : getShardFileName
+// DESCRIPTION :
+//    Builds the file name of a shard.
+// PARAMETERS :
+//    int shard: The shard number.
+//    char* fileName: Receives the file name.
+//    int size: The size of the file name buffer.
+// RETURNS :
+//    void
+static void getShardFileName(int shard, char* fileName, int size) {
+  snprintf(fileName, size, ORDER_SHARD_FILE_FORMAT, shard);
+}
+
+// FUNCTION : getShardWriteTime
+// DESCRIPTION :
+//    Reads the last write time of a shard file.
+// PARAMETERS :
+//    const char* fileName: The shard file.
+// RETURNS :
+//    unsigned long long : The last write time, or 0 if the file does not exist.
+static unsigned long long getShardWriteTime(const char* fileName) {
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if (!GetFileAttributesExA(fileName, GetFileExInfoStandard, &attributes)) {
+    return 0;
+  }
+  ULARGE_INTEGER writeTime;
+  writeTime.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
+  writeTime.HighPart = attributes.ftLastWriteTime.dwHighDateTime;
+  return writeTime.QuadPart;
+}
+
+// FUNCTION : parseLineCustomerID
+// DESCRIPTION :
+//    Reads the customerID (4th field) of an order line without splitting it.
+// PARAMETERS :
+//    const char* line: The order line.
+// RETURNS :
+//    int : The customerID, or 0 if the line has fewer fields.
+static int parseLineCustomerID(const char* line) {
+  for (int delimiters = 0; delimiters < 3; delimiters++) {
+    line = strchr(line, '|');
+    if (line == NULL) {
+      return 0;
+    }
+    line++;
+  }
+  return atoi(line);
+}
+
+// FUNCTION : splitOrdersIntoShards
+// DESCRIPTION :
+//    Copies each line of an orders file, unchanged, into the shard file of its customerID.
+//    Shard files that receive no orders are deleted so no stale orders remain.
+//    Lines without a customerID go to shard 0, where loading reports them as invalid.
+//    The orders file may be kept compressed (see resolveDatabaseFile); the shards are written plain.
+// PARAMETERS :
+//    const char* ordersFile: The orders file to split.
+// RETURNS :
+//    int : The number of shard files written, or -1 if a shard file could not be opened or written.
+//          The shard files are then incomplete and should not be loaded until a split succeeds.
+int splitOrdersIntoShards(const char* ordersFile) {
+  char sourceFileName[260];
+  resolveDatabaseFile(ordersFile, sourceFileName, sizeof(sourceFileName));
+  AsyncReader* input = openAsyncReader(sourceFileName);
+  if (input == NULL) {
+    logGeneric("Failed to open orders database for sharding.");
+    return -1;
+  }
+  FILE** outputs = (FILE**)calloc(ORDER_SHARD_COUNT, sizeof(FILE*));
+  if (outputs == NULL) {
+    logGeneric("Failed to allocate memory for sharding orders.");
+    closeAsyncReader(input);
+    return -1;
+  }
+  char fileName[64];
+  char errorMessage[256];
+  char line[2048];
+  int lineNumber = 0;
+  int isSuccessful = 1;
+  errno_t err = 0;
+  while (readAsyncLine(input, line, sizeof(line)) != NULL) {
+    if (line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    lineNumber++;
+    size_t length = strlen(line);
+    if (length >= 2 && line[length - 2] == '\r' && line[length - 1] == '\n') {
+      line[--length - 1] = '\n'; // Read as binary, so "\r\n" endings are still there
+      line[length] = '\0';
+    }
+    if (line[length - 1] != '\n') {
+      if (length == sizeof(line) - 1) {
+        snprintf(errorMessage, sizeof(errorMessage), "In orders database line %d: Line is too long, not sharded.", lineNumber);
+        logGeneric(errorMessage);
+        char rest[256];
+        while (readAsyncLine(input, rest, sizeof(rest)) != NULL && rest[strlen(rest) - 1] != '\n') {
+        }
+        continue;
+      }
+      strcat_s(line, sizeof(line), "\n"); // Last line of the file without a trailing newline
+    }
+    int shard = getOrderShard(parseLineCustomerID(line));
+    if (outputs[shard] == NULL) {
+      getShardFileName(shard, fileName, sizeof(fileName));
+      err = fopen_s(&outputs[shard], fileName, "w");
+      if (err != 0 || outputs[shard] == NULL) {
+        snprintf(errorMessage, sizeof(errorMessage), "Failed to open %s for writing.", fileName);
+        logGeneric(errorMessage);
+        outputs[shard] = NULL;
+        isSuccessful = 0;
+        break;
+      }
+    }
+    if (fputs(line, outputs[shard]) == EOF) {
+      getShardFileName(shard, fileName, sizeof(fileName));
+      snprintf(errorMessage, sizeof(errorMessage), "Failed to write order line %d to %s.", lineNumber, fileName);
+      logGeneric(errorMessage);
+      isSuccessful = 0;
+      break;
+    }
+  }
+  closeAsyncReader(input);
+  int writtenCount = 0;
+  for (int shard = 0; shard < ORDER_SHARD_COUNT; shard++) {
+    if (outputs[shard] != NULL) {
+      if (fclose(outputs[shard]) != 0) { // Buffered lines are only written now, so a full disk can show up here
+        getShardFileName(shard, fileName, sizeof(fileName));
+        snprintf(errorMessage, sizeof(errorMessage), "Failed to write %s.", fileName);
+        logGeneric(errorMessage);
+        isSuccessful = 0;
+      }
+      writtenCount++;
+    }
+    else if (isSuccessful) {
+      getShardFileName(shard, fileName, sizeof(fileName));
+      DeleteFileA(fileName);
+    }
+  }
+  free(outputs);
+  return isSuccessful ? writtenCount : -1;
+}
+
+// FUNCTION : initShardedOrders
+// DESCRIPTION :
+//    Creates an empty sharded data set. Shard memory is allocated when a shard file is first loaded.
+// PARAMETERS :
+//    ShardedOrders* sharded: The data set to initialize.
+//    DuplicatePolicy duplicatePolicy: How repeated orderIDs within a shard are loaded.
+// RETURNS :
+//    void
+void initShardedOrders(ShardedOrders* sharded, DuplicatePolicy duplicatePolicy) {
+  memset(sharded->shards, 0, sizeof(sharded->shards));
+  sharded->duplicatePolicy = duplicatePolicy;
+}
+
+// FUNCTION : loadShardFile
+// DESCRIPTION :
+//    Loads a shard file into an orders buffer grown to the number of lines in the file, so a shard
+//    is not held to ORDERS_LIMIT orders. If the buffer cannot grow, the orders that fit are loaded
+//    and loadStagedOrders logs the lines left out.
+// PARAMETERS :
+//    Order** orders: The orders buffer, NULL or reallocated as needed.
+//    int* capacity: The number of orders the buffer holds, updated.
+//    const char* fileName: The shard file.
+//    const Part* parts: The parts used to validate orders.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers used to validate orders.
+//    int customerCount: Number of customers.
+//    LoadOptions* options: The load options. Its orderCapacity is set to the buffer size.
+// RETURNS :
+//    int : The number of orders loaded, or -1 if the file could not be read. The buffer is then
+//          left as it was.
+static int loadShardFile(Order** orders, int* capacity, const char* fileName, const Part* parts, int partCount,
+  const Customer* customers, int customerCount, LoadOptions* options) {
+  StagedOrders staged;
+  if (!readOrderLines(&staged, fileName, options)) {
+    return -1;
+  }
+  if (staged.count > *capacity) {
+    Order* grownOrders = (Order*)realloc(*orders, staged.count * sizeof(Order));
+    if (grownOrders != NULL) {
+      *orders = grownOrders;
+      *capacity = staged.count;
+    }
+    else {
+      char errorMessage[200];
+      snprintf(errorMessage, sizeof(errorMessage), "Failed to allocate memory for the %d order lines of %s.",
+        staged.count, fileName);
+      logGeneric(errorMessage);
+    }
+  }
+  int orderCount = 0;
+  if (*capacity > 0) {
+    options->orderCapacity = *capacity;
+    orderCount = loadStagedOrders(*orders, &staged, parts, partCount, customers, customerCount, fileName, options);
+  }
+  freeStagedOrders(&staged);
+  return orderCount;
+}
+
+// FUNCTION : loadShardWorker
+// DESCRIPTION :
+//    Thread worker that loads every workerCount-th shard of the list. A shard that fails to load
+//    keeps its earlier orders and write time, so the next call tries it again.
+// PARAMETERS :
+//    void* argument: The ShardLoadWork of this worker.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall loadShardWorker(void* argument) {
+  ShardLoadWork* work = (ShardLoadWork*)argument;
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions)); // No shared sinks, so shards can load concurrently
+  options.duplicatePolicy = work->sharded->duplicatePolicy;
+  char fileName[64];
+  for (int i = work->workerIndex; i < work->shardCount; i += work->workerCount) {
+    OrderShard* shard = &work->sharded->shards[work->shardNumbers[i]];
+    getShardFileName(work->shardNumbers[i], fileName, sizeof(fileName));
+    options.rankings = &shard->rankings; // Each shard has its own, merged when reported
+    int orderCount = loadShardFile(&shard->orders, &shard->capacity, fileName, work->parts, work->partCount,
+      work->customers, work->customerCount, &options);
+    if (orderCount < 0) {
+      work->failedCount++;
+      continue;
+    }
+    shard->count = orderCount;
+    shard->droppedCount = 0; // Counted again once every shard has loaded
+    shard->lastWriteTime = work->writeTimes[i];
+  }
+  return 0;
+}
+
+// FUNCTION : dropCrossShardDuplicates
+// DESCRIPTION :
+//    Drops every order whose orderID is already held by a lower shard, as pageOrderShards does, so
+//    each orderID is counted once. The duplicate policy only applies within a shard, and a damaged
+//    or hand-edited shard file can repeat an orderID of another customer's shard.
+// PARAMETERS :
+//    ShardedOrders* sharded: The loaded shards.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+static int dropCrossShardDuplicates(ShardedOrders* sharded) {
+  IdIndex seen;
+  if (!initIdIndex(&seen, countShardedOrders(sharded))) {
+    logGeneric("Failed to allocate memory for checking orderIDs across the order shards.");
+    return 0;
+  }
+  char fileName[64];
+  char errorMessage[200];
+  int isSuccessful = 1;
+  for (int s = 0; s < ORDER_SHARD_COUNT && isSuccessful; s++) {
+    OrderShard* shard = &sharded->shards[s];
+    int keptCount = 0;
+    for (int i = 0; i < shard->count; i++) {
+      Order* order = &shard->orders[i];
+      int heldBy = findIdIndex(&seen, order->orderID);
+      if (heldBy != ID_INDEX_NOT_FOUND && heldBy != s) {
+        getShardFileName(s, fileName, sizeof(fileName));
+        snprintf(errorMessage, sizeof(errorMessage), "Order %lld in %s is already in an earlier shard, it was not loaded.",
+          order->orderID, fileName);
+        logGeneric(errorMessage);
+        rankingsRemoveOrder(&shard->rankings, order);
+        shard->droppedCount++;
+        continue;
+      }
+      if (heldBy == ID_INDEX_NOT_FOUND && !setIdIndex(&seen, order->orderID, s)) {
+        logGeneric("Failed to allocate memory for checking orderIDs across the order shards.");
+        isSuccessful = 0;
+        break;
+      }
+      if (keptCount != i) {
+        shard->orders[keptCount] = *order;
+      }
+      keptCount++;
+    }
+    if (isSuccessful) {
+      shard->count = keptCount;
+    }
+  }
+  freeIdIndex(&seen);
+  return isSuccessful;
+}
+
+// FUNCTION : loadChangedShards
+// DESCRIPTION :
+//    Reloads, in parallel, every shard whose file was created, changed or deleted since it was last loaded.
+//    On the first call this loads all shard files. A shard file that cannot be read is left out of
+//    the count and tried again on the next call. An orderID held by more than one shard is kept in
+//    the lowest one; shards that lost orders this way are reloaded whenever another shard changes,
+//    in case the lower copy is gone.
+// PARAMETERS :
+//    ShardedOrders* sharded: The data set to refresh.
+//    const Part* parts: The parts used to validate orders.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers used to validate orders.
+//    int customerCount: Number of customers.
+// RETURNS :
+//    int : The number of shards reloaded, or -1 on failure.
+int loadChangedShards(ShardedOrders* sharded, const Part* parts, int partCount, const Customer* customers, int customerCount) {
+  int changedShards[ORDER_SHARD_COUNT];
+  unsigned long long changedWriteTimes[ORDER_SHARD_COUNT];
+  int changedCount = 0;
+  int retryShards[ORDER_SHARD_COUNT]; // Unchanged shards that lost orders to a lower shard
+  int retryCount = 0;
+  int reloadedCount = 0;
+  char fileName[64];
+  for (int i = 0; i < ORDER_SHARD_COUNT; i++) {
+    OrderShard* shard = &sharded->shards[i];
+    getShardFileName(i, fileName, sizeof(fileName));
+    unsigned long long writeTime = getShardWriteTime(fileName);
+    if (writeTime == shard->lastWriteTime) {
+      if (shard->droppedCount > 0) {
+        retryShards[retryCount++] = i;
+      }
+      continue;
+    }
+    reloadedCount++;
+    if (writeTime == 0) {
+      shard->lastWriteTime = 0;
+      shard->count = 0; // Shard file was deleted
+      shard->droppedCount = 0;
+      clearOrderRankings(&shard->rankings);
+      continue;
+    }
+    if (shard->rankings.customerTotals.capacity == 0 && !initOrderRankings(&shard->rankings, HEAVY_HITTER_SLOTS)) {
+      logGeneric("Failed to allocate memory for an order shard.");
+      return -1;
+    }
+    changedWriteTimes[changedCount] = writeTime;
+    changedShards[changedCount++] = i;
+  }
+  if (reloadedCount == 0) {
+    return 0;
+  }
+  for (int i = 0; i < retryCount; i++) {
+    changedWriteTimes[changedCount] = sharded->shards[retryShards[i]].lastWriteTime;
+    changedShards[changedCount++] = retryShards[i];
+  }
+  reloadedCount += retryCount;
+  if (changedCount == 0) {
+    return reloadedCount;
+  }
+  int workerCount = getTaskWorkerCount(changedCount);
+  ShardLoadWork work[MAX_WORKER_THREADS];
+  for (int w = 0; w < workerCount; w++) {
+    work[w].sharded = sharded;
+    work[w].shardNumbers = changedShards;
+    work[w].writeTimes = changedWriteTimes;
+    work[w].shardCount = changedCount;
+    work[w].workerIndex = w;
+    work[w].workerCount = workerCount;
+    work[w].parts = parts;
+    work[w].partCount = partCount;
+    work[w].customers = customers;
+    work[w].customerCount = customerCount;
+    work[w].failedCount = 0;
+  }
+  runWorkers(loadShardWorker, work, sizeof(ShardLoadWork), workerCount);
+  int failedCount = 0;
+  for (int w = 0; w < workerCount; w++) {
+    failedCount += work[w].failedCount;
+  }
+  if (failedCount > 0) {
+    char errorMessage[128];
+    snprintf(errorMessage, sizeof(errorMessage), "%d shard file(s) could not be loaded, they will be tried again on the next load.",
+      failedCount);
+    logGeneric(errorMessage);
+  }
+  if (!dropCrossShardDuplicates(sharded)) {
+    return -1;
+  }
+  return reloadedCount - failedCount;
+}
+
+// FUNCTION : pageOrderShards
+// DESCRIPTION :
+//    Loads the shard files one at a time and appends their orders to a paged order store, so the
+//    order history is searchable with only one shard and the store's buffer pool in memory. An
+//    orderID found in more than one shard is stored once, from the lowest shard.
+// PARAMETERS :
+//    OrderStore* store: The open, empty store to fill.
+//    DuplicatePolicy duplicatePolicy: Applied within each shard.
+//    const Part* parts: The parts used to validate orders.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers used to validate orders.
+//    int customerCount: Number of customers.
+// RETURNS :
+//    int : The number of orders stored, or -1 on failure.
+int pageOrderShards(OrderStore* store, DuplicatePolicy duplicatePolicy, const Part* parts, int partCount,
+  const Customer* customers, int customerCount) {
+  Order* orders = NULL; // Grown to the largest shard file
+  int capacity = 0;
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions));
+  options.duplicatePolicy = duplicatePolicy;
+  char fileName[64];
+  char errorMessage[200];
+  int isSuccessful = 1;
+  for (int shard = 0; shard < ORDER_SHARD_COUNT && isSuccessful; shard++) {
+    getShardFileName(shard, fileName, sizeof(fileName));
+    if (getShardWriteTime(fileName) == 0) {
+      continue;
+    }
+    int orderCount = loadShardFile(&orders, &capacity, fileName, parts, partCount, customers, customerCount, &options);
+    if (orderCount < 0) {
+      isSuccessful = 0; // A store missing a shard would answer lookups wrongly
+      break;
+    }
+    for (int i = 0; i < orderCount; i++) {
+      int result = addStoredOrder(store, &orders[i]);
+      if (result < 0) {
+        isSuccessful = 0;
+        break;
+      }
+      if (result == 0) {
+        snprintf(errorMessage, sizeof(errorMessage), "Order %lld in %s is already in an earlier shard, it was not paged.",
+          orders[i].orderID, fileName);
+        logGeneric(errorMessage);
+      }
+    }
+  }
+  free(orders);
+  if (!isSuccessful) {
+    return -1;
+  }
+  // Written now so later lookups only read
+  if (!flushPageStore(&store->pages)) {
+    return -1;
+  }
+  store->pages.hits = 0; // Counted from here, so they show how lookups use the pool
+  store->pages.faults = 0;
+  store->pages.writeBacks = 0;
+  return countStoredOrders(store);
+}
+
+// FUNCTION : scanShards
+// DESCRIPTION :
+//    Collects the orders matching a predicate in a range of shards.
+// PARAMETERS :
+//    ShardQueryWork* work: The shard range, predicate and hit buffer.
+// RETURNS :
+//    void
+static void scanShards(ShardQueryWork* work) {
+  work->matchCount = 0;
+  for (int s = work->firstShard; s < work->lastShard; s++) {
+    const OrderShard* shard = &work->sharded->shards[s];
+    for (int i = 0; i < shard->count; i++) {
+      if (work->predicate != NULL && !work->predicate(&shard->orders[i], work->context)) {
+        continue;
+      }
+      if (work->matchCount < work->maxHits) {
+        work->hits[work->matchCount].shard = s;
+        work->hits[work->matchCount].position = i;
+      }
+      work->matchCount++;
+    }
+  }
+}
+
+// FUNCTION : queryShardWorker
+// DESCRIPTION :
+//    Thread worker that scans its range of shards.
+// PARAMETERS :
+//    void* argument: The ShardQueryWork of this worker.
+// RETURNS :
+//    unsigned : Always 0.
+static unsigned __stdcall queryShardWorker(void* argument) {
+  scanShards((ShardQueryWork*)argument);
+  return 0;
+}
+
+// FUNCTION : queryShardedOrders
+// DESCRIPTION :
+//    Scatters a query over all shards and gathers the matching orders in shard order.
+//    Large data sets are scanned by several workers, each over a range of shards.
+// PARAMETERS :
+//    const ShardedOrders* sharded: The data set to query.
+//    OrderPredicate predicate: Returns nonzero for matching orders, or NULL to match all orders.
+//    const void* context: Passed to the predicate.
+//    ShardHit* hits: Receives up to maxHits matches.
+//    int maxHits: The size of the hits array.
+// RETURNS :
+//    int : The total number of matches (may exceed maxHits), or -1 on failure.
+int queryShardedOrders(const ShardedOrders* sharded, OrderPredicate predicate, const void* context, ShardHit* hits, int maxHits) {
+  int workerCount = getWorkerCount(countShardedOrders(sharded));
+  ShardQueryWork work[MAX_WORKER_THREADS];
+  int shardsPerWorker = (ORDER_SHARD_COUNT + workerCount - 1) / workerCount;
+  for (int w = 0; w < workerCount; w++) {
+    work[w].sharded = sharded;
+    work[w].firstShard = w * shardsPerWorker < ORDER_SHARD_COUNT ? w * shardsPerWorker : ORDER_SHARD_COUNT;
+    work[w].lastShard = work[w].firstShard + shardsPerWorker < ORDER_SHARD_COUNT ? work[w].firstShard + shardsPerWorker : ORDER_SHARD_COUNT;
+    work[w].predicate = predicate;
+    work[w].context = context;
+    work[w].maxHits = maxHits;
+    work[w].hits = w == 0 ? hits : (ShardHit*)malloc(maxHits * sizeof(ShardHit));
+    if (work[w].hits == NULL) {
+      logGeneric("Failed to allocate memory for a sharded query.");
+      for (int i = 1; i < w; i++) {
+        free(work[i].hits);
+      }
+      return -1;
+    }
+  }
+  runWorkers(queryShardWorker, work, sizeof(ShardQueryWork), workerCount);
+  // Gather: worker 0 already wrote into hits, append the others in shard order
+  int matchCount = work[0].matchCount;
+  for (int w = 1; w < workerCount; w++) {
+    int storedCount = work[w].matchCount < work[w].maxHits ? work[w].matchCount : work[w].maxHits;
+    for (int i = 0; i < storedCount && matchCount + i < maxHits; i++) {
+      hits[matchCount + i] = work[w].hits[i];
+    }
+    matchCount += work[w].matchCount;
+    free(work[w].hits);
+  }
+  return matchCount;
+}
+
+// FUNCTION : findCustomerShardOrders
+// DESCRIPTION :
+//    Finds a customer's orders by scanning only the shard the customerID hashes to.
+// PARAMETERS :
+//    const ShardedOrders* sharded: The data set to query.
+//    int customerID: The customer to find orders for.
+//    ShardHit* hits: Receives up to maxHits matches.
+//    int maxHits: The size of the hits array.
+// RETURNS :
+//    int : The total number of the customer's orders (may exceed maxHits).
+int findCustomerShardOrders(const ShardedOrders* sharded, int customerID, ShardHit* hits, int maxHits) {
+  int shardNumber = getOrderShard(customerID);
+  const OrderShard* shard = &sharded->shards[shardNumber];
+  int matchCount = 0;
+  for (int i = 0; i < shard->count; i++) {
+    if (shard->orders[i].customerID != customerID) {
+      continue;
+    }
+    if (matchCount < maxHits) {
+      hits[matchCount].shard = shardNumber;
+      hits[matchCount].position = i;
+    }
+    matchCount++;
+  }
+  return matchCount;
+}
+
+// FUNCTION : countShardedOrders
+// DESCRIPTION :
+//    Counts the orders loaded across all shards.
+// PARAMETERS :
+//    const ShardedOrders* sharded: The data set.
+// RETURNS :
+//    int : The number of loaded orders.
+int countShardedOrders(const ShardedOrders* sharded) {
+  int orderCount = 0;
+  for (int i = 0; i < ORDER_SHARD_COUNT; i++) {
+    orderCount += sharded->shards[i].count;
+  }
+  return orderCount;
+}
+
+// FUNCTION : mergeShardRankings
+// DESCRIPTION :
+//    Merges the rankings each shard counted while it loaded into rankings across all shards.
+// PARAMETERS :
+//    const ShardedOrders* sharded: The data set.
+//    OrderRankings* merged: Initialized rankings that receive the merged ones.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int mergeShardRankings(const ShardedOrders* sharded, OrderRankings* merged) {
+  clearOrderRankings(merged);
+  for (int i = 0; i < ORDER_SHARD_COUNT; i++) {
+    if (sharded->shards[i].count > 0 && !mergeOrderRankings(merged, &sharded->shards[i].rankings)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// FUNCTION : freeShardedOrders
+// DESCRIPTION :
+//    Frees the memory held by all shards.
+// PARAMETERS :
+//    ShardedOrders* sharded: The data set to free.
+// RETURNS :
+//    void
+void freeShardedOrders(ShardedOrders* sharded) {
+  for (int i = 0; i < ORDER_SHARD_COUNT; i++) {
+    free(sharded->shards[i].orders);
+    freeOrderRankings(&sharded->shards[i].rankings);
+  }
+  initShardedOrders(sharded, sharded->duplicatePolicy);
+}
@@ -0,0 +1,46 @@
+// FILE : Shard.h
+// DESCRIPTION : This header file defines the order data set split into files sharded by customerID, and queries across the shards.
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+#include "FileIO.h"
+#include "OrderStore.h"
+#include "Constants.h"
+
+typedef struct {
+  Order* orders; // Grown to the number of lines in the shard file when it loads
+  int count;
+  int capacity; // Number of orders the orders buffer holds
+  unsigned long long lastWriteTime; // Write time of the shard file when it was loaded, 0 if it does not exist
+  OrderRankings rankings; // Top customers and parts of the shard, counted while it loads
+  int droppedCount; // Orders left out because a lower shard holds their orderID
+} OrderShard;
+
+typedef struct {
+  OrderShard shards[ORDER_SHARD_COUNT];
+  DuplicatePolicy duplicatePolicy; // Applied within each shard
+} ShardedOrders;
+
+typedef struct {
+  int shard;
+  int position; // Position of the order in its shard
+} ShardHit;
+
+typedef int (*OrderPredicate)(const Order* order, const void* context);
+
+int getOrderShard(int customerID);
+int splitOrdersIntoShards(const char* ordersFile);
+void initShardedOrders(ShardedOrders* sharded, DuplicatePolicy duplicatePolicy);
+int loadChangedShards(ShardedOrders* sharded, const Part* parts, int partCount, const Customer* customers, int customerCount);
+int queryShardedOrders(const ShardedOrders* sharded, OrderPredicate predicate, const void* context, ShardHit* hits, int maxHits);
+int findCustomerShardOrders(const ShardedOrders* sharded, int customerID, ShardHit* hits, int maxHits);
+int pageOrderShards(OrderStore* store, DuplicatePolicy duplicatePolicy, const Part* parts, int partCount,
+  const Customer* customers, int customerCount);
+int countShardedOrders(const ShardedOrders* sharded);
+int mergeShardRankings(const ShardedOrders* sharded, OrderRankings* merged);
+void freeShardedOrders(ShardedOrders* sharded);
+
+#endif
@@ -0,0 +1,247 @@
+// FILE : Submit.c
+// DESCRIPTION :
+//    Implements the in-memory submission of orders, customers and parts. A caller that already has
+//    the records as structures hands them over in batches instead of writing database lines for
+//    them to be parsed again. Orders go through the same business rules as a loaded orders line,
+//    checked on the binary values against IdIndex lookups of the customers, parts and orders, and
+//    each accepted order is added to the dependency index, rollups, orderID allocator, backorder
+//    waitlists, sales cubes and rankings on the spot. The order date index is rebuilt once per batch.
+#include "Submit.h"
+#include "Validation.h"
+#include "Update.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <string.h>
+
+// FUNCTION : openOrderSubmitter
+// DESCRIPTION :
+//    Indexes the customers, parts and orders the submitter points at. The submitter is set up by
+//    the caller with the arrays, their counts and the side structures to keep in step, then opened.
+//    It must be opened again after the arrays are changed other than through it.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The submitter, with its arrays and side structures set.
+// RETURNS :
+//    int : 1 if the submitter is ready, 0 if memory could not be allocated.
+int openOrderSubmitter(OrderSubmitter* submitter) {
+  if (!initIdIndex(&submitter->customerIndex, CUSTOMERS_LIMIT) || !initIdIndex(&submitter->partIndex, PARTS_LIMIT) ||
+    !initIdIndex(&submitter->orderIndex, ORDERS_LIMIT) || !initValidityFlips(&submitter->flips, ORDERS_LIMIT)) {
+    logGeneric("Failed to allocate memory for the order submitter.");
+    closeOrderSubmitter(submitter);
+    return 0;
+  }
+  int isIndexed = 1;
+  for (int i = 0; i < *submitter->customerCount; i++) {
+    isIndexed &= setIdIndex(&submitter->customerIndex, submitter->customers[i].customerID, i);
+  }
+  for (int i = 0; i < *submitter->partCount; i++) {
+    isIndexed &= setIdIndex(&submitter->partIndex, submitter->parts[i].partID, i);
+  }
+  for (int i = 0; i < *submitter->orderCount; i++) {
+    isIndexed &= setIdIndex(&submitter->orderIndex, submitter->orders[i].orderID, i);
+  }
+  if (!isIndexed) {
+    logGeneric("Failed to allocate memory for the order submitter.");
+    closeOrderSubmitter(submitter);
+    return 0;
+  }
+  return 1;
+}
+
+// FUNCTION : rejectSubmission
+// DESCRIPTION :
+//    Logs why a submitted order was not accepted.
+// PARAMETERS :
+//    const Order* order: The order.
+//    const char* reason: The failed rules.
+// RETURNS :
+//    void
+static void rejectSubmission(const Order* order, const char* reason) {
+  char errorMessage[4200];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when submitting order %lld: %s", order->orderID, reason);
+  logGeneric(errorMessage);
+}
+
+// FUNCTION : submitOrders
+// DESCRIPTION :
+//    Checks a batch of orders and appends the ones that pass to the orders array. An order whose
+//    orderDate is empty gets the date of its orderID.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The opened submitter.
+//    const Order* orders: The orders to submit.
+//    int count: Number of orders to submit.
+//    int* results: Receives 0 for each accepted order, otherwise its ORDER_RULE_* or SUBMIT_* flags. May be NULL.
+// RETURNS :
+//    int : The number of orders accepted.
+int submitOrders(OrderSubmitter* submitter, const Order* orders, int count, int* results) {
+  char reason[4096];
+  int acceptedCount = 0;
+  for (int i = 0; i < count; i++) {
+    Order order = orders[i];
+    int result = checkOrderRecord(&order, submitter->parts, &submitter->partIndex, &submitter->customerIndex,
+      reason, sizeof(reason));
+    if (result == 0 && findIdIndex(&submitter->orderIndex, order.orderID) != ID_INDEX_NOT_FOUND) {
+      result = SUBMIT_DUPLICATE_ID;
+      strcpy_s(reason, sizeof(reason), "Duplicate order ID.");
+    }
+    if (result == 0 && *submitter->orderCount >= ORDERS_LIMIT) {
+      result = SUBMIT_LIMIT_REACHED;
+      strcpy_s(reason, sizeof(reason), "Order limit reached, cannot add more orders.");
+    }
+    if (results != NULL) {
+      results[i] = result;
+    }
+    if (result != 0) {
+      rejectSubmission(&order, reason);
+      continue;
+    }
+    if (order.orderDate[0] == '\0') {
+      snprintf(order.orderDate, sizeof(order.orderDate), "%04d-%02d-%02d", (int)(order.orderID / 10000000),
+        (int)(order.orderID / 100000 % 100), (int)(order.orderID / 1000 % 100));
+    }
+    order.orderDay = dateToDayNumber(order.orderDate);
+    int position = (*submitter->orderCount)++;
+    submitter->orders[position] = order;
+    setIdIndex(&submitter->orderIndex, order.orderID, position); // Sized for ORDERS_LIMIT, so never grows
+    addOrderDependencies(submitter->deps, &submitter->orders[position], position);
+    if (submitter->orderIds != NULL) {
+      noteOrderID(submitter->orderIds, &order);
+    }
+    if (submitter->rollups != NULL) {
+      rollupAddOrder(submitter->rollups, &order);
+    }
+    if (submitter->waitlists != NULL && order.orderStatus == 99) {
+      addBackorderedOrder(submitter->waitlists, submitter->orders, position);
+    }
+    if (submitter->salesCubes != NULL) {
+      salesCubesAddOrder(submitter->salesCubes, &order, submitter->parts, &submitter->partIndex);
+    }
+    if (submitter->rankings != NULL) {
+      rankingsAddOrder(submitter->rankings, &order);
+    }
+    acceptedCount++;
+  }
+  if (acceptedCount > 0 && submitter->orderDates != NULL) {
+    buildOrderDateIndex(submitter->orderDates, submitter->orders, *submitter->orderCount);
+  }
+  return acceptedCount;
+}
+
+// FUNCTION : applySubmittedFlips
+// DESCRIPTION :
+//    Carries the orders whose validity a submitted customer or part flipped into the rollups and
+//    rankings.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The submitter, holding the flips.
+// RETURNS :
+//    int : 1 if any order flipped, 0 otherwise.
+static int applySubmittedFlips(OrderSubmitter* submitter) {
+  if (submitter->flips.count == 0) {
+    return 0;
+  }
+  if (submitter->rollups != NULL) {
+    rollupApplyValidityFlips(submitter->rollups, &submitter->flips, submitter->orders);
+  }
+  if (submitter->rankings != NULL) {
+    rankingsApplyValidityFlips(submitter->rankings, &submitter->flips, submitter->orders);
+  }
+  return 1;
+}
+
+// FUNCTION : submitCustomers
+// DESCRIPTION :
+//    Adds or replaces a batch of customers, re-validating the orders of each new customer.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The opened submitter.
+//    const Customer* customers: The customers to submit, with all fields filled in.
+//    int count: Number of customers to submit.
+//    int* results: Receives 0 for each accepted customer, otherwise SUBMIT_RECORD_INVALID. May be NULL.
+// RETURNS :
+//    int : The number of customers accepted.
+int submitCustomers(OrderSubmitter* submitter, const Customer* customers, int count, int* results) {
+  int acceptedCount = 0;
+  int isFlipped = 0;
+  for (int i = 0; i < count; i++) {
+    Customer customer = customers[i];
+    customer.fieldState = FIELDS_LOADED;
+    customer.lineOffset = -1;
+    int isNew = findIdIndex(&submitter->customerIndex, customer.customerID) == ID_INDEX_NOT_FOUND;
+    int isAccepted = updateCustomer(submitter->customers, submitter->customerCount, &customer, submitter->parts,
+      *submitter->partCount, submitter->orders, *submitter->orderCount, submitter->deps, &submitter->flips);
+    if (results != NULL) {
+      results[i] = isAccepted ? 0 : SUBMIT_RECORD_INVALID;
+    }
+    if (!isAccepted) {
+      continue;
+    }
+    if (isNew) {
+      setIdIndex(&submitter->customerIndex, customer.customerID, *submitter->customerCount - 1);
+    }
+    isFlipped |= applySubmittedFlips(submitter);
+    acceptedCount++;
+  }
+  if (isFlipped && submitter->waitlists != NULL) {
+    buildBackorderWaitlists(submitter->waitlists, submitter->orders, submitter->deps->orderValid, *submitter->orderCount);
+  }
+  if (isFlipped && submitter->salesCubes != NULL) {
+    buildSalesCubes(submitter->salesCubes, submitter->orders, submitter->deps->orderValid, *submitter->orderCount,
+      submitter->parts, *submitter->partCount);
+  }
+  return acceptedCount;
+}
+
+// FUNCTION : submitParts
+// DESCRIPTION :
+//    Adds or replaces a batch of parts, re-validating the orders of each new part or changed cost.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The opened submitter.
+//    const Part* parts: The parts to submit, with all fields filled in.
+//    int count: Number of parts to submit.
+//    int* results: Receives 0 for each accepted part, otherwise SUBMIT_RECORD_INVALID. May be NULL.
+// RETURNS :
+//    int : The number of parts accepted.
+int submitParts(OrderSubmitter* submitter, const Part* parts, int count, int* results) {
+  int acceptedCount = 0;
+  int isFlipped = 0;
+  for (int i = 0; i < count; i++) {
+    Part part = parts[i];
+    part.fieldState = FIELDS_LOADED;
+    part.lineOffset = -1;
+    int isNew = findIdIndex(&submitter->partIndex, part.partID) == ID_INDEX_NOT_FOUND;
+    int isAccepted = updatePart(submitter->parts, submitter->partCount, &part, submitter->customers,
+      *submitter->customerCount, submitter->orders, *submitter->orderCount, submitter->deps, &submitter->flips);
+    if (results != NULL) {
+      results[i] = isAccepted ? 0 : SUBMIT_RECORD_INVALID;
+    }
+    if (!isAccepted) {
+      continue;
+    }
+    if (isNew) {
+      setIdIndex(&submitter->partIndex, part.partID, *submitter->partCount - 1);
+    }
+    isFlipped |= applySubmittedFlips(submitter);
+    acceptedCount++;
+  }
+  if (isFlipped && submitter->waitlists != NULL) {
+    buildBackorderWaitlists(submitter->waitlists, submitter->orders, submitter->deps->orderValid, *submitter->orderCount);
+  }
+  if (acceptedCount > 0 && submitter->salesCubes != NULL) { // Part amounts follow the part costs
+    buildSalesCubes(submitter->salesCubes, submitter->orders, submitter->deps->orderValid, *submitter->orderCount,
+      submitter->parts, *submitter->partCount);
+  }
+  return acceptedCount;
+}
+
+// FUNCTION : closeOrderSubmitter
+// DESCRIPTION :
+//    Frees the indexes of the submitter. The arrays and side structures stay with the caller.
+// PARAMETERS :
+//    OrderSubmitter* submitter: The submitter.
+// RETURNS :
+//    void
+void closeOrderSubmitter(OrderSubmitter* submitter) {
+  freeIdIndex(&submitter->customerIndex);
+  freeIdIndex(&submitter->partIndex);
+  freeIdIndex(&submitter->orderIndex);
+  freeValidityFlips(&submitter->flips);
+}
@@ -0,0 +1,49 @@
+// FILE : Submit.h
+// DESCRIPTION : This header file defines the in-memory submission of orders, customers and parts as structures, in batches.
+#ifndef SUBMIT_H
+#define SUBMIT_H
+
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+#include "Index.h"
+#include "Dependency.h"
+#include "Rollup.h"
+#include "DateIndex.h"
+#include "OrderId.h"
+#include "Receipts.h"
+#include "SalesCube.h"
+#include "Ranking.h"
+
+// Submission results besides the ORDER_RULE_* flags of Validation.h; 0 means the record was accepted
+#define SUBMIT_DUPLICATE_ID 0x100 // An order with the same orderID is already loaded
+#define SUBMIT_LIMIT_REACHED 0x200 // The orders array is full
+#define SUBMIT_RECORD_INVALID 0x400 // The customer or part failed validation, or its array is full
+
+typedef struct {
+  Customer* customers;
+  int* customerCount;
+  Part* parts;
+  int* partCount;
+  Order* orders;
+  int* orderCount;
+  OrderDependencies* deps;
+  CustomerRollups* rollups; // Optional, kept in step with the accepted orders
+  OrderDateIndex* orderDates; // Optional, rebuilt once per batch of orders
+  OrderIdAllocator* orderIds; // Optional, told about each accepted orderID
+  BackorderWaitlists* waitlists; // Optional, given the accepted orders with status 99
+  SalesCubes* salesCubes; // Optional, given the accepted orders
+  OrderRankings* rankings; // Optional, counts the accepted orders
+  IdIndex customerIndex; // customerID -> position in customers
+  IdIndex partIndex; // partID -> position in parts
+  IdIndex orderIndex; // orderID -> position in orders
+  ValidityFlips flips; // Orders whose validity a submitted customer or part flipped
+} OrderSubmitter;
+
+int openOrderSubmitter(OrderSubmitter* submitter);
+int submitOrders(OrderSubmitter* submitter, const Order* orders, int count, int* results);
+int submitCustomers(OrderSubmitter* submitter, const Customer* customers, int count, int* results);
+int submitParts(OrderSubmitter* submitter, const Part* parts, int count, int* results);
+void closeOrderSubmitter(OrderSubmitter* submitter);
+
+#endif
@@ -0,0 +1,130 @@
+// FILE : Fixtures.c
+// DESCRIPTION :
+//    Builds the records and database files the test suites share, so each suite only states the
+//    fields its checks depend on.
+#include "Fixtures.h"
+#include "DateIndex.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : writeCustomerLines
+// DESCRIPTION :
+//    Writes a customers database of valid customers with IDs 1 to count.
+// PARAMETERS :
+//    const char* fileName: The file to create.
+//    int count: Number of customers.
+// RETURNS :
+//    int : 1 if the file was written, 0 otherwise.
+int writeCustomerLines(const char* fileName, int count) {
+  FILE* file = NULL;
+  if (fopen_s(&file, fileName, "wb") != 0 || file == NULL) {
+    return 0;
+  }
+  for (int i = 1; i <= count; i++) {
+    fprintf(file, "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|%d|500.00|256.00|2024-12-12|2020-01-01|\n", i);
+  }
+  return fclose(file) == 0;
+}
+
+// FUNCTION : writeOrderLines
+// DESCRIPTION :
+//    Writes an orders database of valid orders of part 1 for customer 1, with sequence numbers 1 to count.
+// PARAMETERS :
+//    const char* fileName: The file to create.
+//    int count: Number of orders.
+// RETURNS :
+//    int : 1 if the file was written, 0 otherwise.
+int writeOrderLines(const char* fileName, int count) {
+  FILE* file = NULL;
+  if (fopen_s(&file, fileName, "wb") != 0 || file == NULL) {
+    return 0;
+  }
+  for (int i = 1; i <= count; i++) {
+    fprintf(file, "20250220%03d|2025-02-20|0|1|2.00|1|2|1|2|\n", i);
+  }
+  return fclose(file) == 0;
+}
+
+// FUNCTION : makeTestCustomer
+// DESCRIPTION :
+//    Makes a customer with a credit limit of 1000, a balance and a last payment date.
+// PARAMETERS :
+//    Customer* customer: The customer to fill.
+//    int customerID: The customerID.
+//    float balance: The current account balance.
+//    const char* lastPaymentMade: The last payment date, YYYY-MM-DD.
+// RETURNS :
+//    void
+void makeTestCustomer(Customer* customer, int customerID, float balance, const char* lastPaymentMade) {
+  memset(customer, 0, sizeof(Customer));
+  customer->customerID = customerID;
+  customer->customerCreditLimit = 1000.0f;
+  customer->currentAccountBalance = balance;
+  strcpy_s(customer->lastPaymentMade, sizeof(customer->lastPaymentMade), lastPaymentMade);
+  customer->lastPaymentDay = dateToDayNumber(lastPaymentMade);
+}
+
+// FUNCTION : makeTestOrder
+// DESCRIPTION :
+//    Makes an order with no parts yet; addTestOrderedPart adds them.
+// PARAMETERS :
+//    Order* order: The order to fill.
+//    long long orderID: The orderID.
+//    int orderDay: The order date as a day number.
+//    int orderStatus: The order status, 99 for a backorder.
+//    int customerID: The customer.
+//    float orderTotal: The order total.
+// RETURNS :
+//    void
+void makeTestOrder(Order* order, long long orderID, int orderDay, int orderStatus, int customerID, float orderTotal) {
+  memset(order, 0, sizeof(Order));
+  order->orderID = orderID;
+  order->orderDay = orderDay;
+  order->orderStatus = orderStatus;
+  order->customerID = customerID;
+  order->orderTotal = orderTotal;
+}
+
+// FUNCTION : addTestOrderedPart
+// DESCRIPTION :
+//    Adds a part to an order made by makeTestOrder and counts it in totalParts.
+// PARAMETERS :
+//    Order* order: The order.
+//    int partID: The part.
+//    int quantity: The quantity ordered.
+// RETURNS :
+//    void
+void addTestOrderedPart(Order* order, int partID, int quantity) {
+  order->orderedParts[order->distinctParts].partID = partID;
+  order->orderedParts[order->distinctParts].quantityOrdered = quantity;
+  order->distinctParts++;
+  order->totalParts += quantity;
+}
+
+// FUNCTION : makeRandomOrders
+// DESCRIPTION :
+//    Fills an orders array with random orders of parts 1 to 8 for customers 1 to 5, a fifth of
+//    them invalid, dated around a few busy days and on the first and last day numbers. Seed rand
+//    first for a repeatable set.
+// PARAMETERS :
+//    Order* orders: The orders to fill.
+//    unsigned char* orderValid: Receives the validity flag of each order.
+//    int orderCount: Number of orders.
+// RETURNS :
+//    void
+void makeRandomOrders(Order* orders, unsigned char* orderValid, int orderCount) {
+  for (int i = 0; i < orderCount; i++) {
+    int customerID = 1 + rand() % 5;
+    int orderDay = i == 0 ? 0 : i == 1 ? DAY_NUMBER_COUNT - 1 : 9000 + rand() % 30;
+    makeTestOrder(&orders[i], 20250101000LL + i, orderDay, 0, customerID, 0.0f);
+    int distinctParts = 1 + rand() % 4;
+    for (int p = 0; p < distinctParts; p++) {
+      int partID = 1 + rand() % 8;
+      addTestOrderedPart(&orders[i], partID, 1 + rand() % 9);
+    }
+    orders[i].orderTotal = (float)(1 + rand() % 10000) / 100.0f;
+    orderValid[i] = rand() % 5 != 0;
+  }
+}
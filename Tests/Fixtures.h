@@ -0,0 +1,19 @@
+// FILE : Fixtures.h
+// DESCRIPTION : This header file defines the records and database files shared by the test suites.
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include "Customer.h"
+#include "Order.h"
+
+// A valid parts database line for partID 1, costing 1.00
+#define FIXTURE_PART_LINE "1/4 inch flange bolt|FL8932D|A023-S077-L04-B19|1.00|468|0|1|\n"
+
+int writeCustomerLines(const char* fileName, int count);
+int writeOrderLines(const char* fileName, int count);
+void makeTestCustomer(Customer* customer, int customerID, float balance, const char* lastPaymentMade);
+void makeTestOrder(Order* order, long long orderID, int orderDay, int orderStatus, int customerID, float orderTotal);
+void addTestOrderedPart(Order* order, int partID, int quantity);
+void makeRandomOrders(Order* orders, unsigned char* orderValid, int orderCount);
+
+#endif
@@ -0,0 +1,25 @@
+// FILE : Test.h
+// DESCRIPTION : This header file defines the checks shared by the unit tests and the test suites run by TestMain.c.
+#ifndef TEST_H
+#define TEST_H
+
+// Records a failed check with the file and line it is on, and carries on with the suite
+#define CHECK(condition) checkCondition((condition) != 0, #condition, __FILE__, __LINE__)
+
+void checkCondition(int isTrue, const char* text, const char* file, int line);
+int writeTestFile(const char* fileName, const char* text);
+int readTestFile(const char* fileName, char* text, int size);
+void removeTestFile(const char* fileName);
+
+// One function per suite, each in Test<Module>.c
+void testIdIndex(void);
+void testLoadLimits(void);
+void testExternalSort(void);
+void testQuarantine(void);
+void testCompression(void);
+void testPayments(void);
+void testBackorderWaitlists(void);
+void testSalesCubes(void);
+void testRankings(void);
+
+#endif
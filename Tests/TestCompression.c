@@ -0,0 +1,240 @@
+// FILE : TestCompression.c
+// DESCRIPTION :
+//    Tests the DEFLATE encoder and decoder and the gzip files built from them: round trips of
+//    empty, repetitive and incompressible data, corrupt streams, and gzip files of several members.
+//    zstd files get the same file round trips.
+#include "Test.h"
+#include "Deflate.h"
+#include "Compression.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPRESSION_TEST_FILE "test_compression.db.gz"
+#define COMPRESSION_TEST_ZSTD_FILE "test_compression.db.zst"
+#define COMPRESSION_TEST_FILE_BYTES (3 * GZIP_MEMBER_BYTES + 1234) // Spans several gzip members
+
+// FUNCTION : roundTripDeflate
+// DESCRIPTION :
+//    Compresses data with deflateData and decodes it again with inflateData.
+// PARAMETERS :
+//    const unsigned char* data: The data, at most DEFLATE_MAX_INPUT bytes.
+//    size_t size: The data size.
+//    size_t* compressedSize: Receives the size of the DEFLATE stream.
+// RETURNS :
+//    int : 1 if the decoded data matches, 0 otherwise.
+static int roundTripDeflate(const unsigned char* data, size_t size, size_t* compressedSize) {
+  size_t bound = getDeflateBound(size);
+  unsigned char* compressed = (unsigned char*)malloc(bound);
+  unsigned char* decoded = (unsigned char*)malloc(size + INFLATE_MAX_MATCH);
+  int* matchTable = (int*)malloc(DEFLATE_MATCH_TABLE_ENTRIES * sizeof(int));
+  int isMatching = 0;
+  if (compressed != NULL && decoded != NULL && matchTable != NULL) {
+    *compressedSize = deflateData(data, size, compressed, bound, matchTable);
+    ByteInput input = { compressed, *compressedSize, 0, NULL, NULL };
+    Inflater inflater;
+    initInflater(&inflater, &input, decoded, size + INFLATE_MAX_MATCH, 1);
+    isMatching = *compressedSize > 0 && inflateData(&inflater) == INFLATE_END && inflater.outputPosition == size &&
+      input.position == *compressedSize && memcmp(decoded, data, size) == 0;
+  }
+  free(compressed);
+  free(decoded);
+  free(matchTable);
+  return isMatching;
+}
+
+// FUNCTION : testDeflateRoundTrip
+// DESCRIPTION :
+//    Empty, repetitive and random data survive a round trip; repetitive data shrinks and random
+//    data grows by no more than the stored block headers. Input over DEFLATE_MAX_INPUT is refused.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testDeflateRoundTrip(void) {
+  unsigned char* data = (unsigned char*)malloc(DEFLATE_MAX_INPUT + 1);
+  int* matchTable = (int*)malloc(DEFLATE_MATCH_TABLE_ENTRIES * sizeof(int));
+  unsigned char output[64];
+  if (data == NULL || matchTable == NULL) {
+    CHECK(data != NULL && matchTable != NULL);
+    free(data);
+    free(matchTable);
+    return;
+  }
+  size_t compressedSize = 0;
+  CHECK(roundTripDeflate(data, 0, &compressedSize));
+  size_t length = 0;
+  while (length < DEFLATE_MAX_INPUT) {
+    char line[128];
+    int lineLength = snprintf(line, sizeof(line), "%lld|2025-02-20|0|%d|6.50|1|100|44|100|\n",
+      20250220000LL + (long long)length % 997, (int)(length % 50) + 1);
+    if (length + lineLength > DEFLATE_MAX_INPUT) {
+      break;
+    }
+    memcpy(data + length, line, lineLength);
+    length += lineLength;
+  }
+  CHECK(roundTripDeflate(data, length, &compressedSize));
+  CHECK(compressedSize < length / 2);
+  srand(26);
+  for (int i = 0; i < DEFLATE_MAX_INPUT; i++) {
+    data[i] = (unsigned char)(rand() >> 3);
+  }
+  CHECK(roundTripDeflate(data, DEFLATE_MAX_INPUT, &compressedSize));
+  CHECK(compressedSize <= getDeflateBound(DEFLATE_MAX_INPUT));
+  memset(data, 'A', 300);
+  CHECK(roundTripDeflate(data, 300, &compressedSize)); // One match reaching back a single byte
+  CHECK(deflateData(data, DEFLATE_MAX_INPUT + 1, output, sizeof(output), matchTable) == 0);
+  CHECK(deflateData(data, 300, output, 1, matchTable) == 0);
+  free(data);
+  free(matchTable);
+}
+
+// FUNCTION : testInflateCorruptData
+// DESCRIPTION :
+//    A stream with a reserved block type and a stream cut short are reported as errors.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testInflateCorruptData(void) {
+  unsigned char decoded[1024];
+  const unsigned char reservedBlock[] = { 0x07 }; // Last block, type 3
+  ByteInput input = { reservedBlock, sizeof(reservedBlock), 0, NULL, NULL };
+  Inflater inflater;
+  initInflater(&inflater, &input, decoded, sizeof(decoded), 1);
+  CHECK(inflateData(&inflater) == INFLATE_ERROR);
+  const unsigned char text[] = "a line that will be cut short, a line that will be cut short";
+  unsigned char compressed[256];
+  int* matchTable = (int*)malloc(DEFLATE_MATCH_TABLE_ENTRIES * sizeof(int));
+  if (matchTable == NULL) {
+    CHECK(matchTable != NULL);
+    return;
+  }
+  size_t compressedSize = deflateData(text, sizeof(text), compressed, sizeof(compressed), matchTable);
+  CHECK(compressedSize > 2);
+  ByteInput truncated = { compressed, compressedSize / 2, 0, NULL, NULL };
+  initInflater(&inflater, &truncated, decoded, sizeof(decoded), 1);
+  CHECK(inflateData(&inflater) == INFLATE_ERROR);
+  free(matchTable);
+}
+
+// FUNCTION : readCompressedFile
+// DESCRIPTION :
+//    Decompresses a whole gzip or zstd file held in memory.
+// PARAMETERS :
+//    const unsigned char* compressed: The file content.
+//    size_t compressedSize: The file size.
+//    char* text: Receives the decompressed data.
+//    size_t size: The size of the text buffer.
+// RETURNS :
+//    size_t : The decompressed size, or size + 1 if the file could not be opened or has more data.
+static size_t readCompressedFile(const unsigned char* compressed, size_t compressedSize, char* text, size_t size) {
+  Decompressor* decompressor = openDecompressor(getCompressionByMagic(compressed, compressedSize), COMPRESSION_TEST_FILE,
+    compressed, compressedSize, NULL, NULL);
+  if (decompressor == NULL) {
+    return size + 1;
+  }
+  size_t length = 0;
+  const char* chunk = NULL;
+  size_t chunkSize = 0;
+  while ((chunkSize = readDecompressed(decompressor, &chunk)) > 0) {
+    if (chunkSize > size - length) {
+      closeDecompressor(decompressor);
+      return size + 1;
+    }
+    memcpy(text + length, chunk, chunkSize);
+    length += chunkSize;
+  }
+  closeDecompressor(decompressor);
+  return length;
+}
+
+// FUNCTION : roundTripCompressedFile
+// DESCRIPTION :
+//    Writes data to a compressed file in uneven pieces and reads it back.
+// PARAMETERS :
+//    int compression: COMPRESSION_GZIP or COMPRESSION_ZSTD.
+//    const char* data: The data.
+//    size_t size: The data size.
+//    char* text: Receives the data read back, at least size bytes.
+// RETURNS :
+//    int : 1 if the data read back matches, 0 otherwise.
+static int roundTripCompressedFile(int compression, const char* data, size_t size, char* text) {
+  FILE* file = NULL;
+  if (fopen_s(&file, COMPRESSION_TEST_FILE, "wb") != 0 || file == NULL) {
+    return 0;
+  }
+  CompressedWriter* writer = openCompressedWriter(file, compression);
+  int isWritten = writer != NULL;
+  for (size_t written = 0; written < size && isWritten; ) {
+    size_t piece = size - written < 1000 + written % 777 ? size - written : 1000 + written % 777;
+    isWritten = writeCompressed(writer, data + written, piece);
+    written += piece;
+  }
+  isWritten = writer != NULL && closeCompressedWriter(writer) && isWritten;
+  isWritten = fclose(file) == 0 && isWritten;
+  if (!isWritten) {
+    return 0;
+  }
+  unsigned char* compressed = (unsigned char*)malloc(size + 4096);
+  file = NULL;
+  if (compressed == NULL || fopen_s(&file, COMPRESSION_TEST_FILE, "rb") != 0 || file == NULL) {
+    free(compressed);
+    return 0;
+  }
+  size_t compressedSize = fread(compressed, 1, size + 4096, file);
+  fclose(file);
+  int isMatching = getCompressionByMagic(compressed, compressedSize) == compression &&
+    readCompressedFile(compressed, compressedSize, text, size) == size && memcmp(text, data, size) == 0;
+  free(compressed);
+  return isMatching;
+}
+
+// FUNCTION : testGzipFiles
+// DESCRIPTION :
+//    An empty gzip file and one of several members both read back as written, and so do zstd
+//    files of the same data.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testGzipFiles(void) {
+  char* data = (char*)malloc(COMPRESSION_TEST_FILE_BYTES);
+  char* text = (char*)malloc(COMPRESSION_TEST_FILE_BYTES);
+  if (data == NULL || text == NULL) {
+    CHECK(data != NULL && text != NULL);
+    free(data);
+    free(text);
+    return;
+  }
+  for (int i = 0; i < COMPRESSION_TEST_FILE_BYTES; i++) {
+    data[i] = i % 61 == 60 ? '\n' : (char)('a' + (i * 7 + i / 61) % 26);
+  }
+  CHECK(roundTripCompressedFile(COMPRESSION_GZIP, data, 0, text));
+  CHECK(roundTripCompressedFile(COMPRESSION_GZIP, data, COMPRESSION_TEST_FILE_BYTES, text));
+#if ZSTD_ENABLED
+  CHECK(roundTripCompressedFile(COMPRESSION_ZSTD, data, 0, text));
+  CHECK(roundTripCompressedFile(COMPRESSION_ZSTD, data, COMPRESSION_TEST_FILE_BYTES, text));
+#endif
+  CHECK(getCompressionByName(COMPRESSION_TEST_FILE) == COMPRESSION_GZIP);
+  CHECK(getCompressionByName(COMPRESSION_TEST_ZSTD_FILE) == COMPRESSION_ZSTD);
+  CHECK(getCompressionByName("orders.db") == COMPRESSION_NONE);
+  removeTestFile(COMPRESSION_TEST_FILE);
+  free(data);
+  free(text);
+}
+
+// FUNCTION : testCompression
+// DESCRIPTION :
+//    Runs the compression tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testCompression(void) {
+  testDeflateRoundTrip();
+  testInflateCorruptData();
+  testGzipFiles();
+}
@@ -0,0 +1,145 @@
+// FILE : TestExternalSort.c
+// DESCRIPTION :
+//    Tests the external merge sort of order files: empty input, ties kept in input order, removing
+//    repeated orderIDs, malformed lines without a key, and inputs cut into more runs than one
+//    merge takes at once.
+#include "Test.h"
+#include "ExternalSort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SORT_TEST_INPUT "test_sort_input.db"
+#define SORT_TEST_SECOND_INPUT "test_sort_second.db"
+#define SORT_TEST_OUTPUT "test_sort_output.db"
+#define SORT_TEST_LINES 6000
+#define SORT_TEST_MEMORY 4096 // Small enough that the test lines are cut into more than MERGE_FAN_IN runs
+
+// FUNCTION : testSortEmptyInput
+// DESCRIPTION :
+//    An empty order file sorts into an empty file, and a missing one fails the sort.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testSortEmptyInput(void) {
+  char text[64];
+  const char* inputFiles[] = { SORT_TEST_INPUT };
+  int duplicateCount = -1;
+  CHECK(writeTestFile(SORT_TEST_INPUT, ""));
+  CHECK(sortOrderFiles(inputFiles, 1, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 1, &duplicateCount) == 0);
+  CHECK(duplicateCount == 0);
+  CHECK(readTestFile(SORT_TEST_OUTPUT, text, sizeof(text)) == 0);
+  removeTestFile(SORT_TEST_INPUT);
+  CHECK(sortOrderFiles(inputFiles, 1, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 1, &duplicateCount) == -1);
+  removeTestFile(SORT_TEST_OUTPUT);
+}
+
+// FUNCTION : testSortDuplicates
+// DESCRIPTION :
+//    Records with the same orderID keep their input order, earlier files first, and only the first
+//    one is kept when removing duplicates. A last line without a newline gets one.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testSortDuplicates(void) {
+  char text[512];
+  const char* inputFiles[] = { SORT_TEST_INPUT, SORT_TEST_SECOND_INPUT };
+  int duplicateCount = -1;
+  CHECK(writeTestFile(SORT_TEST_INPUT, "30|first|\n10|first|\r\n\n20|only|\n"));
+  CHECK(writeTestFile(SORT_TEST_SECOND_INPUT, "10|second|\n30|second|"));
+  CHECK(sortOrderFiles(inputFiles, 2, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 0, &duplicateCount) == 5);
+  CHECK(duplicateCount == 0);
+  readTestFile(SORT_TEST_OUTPUT, text, sizeof(text));
+  CHECK(strcmp(text, "10|first|\n10|second|\n20|only|\n30|first|\n30|second|\n") == 0);
+  CHECK(sortOrderFiles(inputFiles, 2, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 1, &duplicateCount) == 3);
+  CHECK(duplicateCount == 2);
+  readTestFile(SORT_TEST_OUTPUT, text, sizeof(text));
+  CHECK(strcmp(text, "10|first|\n20|only|\n30|first|\n") == 0);
+  removeTestFile(SORT_TEST_INPUT);
+  removeTestFile(SORT_TEST_SECOND_INPUT);
+  removeTestFile(SORT_TEST_OUTPUT);
+}
+
+// FUNCTION : testSortMalformedLines
+// DESCRIPTION :
+//    Lines that do not start with an orderID sort first in input order and are never removed
+//    as duplicates of each other.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testSortMalformedLines(void) {
+  char text[512];
+  const char* inputFiles[] = { SORT_TEST_INPUT };
+  int duplicateCount = -1;
+  CHECK(writeTestFile(SORT_TEST_INPUT, "5|a|\nbad line\n5|b|\nx|y|\nbad line\n|5|\n"));
+  CHECK(sortOrderFiles(inputFiles, 1, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 1, &duplicateCount) == 5);
+  CHECK(duplicateCount == 1);
+  readTestFile(SORT_TEST_OUTPUT, text, sizeof(text));
+  CHECK(strcmp(text, "bad line\nx|y|\nbad line\n|5|\n5|a|\n") == 0);
+  removeTestFile(SORT_TEST_INPUT);
+  removeTestFile(SORT_TEST_OUTPUT);
+}
+
+// FUNCTION : testSortManyRuns
+// DESCRIPTION :
+//    An input cut into more runs than MERGE_FAN_IN is merged in passes into one sorted file that
+//    keeps every line, with ties in input order.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testSortManyRuns(void) {
+  FILE* input = NULL;
+  if (fopen_s(&input, SORT_TEST_INPUT, "wb") != 0 || input == NULL) {
+    CHECK(input != NULL);
+    return;
+  }
+  srand(34);
+  for (int i = 0; i < SORT_TEST_LINES; i++) {
+    fprintf(input, "%d|%d|\n", 1 + rand() % (SORT_TEST_LINES / 4), i);
+  }
+  fclose(input);
+  const char* inputFiles[] = { SORT_TEST_INPUT };
+  int duplicateCount = -1;
+  CHECK(sortOrderFiles(inputFiles, 1, SORT_TEST_OUTPUT, SORT_TEST_MEMORY, 0, &duplicateCount) == SORT_TEST_LINES);
+  FILE* output = NULL;
+  if (fopen_s(&output, SORT_TEST_OUTPUT, "r") != 0 || output == NULL) {
+    CHECK(output != NULL);
+    removeTestFile(SORT_TEST_INPUT);
+    return;
+  }
+  int lineCount = 0;
+  int isOrdered = 1;
+  int lastOrderID = 0;
+  int lastSequence = -1;
+  int orderID = 0;
+  int sequence = 0;
+  while (fscanf_s(output, "%d|%d|\n", &orderID, &sequence) == 2) {
+    isOrdered &= orderID > lastOrderID || (orderID == lastOrderID && sequence > lastSequence);
+    lastOrderID = orderID;
+    lastSequence = sequence;
+    lineCount++;
+  }
+  fclose(output);
+  CHECK(lineCount == SORT_TEST_LINES);
+  CHECK(isOrdered);
+  removeTestFile(SORT_TEST_INPUT);
+  removeTestFile(SORT_TEST_OUTPUT);
+}
+
+// FUNCTION : testExternalSort
+// DESCRIPTION :
+//    Runs the external sort tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testExternalSort(void) {
+  testSortEmptyInput();
+  testSortDuplicates();
+  testSortMalformedLines();
+  testSortManyRuns();
+}
@@ -0,0 +1,244 @@
+// FILE : TestFileIO.c
+// DESCRIPTION :
+//    Tests the database loaders at their edges: empty and missing files, files with more records
+//    than the arrays hold, repeated IDs under each duplicate policy, malformed lines, and lines of
+//    trusted files that could not be parsed safely.
+#include "Test.h"
+#include "Fixtures.h"
+#include "FileIO.h"
+#include "Checksum.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOAD_TEST_CUSTOMERS "test_load_customers.db"
+#define LOAD_TEST_PARTS "test_load_parts.db"
+#define LOAD_TEST_ORDERS "test_load_orders.db"
+
+// FUNCTION : testEmptyDatabases
+// DESCRIPTION :
+//    Empty files load no records; a missing customers or parts file is an error and a missing
+//    orders file loads nothing.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testEmptyDatabases(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  CHECK(writeTestFile(LOAD_TEST_CUSTOMERS, ""));
+  CHECK(writeTestFile(LOAD_TEST_PARTS, "\n\r\n"));
+  CHECK(writeTestFile(LOAD_TEST_ORDERS, ""));
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, NULL) == 0);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, NULL) == 0);
+  CHECK(loadOrders(orders, parts, 0, customers, 0, LOAD_TEST_ORDERS, NULL) == 0);
+  removeTestFile(LOAD_TEST_CUSTOMERS);
+  removeTestFile(LOAD_TEST_PARTS);
+  removeTestFile(LOAD_TEST_ORDERS);
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, NULL) == -1);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, NULL) == -1);
+  CHECK(loadOrders(orders, parts, 0, customers, 0, LOAD_TEST_ORDERS, NULL) == 0);
+}
+
+// FUNCTION : testFullArrays
+// DESCRIPTION :
+//    Files with more records than the limits fill the arrays exactly and stop there.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testFullArrays(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  CHECK(writeCustomerLines(LOAD_TEST_CUSTOMERS, CUSTOMERS_LIMIT + 3));
+  CHECK(writeTestFile(LOAD_TEST_PARTS, FIXTURE_PART_LINE));
+  CHECK(writeOrderLines(LOAD_TEST_ORDERS, ORDERS_LIMIT + 5));
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, NULL) == CUSTOMERS_LIMIT);
+  CHECK(customers[CUSTOMERS_LIMIT - 1].customerID == CUSTOMERS_LIMIT);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, NULL) == 1);
+  CHECK(loadOrders(orders, parts, 1, customers, CUSTOMERS_LIMIT, LOAD_TEST_ORDERS, NULL) == ORDERS_LIMIT);
+  CHECK(orders[ORDERS_LIMIT - 1].orderID == 20250220000LL + ORDERS_LIMIT);
+  // A full array takes no appended records
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions));
+  options.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  options.existingCount = ORDERS_LIMIT;
+  CHECK(writeTestFile(LOAD_TEST_ORDERS, "20250220099|2025-02-20|0|1|2.00|1|2|1|2|\n"));
+  CHECK(loadOrders(orders, parts, 1, customers, CUSTOMERS_LIMIT, LOAD_TEST_ORDERS, &options) == ORDERS_LIMIT);
+  removeTestFile(LOAD_TEST_CUSTOMERS);
+  removeTestFile(LOAD_TEST_PARTS);
+  removeTestFile(LOAD_TEST_ORDERS);
+}
+
+// FUNCTION : testDuplicatePolicies
+// DESCRIPTION :
+//    Repeated orderIDs keep the first record, keep the last one, or reject them all, and each
+//    repeat is reported.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testDuplicatePolicies(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  CHECK(writeCustomerLines(LOAD_TEST_CUSTOMERS, 1));
+  CHECK(writeTestFile(LOAD_TEST_PARTS, FIXTURE_PART_LINE));
+  CHECK(writeTestFile(LOAD_TEST_ORDERS,
+    "20250220001|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220002|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220001|2025-02-20|0|1|3.00|1|3|1|3|\n"));
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, NULL) == 1);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, NULL) == 1);
+  DuplicateReport duplicates;
+  CHECK(initDuplicateReport(&duplicates, 16));
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions));
+  options.duplicates = &duplicates;
+  options.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  CHECK(loadOrders(orders, parts, 1, customers, 1, LOAD_TEST_ORDERS, &options) == 2);
+  CHECK(orders[0].orderID == 20250220001LL && orders[0].totalParts == 2);
+  CHECK(duplicates.count == 1 && duplicates.ids[0] == 20250220001LL && duplicates.lineNumbers[0] == 3);
+  duplicates.count = 0;
+  options.duplicatePolicy = DUPLICATE_KEEP_LAST;
+  CHECK(loadOrders(orders, parts, 1, customers, 1, LOAD_TEST_ORDERS, &options) == 2);
+  CHECK(orders[0].orderID == 20250220001LL && orders[0].totalParts == 3);
+  CHECK(orders[1].orderID == 20250220002LL);
+  CHECK(duplicates.count == 1);
+  duplicates.count = 0;
+  options.duplicatePolicy = DUPLICATE_REJECT;
+  CHECK(loadOrders(orders, parts, 1, customers, 1, LOAD_TEST_ORDERS, &options) == 1);
+  CHECK(orders[0].orderID == 20250220002LL);
+  freeDuplicateReport(&duplicates);
+  removeTestFile(LOAD_TEST_CUSTOMERS);
+  removeTestFile(LOAD_TEST_PARTS);
+  removeTestFile(LOAD_TEST_ORDERS);
+}
+
+// FUNCTION : testMalformedLines
+// DESCRIPTION :
+//    Lines with a wrong field count, a bad date, a non-numeric ID, a wrong total or an unknown
+//    part are rejected and the valid lines around them still load.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testMalformedLines(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  CHECK(writeTestFile(LOAD_TEST_CUSTOMERS,
+    "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|1|500.00|256.00|2024-12-12|2020-01-01|\n"
+    "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|2|500.00|256.00|2024-12-12|\n"
+    "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|x|500.00|256.00|2024-12-12|2020-01-01|\n"));
+  CHECK(writeTestFile(LOAD_TEST_PARTS,
+    FIXTURE_PART_LINE
+    "1/4 inch flange bolt|FL8932D|bad location|1.00|468|0|2|\n"));
+  CHECK(writeTestFile(LOAD_TEST_ORDERS,
+    "garbage\n"
+    "20250220001|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220002|2025-02-31|0|1|2.00|1|2|1|2|\n"
+    "2025022000x|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220004|2025-02-20|0|1|9.00|1|2|1|2|\n"
+    "20250220005|2025-02-20|0|1|2.00|1|2|7|2|\n"
+    "20250220006|2025-02-20|0|1|2.00|1|2|1|2|"));
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, NULL) == 1);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, NULL) == 1);
+  CHECK(loadOrders(orders, parts, 1, customers, 1, LOAD_TEST_ORDERS, NULL) == 2);
+  CHECK(orders[0].orderID == 20250220001LL && orders[1].orderID == 20250220006LL);
+  removeTestFile(LOAD_TEST_CUSTOMERS);
+  removeTestFile(LOAD_TEST_PARTS);
+  removeTestFile(LOAD_TEST_ORDERS);
+}
+
+// FUNCTION : writeTestChecksum
+// DESCRIPTION :
+//    Writes the checksum file that lets a test database load as trusted.
+// PARAMETERS :
+//    const char* fileName: The database file.
+// RETURNS :
+//    int : 1 on success, 0 otherwise.
+static int writeTestChecksum(const char* fileName) {
+  unsigned long crc = 0;
+  char checksumFileName[260];
+  char text[16];
+  if (!computeFileCrc32(fileName, &crc)) {
+    return 0;
+  }
+  snprintf(checksumFileName, sizeof(checksumFileName), "%s%s", fileName, CHECKSUM_SUFFIX);
+  snprintf(text, sizeof(text), "%08lx\n", crc);
+  return writeTestFile(checksumFileName, text);
+}
+
+// FUNCTION : removeTestChecksum
+// DESCRIPTION :
+//    Deletes a database file and its checksum file.
+// PARAMETERS :
+//    const char* fileName: The database file.
+// RETURNS :
+//    void
+static void removeTestChecksum(const char* fileName) {
+  char checksumFileName[260];
+  snprintf(checksumFileName, sizeof(checksumFileName), "%s%s", fileName, CHECKSUM_SUFFIX);
+  removeTestFile(fileName);
+  removeTestFile(checksumFileName);
+}
+
+// FUNCTION : testTrustedLines
+// DESCRIPTION :
+//    Trusted files skip the format checks, but a text field longer than its record field, a date
+//    outside 2000 to 2100 or a distinct parts count that does not match the parts given is still
+//    rejected instead of being parsed.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testTrustedLines(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  CHECK(writeTestFile(LOAD_TEST_CUSTOMERS,
+    "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|1|500.00|256.00|2024-12-12|2020-01-01|\n"
+    "Smith, John Jacob Jingleheimer Schmidt of Any Town, Ontario|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|"
+    "jsmith@gmail.com|2|500.00|256.00|2024-12-12|2020-01-01|\n"
+    "Smith, John|123 Any Street|Any Town|ON|M4G2H7|555-555-1212|jsmith@gmail.com|3|500.00|256.00||1899-01-01|\n"));
+  CHECK(writeTestFile(LOAD_TEST_PARTS,
+    FIXTURE_PART_LINE
+    "1/4 inch flange bolt|FL8932D|A023-S077-L04-B19-X000-Y000|1.00|468|0|2|\n"));
+  CHECK(writeTestFile(LOAD_TEST_ORDERS,
+    "20250220001|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220002|2025-02-20|0|1|2.00|60|2|1|2|\n"
+    "21010101001|2101-01-01|0|1|2.00|1|2|1|2|\n"
+    "20250220004|2025-02-20|0|1|2.00|1|2|1|2|\n"));
+  CHECK(writeTestChecksum(LOAD_TEST_CUSTOMERS));
+  CHECK(writeTestChecksum(LOAD_TEST_PARTS));
+  CHECK(writeTestChecksum(LOAD_TEST_ORDERS));
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions));
+  options.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  options.trustedFiles = TRUSTED_CUSTOMERS | TRUSTED_PARTS | TRUSTED_ORDERS;
+  CHECK(loadCustomers(customers, LOAD_TEST_CUSTOMERS, &options) == 1);
+  CHECK(loadParts(parts, LOAD_TEST_PARTS, &options) == 1);
+  CHECK(loadOrders(orders, parts, 1, customers, 1, LOAD_TEST_ORDERS, &options) == 2);
+  CHECK(orders[0].orderID == 20250220001LL && orders[1].orderID == 20250220004LL);
+  removeTestChecksum(LOAD_TEST_CUSTOMERS);
+  removeTestChecksum(LOAD_TEST_PARTS);
+  removeTestChecksum(LOAD_TEST_ORDERS);
+}
+
+// FUNCTION : testLoadLimits
+// DESCRIPTION :
+//    Runs the loader edge case tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testLoadLimits(void) {
+  testEmptyDatabases();
+  testFullArrays();
+  testDuplicatePolicies();
+  testMalformedLines();
+  testTrustedLines();
+}
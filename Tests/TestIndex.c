@@ -0,0 +1,90 @@
+// FILE : TestIndex.c
+// DESCRIPTION :
+//    Tests the ID index: lookups in an empty index, growing past the expected count, repeated
+//    keys and the reserved empty key.
+#include "Test.h"
+#include "Index.h"
+#include "Constants.h"
+
+// FUNCTION : testEmptyIdIndex
+// DESCRIPTION :
+//    An index with nothing in it finds nothing, even when sized for nothing.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testEmptyIdIndex(void) {
+  IdIndex index;
+  CHECK(initIdIndex(&index, 0));
+  CHECK(index.count == 0);
+  CHECK(findIdIndex(&index, 1) == ID_INDEX_NOT_FOUND);
+  CHECK(findIdIndex(&index, ID_INDEX_EMPTY_KEY) == ID_INDEX_NOT_FOUND);
+  clearIdIndex(&index);
+  CHECK(findIdIndex(&index, 1) == ID_INDEX_NOT_FOUND);
+  freeIdIndex(&index);
+  CHECK(findIdIndex(&index, 1) == ID_INDEX_NOT_FOUND); // A freed index has no slots
+}
+
+// FUNCTION : testIdIndexGrowth
+// DESCRIPTION :
+//    Every key stays findable after the index grows well past the count it was sized for,
+//    including orderIDs too large for an int.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testIdIndexGrowth(void) {
+  IdIndex index;
+  CHECK(initIdIndex(&index, ORDERS_LIMIT));
+  int isSet = 1;
+  for (int i = 0; i < 5000; i++) {
+    isSet &= setIdIndex(&index, 20250101000LL + i * 7, i);
+  }
+  CHECK(isSet);
+  CHECK(index.count == 5000);
+  int isFound = 1;
+  for (int i = 0; i < 5000; i++) {
+    isFound &= findIdIndex(&index, 20250101000LL + i * 7) == i;
+  }
+  CHECK(isFound);
+  CHECK(findIdIndex(&index, 20250101001LL) == ID_INDEX_NOT_FOUND);
+  CHECK(index.count * 10 <= index.capacity * 7);
+  freeIdIndex(&index);
+}
+
+// FUNCTION : testIdIndexDuplicateKeys
+// DESCRIPTION :
+//    Setting a key again replaces its position without adding an entry, and the empty key is refused.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testIdIndexDuplicateKeys(void) {
+  IdIndex index;
+  CHECK(initIdIndex(&index, CUSTOMERS_LIMIT));
+  CHECK(setIdIndex(&index, 42, 0));
+  CHECK(setIdIndex(&index, 42, 7));
+  CHECK(index.count == 1);
+  CHECK(findIdIndex(&index, 42) == 7);
+  CHECK(!setIdIndex(&index, ID_INDEX_EMPTY_KEY, 3));
+  CHECK(index.count == 1);
+  clearIdIndex(&index);
+  CHECK(index.count == 0);
+  CHECK(findIdIndex(&index, 42) == ID_INDEX_NOT_FOUND);
+  CHECK(setIdIndex(&index, 42, 2));
+  CHECK(findIdIndex(&index, 42) == 2);
+  freeIdIndex(&index);
+}
+
+// FUNCTION : testIdIndex
+// DESCRIPTION :
+//    Runs the ID index tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testIdIndex(void) {
+  testEmptyIdIndex();
+  testIdIndexGrowth();
+  testIdIndexDuplicateKeys();
+}
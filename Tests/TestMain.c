@@ -0,0 +1,119 @@
+// FILE : TestMain.c
+// DESCRIPTION :
+//    Runs the unit tests of the loaders and the pure-logic modules. Each suite works on its own
+//    test_*.db files in the working directory and removes them when done. The exit code is the
+//    number of failed checks, so the tests can gate a build.
+#include "Test.h"
+#include "Logger.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  const char* name;
+  void (*run)(void);
+} TestSuite;
+
+static int checkCount = 0;
+static int failureCount = 0;
+
+// FUNCTION : checkCondition
+// DESCRIPTION :
+//    Counts a check and prints it when it fails.
+// PARAMETERS :
+//    int isTrue: 1 if the check passed.
+//    const char* text: The checked condition, as written in the test.
+//    const char* file: The test file.
+//    int line: The line of the check.
+// RETURNS :
+//    void
+void checkCondition(int isTrue, const char* text, const char* file, int line) {
+  checkCount++;
+  if (!isTrue) {
+    failureCount++;
+    printf("  FAILED %s:%d: %s\n", file, line, text);
+  }
+}
+
+// FUNCTION : writeTestFile
+// DESCRIPTION :
+//    Creates a database file for a test, replacing any file of that name.
+// PARAMETERS :
+//    const char* fileName: The file to create.
+//    const char* text: The content of the file.
+// RETURNS :
+//    int : 1 if the file was written, 0 otherwise.
+int writeTestFile(const char* fileName, const char* text) {
+  FILE* file = NULL;
+  if (fopen_s(&file, fileName, "wb") != 0 || file == NULL) {
+    return 0;
+  }
+  size_t length = strlen(text);
+  int isWritten = fwrite(text, 1, length, file) == length;
+  return fclose(file) == 0 && isWritten;
+}
+
+// FUNCTION : readTestFile
+// DESCRIPTION :
+//    Reads a whole file written by the code under test, in text mode as it was written.
+// PARAMETERS :
+//    const char* fileName: The file to read.
+//    char* text: Receives the content, ending with '\0'.
+//    int size: The size of the text buffer.
+// RETURNS :
+//    int : The number of bytes read, or -1 if the file cannot be opened.
+int readTestFile(const char* fileName, char* text, int size) {
+  FILE* file = NULL;
+  text[0] = '\0';
+  if (fopen_s(&file, fileName, "r") != 0 || file == NULL) {
+    return -1;
+  }
+  int length = (int)fread(text, 1, size - 1, file);
+  text[length] = '\0';
+  fclose(file);
+  return length;
+}
+
+// FUNCTION : removeTestFile
+// DESCRIPTION :
+//    Deletes a file made by a test, if it exists.
+// PARAMETERS :
+//    const char* fileName: The file to delete.
+// RETURNS :
+//    void
+void removeTestFile(const char* fileName) {
+  remove(fileName);
+}
+
+// FUNCTION : main
+// DESCRIPTION :
+//    Runs every suite and prints the checks that failed.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    int : The number of failed checks, 0 if all passed.
+int main() {
+  const TestSuite suites[] = {
+    { "IdIndex", testIdIndex },
+    { "LoadLimits", testLoadLimits },
+    { "ExternalSort", testExternalSort },
+    { "Quarantine", testQuarantine },
+    { "Compression", testCompression },
+    { "Payments", testPayments },
+    { "BackorderWaitlists", testBackorderWaitlists },
+    { "SalesCubes", testSalesCubes },
+    { "Rankings", testRankings }
+  };
+  int suiteCount = (int)(sizeof(suites) / sizeof(suites[0]));
+  int failedSuites = 0;
+  clearLog();
+  for (int i = 0; i < suiteCount; i++) {
+    int failuresBefore = failureCount;
+    printf("%s\n", suites[i].name);
+    suites[i].run();
+    if (failureCount > failuresBefore) {
+      failedSuites++;
+    }
+  }
+  printf("%d checks, %d failed, in %d of %d suites.\n", checkCount, failureCount, failedSuites, suiteCount);
+  return failureCount;
+}
@@ -0,0 +1,89 @@
+// FILE : TestPayments.c
+// DESCRIPTION :
+//    Tests the sorted merge of the payments feed into the customers: payments of unsorted
+//    customers, unknown customers, payments over the balance, malformed lines and empty inputs.
+#include "Test.h"
+#include "Fixtures.h"
+#include "Payments.h"
+#include <string.h>
+
+#define PAYMENTS_TEST_FILE "test_payments.db"
+#define PAYMENTS_TEST_REJECTED_FILE "test_payments.rejected.db"
+#define PAYMENTS_TEST_REASONS_FILE "test_payments.rejected.idx"
+
+// FUNCTION : testEmptyPayments
+// DESCRIPTION :
+//    An empty payments file changes nothing, payments with no customers are all rejected, and a
+//    missing file fails.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testEmptyPayments(void) {
+  Customer customer;
+  PaymentSummary summary;
+  makeTestCustomer(&customer, 1, 100.0f, "2024-12-12");
+  CHECK(writeTestFile(PAYMENTS_TEST_FILE, ""));
+  CHECK(applyPaymentsFile(&customer, 1, PAYMENTS_TEST_FILE, NULL, 0, &summary));
+  CHECK(summary.lineCount == 0 && summary.appliedCount == 0 && summary.rejectedCount == 0);
+  CHECK(customer.currentAccountBalance == 100.0f);
+  CHECK(writeTestFile(PAYMENTS_TEST_FILE, "1|10.00|2025-01-03|\n"));
+  CHECK(applyPaymentsFile(NULL, 0, PAYMENTS_TEST_FILE, NULL, 0, &summary));
+  CHECK(summary.lineCount == 1 && summary.appliedCount == 0 && summary.rejectedCount == 1);
+  removeTestFile(PAYMENTS_TEST_FILE);
+  CHECK(!applyPaymentsFile(&customer, 1, PAYMENTS_TEST_FILE, NULL, 0, &summary));
+}
+
+// FUNCTION : testPaymentsMerge
+// DESCRIPTION :
+//    Payments reach customers stored out of customerID order, the last payment date only moves
+//    forward, payments the balance cannot cover are rejected, and the rejected lines are
+//    quarantined verbatim and in file order.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testPaymentsMerge(void) {
+  Customer customers[3];
+  PaymentSummary summary;
+  makeTestCustomer(&customers[0], 3, 100.0f, "2024-12-12");
+  makeTestCustomer(&customers[1], 1, 200.0f, "2024-12-12");
+  makeTestCustomer(&customers[2], 2, 100.0f, "2024-12-12");
+  CHECK(writeTestFile(PAYMENTS_TEST_FILE,
+    "2|50.00|2025-01-05|\n"
+    "1|10.00|2025-01-03|\r\n"
+    "bad line\n"
+    "9999|5.00|2025-01-02|\n"
+    "1|20.00|2025-01-01|\n"
+    "3|500.00|2025-01-04|\n"
+    "2|50.00|2025-01-06|"));
+  CHECK(applyPaymentsFile(customers, 3, PAYMENTS_TEST_FILE, NULL, 1, &summary));
+  CHECK(summary.lineCount == 7);
+  CHECK(summary.appliedCount == 4 && summary.rejectedCount == 3);
+  CHECK(summary.customerCount == 2);
+  CHECK(summary.appliedTotal > 129.99 && summary.appliedTotal < 130.01);
+  CHECK(customers[1].currentAccountBalance > 169.99f && customers[1].currentAccountBalance < 170.01f);
+  CHECK(strcmp(customers[1].lastPaymentMade, "2025-01-03") == 0);
+  CHECK(customers[2].currentAccountBalance == 0.0f);
+  CHECK(strcmp(customers[2].lastPaymentMade, "2025-01-06") == 0);
+  CHECK(customers[0].currentAccountBalance == 100.0f);
+  CHECK(strcmp(customers[0].lastPaymentMade, "2024-12-12") == 0);
+  char text[256];
+  readTestFile(PAYMENTS_TEST_REJECTED_FILE, text, sizeof(text));
+  CHECK(strcmp(text, "bad line\n9999|5.00|2025-01-02|\n3|500.00|2025-01-04|\n") == 0);
+  removeTestFile(PAYMENTS_TEST_FILE);
+  removeTestFile(PAYMENTS_TEST_REJECTED_FILE);
+  removeTestFile(PAYMENTS_TEST_REASONS_FILE);
+}
+
+// FUNCTION : testPayments
+// DESCRIPTION :
+//    Runs the payments tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testPayments(void) {
+  testEmptyPayments();
+  testPaymentsMerge();
+}
@@ -0,0 +1,128 @@
+// FILE : TestQuarantine.c
+// DESCRIPTION :
+//    Tests the quarantine of rejected order lines and their re-ingest: the lines are kept verbatim
+//    in file order with their reasons, load once their customer exists, and lines still wrong are
+//    quarantined again.
+#include "Test.h"
+#include "Fixtures.h"
+#include "Quarantine.h"
+#include "FileIO.h"
+#include "Constants.h"
+#include <string.h>
+
+#define QUARANTINE_TEST_CUSTOMERS "test_quarantine_customers.db"
+#define QUARANTINE_TEST_PARTS "test_quarantine_parts.db"
+#define QUARANTINE_TEST_ORDERS "test_quarantine_orders.db"
+#define QUARANTINE_TEST_REJECTED "test_quarantine_orders.rejected.db"
+#define QUARANTINE_TEST_REASONS "test_quarantine_orders.rejected.idx"
+#define QUARANTINE_TEST_REINGEST "test_quarantine_orders.reingest.db"
+
+// FUNCTION : testQuarantineFileNames
+// DESCRIPTION :
+//    Quarantine files are named after the database, and a re-ingest work file shares them.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testQuarantineFileNames(void) {
+  char fileName[QUARANTINE_FILE_NAME_SIZE];
+  getQuarantineFileName("orders.db", QUARANTINE_LINES_SUFFIX, fileName, sizeof(fileName));
+  CHECK(strcmp(fileName, "orders.rejected.db") == 0);
+  getQuarantineFileName("orders.reingest.db", QUARANTINE_REASONS_SUFFIX, fileName, sizeof(fileName));
+  CHECK(strcmp(fileName, "orders.rejected.idx") == 0);
+  getQuarantineFileName("orders", REINGEST_SUFFIX, fileName, sizeof(fileName));
+  CHECK(strcmp(fileName, "orders.reingest.db") == 0);
+}
+
+// FUNCTION : testDisabledQuarantine
+// DESCRIPTION :
+//    A disabled quarantine creates no files, and there is nothing to re-ingest.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testDisabledQuarantine(void) {
+  char text[64];
+  char workFileName[QUARANTINE_FILE_NAME_SIZE];
+  QuarantineWriter quarantine;
+  openQuarantine(&quarantine, QUARANTINE_TEST_ORDERS, 0);
+  quarantineLine(&quarantine, "bad line\n", 1, "Rejected.");
+  CHECK(closeQuarantine(&quarantine) == 0);
+  CHECK(readTestFile(QUARANTINE_TEST_REJECTED, text, sizeof(text)) == -1);
+  CHECK(!beginReingest(QUARANTINE_TEST_ORDERS, workFileName, sizeof(workFileName)));
+}
+
+// FUNCTION : testQuarantineReingest
+// DESCRIPTION :
+//    Loads orders with one unknown customer and one malformed line, then re-ingests the
+//    quarantined lines once the customer exists.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testQuarantineReingest(void) {
+  static Customer customers[CUSTOMERS_LIMIT];
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  char text[512];
+  CHECK(writeCustomerLines(QUARANTINE_TEST_CUSTOMERS, 1));
+  CHECK(writeTestFile(QUARANTINE_TEST_PARTS, FIXTURE_PART_LINE));
+  CHECK(writeTestFile(QUARANTINE_TEST_ORDERS,
+    "20250220001|2025-02-20|0|1|2.00|1|2|1|2|\n"
+    "20250220002|2025-02-20|0|2|2.00|1|2|1|2|\r\n"
+    "20250220003|2025-02-20|0|1|2.00|1\n"));
+  LoadOptions options;
+  memset(&options, 0, sizeof(LoadOptions));
+  options.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  options.isQuarantining = 1;
+  CHECK(loadCustomers(customers, QUARANTINE_TEST_CUSTOMERS, &options) == 1);
+  CHECK(loadParts(parts, QUARANTINE_TEST_PARTS, &options) == 1);
+  CHECK(loadOrders(orders, parts, 1, customers, 1, QUARANTINE_TEST_ORDERS, &options) == 1);
+  readTestFile(QUARANTINE_TEST_REJECTED, text, sizeof(text));
+  CHECK(strcmp(text, "20250220002|2025-02-20|0|2|2.00|1|2|1|2|\n20250220003|2025-02-20|0|1|2.00|1\n") == 0);
+  readTestFile(QUARANTINE_TEST_REASONS, text, sizeof(text));
+  CHECK(strncmp(text, "1|" QUARANTINE_TEST_ORDERS "|2|", strlen("1|" QUARANTINE_TEST_ORDERS "|2|")) == 0);
+  CHECK(strstr(text, "\n2|" QUARANTINE_TEST_ORDERS "|3|") != NULL);
+
+  customers[1] = customers[0];
+  customers[1].customerID = 2;
+  char workFileName[QUARANTINE_FILE_NAME_SIZE];
+  CHECK(beginReingest(QUARANTINE_TEST_ORDERS, workFileName, sizeof(workFileName)));
+  CHECK(strcmp(workFileName, QUARANTINE_TEST_REINGEST) == 0);
+  CHECK(readTestFile(QUARANTINE_TEST_REJECTED, text, sizeof(text)) == -1);
+  options.existingCount = 1;
+  CHECK(loadOrders(orders, parts, 1, customers, 2, workFileName, &options) == 2);
+  CHECK(orders[0].orderID == 20250220001LL && orders[1].orderID == 20250220002LL);
+  endReingest(workFileName);
+  CHECK(readTestFile(QUARANTINE_TEST_REINGEST, text, sizeof(text)) == -1);
+  readTestFile(QUARANTINE_TEST_REJECTED, text, sizeof(text));
+  CHECK(strcmp(text, "20250220003|2025-02-20|0|1|2.00|1\n") == 0);
+  readTestFile(QUARANTINE_TEST_REASONS, text, sizeof(text));
+  CHECK(strncmp(text, "1|" QUARANTINE_TEST_REINGEST "|2|", strlen("1|" QUARANTINE_TEST_REINGEST "|2|")) == 0);
+
+  // Re-ingesting the same line again neither loads it nor loses it
+  options.existingCount = 2;
+  CHECK(beginReingest(QUARANTINE_TEST_ORDERS, workFileName, sizeof(workFileName)));
+  CHECK(loadOrders(orders, parts, 1, customers, 2, workFileName, &options) == 2);
+  endReingest(workFileName);
+  readTestFile(QUARANTINE_TEST_REJECTED, text, sizeof(text));
+  CHECK(strcmp(text, "20250220003|2025-02-20|0|1|2.00|1\n") == 0);
+  removeTestFile(QUARANTINE_TEST_CUSTOMERS);
+  removeTestFile(QUARANTINE_TEST_PARTS);
+  removeTestFile(QUARANTINE_TEST_ORDERS);
+  removeTestFile(QUARANTINE_TEST_REJECTED);
+  removeTestFile(QUARANTINE_TEST_REASONS);
+}
+
+// FUNCTION : testQuarantine
+// DESCRIPTION :
+//    Runs the quarantine and re-ingest tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testQuarantine(void) {
+  testQuarantineFileNames();
+  testDisabledQuarantine();
+  testQuarantineReingest();
+}
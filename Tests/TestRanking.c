@@ -0,0 +1,137 @@
+// FILE : TestRanking.c
+// DESCRIPTION :
+//    Tests the Space-Saving top-K summaries of the order rankings: exact counts while every key
+//    fits, the error bounds once keys are replaced, removed orders, and merged summaries.
+#include "Test.h"
+#include "Fixtures.h"
+#include "Ranking.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RANKING_TEST_SLOTS 8
+#define RANKING_TEST_CUSTOMERS 120
+
+// FUNCTION : isWithinBounds
+// DESCRIPTION :
+//    Checks the Space-Saving guarantees of a summary against the true weights: no more keys than
+//    slots, estimates never under the true weight and never over it by more than their error.
+// PARAMETERS :
+//    const HeavyHitters* hitters: The summary.
+//    const double* weights: True weight of each key, by key.
+//    int keyCount: Keys 1 to keyCount - 1 are checked.
+// RETURNS :
+//    int : 1 if the summary keeps its guarantees, 0 otherwise.
+static int isWithinBounds(const HeavyHitters* hitters, const double* weights, int keyCount) {
+  int isWithin = hitters->count <= hitters->capacity;
+  for (int key = 1; key < keyCount; key++) {
+    RankedKey estimate;
+    estimateRankedKey(hitters, key, &estimate);
+    isWithin &= estimate.weight + 0.001 >= weights[key] && estimate.weight - estimate.error <= weights[key] + 0.001;
+  }
+  return isWithin;
+}
+
+// FUNCTION : testExactRankings
+// DESCRIPTION :
+//    With no more keys than slots the counts are exact and the top keys come heaviest first;
+//    an empty summary has no top keys.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testExactRankings(void) {
+  OrderRankings rankings;
+  RankedKey top[RANKING_TEST_SLOTS];
+  Order order;
+  CHECK(initOrderRankings(&rankings, RANKING_TEST_SLOTS));
+  CHECK(getTopRankedKeys(&rankings.customerTotals, RANKING_TEST_SLOTS, top) == 0);
+  for (int customerID = 1; customerID <= 5; customerID++) {
+    for (int i = 0; i < customerID; i++) {
+      makeTestOrder(&order, 0, 0, 0, customerID, 10.0f);
+      addTestOrderedPart(&order, 100 + customerID, 2);
+      rankingsAddOrder(&rankings, &order);
+    }
+  }
+  CHECK(getTopRankedKeys(&rankings.customerTotals, 3, top) == 3);
+  CHECK(top[0].key == 5 && top[0].weight == 50.0 && top[0].error == 0.0);
+  CHECK(top[1].key == 4 && top[1].weight == 40.0);
+  CHECK(top[2].key == 3 && top[2].weight == 30.0);
+  CHECK(getTopRankedKeys(&rankings.partQuantities, RANKING_TEST_SLOTS, top) == 5);
+  CHECK(top[0].key == 105 && top[0].weight == 10.0);
+  makeTestOrder(&order, 0, 0, 0, 5, 10.0f);
+  addTestOrderedPart(&order, 105, 2);
+  rankingsRemoveOrder(&rankings, &order);
+  rankingsRemoveOrder(&rankings, &order);
+  RankedKey estimate;
+  estimateRankedKey(&rankings.customerTotals, 5, &estimate);
+  CHECK(estimate.weight == 30.0);
+  CHECK(getTopRankedKeys(&rankings.customerTotals, 1, top) == 1);
+  CHECK(top[0].key == 4);
+  clearOrderRankings(&rankings);
+  CHECK(getTopRankedKeys(&rankings.customerTotals, RANKING_TEST_SLOTS, top) == 0);
+  freeOrderRankings(&rankings);
+}
+
+// FUNCTION : testRankingBounds
+// DESCRIPTION :
+//    With many more customers than slots, two summaries and their merge keep the error bounds,
+//    and a customer heavier than all the others together stays on top.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testRankingBounds(void) {
+  static double weights[3][RANKING_TEST_CUSTOMERS];
+  OrderRankings rankings[3];
+  Order order;
+  int isReady = 1;
+  for (int r = 0; r < 3; r++) {
+    isReady &= initOrderRankings(&rankings[r], RANKING_TEST_SLOTS);
+  }
+  CHECK(isReady);
+  if (!isReady) {
+    return;
+  }
+  memset(weights, 0, sizeof(weights));
+  srand(48);
+  for (int r = 0; r < 2; r++) {
+    for (int i = 0; i < 2000; i++) {
+      int customerID = i % 10 == 0 ? 1 : 2 + rand() % (RANKING_TEST_CUSTOMERS - 2);
+      float orderTotal = customerID == 1 ? 100.0f : (float)(1 + rand() % 20);
+      makeTestOrder(&order, 0, 0, 0, customerID, orderTotal);
+      addTestOrderedPart(&order, 1 + rand() % 40, 1 + rand() % 5);
+      rankingsAddOrder(&rankings[r], &order);
+      weights[r][customerID] += orderTotal;
+      weights[2][customerID] += orderTotal;
+    }
+  }
+  CHECK(mergeOrderRankings(&rankings[2], &rankings[0]));
+  CHECK(mergeOrderRankings(&rankings[2], &rankings[1]));
+  RankedKey top[RANKING_TEST_SLOTS];
+  for (int r = 0; r < 3; r++) {
+    CHECK(isWithinBounds(&rankings[r].customerTotals, weights[r], RANKING_TEST_CUSTOMERS));
+    int topCount = getTopRankedKeys(&rankings[r].customerTotals, RANKING_TEST_SLOTS, top);
+    CHECK(topCount == rankings[r].customerTotals.count);
+    CHECK(topCount > 0 && top[0].key == 1);
+    int isDescending = 1;
+    for (int i = 1; i < topCount; i++) {
+      isDescending &= top[i].weight <= top[i - 1].weight;
+    }
+    CHECK(isDescending);
+  }
+  for (int r = 0; r < 3; r++) {
+    freeOrderRankings(&rankings[r]);
+  }
+}
+
+// FUNCTION : testRankings
+// DESCRIPTION :
+//    Runs the order ranking tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testRankings(void) {
+  testExactRankings();
+  testRankingBounds();
+}
@@ -0,0 +1,103 @@
+// FILE : TestReceipts.c
+// DESCRIPTION :
+//    Tests the backorder waitlists through the receipts feed: restocked parts go to the oldest
+//    waiting orders first, orders still short stay waiting, and rejected receipt lines are quarantined.
+#include "Test.h"
+#include "Fixtures.h"
+#include "Receipts.h"
+#include "Constants.h"
+#include <string.h>
+
+#define RECEIPTS_TEST_FILE "test_receipts.db"
+#define RECEIPTS_TEST_REJECTED_FILE "test_receipts.rejected.db"
+#define RECEIPTS_TEST_REASONS_FILE "test_receipts.rejected.idx"
+
+// FUNCTION : testEmptyReceipts
+// DESCRIPTION :
+//    Waitlists of no orders, an empty receipts file and a missing one.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testEmptyReceipts(void) {
+  BackorderWaitlists waitlists;
+  ReceiptSummary summary;
+  Part part;
+  memset(&part, 0, sizeof(Part));
+  part.partID = 1;
+  CHECK(initBackorderWaitlists(&waitlists, PARTS_LIMIT));
+  CHECK(buildBackorderWaitlists(&waitlists, NULL, NULL, 0) == 0);
+  CHECK(writeTestFile(RECEIPTS_TEST_FILE, ""));
+  CHECK(applyReceiptsFile(&part, 1, NULL, NULL, 0, &waitlists, NULL, RECEIPTS_TEST_FILE, 1, &summary));
+  CHECK(summary.lineCount == 0 && summary.receivedCount == 0 && summary.fulfilledCount == 0);
+  removeTestFile(RECEIPTS_TEST_FILE);
+  CHECK(!applyReceiptsFile(&part, 1, NULL, NULL, 0, &waitlists, NULL, RECEIPTS_TEST_FILE, 1, &summary));
+  freeBackorderWaitlists(&waitlists);
+}
+
+// FUNCTION : testBackorderRefill
+// DESCRIPTION :
+//    Receipts fill the oldest waiting orders first (by day, then orderID), skip orders that are
+//    not waiting or not valid, keep orders short of another part waiting, and fill them once
+//    that part arrives.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+static void testBackorderRefill(void) {
+  Part parts[2];
+  Order orders[5];
+  unsigned char orderValid[5] = { 1, 1, 1, 1, 0 };
+  memset(parts, 0, sizeof(parts));
+  parts[0].partID = 1;
+  parts[1].partID = 2;
+  makeTestOrder(&orders[0], 20250101002LL, 100, 99, 1, 1.0f);
+  addTestOrderedPart(&orders[0], 1, 5);
+  makeTestOrder(&orders[1], 20250101001LL, 100, 99, 1, 1.0f);
+  addTestOrderedPart(&orders[1], 1, 5);
+  makeTestOrder(&orders[2], 20250101003LL, 99, 99, 1, 1.0f); // Oldest, but also short of part 2
+  addTestOrderedPart(&orders[2], 1, 8);
+  addTestOrderedPart(&orders[2], 2, 1);
+  makeTestOrder(&orders[3], 20250101004LL, 98, 1, 1, 1.0f); // Already fulfilled
+  addTestOrderedPart(&orders[3], 2, 1);
+  makeTestOrder(&orders[4], 20250101005LL, 97, 99, 1, 1.0f); // Not valid
+  addTestOrderedPart(&orders[4], 1, 1);
+  BackorderWaitlists waitlists;
+  ReceiptSummary summary;
+  CHECK(initBackorderWaitlists(&waitlists, PARTS_LIMIT));
+  CHECK(buildBackorderWaitlists(&waitlists, orders, orderValid, 5) == 3);
+  CHECK(writeTestFile(RECEIPTS_TEST_FILE, "1|10|\nbad|line|\n9|5|\n"));
+  CHECK(applyReceiptsFile(parts, 2, orders, orderValid, 5, &waitlists, NULL, RECEIPTS_TEST_FILE, 1, &summary));
+  CHECK(summary.lineCount == 3 && summary.receivedCount == 1 && summary.rejectedCount == 2);
+  CHECK(summary.unitsReceived == 10);
+  CHECK(summary.retriedCount == 3 && summary.fulfilledCount == 2);
+  CHECK(orders[0].orderStatus == 1 && orders[1].orderStatus == 1);
+  CHECK(orders[2].orderStatus == 99 && orders[4].orderStatus == 99);
+  CHECK(parts[0].quantityOnHand == 0);
+  char text[256];
+  readTestFile(RECEIPTS_TEST_REJECTED_FILE, text, sizeof(text));
+  CHECK(strcmp(text, "bad|line|\n9|5|\n") == 0);
+  CHECK(writeTestFile(RECEIPTS_TEST_FILE, "2|1|\n1|8|\n"));
+  CHECK(applyReceiptsFile(parts, 2, orders, orderValid, 5, &waitlists, NULL, RECEIPTS_TEST_FILE, 1, &summary));
+  CHECK(summary.receivedCount == 2 && summary.rejectedCount == 0);
+  CHECK(summary.fulfilledCount == 1 && orders[2].orderStatus == 1);
+  CHECK(orders[4].orderStatus == 99);
+  CHECK(parts[0].quantityOnHand == 0 && parts[1].quantityOnHand == 0);
+  CHECK(readTestFile(RECEIPTS_TEST_REJECTED_FILE, text, sizeof(text)) == -1); // A clean run drops the old quarantine
+  removeTestFile(RECEIPTS_TEST_FILE);
+  removeTestFile(RECEIPTS_TEST_REJECTED_FILE);
+  removeTestFile(RECEIPTS_TEST_REASONS_FILE);
+  freeBackorderWaitlists(&waitlists);
+}
+
+// FUNCTION : testBackorderWaitlists
+// DESCRIPTION :
+//    Runs the backorder waitlist tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testBackorderWaitlists(void) {
+  testEmptyReceipts();
+  testBackorderRefill();
+}
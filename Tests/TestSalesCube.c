@@ -0,0 +1,144 @@
+// FILE : TestSalesCube.c
+// DESCRIPTION :
+//    Tests the Fenwick tree sales cubes against totals counted directly from the orders, over
+//    ranges that reach the first and last day numbers, for a full orders array built in one pass
+//    and then added to order by order.
+#include "Test.h"
+#include "Fixtures.h"
+#include "SalesCube.h"
+#include "DateIndex.h"
+#include "Constants.h"
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : countSales
+// DESCRIPTION :
+//    Totals the sales of one part or customer between two days by scanning the orders.
+// PARAMETERS :
+//    const Order* orders: The orders.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    int orderCount: Number of orders.
+//    const Part* parts: The parts, partID i at position i - 1.
+//    int isPart: 1 for a partID, 0 for a customerID.
+//    int key: The partID or customerID.
+//    int fromDay: The first day number.
+//    int toDay: The last day number.
+//    SalesCell* total: Receives the total.
+// RETURNS :
+//    void
+static void countSales(const Order* orders, const unsigned char* orderValid, int orderCount, const Part* parts,
+  int isPart, int key, int fromDay, int toDay, SalesCell* total) {
+  memset(total, 0, sizeof(SalesCell));
+  for (int i = 0; i < orderCount; i++) {
+    const Order* order = &orders[i];
+    if (!orderValid[i] || order->orderDay < fromDay || order->orderDay > toDay) {
+      continue;
+    }
+    if (!isPart && order->customerID == key) {
+      total->units += order->totalParts;
+      total->amount += order->orderTotal;
+      total->orderCount++;
+    }
+    for (int p = 0; isPart && p < order->distinctParts; p++) {
+      if (order->orderedParts[p].partID == key) {
+        total->units += order->orderedParts[p].quantityOrdered;
+        total->amount += (double)parts[key - 1].partCost * order->orderedParts[p].quantityOrdered;
+        total->orderCount++;
+      }
+    }
+  }
+}
+
+// FUNCTION : isSameSales
+// DESCRIPTION :
+//    Compares two totals, allowing for rounding in the amounts.
+// PARAMETERS :
+//    const SalesCell* a: The first total.
+//    const SalesCell* b: The second total.
+// RETURNS :
+//    int : 1 if the totals match, 0 otherwise.
+static int isSameSales(const SalesCell* a, const SalesCell* b) {
+  double difference = a->amount - b->amount;
+  return a->units == b->units && a->orderCount == b->orderCount && difference < 0.001 && difference > -0.001;
+}
+
+// FUNCTION : checkAllSales
+// DESCRIPTION :
+//    Compares the cubes with the direct totals for every test key over a set of day ranges.
+// PARAMETERS :
+//    const SalesCubes* cubes: The cubes.
+//    const Order* orders: The orders.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    int orderCount: Number of orders aggregated.
+//    const Part* parts: The parts.
+// RETURNS :
+//    int : 1 if every range matches, 0 otherwise.
+static int checkAllSales(const SalesCubes* cubes, const Order* orders, const unsigned char* orderValid, int orderCount,
+  const Part* parts) {
+  const int ranges[][2] = { { 0, DAY_NUMBER_COUNT - 1 }, { -10, DAY_NUMBER_COUNT + 10 }, { 0, 0 },
+    { DAY_NUMBER_COUNT - 1, DAY_NUMBER_COUNT - 1 }, { 9000, 9009 }, { 9010, 9029 }, { 9015, 9015 }, { 9020, 9010 } };
+  int isMatching = 1;
+  for (int r = 0; r < (int)(sizeof(ranges) / sizeof(ranges[0])); r++) {
+    for (int key = 1; key <= 9; key++) {
+      SalesCell fromCube;
+      SalesCell counted;
+      querySales(&cubes->partSales, key, ranges[r][0], ranges[r][1], &fromCube);
+      countSales(orders, orderValid, orderCount, parts, 1, key, ranges[r][0], ranges[r][1], &counted);
+      isMatching &= isSameSales(&fromCube, &counted);
+      querySales(&cubes->customerSales, key, ranges[r][0], ranges[r][1], &fromCube);
+      countSales(orders, orderValid, orderCount, parts, 0, key, ranges[r][0], ranges[r][1], &counted);
+      isMatching &= isSameSales(&fromCube, &counted);
+    }
+  }
+  return isMatching;
+}
+
+// FUNCTION : testSalesCubes
+// DESCRIPTION :
+//    Runs the sales cube tests.
+// PARAMETERS :
+//    void
+// RETURNS :
+//    void
+void testSalesCubes(void) {
+  static Part parts[PARTS_LIMIT];
+  static Order orders[ORDERS_LIMIT];
+  unsigned char orderValid[ORDERS_LIMIT];
+  SalesCubes cubes;
+  CHECK(initSalesCubes(&cubes));
+  SalesCell total;
+  CHECK(buildSalesCubes(&cubes, orders, orderValid, 0, parts, 0) == 0);
+  CHECK(!querySales(&cubes.partSales, 1, 0, DAY_NUMBER_COUNT - 1, &total));
+  CHECK(total.units == 0 && total.orderCount == 0 && total.amount == 0.0);
+  for (int i = 0; i < PARTS_LIMIT; i++) {
+    memset(&parts[i], 0, sizeof(Part));
+    parts[i].partID = i + 1;
+    parts[i].partCost = (float)(1 + i % 7) / 4.0f;
+  }
+  srand(42);
+  makeRandomOrders(orders, orderValid, ORDERS_LIMIT);
+  int validCount = 0;
+  for (int i = 0; i < ORDERS_LIMIT; i++) {
+    validCount += orderValid[i];
+  }
+  CHECK(buildSalesCubes(&cubes, orders, orderValid, ORDERS_LIMIT, parts, PARTS_LIMIT) == validCount);
+  CHECK(checkAllSales(&cubes, orders, orderValid, ORDERS_LIMIT, parts));
+  int half = ORDERS_LIMIT / 2;
+  CHECK(buildSalesCubes(&cubes, orders, orderValid, half, parts, PARTS_LIMIT) >= 0);
+  CHECK(checkAllSales(&cubes, orders, orderValid, half, parts));
+  IdIndex partIndex;
+  CHECK(initIdIndex(&partIndex, PARTS_LIMIT));
+  for (int i = 0; i < PARTS_LIMIT; i++) {
+    setIdIndex(&partIndex, parts[i].partID, i);
+  }
+  int isAdded = 1;
+  for (int i = half; i < ORDERS_LIMIT; i++) {
+    if (orderValid[i]) {
+      isAdded &= salesCubesAddOrder(&cubes, &orders[i], parts, &partIndex);
+    }
+  }
+  CHECK(isAdded);
+  CHECK(checkAllSales(&cubes, orders, orderValid, ORDERS_LIMIT, parts));
+  freeIdIndex(&partIndex);
+  freeSalesCubes(&cubes);
+}
@@ -0,0 +1,201 @@
+// FILE : Update.c
+// DESCRIPTION :
+//    Implements in-memory updates of parts and customers.
+//    After each update only the orders that reference the changed partID or customerID are
+//    re-validated, and the orders whose validity flipped are reported.
+#include "Update.h"
+#include "Dependency.h"
+#include "Validation.h"
+#include "PickList.h"
+#include "DateIndex.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <stdio.h>
+#include <string.h>
+
+// FUNCTION : findPartPosition
+// DESCRIPTION :
+//    Finds the position of a part in the parts array.
+// PARAMETERS :
+//    const Part* parts: The parts array.
+//    int partCount: Number of parts.
+//    int partID: The part ID to find.
+// RETURNS :
+//    int : The position of the part, or -1 if it does not exist.
+static int findPartPosition(const Part* parts, int partCount, int partID) {
+  for (int i = 0; i < partCount; i++) {
+    if (parts[i].partID == partID) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// FUNCTION : findCustomerPosition
+// DESCRIPTION :
+//    Finds the position of a customer in the customers array.
+// PARAMETERS :
+//    const Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    int customerID: The customer ID to find.
+// RETURNS :
+//    int : The position of the customer, or -1 if it does not exist.
+static int findCustomerPosition(const Customer* customers, int customerCount, int customerID) {
+  for (int i = 0; i < customerCount; i++) {
+    if (customers[i].customerID == customerID) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// FUNCTION : updatePart
+// DESCRIPTION :
+//    Inserts a new part or replaces the part with the same partID.
+//    Dependent orders are re-validated only when the part is new or its cost changed,
+//    since the cost is the only part value that order validation uses.
+// PARAMETERS :
+//    Part* parts: The parts array.
+//    int* partCount: Number of parts, updated when the part is new.
+//    const Part* updatedPart: The new part values.
+//    const Customer* customers: The current customers.
+//    int customerCount: Number of customers.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+// RETURNS :
+//    int : 1 if the part was applied, 0 if it was invalid or the parts limit was reached.
+int updatePart(Part* parts, int* partCount, const Part* updatedPart, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips) {
+  if (flips != NULL) {
+    flips->count = 0;
+  }
+  if (!validatePartRecord(updatedPart)) {
+    return 0;
+  }
+  int position = findPartPosition(parts, *partCount, updatedPart->partID);
+  int isCostChanged = 1;
+  if (position == -1) {
+    if (*partCount >= PARTS_LIMIT) {
+      logGeneric("Part limit reached, cannot add more parts.");
+      return 0;
+    }
+    position = (*partCount)++;
+  }
+  else {
+    isCostChanged = parts[position].partCost != updatedPart->partCost;
+  }
+  parts[position] = *updatedPart;
+  parts[position].partLocationCode = packPartLocation(updatedPart->partLocation);
+  if (isCostChanged) {
+    revalidateDependentOrders(deps, &updatedPart->partID, 1, NULL, 0,
+      orders, orderCount, parts, *partCount, customers, customerCount, flips);
+  }
+  return 1;
+}
+
+// FUNCTION : removePart
+// DESCRIPTION :
+//    Removes a part and re-validates the orders that reference it.
+// PARAMETERS :
+//    Part* parts: The parts array.
+//    int* partCount: Number of parts, updated.
+//    int partID: The ID of the part to remove.
+//    const Customer* customers: The current customers.
+//    int customerCount: Number of customers.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+// RETURNS :
+//    int : 1 if the part was removed, 0 if it did not exist.
+int removePart(Part* parts, int* partCount, int partID, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips) {
+  if (flips != NULL) {
+    flips->count = 0;
+  }
+  int position = findPartPosition(parts, *partCount, partID);
+  if (position == -1) {
+    return 0;
+  }
+  memmove(&parts[position], &parts[position + 1], (*partCount - position - 1) * sizeof(Part));
+  (*partCount)--;
+  revalidateDependentOrders(deps, &partID, 1, NULL, 0,
+    orders, orderCount, parts, *partCount, customers, customerCount, flips);
+  return 1;
+}
+
+// FUNCTION : updateCustomer
+// DESCRIPTION :
+//    Inserts a new customer or replaces the customer with the same customerID.
+//    Dependent orders are re-validated only when the customer is new, since orders
+//    only depend on the existence of their customerID.
+// PARAMETERS :
+//    Customer* customers: The customers array.
+//    int* customerCount: Number of customers, updated when the customer is new.
+//    const Customer* updatedCustomer: The new customer values.
+//    const Part* parts: The current parts.
+//    int partCount: Number of parts.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+// RETURNS :
+//    int : 1 if the customer was applied, 0 if it was invalid or the customers limit was reached.
+int updateCustomer(Customer* customers, int* customerCount, const Customer* updatedCustomer, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips) {
+  if (flips != NULL) {
+    flips->count = 0;
+  }
+  if (!validateCustomerRecord(updatedCustomer)) {
+    return 0;
+  }
+  Customer newCustomer = *updatedCustomer;
+  newCustomer.lastPaymentDay = dateToDayNumber(newCustomer.lastPaymentMade);
+  newCustomer.customerJoinDay = dateToDayNumber(newCustomer.customerJoinDate);
+  int position = findCustomerPosition(customers, *customerCount, updatedCustomer->customerID);
+  if (position != -1) {
+    customers[position] = newCustomer;
+    return 1;
+  }
+  if (*customerCount >= CUSTOMERS_LIMIT) {
+    logGeneric("Customer limit reached, cannot add more customers.");
+    return 0;
+  }
+  customers[(*customerCount)++] = newCustomer;
+  revalidateDependentOrders(deps, NULL, 0, &updatedCustomer->customerID, 1,
+    orders, orderCount, parts, partCount, customers, *customerCount, flips);
+  return 1;
+}
+
+// FUNCTION : removeCustomer
+// DESCRIPTION :
+//    Removes a customer and re-validates the orders that reference it.
+// PARAMETERS :
+//    Customer* customers: The customers array.
+//    int* customerCount: Number of customers, updated.
+//    int customerID: The ID of the customer to remove.
+//    const Part* parts: The current parts.
+//    int partCount: Number of parts.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+// RETURNS :
+//    int : 1 if the customer was removed, 0 if it did not exist.
+int removeCustomer(Customer* customers, int* customerCount, int customerID, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips) {
+  if (flips != NULL) {
+    flips->count = 0;
+  }
+  int position = findCustomerPosition(customers, *customerCount, customerID);
+  if (position == -1) {
+    return 0;
+  }
+  memmove(&customers[position], &customers[position + 1], (*customerCount - position - 1) * sizeof(Customer));
+  (*customerCount)--;
+  revalidateDependentOrders(deps, NULL, 0, &customerID, 1,
+    orders, orderCount, parts, partCount, customers, *customerCount, flips);
+  return 1;
+}
@@ -0,0 +1,21 @@
+// FILE : Update.h
+// DESCRIPTION : This header file defines functions for updating parts and customers in memory
+//               and re-validating only the orders that depend on them.
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+#include "Dependency.h"
+
+int updatePart(Part* parts, int* partCount, const Part* updatedPart, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips);
+int removePart(Part* parts, int* partCount, int partID, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips);
+int updateCustomer(Customer* customers, int* customerCount, const Customer* updatedCustomer, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips);
+int removeCustomer(Customer* customers, int* customerCount, int customerID, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips);
+
+#endif
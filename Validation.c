@@ -7,6 +7,7 @@
 #include "Part.h"
 #include "Order.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -14,192 +15,425 @@
 const char* CANADA_PROVINCES[] = {
     "AB", "BC", "MB", "NB", "NL", "NS", "NT", "NU", "ON", "PE", "QC", "SK", "YT"
 };
-// FUNCTION : validateCustomerFields
+// FUNCTION : copyValidationReason
 // DESCRIPTION :
-//    Validates the fields of a customer record.
-//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
-//    Assumes the fields are in the correct amount
+//    Copies the field errors of a validation message without its "Error when loading ..." prefix,
+//    on one line, for use as the reason of a quarantined line.
+// PARAMETERS :
+//    const char* errorMessage: The validation error message.
+//    char* reason: Receives the reason, or NULL if not wanted.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    void
+static void copyValidationReason(const char* errorMessage, char* reason, int reasonSize) {
+  if (reason == NULL) {
+    return;
+  }
+  const char* firstError = strchr(errorMessage, '\n');
+  strncpy_s(reason, reasonSize, firstError != NULL ? firstError + 1 : errorMessage, _TRUNCATE);
+  for (char* cursor = reason; *cursor != '\0'; cursor++) {
+    if (*cursor == '\n') {
+      *cursor = ' ';
+    }
+  }
+}
+// FUNCTION : checkCustomerTextFields
+// DESCRIPTION :
+//    Appends the errors of the text fields of a customer record (name, address, city, province,
+//    postal code, phone and email) to a validation message.
 // PARAMETERS :
 //    char** fields: Array of strings containing customer data.
-//    int lineNumber: The line number in the file for error reporting.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
 // RETURNS :
-//    int : 1 if all fields are valid, 0 if any field is invalid.
-int validateCustomerFields(char** fields, int lineNumber) {
-  char errorMessage[1024];
-  snprintf(errorMessage, sizeof(errorMessage), "Error when loading  customers database: Line %d: ", lineNumber);
+//    void
+static void checkCustomerTextFields(char** fields, char* errorMessage, int size) {
   // Validate name
   if (strlen(fields[0]) == 0 || strlen(fields[0]) > 50) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #1: Customer name must neither be blank or over 50 characters");
   }
   // Validate address
   if (strlen(fields[1]) == 0 || strlen(fields[1]) > 100) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #2: Customer address must neither be blank or over 100 characters.");
   }
   // Validate city
   if (strlen(fields[2]) == 0 || strlen(fields[2]) > 100) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #3: Customer city must neither be blank or over 100 characters. ");
   }
   // Validate province
   if (!validateProvince(fields[3])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #4: Customer province must be a valid canadian province abbreviation");
   }
   // Validate postal code
   if (!validatePostalCode(fields[4])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #5: Customer postal code must be in ANANAN format (where A is an alphabetic letter and N is a numeric digit)");
   }
   // Validate phone number
   if (!validatePhoneNumber(fields[5])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #6: Customer phone number must be in ###-###-#### format");
   }
   // Validate email
   if (!validateEmail(fields[6])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #7: Customer email address must a valid email address");
   }
+}
+// FUNCTION : checkCustomerKeyFields
+// DESCRIPTION :
+//    Appends the errors of the ID, numeric and date fields of a customer record to a validation message.
+// PARAMETERS :
+//    char** fields: Array of strings containing customer data.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
+// RETURNS :
+//    void
+static void checkCustomerKeyFields(char** fields, char* errorMessage, int size) {
   // Validate customer ID
   int customerID = 0;
   sscanf_s(fields[7], "%d", &customerID);
   if (!isInteger(fields[7]) || customerID <= 0) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #8: Customer ID must be a positive int.");
   }
   // Validate credit limit
   float creditLimit = 0.0;
   sscanf_s(fields[8], "%f", &creditLimit);
   if (!isNumber(fields[8]) || creditLimit <= 0.0) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #9: Customer credit limit must be greater than 0. ");
   }
   // Validate account balance
   if (!isNumber(fields[9]) || fields[9][0] == '-') {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #10: Customer account balance greater than or equal to 0. ");
   }
   // Validate last payment date (optional)
   if (strlen(fields[10]) > 0 && !validateDate(fields[10])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #11: Customer last payment date must be either blank or in YYYY-MM-DD format and is a valid date.");
   }
   // Validate join date
   if (fields[11] == NULL || !validateDate(fields[11])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #12: Customer join date must be in YYYY-MM-DD format and is a valid date.");
   }
+}
+// FUNCTION : reportFieldErrors
+// DESCRIPTION :
+//    Counts, logs and hands back the errors of a validation message that has at least one.
+// PARAMETERS :
+//    MetricSource source: The kind of record validated.
+//    const char* errorMessage: The validation message.
+//    char* reason: Receives the field errors on one line, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    void
+static void reportFieldErrors(MetricSource source, const char* errorMessage, char* reason, int reasonSize) {
+  METRIC_FIELD_ERRORS(source, errorMessage);
+  copyValidationReason(errorMessage, reason, reasonSize);
+  logGeneric(errorMessage);
+}
+// FUNCTION : validateCustomerFields
+// DESCRIPTION :
+//    Validates the fields of a customer record.
+//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
+//    Assumes the fields are in the correct amount
+// PARAMETERS :
+//    char** fields: Array of strings containing customer data.
+//    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validateCustomerFields(char** fields, int lineNumber, char* reason, int reasonSize) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading  customers database: Line %d: ", lineNumber);
+  checkCustomerTextFields(fields, errorMessage, sizeof(errorMessage));
+  checkCustomerKeyFields(fields, errorMessage, sizeof(errorMessage));
   if (strlen(errorMessage) > 60) { // When there is at least one error
-    logGeneric(errorMessage);
+    reportFieldErrors(METRIC_SOURCE_CUSTOMERS, errorMessage, reason, reasonSize);
     return 0; 
   }
   return 1;
 }
-// FUNCTION : validatePartFields
+// FUNCTION : validateCustomerKeyFields
 // DESCRIPTION :
-//    Validates the fields of a part record.
-//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
-//    Assumes the fields are in the correct amount
+//    Validates only the ID, numeric and date fields of a customer record, for loads that defer
+//    the text fields until they are first used (see validateCustomerTextFields).
 // PARAMETERS :
-//    char** fields: Array of strings containing part data.
+//    char** fields: Array of strings containing customer data.
 //    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
 // RETURNS :
-//    int : 1 if all fields are valid, 0 if any field is invalid.
-int validatePartFields(char** fields, int lineNumber) {
+//    int : 1 if the fields are valid, 0 if any of them is invalid.
+int validateCustomerKeyFields(char** fields, int lineNumber, char* reason, int reasonSize) {
   char errorMessage[1024];
-  snprintf(errorMessage, sizeof(errorMessage), "Error when loading part database: Line %d: ", lineNumber);
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading  customers database: Line %d: ", lineNumber);
+  size_t prefixLength = strlen(errorMessage);
+  checkCustomerKeyFields(fields, errorMessage, sizeof(errorMessage));
+  if (strlen(errorMessage) > prefixLength) {
+    reportFieldErrors(METRIC_SOURCE_CUSTOMERS, errorMessage, reason, reasonSize);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : isCustomerValid
+// DESCRIPTION :
+//    Checks the fields of a customer record without logging anything, so it can run on a load
+//    pipeline thread. Lines that fail are validated again with validateCustomerFields (or
+//    validateCustomerKeyFields) in file order, which reports the errors.
+// PARAMETERS :
+//    char** fields: Array of strings containing customer data.
+//    int isKeyOnly: 1 to check only the fields checked by validateCustomerKeyFields.
+// RETURNS :
+//    int : 1 if the fields are valid, 0 otherwise.
+int isCustomerValid(char** fields, int isKeyOnly) {
+  char errorMessage[1024];
+  errorMessage[0] = '\0';
+  if (!isKeyOnly) {
+    checkCustomerTextFields(fields, errorMessage, sizeof(errorMessage));
+  }
+  checkCustomerKeyFields(fields, errorMessage, sizeof(errorMessage));
+  return errorMessage[0] == '\0';
+}
+// FUNCTION : isCustomerParseSafe
+// DESCRIPTION :
+//    Checks only what parsing a customer line relies on, for trusted files whose format is not
+//    otherwise checked: the text fields fit the record (strcpy_s ends the program on a longer
+//    field) and the dates are valid, since they are converted to day numbers.
+// PARAMETERS :
+//    char** fields: Array of strings containing customer data.
+//    int isKeyOnly: 1 if the text fields are parsed later, when they are first used.
+// RETURNS :
+//    int : 1 if the line can be parsed, 0 otherwise.
+int isCustomerParseSafe(char** fields, int isKeyOnly) {
+  if (!isKeyOnly && (strlen(fields[0]) > 50 || strlen(fields[1]) > 100 || strlen(fields[2]) > 100 ||
+    strlen(fields[3]) > 2 || strlen(fields[4]) > 6 || strlen(fields[5]) > 12 || strlen(fields[6]) > 50)) {
+    return 0;
+  }
+  return (strlen(fields[10]) == 0 || validateDate(fields[10])) && validateDate(fields[11]);
+}
+// FUNCTION : validateCustomerTextFields
+// DESCRIPTION :
+//    Validates the text fields of a customer record deferred by validateCustomerKeyFields.
+// PARAMETERS :
+//    char** fields: Array of strings containing customer data.
+//    int customerID: The ID of the customer, for error reporting.
+// RETURNS :
+//    int : 1 if the fields are valid, 0 if any of them is invalid.
+int validateCustomerTextFields(char** fields, int customerID) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading the details of customer %d: ", customerID);
+  size_t prefixLength = strlen(errorMessage);
+  checkCustomerTextFields(fields, errorMessage, sizeof(errorMessage));
+  if (strlen(errorMessage) > prefixLength) {
+    reportFieldErrors(METRIC_SOURCE_CUSTOMERS, errorMessage, NULL, 0);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : checkPartTextFields
+// DESCRIPTION :
+//    Appends the errors of the name and number fields of a part record to a validation message.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
+// RETURNS :
+//    void
+static void checkPartTextFields(char** fields, char* errorMessage, int size) {
   // Validate part name
   if (strlen(fields[0]) == 0 || strlen(fields[0]) > 50) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #1: Part name must neither be blank or over 50 characters");
   }
   // Validate part number
   if (strlen(fields[1]) == 0 || strlen(fields[1]) > 50) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #2: Part number must neither be blank or over 50 characters");
   }
+}
+// FUNCTION : checkPartKeyFields
+// DESCRIPTION :
+//    Appends the errors of the location, numeric and ID fields of a part record to a validation message.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
+// RETURNS :
+//    void
+static void checkPartKeyFields(char** fields, char* errorMessage, int size) {
   // Validate part location
   if (!validatePartLocation(fields[2])) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #3: Part location must be in A###-S###-L##-B## format");
   }
   // Validate part cost
   float partCost = 0.0;
   sscanf_s(fields[3], "%f", &partCost);
   if (!isNumber(fields[3]) || partCost <= 0.0) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #4: Part cost must be a positive number.");
   }
   // Validate quantity on hand
   if (!isInteger(fields[4]) || fields[4][0] == '-') {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #5: Quantity on hand must be a integer greater than or equal 0.");
   }
   // Validate part status
   if (!validatePartStatus(fields[4], fields[5])) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #6: Part status or quantity on hand is invalid.");
   }
   // Validate part ID
   int partID = 0;
   sscanf_s(fields[6], "%d", &partID);
   if (!isInteger(fields[6]) || partID <= 0) {
-    strcat_s(errorMessage, sizeof(errorMessage),
+    strcat_s(errorMessage, size,
       "\nField #7: Part ID must be a positive integer.");
   }
+}
+// FUNCTION : validatePartFields
+// DESCRIPTION :
+//    Validates the fields of a part record.
+//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
+//    Assumes the fields are in the correct amount
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validatePartFields(char** fields, int lineNumber, char* reason, int reasonSize) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading part database: Line %d: ", lineNumber);
+  checkPartTextFields(fields, errorMessage, sizeof(errorMessage));
+  checkPartKeyFields(fields, errorMessage, sizeof(errorMessage));
 
   if (strlen(errorMessage) > 60) { // When there is at least one error
-    logGeneric(errorMessage);
+    reportFieldErrors(METRIC_SOURCE_PARTS, errorMessage, reason, reasonSize);
     return 0; 
   }
   return 1;
 }
-// FUNCTION : validateOrderFields
+// FUNCTION : validatePartKeyFields
 // DESCRIPTION :
-//    Validates the fields of an order record.
-//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
-//    Assumes the fields are in the correct amount
-//    Uses existing parts and customers arrays to validate part IDs and customer IDs.
+//    Validates every field of a part record except the name and number, for loads that defer
+//    them until they are first used (see validatePartTextFields). The location is kept because
+//    pick lists use it.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if the fields are valid, 0 if any of them is invalid.
+int validatePartKeyFields(char** fields, int lineNumber, char* reason, int reasonSize) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading part database: Line %d: ", lineNumber);
+  size_t prefixLength = strlen(errorMessage);
+  checkPartKeyFields(fields, errorMessage, sizeof(errorMessage));
+  if (strlen(errorMessage) > prefixLength) {
+    reportFieldErrors(METRIC_SOURCE_PARTS, errorMessage, reason, reasonSize);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : isPartValid
+// DESCRIPTION :
+//    Checks the fields of a part record without logging anything, in the same way as isCustomerValid.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    int isKeyOnly: 1 to check only the fields checked by validatePartKeyFields.
+// RETURNS :
+//    int : 1 if the fields are valid, 0 otherwise.
+int isPartValid(char** fields, int isKeyOnly) {
+  char errorMessage[1024];
+  errorMessage[0] = '\0';
+  if (!isKeyOnly) {
+    checkPartTextFields(fields, errorMessage, sizeof(errorMessage));
+  }
+  checkPartKeyFields(fields, errorMessage, sizeof(errorMessage));
+  return errorMessage[0] == '\0';
+}
+// FUNCTION : isPartParseSafe
+// DESCRIPTION :
+//    Checks only that the text fields of a part line fit the record, for trusted files, in the
+//    same way as isCustomerParseSafe.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    int isKeyOnly: 1 if the name and number are parsed later, when they are first used.
+// RETURNS :
+//    int : 1 if the line can be parsed, 0 otherwise.
+int isPartParseSafe(char** fields, int isKeyOnly) {
+  if (!isKeyOnly && (strlen(fields[0]) > 50 || strlen(fields[1]) > 50)) {
+    return 0;
+  }
+  return strlen(fields[2]) <= 20;
+}
+// FUNCTION : validatePartTextFields
+// DESCRIPTION :
+//    Validates the name and number fields of a part record deferred by validatePartKeyFields.
+// PARAMETERS :
+//    char** fields: Array of strings containing part data.
+//    int partID: The ID of the part, for error reporting.
+// RETURNS :
+//    int : 1 if the fields are valid, 0 if any of them is invalid.
+int validatePartTextFields(char** fields, int partID) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading the details of part %d: ", partID);
+  size_t prefixLength = strlen(errorMessage);
+  checkPartTextFields(fields, errorMessage, sizeof(errorMessage));
+  if (strlen(errorMessage) > prefixLength) {
+    reportFieldErrors(METRIC_SOURCE_PARTS, errorMessage, NULL, 0);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : checkOrderFormatFields
+// DESCRIPTION :
+//    Appends the format errors of an order record to a validation message: everything that can be
+//    checked from the line alone, without the customers and parts.
 // PARAMETERS :
 //    char** fields: Array of strings containing order data.
 //    int numOfReadFields: Number of fields read from the order line.
-//    int lineNumber: The line number in the file for error reporting.
-//    const Part* parts: Pointer to the array of Part structures for validating part IDs.
-//    int partCount: Number of parts in the parts array.
-//    const Customer* customers: Pointer to the array of Customer structures for validating customer IDs.
-//    int customerCount: Number of customers in the customers array.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
 // RETURNS :
-//    int : 1 if all fields are valid, 0 if any field is invalid.
-int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount, const Customer* customers, int customerCount) {
-  char errorMessage[4096];
-  snprintf(errorMessage, sizeof(errorMessage), "Error when loading orders database: Line %d: ", lineNumber);
+//    void
+static void checkOrderFormatFields(char** fields, int numOfReadFields, char* errorMessage, int size) {
   // Validate order ID
   if (!validateOrderID(fields[0])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #1: Order ID must be in YYYYMMDDSSS format and is a valid date.");
   }
   // Validate order date
   if (!validateDate(fields[1])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #2: Order date must be in YYYY-MM-DD format and is a valid date.");
   }
+  else if (validateOrderID(fields[0]) && !validateOrderIDMatchesDate(fields[0], fields[1])) {
+    strcat_s(errorMessage, size, 
+      "\nField #1: Order ID must start with the order date and end with a sequence number from 001 to 999.");
+  }
   // Validate order status
   if (!validateOrderStatus(fields[2])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #3: Order status must be a valid integer (0, 1, 99, or 500).");
   }
-  // Validate customer ID
-  if (!validateCustomerIDInOrder(fields[3], customers, customerCount)) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
-      "\nField #4: Customer ID must be a positive integer and must link to an existing customer.");
-  }
   // Validate order total (just a format check, actual calculation is done later)
   float orderTotal = 0.0;
   sscanf_s(fields[4], "%f", &orderTotal);
   if (!isNumber(fields[4]) || orderTotal <= 0.0) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #5: Order total must be a positive number.");
   }
   // Validate distinct parts
@@ -207,50 +441,91 @@ int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, cons
   sscanf_s(fields[5], "%d", &distinctParts);
   int expectedDistinctParts = (numOfReadFields - 7) / 2; // Each part has two fields
   if (!isInteger(fields[5])) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #6: Distinct parts must be a positive integer.");
   }
   else if (distinctParts != expectedDistinctParts) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #6: Distinct parts count does not match the number of parts provided.");
   }
   // Validate total parts (just a format check, actual calculation is done later)
   int totalParts = 0;
   sscanf_s(fields[6], "%d", &totalParts);
   if (!isInteger(fields[6]) || totalParts < 1) {
-    strcat_s(errorMessage, sizeof(errorMessage), 
+    strcat_s(errorMessage, size, 
       "\nField #7: Total parts must be a positive integer greater than or equal to 1.");
   }
   // Validate ordered parts
   int numOfParsedOrderedParts = (numOfReadFields - 7) / 2;
   char localErrorMessage[200];
-  int isAllPartsValid = 1;
   for (int i = 0; i < numOfParsedOrderedParts; i++) {
     int partID = 0;
     int quantityOrdered = 0;
     sscanf_s(fields[7 + i * 2], "%d", &partID);
     sscanf_s(fields[8 + i * 2], "%d", &quantityOrdered);
     if (!isInteger(fields[7 + i * 2]) || partID <= 0) {
-      isAllPartsValid = 0;
       snprintf(localErrorMessage, sizeof(localErrorMessage), 
         "\nField #%d: Part ID must be a positive integer.", 8 + i * 2);
-      strcat_s(errorMessage, sizeof(errorMessage), localErrorMessage);
+      strcat_s(errorMessage, size, localErrorMessage);
+    }
+    if (!isInteger(fields[8 + i * 2]) || quantityOrdered <= 0) {
+      snprintf(localErrorMessage, sizeof(localErrorMessage), 
+        "\nField #%d: Quantity ordered must be a positive integer.", 9 + i * 2);
+      strcat_s(errorMessage, size, localErrorMessage);
+    }
+  }
+}
+// FUNCTION : checkOrderReferences
+// DESCRIPTION :
+//    Appends the reference errors of an order record to a validation message: the customer and
+//    parts must exist, and the total parts and order total must match the ordered parts.
+//    The totals are only checked when every ordered part is well formed and exists.
+// PARAMETERS :
+//    char** fields: Array of strings containing order data.
+//    int numOfReadFields: Number of fields read from the order line.
+//    const Part* parts: Pointer to the array of Part structures for validating part IDs.
+//    int partCount: Number of parts in the parts array.
+//    const Customer* customers: Pointer to the array of Customer structures for validating customer IDs.
+//    int customerCount: Number of customers in the customers array.
+//    char* errorMessage: The validation message to append to.
+//    int size: The size of the errorMessage buffer.
+// RETURNS :
+//    void
+static void checkOrderReferences(char** fields, int numOfReadFields, const Part* parts, int partCount, const Customer* customers,
+  int customerCount, char* errorMessage, int size) {
+  // Validate customer ID
+  if (!validateCustomerIDInOrder(fields[3], customers, customerCount)) {
+    strcat_s(errorMessage, size, 
+      "\nField #4: Customer ID must be a positive integer and must link to an existing customer.");
+  }
+  // Validate ordered part IDs
+  int numOfParsedOrderedParts = (numOfReadFields - 7) / 2;
+  char localErrorMessage[200];
+  int isAllPartsValid = 1;
+  for (int i = 0; i < numOfParsedOrderedParts; i++) {
+    int partID = 0;
+    int quantityOrdered = 0;
+    sscanf_s(fields[7 + i * 2], "%d", &partID);
+    sscanf_s(fields[8 + i * 2], "%d", &quantityOrdered);
+    if (!isInteger(fields[7 + i * 2]) || partID <= 0) {
+      isAllPartsValid = 0; // Reported by checkOrderFormatFields
     }
     else if (!validatePartIDInOrder(partID, parts, partCount)) {
       isAllPartsValid = 0;
       snprintf(localErrorMessage, sizeof(localErrorMessage),
         "\nField #%d: Part ID %d does not exist in the parts database.", 7 + i * 2, partID);
-      strcat_s(errorMessage, sizeof(errorMessage), localErrorMessage);
+      strcat_s(errorMessage, size, localErrorMessage);
     }
     if (!isInteger(fields[8 + i * 2]) || quantityOrdered <= 0) {
-      isAllPartsValid = 0;
-      snprintf(localErrorMessage, sizeof(localErrorMessage), 
-        "\nField #%d: Quantity ordered must be a positive integer.", 9 + i * 2);
-      strcat_s(errorMessage, sizeof(errorMessage), localErrorMessage);
+      isAllPartsValid = 0; // Reported by checkOrderFormatFields
     }
   }
   // Validate order total and total parts
   if (isAllPartsValid) {
+    float orderTotal = 0.0;
+    int totalParts = 0;
+    sscanf_s(fields[4], "%f", &orderTotal);
+    sscanf_s(fields[6], "%d", &totalParts);
     int calculatedTotalParts = 0;
     float calculatedOrderTotal = 0.0;
     for (int i = 0; i < numOfParsedOrderedParts; i++) {
@@ -267,20 +542,461 @@ int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, cons
       }
     }
     if (isInteger(fields[6]) && calculatedTotalParts != totalParts) {
-      strcat_s(errorMessage, sizeof(errorMessage), 
+      strcat_s(errorMessage, size, 
         "\nField #7: Calculated total parts does not match the provided total parts.");
     }
     if (isNumber(fields[4]) && calculatedOrderTotal != orderTotal) {
-      strcat_s(errorMessage, sizeof(errorMessage), 
+      strcat_s(errorMessage, size, 
         "\nField #5: Calculated order total does not match the provided order total.");
     }
   }
+}
+// FUNCTION : validateOrderFields
+// DESCRIPTION :
+//    Validates the fields of an order record.
+//    Checks for correct formats, lengths, and valid values according to PWH System requirements.
+//    Assumes the fields are in the correct amount
+//    Uses existing parts and customers arrays to validate part IDs and customer IDs.
+// PARAMETERS :
+//    char** fields: Array of strings containing order data.
+//    int numOfReadFields: Number of fields read from the order line.
+//    int lineNumber: The line number in the file for error reporting.
+//    const Part* parts: Pointer to the array of Part structures for validating part IDs.
+//    int partCount: Number of parts in the parts array.
+//    const Customer* customers: Pointer to the array of Customer structures for validating customer IDs.
+//    int customerCount: Number of customers in the customers array.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount, const Customer* customers, int customerCount,
+  char* reason, int reasonSize) {
+  char errorMessage[4096];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading orders database: Line %d: ", lineNumber);
+  checkOrderFormatFields(fields, numOfReadFields, errorMessage, sizeof(errorMessage));
+  checkOrderReferences(fields, numOfReadFields, parts, partCount, customers, customerCount, errorMessage, sizeof(errorMessage));
   if (strlen(errorMessage) > 60) { // When there is at least one error
-    logGeneric(errorMessage);
+    reportFieldErrors(METRIC_SOURCE_ORDERS, errorMessage, reason, reasonSize);
     return 0; 
   }
   return 1;
 }
+// FUNCTION : isOrderFormatValid
+// DESCRIPTION :
+//    Checks the format of an order record without logging anything, so it can run on a load
+//    pipeline thread before the customers and parts are loaded. Lines that fail are validated
+//    again with validateOrderFields once they are, which reports the errors.
+// PARAMETERS :
+//    char** fields: Array of strings containing order data.
+//    int numOfReadFields: Number of fields read from the order line.
+// RETURNS :
+//    int : 1 if the format is valid, 0 otherwise.
+int isOrderFormatValid(char** fields, int numOfReadFields) {
+  char errorMessage[4096];
+  errorMessage[0] = '\0';
+  checkOrderFormatFields(fields, numOfReadFields, errorMessage, sizeof(errorMessage));
+  return errorMessage[0] == '\0';
+}
+// FUNCTION : isOrderParseSafe
+// DESCRIPTION :
+//    Checks only what parsing an order line relies on, for trusted files, in the same way as
+//    isCustomerParseSafe: the order date is valid, so its day number indexes the per-day tables,
+//    and distinct parts matches the ordered parts given, so parsing reads no more fields than the
+//    line has and no more parts than an order holds.
+// PARAMETERS :
+//    char** fields: Array of strings containing order data.
+//    int numOfReadFields: Number of fields read from the order line.
+// RETURNS :
+//    int : 1 if the line can be parsed, 0 otherwise.
+int isOrderParseSafe(char** fields, int numOfReadFields) {
+  int distinctParts = 0;
+  sscanf_s(fields[5], "%d", &distinctParts);
+  return validateDate(fields[1]) && isInteger(fields[5]) && distinctParts == (numOfReadFields - 7) / 2 &&
+    distinctParts <= PARTS_LIMIT;
+}
+// FUNCTION : validateOrderReferences
+// DESCRIPTION :
+//    Validates only the references and totals of an order record, for trusted files whose format
+//    is guaranteed upstream: the customer and parts must exist and the totals must add up.
+// PARAMETERS :
+//    char** fields: Array of strings containing order data.
+//    int numOfReadFields: Number of fields read from the order line.
+//    int lineNumber: The line number in the file for error reporting.
+//    const Part* parts: Pointer to the array of Part structures for validating part IDs.
+//    int partCount: Number of parts in the parts array.
+//    const Customer* customers: Pointer to the array of Customer structures for validating customer IDs.
+//    int customerCount: Number of customers in the customers array.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if the references and totals are valid, 0 otherwise.
+int validateOrderReferences(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount,
+  const Customer* customers, int customerCount, char* reason, int reasonSize) {
+  char errorMessage[4096];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading orders database: Line %d: ", lineNumber);
+  size_t prefixLength = strlen(errorMessage);
+  checkOrderReferences(fields, numOfReadFields, parts, partCount, customers, customerCount, errorMessage, sizeof(errorMessage));
+  if (strlen(errorMessage) > prefixLength) {
+    reportFieldErrors(METRIC_SOURCE_ORDERS, errorMessage, reason, reasonSize);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : validatePaymentFields
+// DESCRIPTION :
+//    Validates the fields of a payment line: customerID|amount|date|.
+//    Whether the customer exists is checked when the payments are applied.
+// PARAMETERS :
+//    char** fields: Array of strings containing payment data.
+//    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validatePaymentFields(char** fields, int lineNumber, char* reason, int reasonSize) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading payments database: Line %d: ", lineNumber);
+  size_t prefixLength = strlen(errorMessage);
+  int customerID = 0;
+  sscanf_s(fields[0], "%d", &customerID);
+  if (!isInteger(fields[0]) || customerID <= 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), 
+      "\nField #1: Customer ID must be a positive int.");
+  }
+  float amount = 0.0;
+  sscanf_s(fields[1], "%f", &amount);
+  if (!isNumber(fields[1]) || amount <= 0.0) {
+    strcat_s(errorMessage, sizeof(errorMessage), 
+      "\nField #2: Payment amount must be greater than 0.");
+  }
+  if (!validateDate(fields[2])) {
+    strcat_s(errorMessage, sizeof(errorMessage), 
+      "\nField #3: Payment date must be in YYYY-MM-DD format and is a valid date.");
+  }
+  if (strlen(errorMessage) > prefixLength) {
+    copyValidationReason(errorMessage, reason, reasonSize);
+    logGeneric(errorMessage);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : validateReceiptFields
+// DESCRIPTION :
+//    Validates the fields of a stock receipt line: partID|quantity|.
+//    Whether the part exists is checked when the receipt is applied.
+// PARAMETERS :
+//    char** fields: Array of strings containing receipt data.
+//    int lineNumber: The line number in the file for error reporting.
+//    char* reason: Receives the field errors on one line when invalid, or NULL.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validateReceiptFields(char** fields, int lineNumber, char* reason, int reasonSize) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when loading receipts database: Line %d: ", lineNumber);
+  size_t prefixLength = strlen(errorMessage);
+  int partID = 0;
+  sscanf_s(fields[0], "%d", &partID);
+  if (!isInteger(fields[0]) || partID <= 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), 
+      "\nField #1: Part ID must be a positive int.");
+  }
+  int quantity = 0;
+  sscanf_s(fields[1], "%d", &quantity);
+  if (!isInteger(fields[1]) || quantity <= 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), 
+      "\nField #2: Quantity received must be a positive int.");
+  }
+  if (strlen(errorMessage) > prefixLength) {
+    copyValidationReason(errorMessage, reason, reasonSize);
+    logGeneric(errorMessage);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : validateCustomerRecord
+// DESCRIPTION :
+//    Validates a Customer structure supplied directly rather than read from the customers database.
+//    Applies the same rules as validateCustomerFields.
+// PARAMETERS :
+//    const Customer* customer: The customer to validate.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validateCustomerRecord(const Customer* customer) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when updating customer %d: ", customer->customerID);
+  size_t headerLength = strlen(errorMessage);
+  // Same lengths as checkCustomerTextFields. A field filling its whole buffer has no terminator, so
+  // strnlen reports it as over the limit.
+  size_t nameLength = strnlen(customer->customerName, sizeof(customer->customerName));
+  if (nameLength == 0 || nameLength > 50) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer name must neither be blank or over 50 characters");
+  }
+  size_t addressLength = strnlen(customer->customerAddress, sizeof(customer->customerAddress));
+  if (addressLength == 0 || addressLength > 100) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer address must neither be blank or over 100 characters.");
+  }
+  size_t cityLength = strnlen(customer->customerCity, sizeof(customer->customerCity));
+  if (cityLength == 0 || cityLength > 100) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer city must neither be blank or over 100 characters.");
+  }
+  if (!validateProvince(customer->customerProvince)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer province must be a valid canadian province abbreviation");
+  }
+  if (!validatePostalCode(customer->customerPostalCode)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer postal code must be in ANANAN format");
+  }
+  if (!validatePhoneNumber(customer->customerPhone)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer phone number must be in ###-###-#### format");
+  }
+  if (strnlen(customer->customerEmail, sizeof(customer->customerEmail)) > 50 || !validateEmail(customer->customerEmail)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer email address must a valid email address");
+  }
+  if (customer->customerID <= 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer ID must be a positive int.");
+  }
+  if (customer->customerCreditLimit <= 0.0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer credit limit must be greater than 0.");
+  }
+  if (customer->currentAccountBalance < 0.0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer account balance greater than or equal to 0.");
+  }
+  if (strlen(customer->lastPaymentMade) > 0 && !validateDate(customer->lastPaymentMade)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer last payment date must be either blank or a valid YYYY-MM-DD date.");
+  }
+  if (!validateDate(customer->customerJoinDate)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCustomer join date must be a valid YYYY-MM-DD date.");
+  }
+  if (strlen(errorMessage) > headerLength) { // When there is at least one error
+    logGeneric(errorMessage);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : validatePartRecord
+// DESCRIPTION :
+//    Validates a Part structure supplied directly rather than read from the parts database.
+//    Applies the same rules as validatePartFields.
+// PARAMETERS :
+//    const Part* part: The part to validate.
+// RETURNS :
+//    int : 1 if all fields are valid, 0 if any field is invalid.
+int validatePartRecord(const Part* part) {
+  char errorMessage[1024];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when updating part %d: ", part->partID);
+  size_t headerLength = strlen(errorMessage);
+  if (strlen(part->partName) == 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart name must not be blank.");
+  }
+  if (strlen(part->partNumber) == 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart number must not be blank.");
+  }
+  if (!validatePartLocation(part->partLocation)) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart location must be in A###-S###-L##-B## format");
+  }
+  if (part->partCost <= 0.0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart cost must be a positive number.");
+  }
+  if (part->quantityOnHand < 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nQuantity on hand must be a integer greater than or equal 0.");
+  }
+  // A negative status is a deficit set by the demand calculation
+  if (part->partStatus >= 0 &&
+      ((part->quantityOnHand > 100 && part->partStatus != 0) || (part->quantityOnHand <= 100 && part->partStatus != 99))) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart status or quantity on hand is invalid.");
+  }
+  if (part->partID <= 0) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nPart ID must be a positive integer.");
+  }
+  if (strlen(errorMessage) > headerLength) { // When there is at least one error
+    logGeneric(errorMessage);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : indexOrderReferences
+// DESCRIPTION :
+//    Indexes the parts and customers that orders refer to, so a batch of orders can be checked with
+//    checkOrderRecord without scanning the arrays. The first record of a repeated ID is the one indexed.
+// PARAMETERS :
+//    const Part* parts: The current parts.
+//    int partCount: Number of parts.
+//    const Customer* customers: The current customers.
+//    int customerCount: Number of customers.
+//    IdIndex* partIndex: Receives partID -> position in parts. Freed by the caller.
+//    IdIndex* customerIndex: Receives customerID -> position in customers. Freed by the caller.
+// RETURNS :
+//    int : 1 on success, 0 if memory could not be allocated.
+int indexOrderReferences(const Part* parts, int partCount, const Customer* customers, int customerCount,
+  IdIndex* partIndex, IdIndex* customerIndex) {
+  memset(partIndex, 0, sizeof(IdIndex));
+  memset(customerIndex, 0, sizeof(IdIndex));
+  if (!initIdIndex(partIndex, partCount) || !initIdIndex(customerIndex, customerCount)) {
+    freeIdIndex(partIndex);
+    freeIdIndex(customerIndex);
+    return 0;
+  }
+  int isIndexed = 1;
+  for (int i = 0; i < partCount; i++) {
+    if (parts[i].partID > 0 && findIdIndex(partIndex, parts[i].partID) == ID_INDEX_NOT_FOUND) {
+      isIndexed &= setIdIndex(partIndex, parts[i].partID, i);
+    }
+  }
+  for (int i = 0; i < customerCount; i++) {
+    if (customers[i].customerID > 0 && findIdIndex(customerIndex, customers[i].customerID) == ID_INDEX_NOT_FOUND) {
+      isIndexed &= setIdIndex(customerIndex, customers[i].customerID, i);
+    }
+  }
+  if (!isIndexed) {
+    freeIdIndex(partIndex);
+    freeIdIndex(customerIndex);
+    return 0;
+  }
+  return 1;
+}
+// FUNCTION : validateOrderRecord
+// DESCRIPTION :
+//    Validates an already parsed order against the current parts and customers, so an order can be
+//    re-checked after a part or customer changes without re-reading its line. The rules are those of
+//    checkOrderRecord; the failed ones are logged.
+// PARAMETERS :
+//    const Order* order: The order to validate.
+//    const Part* parts: The parts array the part index points into.
+//    const IdIndex* partIndex: partID -> position in parts, from indexOrderReferences.
+//    const IdIndex* customerIndex: customerID -> position of the customer, from indexOrderReferences.
+// RETURNS :
+//    int : 1 if the order is valid, 0 if any rule fails.
+int validateOrderRecord(const Order* order, const Part* parts, const IdIndex* partIndex, const IdIndex* customerIndex) {
+  char reason[4096];
+  if (checkOrderRecord(order, parts, partIndex, customerIndex, reason, sizeof(reason)) == 0) {
+    return 1;
+  }
+  char errorMessage[4200];
+  snprintf(errorMessage, sizeof(errorMessage), "Error when revalidating order %lld: %s", order->orderID, reason);
+  logGeneric(errorMessage);
+  return 0;
+}
+// FUNCTION : checkOrderRecord
+// DESCRIPTION :
+//    Checks an order supplied as a structure against the business rules of validateOrderFields,
+//    using the IdIndex of the parts and customers instead of scanning them, so a check costs a few
+//    lookups per ordered part. The reason text is only formatted when a rule fails.
+// PARAMETERS :
+//    const Order* order: The order to check.
+//    const Part* parts: The parts array the part index points into.
+//    const IdIndex* partIndex: partID -> position in parts.
+//    const IdIndex* customerIndex: customerID -> position of the customer.
+//    char* reason: Receives the failed rules, one per line, or NULL if not wanted.
+//    int reasonSize: The size of the reason buffer.
+// RETURNS :
+//    int : 0 if the order passes, otherwise the ORDER_RULE_* flags of the failed rules.
+int checkOrderRecord(const Order* order, const Part* parts, const IdIndex* partIndex, const IdIndex* customerIndex,
+  char* reason, int reasonSize) {
+  int failedRules = 0;
+  int year = (int)(order->orderID / 10000000);
+  int month = (int)(order->orderID / 100000 % 100);
+  int day = (int)(order->orderID / 1000 % 100);
+  if (order->orderID < 10000000000LL || order->orderID > 99999999999LL || !isValidDate(year, month, day) ||
+    order->orderID % 1000 == 0) {
+    failedRules |= ORDER_RULE_ID;
+  }
+  else if (order->orderDate[0] != '\0') {
+    char idDate[11];
+    snprintf(idDate, sizeof(idDate), "%04d-%02d-%02d", year, month, day);
+    if (strcmp(idDate, order->orderDate) != 0) {
+      failedRules |= ORDER_RULE_DATE;
+    }
+  }
+  if (order->orderStatus != 0 && order->orderStatus != 1 && order->orderStatus != 99 && order->orderStatus != 500) {
+    failedRules |= ORDER_RULE_STATUS;
+  }
+  if (order->customerID <= 0 || findIdIndex(customerIndex, order->customerID) == ID_INDEX_NOT_FOUND) {
+    failedRules |= ORDER_RULE_CUSTOMER;
+  }
+  if (order->orderTotal <= 0.0) {
+    failedRules |= ORDER_RULE_TOTAL;
+  }
+  if (order->totalParts < 1) {
+    failedRules |= ORDER_RULE_PART_COUNT;
+  }
+  if (order->distinctParts < 1 || order->distinctParts > PARTS_LIMIT) {
+    failedRules |= ORDER_RULE_PART_COUNT;
+  }
+  else {
+    // Recompute the totals in the same order as validateOrderFields so the float sums compare equal
+    int calculatedTotalParts = 0;
+    float calculatedOrderTotal = 0.0;
+    for (int i = 0; i < order->distinctParts; i++) {
+      int position = order->orderedParts[i].partID > 0
+        ? findIdIndex(partIndex, order->orderedParts[i].partID) : ID_INDEX_NOT_FOUND;
+      if (position == ID_INDEX_NOT_FOUND) {
+        failedRules |= ORDER_RULE_PART;
+      }
+      if (order->orderedParts[i].quantityOrdered <= 0) {
+        failedRules |= ORDER_RULE_QUANTITY;
+      }
+      if (position != ID_INDEX_NOT_FOUND) {
+        calculatedTotalParts += order->orderedParts[i].quantityOrdered;
+        calculatedOrderTotal += parts[position].partCost * order->orderedParts[i].quantityOrdered;
+      }
+    }
+    if (!(failedRules & (ORDER_RULE_PART | ORDER_RULE_QUANTITY))) {
+      if (calculatedTotalParts != order->totalParts) {
+        failedRules |= ORDER_RULE_PART_COUNT;
+      }
+      if (calculatedOrderTotal != order->orderTotal) {
+        failedRules |= ORDER_RULE_TOTAL;
+      }
+    }
+  }
+  if (failedRules == 0 || reason == NULL) {
+    return failedRules;
+  }
+  char errorMessage[4096] = "";
+  char localErrorMessage[200];
+  if (failedRules & ORDER_RULE_ID) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nOrder ID must be in YYYYMMDDSSS format and is a valid date.");
+  }
+  if (failedRules & ORDER_RULE_DATE) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nOrder date must match the date in the order ID.");
+  }
+  if (failedRules & ORDER_RULE_STATUS) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nOrder status must be a valid integer (0, 1, 99, or 500).");
+  }
+  if (failedRules & ORDER_RULE_CUSTOMER) {
+    strcat_s(errorMessage, sizeof(errorMessage),
+      "\nCustomer ID must be a positive integer and must link to an existing customer.");
+  }
+  if (failedRules & ORDER_RULE_TOTAL) {
+    strcat_s(errorMessage, sizeof(errorMessage),
+      order->orderTotal <= 0.0 ? "\nOrder total must be a positive number."
+      : "\nCalculated order total does not match the provided order total.");
+  }
+  int isPartCountValid = order->distinctParts >= 1 && order->distinctParts <= PARTS_LIMIT;
+  if (order->totalParts < 1) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nTotal parts must be a positive integer greater than or equal to 1.");
+  }
+  if (!isPartCountValid) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nDistinct parts must be a positive integer.");
+  }
+  else if ((failedRules & ORDER_RULE_PART_COUNT) && order->totalParts >= 1) {
+    strcat_s(errorMessage, sizeof(errorMessage), "\nCalculated total parts does not match the provided total parts.");
+  }
+  for (int i = 0; isPartCountValid && (failedRules & (ORDER_RULE_PART | ORDER_RULE_QUANTITY)) && i < order->distinctParts; i++) {
+    int partID = order->orderedParts[i].partID;
+    if (partID <= 0 || findIdIndex(partIndex, partID) == ID_INDEX_NOT_FOUND) {
+      snprintf(localErrorMessage, sizeof(localErrorMessage), "\nPart ID %d does not exist in the parts database.", partID);
+      strcat_s(errorMessage, sizeof(errorMessage), localErrorMessage);
+    }
+    if (order->orderedParts[i].quantityOrdered <= 0) {
+      snprintf(localErrorMessage, sizeof(localErrorMessage),
+        "\nQuantity ordered for part ID %d must be a positive integer.", partID);
+      strcat_s(errorMessage, sizeof(errorMessage), localErrorMessage);
+    }
+  }
+  copyValidationReason(errorMessage, reason, reasonSize);
+  return failedRules;
+}
 // FUNCTION : validateProvince
 // DESCRIPTION :
 //    Validates the province code against a predefined list of Canadian provinces.
@@ -430,6 +1146,22 @@ int validateDate(const char* date) {
 
   return isValidDate(year, month, day); 
 }
+// FUNCTION : validateOrderIDMatchesDate
+// DESCRIPTION :
+//    Checks that the YYYYMMDD prefix of an order ID is the order date and that the SSS sequence is not 000.
+//    Both values must already be in a valid format.
+// PARAMETERS :
+//    const char* orderID: The order ID string (YYYYMMDDSSS).
+//    const char* orderDate: The order date string (YYYY-MM-DD).
+// RETURNS :
+//    int : 1 if the order ID matches the date, 0 otherwise.
+int validateOrderIDMatchesDate(const char* orderID, const char* orderDate) {
+  if (strncmp(orderID, orderDate, 4) != 0 || strncmp(orderID + 4, orderDate + 5, 2) != 0 ||
+    strncmp(orderID + 6, orderDate + 8, 2) != 0) {
+    return 0;
+  }
+  return strcmp(orderID + 8, "000") != 0;
+}
 // FUNCTION : validatePartLocation
 // DESCRIPTION :
 //    Validates the part location format according to the (A###-S###-L##-B##) format.
@@ -439,7 +1171,6 @@ int validateDate(const char* date) {
 //    int : 1 if the part location is valid, 0 if it is invalid.
 int validatePartLocation(const char* partLocation) {
   if (strlen(partLocation) != 17 || partLocation[4] != '-' || partLocation[9] != '-' || partLocation[13] != '-') {
-    printf("Invalid part location format: %s\n", partLocation);
     return 0; // Invalid format
   }
   // Check A###-S###-L##-B##
@@ -529,12 +1260,12 @@ int validateOrderStatus(char* orderStatus) {
 // DESCRIPTION :
 //    Validates the customer ID in an order against the existing customers.
 // PARAMETERS :
-//    char* customerID: The customer ID string to validate.
+//    const char* customerID: The customer ID string to validate.
 //    const Customer* customers: Pointer to the array of Customer structures for validating customer IDs.
 //    int customerCount: Number of customers in the customers array.
 // RETURNS :
 //    int : 1 if the customer ID is valid and exists in the customers array, 0 if it is invalid or does not exist.
-int validateCustomerIDInOrder(char* customerID, const Customer* customers, int customerCount) {
+int validateCustomerIDInOrder(const char* customerID, const Customer* customers, int customerCount) {
   if (!isInteger(customerID)) {
     return 0; 
   }
@@ -5,23 +5,57 @@
 #include "Customer.h"
 #include "Part.h"
 #include "Order.h"
+#include "Index.h"
 
-int validateCustomerFields(char** fields, int lineNumber);
+// Business rules of an order checked by checkOrderRecord, one bit each
+#define ORDER_RULE_ID 0x001 // orderID is YYYYMMDDSSS with a valid date and SSS >= 001
+#define ORDER_RULE_DATE 0x002 // orderDate, when given, is the date of the orderID
+#define ORDER_RULE_STATUS 0x004 // orderStatus is 0, 1, 99 or 500
+#define ORDER_RULE_CUSTOMER 0x008 // customerID links to an existing customer
+#define ORDER_RULE_TOTAL 0x010 // orderTotal is positive and equals the sum of the part costs
+#define ORDER_RULE_PART_COUNT 0x020 // distinctParts is 1 to PARTS_LIMIT and totalParts equals the sum of the quantities
+#define ORDER_RULE_PART 0x040 // Every partID links to an existing part
+#define ORDER_RULE_QUANTITY 0x080 // Every quantityOrdered is positive
+
+int validateCustomerFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int validateCustomerKeyFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int validateCustomerTextFields(char** fields, int customerID);
+int isCustomerValid(char** fields, int isKeyOnly);
+int isCustomerParseSafe(char** fields, int isKeyOnly);
 int validateProvince(const char* province);
 int validatePostalCode(const char* postalCode);
 int validatePhoneNumber(const char* phoneNumber);
 int validateEmail(const char* email);
 int validateDate(const char* date);
 
-int validatePartFields(char** fields, int lineNumber);
+int validatePartFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int validatePartKeyFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int validatePartTextFields(char** fields, int partID);
+int isPartValid(char** fields, int isKeyOnly);
+int isPartParseSafe(char** fields, int isKeyOnly);
 int validatePartLocation(const char* partLocation);
 int validatePartStatus(char* quantityOnHand, char* partStatus);
 
-int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount, const Customer* customers, int customerCount);
+int validateOrderFields(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount, const Customer* customers, int customerCount,
+  char* reason, int reasonSize);
+int isOrderFormatValid(char** fields, int numOfReadFields);
+int isOrderParseSafe(char** fields, int numOfReadFields);
+int validateOrderReferences(char** fields, int numOfReadFields, int lineNumber, const Part* parts, int partCount,
+  const Customer* customers, int customerCount, char* reason, int reasonSize);
 int validateOrderID(const char* orderID);
+int validateOrderIDMatchesDate(const char* orderID, const char* orderDate);
 int validateOrderStatus(char* orderStatus);
 int validateCustomerIDInOrder(const char* customerID, const Customer* customers, int customerCount);
 int validatePartIDInOrder(int partID, const Part* parts, int partCount);
+int validateCustomerRecord(const Customer* customer);
+int validatePartRecord(const Part* part);
+int validatePaymentFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int validateReceiptFields(char** fields, int lineNumber, char* reason, int reasonSize);
+int indexOrderReferences(const Part* parts, int partCount, const Customer* customers, int customerCount,
+  IdIndex* partIndex, IdIndex* customerIndex);
+int validateOrderRecord(const Order* order, const Part* parts, const IdIndex* partIndex, const IdIndex* customerIndex);
+int checkOrderRecord(const Order* order, const Part* parts, const IdIndex* partIndex, const IdIndex* customerIndex,
+  char* reason, int reasonSize);
 
 int isInteger(const char* str);
 int isNumber(const char* str);
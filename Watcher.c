@@ -0,0 +1,294 @@
+// FILE : Watcher.c
+// DESCRIPTION :
+//    Implements watching of the customers, parts and orders databases for changes.
+//    When only customers.db or parts.db changes, only that file is re-parsed and only the orders
+//    that reference a changed customerID or partID are re-validated, instead of reloading everything.
+#include "Watcher.h"
+#include "FileIO.h"
+#include "Dependency.h"
+#include "Index.h"
+#include "Rollup.h"
+#include "Logger.h"
+#include "Constants.h"
+#include <windows.h>
+#include <conio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FUNCTION : getLastWriteTime
+// DESCRIPTION :
+//    Reads the last write time of a file.
+// PARAMETERS :
+//    const char* fileName: The file to inspect.
+//    FILETIME* lastWriteTime: Receives the last write time, zeroed if the file does not exist.
+// RETURNS :
+//    void
+static void getLastWriteTime(const char* fileName, FILETIME* lastWriteTime) {
+  WIN32_FILE_ATTRIBUTE_DATA attributes;
+  if (GetFileAttributesExA(fileName, GetFileExInfoStandard, &attributes)) {
+    *lastWriteTime = attributes.ftLastWriteTime;
+  }
+  else {
+    memset(lastWriteTime, 0, sizeof(FILETIME));
+  }
+}
+
+// FUNCTION : hasFileChanged
+// DESCRIPTION :
+//    Compares the current last write time of a file with a saved one and updates the saved time.
+// PARAMETERS :
+//    const char* fileName: The file to inspect.
+//    FILETIME* savedWriteTime: The last write time seen so far, updated in place.
+// RETURNS :
+//    int : 1 if the file changed since the saved time, 0 otherwise.
+static int hasFileChanged(const char* fileName, FILETIME* savedWriteTime) {
+  FILETIME currentWriteTime;
+  getLastWriteTime(fileName, &currentWriteTime);
+  if (CompareFileTime(&currentWriteTime, savedWriteTime) == 0) {
+    return 0;
+  }
+  *savedWriteTime = currentWriteTime;
+  return 1;
+}
+
+// FUNCTION : reloadCustomersDelta
+// DESCRIPTION :
+//    Re-parses only the customers database, then re-validates only the orders whose customerID
+//    was added or removed by the change. Other customer fields do not affect order validity.
+// PARAMETERS :
+//    Customer* customers: The customers array, replaced with the new contents of the file.
+//    int* customerCount: Number of customers, updated.
+//    const Part* parts: The current parts.
+//    int partCount: Number of parts.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+//    const LoadOptions* options: Options for re-parsing the file.
+// RETURNS :
+//    int : The number of orders re-validated, or -1 on failure. The old records are kept when the
+//          file could not be read.
+int reloadCustomersDelta(Customer* customers, int* customerCount, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips, const LoadOptions* options) {
+  Customer* newCustomers = (Customer*)malloc(CUSTOMERS_LIMIT * sizeof(Customer));
+  int* changedIDs = (int*)malloc(CUSTOMERS_LIMIT * 2 * sizeof(int));
+  unsigned char* isKept = (unsigned char*)calloc(CUSTOMERS_LIMIT, sizeof(unsigned char));
+  IdIndex oldIndex = { 0 };
+  if (newCustomers == NULL || changedIDs == NULL || isKept == NULL || !initIdIndex(&oldIndex, *customerCount)) {
+    logGeneric("Failed to allocate memory for customers reload.");
+    free(newCustomers);
+    free(changedIDs);
+    free(isKept);
+    return -1;
+  }
+  int newCount = loadCustomers(newCustomers, CUSTOMERS_FILE, options);
+  if (newCount < 0) {
+    // Most likely still being written: keep the old customers rather than treat them all as removed
+    freeIdIndex(&oldIndex);
+    free(newCustomers);
+    free(changedIDs);
+    free(isKept);
+    return -1;
+  }
+  for (int i = 0; i < *customerCount; i++) {
+    setIdIndex(&oldIndex, customers[i].customerID, i);
+  }
+  // Added customers
+  int changedCount = 0;
+  for (int i = 0; i < newCount; i++) {
+    int oldPosition = findIdIndex(&oldIndex, newCustomers[i].customerID);
+    if (oldPosition == ID_INDEX_NOT_FOUND) {
+      changedIDs[changedCount++] = newCustomers[i].customerID;
+    }
+    else {
+      isKept[oldPosition] = 1;
+    }
+  }
+  // Removed customers
+  for (int i = 0; i < *customerCount; i++) {
+    if (!isKept[i]) {
+      changedIDs[changedCount++] = customers[i].customerID;
+    }
+  }
+  memcpy(customers, newCustomers, newCount * sizeof(Customer));
+  *customerCount = newCount;
+  int revalidatedCount = revalidateDependentOrders(deps, NULL, 0, changedIDs, changedCount,
+    orders, orderCount, parts, partCount, customers, *customerCount, flips);
+
+  freeIdIndex(&oldIndex);
+  free(newCustomers);
+  free(changedIDs);
+  free(isKept);
+  return revalidatedCount;
+}
+
+// FUNCTION : reloadPartsDelta
+// DESCRIPTION :
+//    Re-parses only the parts database, then re-validates only the orders that reference a partID
+//    that was added, removed, or whose cost changed.
+// PARAMETERS :
+//    Part* parts: The parts array, replaced with the new contents of the file.
+//    int* partCount: Number of parts, updated.
+//    const Customer* customers: The current customers.
+//    int customerCount: Number of customers.
+//    const Order* orders: The loaded orders.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    ValidityFlips* flips: Receives the orders whose validity flipped, or NULL.
+//    const LoadOptions* options: Options for re-parsing the file.
+// RETURNS :
+//    int : The number of orders re-validated, or -1 on failure. The old records are kept when the
+//          file could not be read.
+int reloadPartsDelta(Part* parts, int* partCount, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips, const LoadOptions* options) {
+  Part* newParts = (Part*)malloc(PARTS_LIMIT * sizeof(Part));
+  int* changedIDs = (int*)malloc(PARTS_LIMIT * 2 * sizeof(int));
+  unsigned char* isKept = (unsigned char*)calloc(PARTS_LIMIT, sizeof(unsigned char));
+  IdIndex oldIndex = { 0 };
+  if (newParts == NULL || changedIDs == NULL || isKept == NULL || !initIdIndex(&oldIndex, *partCount)) {
+    logGeneric("Failed to allocate memory for parts reload.");
+    free(newParts);
+    free(changedIDs);
+    free(isKept);
+    return -1;
+  }
+  int newCount = loadParts(newParts, PARTS_FILE, options);
+  if (newCount < 0) {
+    // Most likely still being written: keep the old parts rather than treat them all as removed
+    freeIdIndex(&oldIndex);
+    free(newParts);
+    free(changedIDs);
+    free(isKept);
+    return -1;
+  }
+  for (int i = 0; i < *partCount; i++) {
+    setIdIndex(&oldIndex, parts[i].partID, i);
+  }
+  // Added parts and parts whose cost changed (the only part value used by order validation)
+  int changedCount = 0;
+  for (int i = 0; i < newCount; i++) {
+    int oldPosition = findIdIndex(&oldIndex, newParts[i].partID);
+    if (oldPosition == ID_INDEX_NOT_FOUND) {
+      changedIDs[changedCount++] = newParts[i].partID;
+      continue;
+    }
+    isKept[oldPosition] = 1;
+    if (parts[oldPosition].partCost != newParts[i].partCost) {
+      changedIDs[changedCount++] = newParts[i].partID;
+    }
+  }
+  // Removed parts
+  for (int i = 0; i < *partCount; i++) {
+    if (!isKept[i]) {
+      changedIDs[changedCount++] = parts[i].partID;
+    }
+  }
+  memcpy(parts, newParts, newCount * sizeof(Part));
+  *partCount = newCount;
+  int revalidatedCount = revalidateDependentOrders(deps, changedIDs, changedCount, NULL, 0,
+    orders, orderCount, parts, *partCount, customers, customerCount, flips);
+
+  freeIdIndex(&oldIndex);
+  free(newParts);
+  free(changedIDs);
+  free(isKept);
+  return revalidatedCount;
+}
+
+// FUNCTION : watchDatabases
+// DESCRIPTION :
+//    Watches the working directory for writes to the database files until a key is pressed.
+//    customers.db and parts.db changes are applied as delta updates. A change to orders.db
+//    reloads the orders and rebuilds the dependency index, since every order may have changed.
+//    Note: orders rejected when orders.db was last loaded are not reconsidered by a delta update.
+// PARAMETERS :
+//    Customer* customers: The customers array.
+//    int* customerCount: Number of customers, updated on reload.
+//    Part* parts: The parts array.
+//    int* partCount: Number of parts, updated on reload.
+//    Order* orders: The orders array.
+//    int* orderCount: Number of orders, updated on reload.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    const LoadOptions* options: Options for re-parsing changed files.
+// RETURNS :
+//    void
+void watchDatabases(Customer* customers, int* customerCount, Part* parts, int* partCount,
+  Order* orders, int* orderCount, OrderDependencies* deps, const LoadOptions* options) {
+  ValidityFlips flips;
+  if (!initValidityFlips(&flips, ORDERS_LIMIT)) {
+    printf("Unable to watch the database files.\n");
+    return;
+  }
+  HANDLE change = FindFirstChangeNotificationA(".", FALSE,
+    FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+  if (change == INVALID_HANDLE_VALUE) {
+    logGeneric("Failed to watch the database directory for changes.");
+    printf("Unable to watch the database files.\n");
+    freeValidityFlips(&flips);
+    return;
+  }
+  FILETIME customersWriteTime;
+  FILETIME partsWriteTime;
+  FILETIME ordersWriteTime;
+  getLastWriteTime(CUSTOMERS_FILE, &customersWriteTime);
+  getLastWriteTime(PARTS_FILE, &partsWriteTime);
+  getLastWriteTime(ORDERS_FILE, &ordersWriteTime);
+  printf("Watching %s, %s and %s for changes. Press any key to stop.\n", CUSTOMERS_FILE, PARTS_FILE, ORDERS_FILE);
+
+  while (!_kbhit()) {
+    if (WaitForSingleObject(change, WATCH_POLL_MS) != WAIT_OBJECT_0) {
+      continue;
+    }
+    Sleep(WATCH_DEBOUNCE_MS); // Let the writer finish before reading the file
+    int isCustomersChanged = hasFileChanged(CUSTOMERS_FILE, &customersWriteTime);
+    int isPartsChanged = hasFileChanged(PARTS_FILE, &partsWriteTime);
+    int isOrdersChanged = hasFileChanged(ORDERS_FILE, &ordersWriteTime);
+    // Orders are revalidated from scratch when orders.db itself changed
+    int dependentOrderCount = isOrdersChanged ? 0 : *orderCount;
+
+    if (isCustomersChanged) {
+      int revalidated = reloadCustomersDelta(customers, customerCount, parts, *partCount, orders, dependentOrderCount, deps, &flips, options);
+      if (revalidated < 0) {
+        memset(&customersWriteTime, 0, sizeof(FILETIME)); // Retry on the next change notification
+        printf("%s changed but could not be read, the loaded customers are kept.\n", CUSTOMERS_FILE);
+      }
+      else {
+        printf("%s changed: %d customers loaded, %d dependent orders re-validated.\n", CUSTOMERS_FILE, *customerCount, revalidated);
+        printValidityFlips(&flips, orders);
+        if (options->rollups != NULL) {
+          rollupApplyValidityFlips(options->rollups, &flips, orders);
+        }
+        if (options->rankings != NULL) {
+          rankingsApplyValidityFlips(options->rankings, &flips, orders);
+        }
+      }
+    }
+    if (isPartsChanged) {
+      int revalidated = reloadPartsDelta(parts, partCount, customers, *customerCount, orders, dependentOrderCount, deps, &flips, options);
+      if (revalidated < 0) {
+        memset(&partsWriteTime, 0, sizeof(FILETIME)); // Retry on the next change notification
+        printf("%s changed but could not be read, the loaded parts are kept.\n", PARTS_FILE);
+      }
+      else {
+        printf("%s changed: %d parts loaded, %d dependent orders re-validated.\n", PARTS_FILE, *partCount, revalidated);
+        printValidityFlips(&flips, orders);
+        if (options->rollups != NULL) {
+          rollupApplyValidityFlips(options->rollups, &flips, orders);
+        }
+        if (options->rankings != NULL) {
+          rankingsApplyValidityFlips(options->rankings, &flips, orders);
+        }
+      }
+    }
+    if (isOrdersChanged) {
+      *orderCount = loadOrders(orders, parts, *partCount, customers, *customerCount, ORDERS_FILE, options);
+      buildOrderDependencies(deps, orders, *orderCount);
+      printf("%s changed: %d orders loaded.\n", ORDERS_FILE, *orderCount);
+    }
+    FindNextChangeNotification(change);
+  }
+  _getch(); // Consume the key that stopped the watch
+  FindCloseChangeNotification(change);
+  freeValidityFlips(&flips);
+}
@@ -0,0 +1,19 @@
+// FILE : Watcher.h
+// DESCRIPTION : This header file defines functions for watching the database files and reloading only what changed.
+#ifndef WATCHER_H
+#define WATCHER_H
+
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+#include "Dependency.h"
+#include "FileIO.h"
+
+void watchDatabases(Customer* customers, int* customerCount, Part* parts, int* partCount,
+  Order* orders, int* orderCount, OrderDependencies* deps, const LoadOptions* options);
+int reloadCustomersDelta(Customer* customers, int* customerCount, const Part* parts, int partCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips, const LoadOptions* options);
+int reloadPartsDelta(Part* parts, int* partCount, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, ValidityFlips* flips, const LoadOptions* options);
+
+#endif
@@ -7,50 +7,308 @@
 #include "Part.h"
 #include "Order.h"
 #include "Constants.h"
+#include "Dependency.h"
+#include "Watcher.h"
+#include "Update.h"
+#include "Rollup.h"
+#include "Demand.h"
+#include "PickList.h"
+#include "DateIndex.h"
+#include "OrderId.h"
+#include "ExternalSort.h"
+#include "Shard.h"
+#include "Metrics.h"
+#include "Quarantine.h"
+#include "LazyFields.h"
+#include "LoadScheduler.h"
+#include "OrderStore.h"
+#include "Payments.h"
+#include "Receipts.h"
+#include "Submit.h"
+#include "SalesCube.h"
+#include "Ranking.h"
 
 void printCustomer(const Customer* customer);
 void printPart(const Part* p);
 void printOrder(const Order* order);
 void printCustomers(const Customer* customers, int count);
 void printParts(const Part* parts, int count);
-void printOrders(const Order* orders, int count);
+void printOrders(const Order* orders, const unsigned char* orderValid, int count);
 void printMenu();
 void promptInt(const char* prompt, int* input);
+void promptFloat(const char* prompt, float* input);
+void updatePartCost(Part* parts, int partCount, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, CustomerRollups* rollups, OrderRankings* rankings, LazyRecords* lazy);
+void printCustomerSummary(Customer* customers, int customerCount, const CustomerRollups* rollups, LazyRecords* lazy);
+void printPickLines(const Order* orders, const unsigned char* orderValid, int orderCount, const Part* parts, int partCount);
+void printPartShortages(Part* parts, int partCount, const Order* orders, const unsigned char* orderValid, int orderCount,
+  LazyRecords* lazy);
 void flushInputStream();
+void promptDuplicatePolicy(LoadOptions* options);
+void toggleLazyLoading(LoadOptions* options, LazyRecords* lazy);
+void promptTrustedFiles(LoadOptions* options);
+int promptDate(const char* prompt);
+void printOrdersBetweenDates(const Order* orders, const unsigned char* orderValid, const OrderDateIndex* orderDates);
+void printCustomersWithoutPayment(Customer* customers, int customerCount, const PaymentZoneMap* paymentZones, LazyRecords* lazy);
+void reserveOrderID(OrderIdAllocator* orderIds);
+void sortOrderDatabases();
+void promptText(const char* prompt, char* input, int size);
+void loadOrderShards(ShardedOrders* sharded, const Part* parts, int partCount, const Customer* customers, int customerCount);
+void printShardCustomerOrders(const ShardedOrders* sharded);
+void printShardOrderByID(const ShardedOrders* sharded);
+int isOrderWithID(const Order* order, const void* context);
+void pageOrderHistory(OrderStore* store, DuplicatePolicy duplicatePolicy, const Part* parts, int partCount,
+  const Customer* customers, int customerCount);
+void printStoredOrderByID(OrderStore* store);
+void applyPayments(Customer* customers, int customerCount, PaymentZoneMap* paymentZones, const LoadOptions* loadOptions);
+void applyReceipts(Part* parts, int partCount, Order* orders, const unsigned char* orderValid, int orderCount,
+  BackorderWaitlists* waitlists, CustomerRollups* rollups, const LoadOptions* loadOptions);
+void submitNewOrders(OrderSubmitter* submitter);
+void printSalesBetweenDates(const SalesCubes* salesCubes);
+void printOrderRankings(const OrderRankings* rankings, const ShardedOrders* sharded);
+void printRankedKeys(const HeavyHitters* hitters, const char* keyName, const char* weightName);
+void reingestQuarantinedLines(Customer* customers, int* customerCount, Part* parts, int* partCount, Order* orders, int* orderCount,
+  OrderDependencies* deps, const LoadOptions* loadOptions);
 
 int main() {
+  METRIC_INIT();
   Customer *customers = (Customer*)malloc(CUSTOMERS_LIMIT * sizeof(Customer)); 
   Part* parts = (Part*)malloc(PARTS_LIMIT * sizeof(Part));
   Order* orders = (Order*)malloc(ORDERS_LIMIT * sizeof(Order));
   int customerCount = 0;
   int partCount = 0;
   int orderCount = 0;
+  OrderDependencies deps;
+  if (!initOrderDependencies(&deps, ORDERS_LIMIT)) {
+    printf("Failed to allocate memory for the order dependency index.\n");
+    return 1;
+  }
+  DuplicateReport duplicates;
+  if (!initDuplicateReport(&duplicates, CUSTOMERS_LIMIT + PARTS_LIMIT + ORDERS_LIMIT)) {
+    printf("Failed to allocate memory for the duplicate report.\n");
+    return 1;
+  }
+  CustomerRollups rollups;
+  if (!initCustomerRollups(&rollups, CUSTOMERS_LIMIT)) {
+    printf("Failed to allocate memory for the customer order rollups.\n");
+    return 1;
+  }
+  OrderDateIndex orderDates;
+  PaymentZoneMap paymentZones;
+  if (!initOrderDateIndex(&orderDates, ORDERS_LIMIT) || !initPaymentZoneMap(&paymentZones, CUSTOMERS_LIMIT)) {
+    printf("Failed to allocate memory for the date indexes.\n");
+    return 1;
+  }
+  OrderIdAllocator orderIds;
+  if (!initOrderIdAllocator(&orderIds)) {
+    printf("Failed to allocate memory for the order ID allocator.\n");
+    return 1;
+  }
+  BackorderWaitlists waitlists;
+  if (!initBackorderWaitlists(&waitlists, PARTS_LIMIT)) {
+    printf("Failed to allocate memory for the backorder waitlists.\n");
+    return 1;
+  }
+  SalesCubes salesCubes;
+  if (!initSalesCubes(&salesCubes)) {
+    printf("Failed to allocate memory for the sales cubes.\n");
+    return 1;
+  }
+  OrderRankings rankings;
+  if (!initOrderRankings(&rankings, HEAVY_HITTER_SLOTS)) {
+    printf("Failed to allocate memory for the order rankings.\n");
+    return 1;
+  }
+  LazyRecords lazyRecords;
+  initLazyRecords(&lazyRecords);
+  LoadOptions loadOptions;
+  memset(&loadOptions, 0, sizeof(LoadOptions));
+  loadOptions.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  loadOptions.duplicates = &duplicates;
+  loadOptions.rollups = &rollups;
+  loadOptions.orderDates = &orderDates;
+  loadOptions.paymentZones = &paymentZones;
+  loadOptions.orderIds = &orderIds;
+  loadOptions.isQuarantining = 1;
+  loadOptions.rankings = &rankings;
+  ShardedOrders shardedOrders;
+  initShardedOrders(&shardedOrders, DUPLICATE_KEEP_FIRST);
+  OrderStore orderStore = { 0 };
 
   while (1) {
     int choice;
     printMenu();
-    promptInt("Enter your choice (1-5): ", &choice);
+    promptInt("Enter your choice (1-29): ", &choice);
     switch (choice) {
       case 1: {
-        customerCount = loadCustomers(customers, CUSTOMERS_FILE);
-        partCount = loadParts(parts, PARTS_FILE);
-        orderCount = loadOrders(orders, parts, partCount, customers, customerCount, ORDERS_FILE);
+        duplicates.count = 0;
+        loadDatabases(customers, &customerCount, parts, &partCount, orders, &orderCount, &loadOptions);
+        buildOrderDependencies(&deps, orders, orderCount);
+        buildBackorderWaitlists(&waitlists, orders, deps.orderValid, orderCount);
+        buildSalesCubes(&salesCubes, orders, deps.orderValid, orderCount, parts, partCount);
+        METRIC_WRITE(METRICS_FILE);
         printf("Loaded %d customers, %d parts, and %d orders.\n", customerCount, partCount, orderCount);
+        if (duplicates.count > 0) {
+          printf("%d duplicate ID(s) found. See %s for details.\n", duplicates.count, LOG_FILE);
+        }
         break;
       }
       case 2: {
+        materializeCustomers(&lazyRecords, customers, customerCount);
         printCustomers(customers, customerCount);
         break;
       }
       case 3: {
+        materializeParts(&lazyRecords, parts, partCount);
         printParts(parts, partCount);
         break;
       }
       case 4: {
-        printOrders(orders, orderCount);
+        printOrders(orders, deps.orderValid, orderCount);
         break;
       }
       case 5: {
+        watchDatabases(customers, &customerCount, parts, &partCount, orders, &orderCount, &deps, &loadOptions);
+        buildBackorderWaitlists(&waitlists, orders, deps.orderValid, orderCount);
+        buildSalesCubes(&salesCubes, orders, deps.orderValid, orderCount, parts, partCount);
+        break;
+      }
+      case 6: {
+        updatePartCost(parts, partCount, customers, customerCount, orders, orderCount, &deps, &rollups, &rankings, &lazyRecords);
+        buildBackorderWaitlists(&waitlists, orders, deps.orderValid, orderCount);
+        buildSalesCubes(&salesCubes, orders, deps.orderValid, orderCount, parts, partCount);
+        break;
+      }
+      case 7: {
+        promptDuplicatePolicy(&loadOptions);
+        break;
+      }
+      case 8: {
+        printCustomerSummary(customers, customerCount, &rollups, &lazyRecords);
+        break;
+      }
+      case 9: {
+        printPartShortages(parts, partCount, orders, deps.orderValid, orderCount, &lazyRecords);
+        break;
+      }
+      case 10: {
+        printPickLines(orders, deps.orderValid, orderCount, parts, partCount);
+        break;
+      }
+      case 11: {
+        printOrdersBetweenDates(orders, deps.orderValid, &orderDates);
+        break;
+      }
+      case 12: {
+        printCustomersWithoutPayment(customers, customerCount, &paymentZones, &lazyRecords);
+        break;
+      }
+      case 13: {
+        reserveOrderID(&orderIds);
+        break;
+      }
+      case 14: {
+        sortOrderDatabases();
+        break;
+      }
+      case 15: {
+        int shardCount = splitOrdersIntoShards(ORDERS_FILE);
+        if (shardCount < 0) {
+          printf("Failed to split %s into shards. See %s for details.\n", ORDERS_FILE, LOG_FILE);
+        }
+        else {
+          printf("Split %s into %d shard file(s).\n", ORDERS_FILE, shardCount);
+        }
+        break;
+      }
+      case 16: {
+        shardedOrders.duplicatePolicy = loadOptions.duplicatePolicy;
+        loadOrderShards(&shardedOrders, parts, partCount, customers, customerCount);
+        break;
+      }
+      case 17: {
+        printShardCustomerOrders(&shardedOrders);
+        break;
+      }
+      case 18: {
+        printShardOrderByID(&shardedOrders);
+        break;
+      }
+      case 19: {
+        reingestQuarantinedLines(customers, &customerCount, parts, &partCount, orders, &orderCount, &deps, &loadOptions);
+        buildBackorderWaitlists(&waitlists, orders, deps.orderValid, orderCount);
+        buildSalesCubes(&salesCubes, orders, deps.orderValid, orderCount, parts, partCount);
+        METRIC_WRITE(METRICS_FILE);
+        break;
+      }
+      case 20: {
+        toggleLazyLoading(&loadOptions, &lazyRecords);
+        break;
+      }
+      case 21: {
+        promptTrustedFiles(&loadOptions);
+        break;
+      }
+      case 22: {
+        pageOrderHistory(&orderStore, loadOptions.duplicatePolicy, parts, partCount, customers, customerCount);
+        break;
+      }
+      case 23: {
+        printStoredOrderByID(&orderStore);
+        break;
+      }
+      case 24: {
+        applyPayments(customers, customerCount, &paymentZones, &loadOptions);
+        break;
+      }
+      case 25: {
+        applyReceipts(parts, partCount, orders, deps.orderValid, orderCount, &waitlists, &rollups, &loadOptions);
+        break;
+      }
+      case 26: {
+        OrderSubmitter submitter;
+        memset(&submitter, 0, sizeof(OrderSubmitter));
+        submitter.customers = customers;
+        submitter.customerCount = &customerCount;
+        submitter.parts = parts;
+        submitter.partCount = &partCount;
+        submitter.orders = orders;
+        submitter.orderCount = &orderCount;
+        submitter.deps = &deps;
+        submitter.rollups = &rollups;
+        submitter.orderDates = &orderDates;
+        submitter.orderIds = &orderIds;
+        submitter.waitlists = &waitlists;
+        submitter.salesCubes = &salesCubes;
+        submitter.rankings = &rankings;
+        if (openOrderSubmitter(&submitter)) {
+          submitNewOrders(&submitter);
+          closeOrderSubmitter(&submitter);
+        }
+        break;
+      }
+      case 27: {
+        printSalesBetweenDates(&salesCubes);
+        break;
+      }
+      case 28: {
+        printOrderRankings(&rankings, &shardedOrders);
+        break;
+      }
+      case 29: {
+        freeOrderRankings(&rankings);
+        freeSalesCubes(&salesCubes);
+        freeBackorderWaitlists(&waitlists);
+        closeOrderStore(&orderStore);
+        freeLazyRecords(&lazyRecords);
+        freeShardedOrders(&shardedOrders);
+        METRIC_WRITE(METRICS_FILE);
+        freeOrderIdAllocator(&orderIds);
+        freePaymentZoneMap(&paymentZones);
+        freeOrderDateIndex(&orderDates);
+        freeCustomerRollups(&rollups);
+        freeDuplicateReport(&duplicates);
+        freeOrderDependencies(&deps);
         free(customers);
         free(parts);
         free(orders);
@@ -58,7 +316,7 @@ int main() {
         return 0;
       }
       default:
-        printf("Invalid choice. Please choose between option 1-5.\n");
+        printf("Invalid choice. Please choose between option 1-29.\n");
     }
   } 
 }
@@ -151,6 +409,7 @@ void printOrder(const Order* order) {
 // FUNCTION: printCustomers
 // DESCRIPTION:
 //    Prints the details of all customers in the provided array.
+//    Customers whose lazily loaded details turned out invalid are skipped.
 // PARAMETERS:
 //    const Customer* customers: Pointer to the array of Customer structs.
 //    int count: Number of customers in the array.
@@ -162,12 +421,15 @@ void printCustomers(const Customer* customers, int count) {
     return;
   }
   for (int i = 0; i < count; i++) {
-    printCustomer(&customers[i]);
+    if (customers[i].fieldState != FIELDS_INVALID) {
+      printCustomer(&customers[i]);
+    }
   }
 }
 // FUNCTION: printParts
 // DESCRIPTION:
 //    Prints the details of all parts in the provided array.
+//    Parts whose lazily loaded name or number turned out invalid are skipped.
 // PARAMETERS:
 //    const Part* parts: Pointer to the array of Part structs.
 //    int count: Number of parts in the array.
@@ -179,25 +441,736 @@ void printParts(const Part* parts, int count) {
     return;
   }
   for (int i = 0; i < count; i++) {
-    printPart(&parts[i]);
+    if (parts[i].fieldState != FIELDS_INVALID) {
+      printPart(&parts[i]);
+    }
   }
 }
 // FUNCTION: printOrders
 // DESCRIPTION:
-//    Prints the details of all orders in the provided array.
+//    Prints the details of all valid orders in the provided array.
+//    Orders invalidated by a later part or customer change are skipped.
 // PARAMETERS:
 //    const Order* orders: Pointer to the array of Order structs.
+//    const unsigned char* orderValid: Validity flag for each order, or NULL if all are valid.
 //    int count: Number of orders in the array.
 // RETURNS:
 //    void
-void printOrders(const Order* orders, int count) {
+void printOrders(const Order* orders, const unsigned char* orderValid, int count) {
   if (count == 0) {
     printf("No orders to display. Try loading databases first.\n");
     return;
   }
   for (int i = 0; i < count; i++) {
-    printOrder(&orders[i]);
+    if (orderValid == NULL || orderValid[i]) {
+      printOrder(&orders[i]);
+    }
+  }
+}
+// FUNCTION: updatePartCost
+// DESCRIPTION:
+//    Prompts for a part ID and a new cost, applies the change through updatePart
+//    and prints the orders whose validity flipped as a result.
+// PARAMETERS:
+//    Part* parts: The parts array.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    const Order* orders: The orders array.
+//    int orderCount: Number of orders.
+//    OrderDependencies* deps: The dependency index of the loaded orders.
+//    CustomerRollups* rollups: The customer order aggregates, updated for flipped orders.
+//    OrderRankings* rankings: The top customers and parts, updated for flipped orders.
+//    LazyRecords* lazy: The lazy sources, for a part whose name and number are not loaded yet.
+// RETURNS:
+//    void
+void updatePartCost(Part* parts, int partCount, const Customer* customers, int customerCount,
+  const Order* orders, int orderCount, OrderDependencies* deps, CustomerRollups* rollups, OrderRankings* rankings, LazyRecords* lazy) {
+  int partID = 0;
+  promptInt("Enter the part ID: ", &partID);
+  for (int i = 0; i < partCount; i++) {
+    if (parts[i].partID == partID) {
+      if (!materializePart(lazy, &parts[i])) { // updatePart validates the whole part
+        printf("Part %d has invalid details. See %s for details.\n", partID, LOG_FILE);
+        return;
+      }
+      Part updatedPart = parts[i];
+      promptFloat("Enter the new part cost: ", &updatedPart.partCost);
+      ValidityFlips flips;
+      if (!initValidityFlips(&flips, ORDERS_LIMIT)) {
+        printf("Failed to allocate memory for the update.\n");
+        return;
+      }
+      if (updatePart(parts, &partCount, &updatedPart, customers, customerCount, orders, orderCount, deps, &flips)) {
+        printValidityFlips(&flips, orders);
+        rollupApplyValidityFlips(rollups, &flips, orders);
+        rankingsApplyValidityFlips(rankings, &flips, orders);
+      }
+      else {
+        printf("Part update rejected. See %s for details.\n", LOG_FILE);
+      }
+      freeValidityFlips(&flips);
+      return;
+    }
+  }
+  printf("Part ID %d does not exist. Try loading databases first.\n", partID);
+}
+// FUNCTION: printCustomerSummary
+// DESCRIPTION:
+//    Prompts for a customer ID and prints the customer's order aggregates and credit exposure.
+// PARAMETERS:
+//    Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    const CustomerRollups* rollups: The customer order aggregates.
+//    LazyRecords* lazy: The lazy sources, for a customer whose name is not loaded yet.
+// RETURNS:
+//    void
+void printCustomerSummary(Customer* customers, int customerCount, const CustomerRollups* rollups, LazyRecords* lazy) {
+  int customerID = 0;
+  promptInt("Enter the customer ID: ", &customerID);
+  for (int i = 0; i < customerCount; i++) {
+    if (customers[i].customerID != customerID) {
+      continue;
+    }
+    materializeCustomer(lazy, &customers[i]);
+    const CustomerRollup* rollup = findCustomerRollup(rollups, customerID);
+    CustomerRollup empty;
+    memset(&empty, 0, sizeof(CustomerRollup));
+    empty.customerID = customerID;
+    if (rollup == NULL) {
+      rollup = &empty;
+    }
+    printf("Customer     : %s (ID %d)\n", customers[i].customerName, customerID);
+    printf("Orders       : %d (Unprocessed %d, Fulfilled %d, Insufficient Parts %d, Credit Exceeded %d)\n",
+      rollup->orderCount, rollup->unprocessedCount, rollup->fulfilledCount, rollup->insufficientPartsCount, rollup->creditExceededCount);
+    printf("Open Total   : $%.2f,\tFulfilled Total : $%.2f\n", rollup->openTotal, rollup->fulfilledTotal);
+    printf("Exposure     : $%.2f of $%.2f credit limit%s\n", getCustomerExposure(rollups, &customers[i]),
+      customers[i].customerCreditLimit, isWithinCreditLimit(rollups, &customers[i], 0.0) ? "" : " (EXCEEDED)");
+    printf("---------------------\n");
+    return;
   }
+  printf("Customer ID %d does not exist. Try loading databases first.\n", customerID);
+}
+// FUNCTION: printPartShortages
+// DESCRIPTION:
+//    Recalculates the demand of all open orders per part, updates each part's status
+//    and prints the parts that are short, largest shortage first.
+// PARAMETERS:
+//    Part* parts: The parts array, whose statuses are updated.
+//    int partCount: Number of parts.
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    int orderCount: Number of orders.
+//    LazyRecords* lazy: The lazy sources, for part numbers not loaded yet.
+// RETURNS:
+//    void
+void printPartShortages(Part* parts, int partCount, const Order* orders, const unsigned char* orderValid, int orderCount,
+  LazyRecords* lazy) {
+  if (partCount == 0) {
+    printf("No parts to display. Try loading databases first.\n");
+    return;
+  }
+  long long* demand = (long long*)malloc(partCount * sizeof(long long));
+  PartShortage* shortages = (PartShortage*)malloc(partCount * sizeof(PartShortage));
+  if (demand == NULL || shortages == NULL || calculatePartDemand(parts, partCount, orders, orderValid, orderCount, demand) < 0) {
+    printf("Failed to calculate part demand.\n");
+    free(demand);
+    free(shortages);
+    return;
+  }
+  int shortageCount = rankPartShortages(parts, partCount, demand, shortages);
+  for (int i = 0; i < shortageCount; i++) {
+    materializePart(lazy, &parts[shortages[i].partPosition]);
+  }
+  printShortageReport(parts, shortages, shortageCount);
+  free(demand);
+  free(shortages);
+}
+// FUNCTION: printPickLines
+// DESCRIPTION:
+//    Builds the pick list for all fulfilled orders, batched into waves and sorted in walk order, and prints it.
+// PARAMETERS:
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    int orderCount: Number of orders.
+//    const Part* parts: The parts array.
+//    int partCount: Number of parts.
+// RETURNS:
+//    void
+void printPickLines(const Order* orders, const unsigned char* orderValid, int orderCount, const Part* parts, int partCount) {
+  PickLine* lines = NULL;
+  int lineCount = buildPickList(orders, orderValid, orderCount, parts, partCount, PICK_WAVE_ORDERS, &lines);
+  if (lineCount < 0) {
+    printf("Failed to build the pick list.\n");
+    return;
+  }
+  printPickList(lines, lineCount);
+  free(lines);
+}
+// FUNCTION: printOrdersBetweenDates
+// DESCRIPTION:
+//    Prompts for a date range and prints the valid orders dated within it, oldest first.
+// PARAMETERS:
+//    const Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    const OrderDateIndex* orderDates: The orders sorted by date.
+// RETURNS:
+//    void
+void printOrdersBetweenDates(const Order* orders, const unsigned char* orderValid, const OrderDateIndex* orderDates) {
+  if (orderDates->count == 0) {
+    printf("No orders to display. Try loading databases first.\n");
+    return;
+  }
+  int fromDay = promptDate("Enter the start date (YYYY-MM-DD): ");
+  int toDay = promptDate("Enter the end date (YYYY-MM-DD): ");
+  int first = 0;
+  int matchCount = findOrdersBetween(orderDates, orders, fromDay, toDay, &first);
+  int printedCount = 0;
+  for (int i = first; i < first + matchCount; i++) {
+    int position = orderDates->positions[i];
+    if (orderValid[position]) {
+      printOrder(&orders[position]);
+      printedCount++;
+    }
+  }
+  printf("%d order(s) found.\n", printedCount);
+}
+// FUNCTION: printCustomersWithoutPayment
+// DESCRIPTION:
+//    Prompts for a number of days and prints the customers who have not made a payment in that many days.
+// PARAMETERS:
+//    Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    const PaymentZoneMap* paymentZones: The zone map over the customers' last payment days.
+//    LazyRecords* lazy: The lazy sources, for customer details not loaded yet.
+// RETURNS:
+//    void
+void printCustomersWithoutPayment(Customer* customers, int customerCount, const PaymentZoneMap* paymentZones, LazyRecords* lazy) {
+  if (customerCount == 0) {
+    printf("No customers to display. Try loading databases first.\n");
+    return;
+  }
+  int days = 0;
+  promptInt("Enter the number of days: ", &days);
+  int* positions = (int*)malloc(customerCount * sizeof(int));
+  if (positions == NULL) {
+    printf("Failed to allocate memory for the search.\n");
+    return;
+  }
+  int matchCount = findCustomersWithoutPaymentSince(paymentZones, customers, customerCount, getTodayDayNumber() - days, positions);
+  for (int i = 0; i < matchCount; i++) {
+    materializeCustomer(lazy, &customers[positions[i]]);
+    printCustomer(&customers[positions[i]]);
+  }
+  printf("%d customer(s) found.\n", matchCount);
+  free(positions);
+}
+// FUNCTION: reserveOrderID
+// DESCRIPTION:
+//    Prompts for an order date and prints the next unused order ID for that day.
+// PARAMETERS:
+//    OrderIdAllocator* orderIds: The order ID allocator, seeded by the last orders load.
+// RETURNS:
+//    void
+void reserveOrderID(OrderIdAllocator* orderIds) {
+  long long orderID = allocateOrderID(orderIds, promptDate("Enter the order date (YYYY-MM-DD): "));
+  if (orderID == 0) {
+    printf("No order IDs are left for that date.\n");
+    return;
+  }
+  printf("Reserved order ID %lld.\n", orderID);
+}
+// FUNCTION: sortOrderDatabases
+// DESCRIPTION:
+//    Prompts for one or more order files and an output file, then sorts the orders by orderID
+//    into the output file, optionally removing records with a repeated orderID.
+// PARAMETERS:
+//    void
+// RETURNS:
+//    void
+void sortOrderDatabases() {
+  char inputFiles[MERGE_FAN_IN][260];
+  const char* inputNames[MERGE_FAN_IN];
+  char outputFile[260];
+  int inputCount = 0;
+  int isRemovingDuplicates = 0;
+  while (1) {
+    promptInt("Enter the number of order files to merge: ", &inputCount);
+    if (inputCount >= 1 && inputCount <= MERGE_FAN_IN) {
+      break;
+    }
+    printf("Invalid count. Please enter a number between 1 and %d.\n", MERGE_FAN_IN);
+  }
+  for (int i = 0; i < inputCount; i++) {
+    promptText("Enter an order file name: ", inputFiles[i], sizeof(inputFiles[i]));
+    inputNames[i] = inputFiles[i];
+  }
+  promptText("Enter the output file name: ", outputFile, sizeof(outputFile));
+  promptInt("Remove records with a repeated order ID? (1 = yes, 0 = no): ", &isRemovingDuplicates);
+  int duplicateCount = 0;
+  int writtenCount = sortOrderFiles(inputNames, inputCount, outputFile, SORT_MEMORY_BYTES, isRemovingDuplicates == 1, &duplicateCount);
+  if (writtenCount < 0) {
+    printf("Failed to sort the order files. See %s for details.\n", LOG_FILE);
+    return;
+  }
+  printf("Wrote %d order(s) to %s, %d duplicate(s) removed.\n", writtenCount, outputFile, duplicateCount);
+}
+// FUNCTION: loadOrderShards
+// DESCRIPTION:
+//    Loads the order shard files that changed since the last load, validated against the loaded
+//    customers and parts, and prints how many shards were reloaded.
+// PARAMETERS:
+//    ShardedOrders* sharded: The sharded orders to refresh.
+//    const Part* parts: The parts array.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+// RETURNS:
+//    void
+void loadOrderShards(ShardedOrders* sharded, const Part* parts, int partCount, const Customer* customers, int customerCount) {
+  if (customerCount == 0 || partCount == 0) {
+    printf("Load the customers and parts before loading order shards.\n");
+    return;
+  }
+  int reloadedCount = loadChangedShards(sharded, parts, partCount, customers, customerCount);
+  if (reloadedCount < 0) {
+    printf("Failed to load the order shards. See %s for details.\n", LOG_FILE);
+    return;
+  }
+  printf("%d shard(s) reloaded, %d order(s) loaded across all shards.\n", reloadedCount, countShardedOrders(sharded));
+}
+// FUNCTION: printShardCustomerOrders
+// DESCRIPTION:
+//    Prompts for a customer ID and prints the customer's orders, read from the customer's shard only.
+// PARAMETERS:
+//    const ShardedOrders* sharded: The sharded orders.
+// RETURNS:
+//    void
+void printShardCustomerOrders(const ShardedOrders* sharded) {
+  int customerID = 0;
+  promptInt("Enter the customer ID: ", &customerID);
+  ShardHit hits[ORDERS_LIMIT];
+  int matchCount = findCustomerShardOrders(sharded, customerID, hits, ORDERS_LIMIT);
+  for (int i = 0; i < matchCount && i < ORDERS_LIMIT; i++) {
+    printOrder(&sharded->shards[hits[i].shard].orders[hits[i].position]);
+  }
+  printf("%d order(s) found in shard %d.\n", matchCount, getOrderShard(customerID));
+}
+// FUNCTION: isOrderWithID
+// DESCRIPTION:
+//    Sharded query predicate matching one orderID.
+// PARAMETERS:
+//    const Order* order: The order to test.
+//    const void* context: Pointer to the long long orderID to match.
+// RETURNS:
+//    int : 1 if the order has the ID, 0 otherwise.
+int isOrderWithID(const Order* order, const void* context) {
+  return order->orderID == *(const long long*)context;
+}
+// FUNCTION: printShardOrderByID
+// DESCRIPTION:
+//    Prompts for an order ID and searches every shard for it, since orders are not sharded by orderID.
+// PARAMETERS:
+//    const ShardedOrders* sharded: The sharded orders.
+// RETURNS:
+//    void
+void printShardOrderByID(const ShardedOrders* sharded) {
+  char inputBuffer[100];
+  long long orderID = 0;
+  promptText("Enter the order ID: ", inputBuffer, sizeof(inputBuffer));
+  if (!validateOrderID(inputBuffer)) {
+    printf("Order ID must be in YYYYMMDDSSS format.\n");
+    return;
+  }
+  sscanf_s(inputBuffer, "%lld", &orderID);
+  ShardHit hits[ORDERS_LIMIT];
+  int matchCount = queryShardedOrders(sharded, isOrderWithID, &orderID, hits, ORDERS_LIMIT);
+  for (int i = 0; i < matchCount && i < ORDERS_LIMIT; i++) {
+    printf("Shard %d:\n", hits[i].shard);
+    printOrder(&sharded->shards[hits[i].shard].orders[hits[i].position]);
+  }
+  if (matchCount <= 0) {
+    printf("Order %lld not found in any shard.\n", orderID);
+  }
+}
+// FUNCTION: pageOrderHistory
+// DESCRIPTION:
+//    Rebuilds the paged order store from the shard files, replacing any earlier one.
+// PARAMETERS:
+//    OrderStore* store: The order store, open or not.
+//    DuplicatePolicy duplicatePolicy: Applied within each shard.
+//    const Part* parts: The parts used to validate orders.
+//    int partCount: Number of parts.
+//    const Customer* customers: The customers used to validate orders.
+//    int customerCount: Number of customers.
+// RETURNS:
+//    void
+void pageOrderHistory(OrderStore* store, DuplicatePolicy duplicatePolicy, const Part* parts, int partCount,
+  const Customer* customers, int customerCount) {
+  if (partCount == 0 || customerCount == 0) {
+    printf("Load the databases first so that the orders can be validated.\n");
+    return;
+  }
+  closeOrderStore(store);
+  if (!openOrderStore(store, ORDER_PAGE_FILE, PAGE_POOL_FRAMES)) {
+    printf("Failed to create the paged order store. See %s for details.\n", LOG_FILE);
+    return;
+  }
+  int storedCount = pageOrderShards(store, duplicatePolicy, parts, partCount, customers, customerCount);
+  if (storedCount < 0) {
+    closeOrderStore(store);
+    printf("Failed to page the order shards. See %s for details.\n", LOG_FILE);
+    return;
+  }
+  printf("%d order(s) paged to %s in %d page(s), %d held in memory.\n", storedCount, ORDER_PAGE_FILE,
+    store->pages.pageCount, PAGE_POOL_FRAMES);
+}
+// FUNCTION: printStoredOrderByID
+// DESCRIPTION:
+//    Prompts for an order ID and prints the order from the paged order store, followed by how
+//    often the buffer pool had the pages it needed.
+// PARAMETERS:
+//    OrderStore* store: The order store.
+// RETURNS:
+//    void
+void printStoredOrderByID(OrderStore* store) {
+  if (!store->isOpen) {
+    printf("Page the order shards to disk first.\n");
+    return;
+  }
+  char inputBuffer[100];
+  long long orderID = 0;
+  promptText("Enter the order ID: ", inputBuffer, sizeof(inputBuffer));
+  if (!validateOrderID(inputBuffer)) {
+    printf("Order ID must be in YYYYMMDDSSS format.\n");
+    return;
+  }
+  sscanf_s(inputBuffer, "%lld", &orderID);
+  Order order;
+  if (findStoredOrder(store, orderID, &order)) {
+    printOrder(&order);
+  }
+  else {
+    printf("Order %lld not found in the paged orders.\n", orderID);
+  }
+  printf("Buffer pool: %lld hit(s), %lld page fault(s), %lld page(s) written back.\n", store->pages.hits,
+    store->pages.faults, store->pages.writeBacks);
+}
+// FUNCTION: applyPayments
+// DESCRIPTION:
+//    Applies the payments database to the loaded customers and prints how many payments were
+//    applied and rejected.
+// PARAMETERS:
+//    Customer* customers: The customers array.
+//    int customerCount: Number of customers.
+//    PaymentZoneMap* paymentZones: The last payment zone map, rebuilt after the payments.
+//    const LoadOptions* loadOptions: The load options, for whether rejected lines are quarantined.
+// RETURNS:
+//    void
+void applyPayments(Customer* customers, int customerCount, PaymentZoneMap* paymentZones, const LoadOptions* loadOptions) {
+  if (customerCount == 0) {
+    printf("Load the databases first so that the payments can be applied.\n");
+    return;
+  }
+  PaymentSummary summary;
+  if (!applyPaymentsFile(customers, customerCount, PAYMENTS_FILE, paymentZones, loadOptions->isQuarantining, &summary)) {
+    printf("Failed to apply %s. See %s for details.\n", PAYMENTS_FILE, LOG_FILE);
+    return;
+  }
+  printf("Applied %d of %d payment(s), %.2f in total, to %d customer(s).\n", summary.appliedCount, summary.lineCount,
+    summary.appliedTotal, summary.customerCount);
+  if (summary.rejectedCount > 0) {
+    printf("%d payment(s) rejected. See %s for details.\n", summary.rejectedCount, LOG_FILE);
+  }
+}
+// FUNCTION: applyReceipts
+// DESCRIPTION:
+//    Applies the receipts database to the loaded parts, re-fulfills the backordered orders
+//    waiting for the restocked parts and prints what changed.
+// PARAMETERS:
+//    Part* parts: The parts array.
+//    int partCount: Number of parts.
+//    Order* orders: The orders array.
+//    const unsigned char* orderValid: Validity flag for each order.
+//    int orderCount: Number of orders.
+//    BackorderWaitlists* waitlists: The waitlists of the backordered orders.
+//    CustomerRollups* rollups: The customer order rollups.
+//    const LoadOptions* loadOptions: The load options, for whether rejected lines are quarantined.
+// RETURNS:
+//    void
+void applyReceipts(Part* parts, int partCount, Order* orders, const unsigned char* orderValid, int orderCount,
+  BackorderWaitlists* waitlists, CustomerRollups* rollups, const LoadOptions* loadOptions) {
+  if (partCount == 0) {
+    printf("Load the databases first so that the receipts can be applied.\n");
+    return;
+  }
+  ReceiptSummary summary;
+  if (!applyReceiptsFile(parts, partCount, orders, orderValid, orderCount, waitlists, rollups, RECEIPTS_FILE,
+      loadOptions->isQuarantining, &summary)) {
+    printf("Failed to apply %s. See %s for details.\n", RECEIPTS_FILE, LOG_FILE);
+    return;
+  }
+  printf("Received %lld unit(s) from %d of %d receipt(s).\n", summary.unitsReceived, summary.receivedCount, summary.lineCount);
+  printf("%d backordered order(s) retried, %d fulfilled.\n", summary.retriedCount, summary.fulfilledCount);
+  if (summary.rejectedCount > 0) {
+    printf("%d receipt(s) rejected. See %s for details.\n", summary.rejectedCount, LOG_FILE);
+  }
+}
+// FUNCTION: submitNewOrders
+// DESCRIPTION:
+//    Prompts for new orders until a customer ID of 0 is entered, giving each the next order ID of
+//    its date and the totals of its parts, then submits them together as one batch and prints the
+//    outcome of each.
+// PARAMETERS:
+//    OrderSubmitter* submitter: The opened submitter for the loaded records.
+// RETURNS:
+//    void
+void submitNewOrders(OrderSubmitter* submitter) {
+  if (*submitter->partCount == 0 || *submitter->customerCount == 0) {
+    printf("Load the databases first so that orders can be submitted.\n");
+    return;
+  }
+  Order batch[ORDERS_LIMIT];
+  int results[ORDERS_LIMIT];
+  int batchCount = 0;
+  while (batchCount < ORDERS_LIMIT - *submitter->orderCount) {
+    Order* order = &batch[batchCount];
+    memset(order, 0, sizeof(Order));
+    promptInt("Enter the customer ID (0 to submit the orders entered): ", &order->customerID);
+    if (order->customerID == 0) {
+      break;
+    }
+    order->orderID = allocateOrderID(submitter->orderIds, promptDate("Enter the order date (YYYY-MM-DD): "));
+    if (order->orderID == 0) {
+      printf("No order IDs are left for that date.\n");
+      continue;
+    }
+    promptInt("Enter the order status (0, 1, 99 or 500): ", &order->orderStatus);
+    while (order->distinctParts < 1 || order->distinctParts > PARTS_LIMIT) {
+      promptInt("Enter the number of distinct parts: ", &order->distinctParts);
+    }
+    for (int i = 0; i < order->distinctParts; i++) {
+      promptInt("Enter the part ID: ", &order->orderedParts[i].partID);
+      promptInt("Enter the quantity ordered: ", &order->orderedParts[i].quantityOrdered);
+      int position = findIdIndex(&submitter->partIndex, order->orderedParts[i].partID);
+      if (position != ID_INDEX_NOT_FOUND) {
+        order->totalParts += order->orderedParts[i].quantityOrdered;
+        order->orderTotal += submitter->parts[position].partCost * order->orderedParts[i].quantityOrdered;
+      }
+    }
+    batchCount++;
+  }
+  if (batchCount == 0) {
+    printf("No orders submitted.\n");
+    return;
+  }
+  int acceptedCount = submitOrders(submitter, batch, batchCount, results);
+  for (int i = 0; i < batchCount; i++) {
+    printf("Order %lld: %s\n", batch[i].orderID, results[i] == 0 ? "accepted" : "rejected");
+  }
+  printf("%d of %d order(s) accepted.\n", acceptedCount, batchCount);
+  if (acceptedCount < batchCount) {
+    printf("See %s for why orders were rejected.\n", LOG_FILE);
+  }
+}
+// FUNCTION: printSalesBetweenDates
+// DESCRIPTION:
+//    Prompts for a part or customer and two dates and prints the units, amount and orders sold
+//    between them, from the sales cubes.
+// PARAMETERS:
+//    const SalesCubes* salesCubes: The sales cubes of the loaded orders.
+// RETURNS:
+//    void
+void printSalesBetweenDates(const SalesCubes* salesCubes) {
+  int kind = 0;
+  while (kind != 1 && kind != 2) {
+    promptInt("Show sales of (1 = part, 2 = customer): ", &kind);
+  }
+  int key = 0;
+  promptInt(kind == 1 ? "Enter the part ID: " : "Enter the customer ID: ", &key);
+  int fromDay = promptDate("Enter the start date (YYYY-MM-DD): ");
+  int toDay = promptDate("Enter the end date (YYYY-MM-DD): ");
+  SalesCell total;
+  if (!querySales(kind == 1 ? &salesCubes->partSales : &salesCubes->customerSales, key, fromDay, toDay, &total)) {
+    printf("No sales for %s ID %d. Try loading databases first.\n", kind == 1 ? "part" : "customer", key);
+    return;
+  }
+  printf("Units Sold   : %lld\n", total.units);
+  printf("Amount       : $%.2f\n", total.amount);
+  printf("%s : %lld\n", kind == 1 ? "Order Lines " : "Orders      ", total.orderCount);
+}
+// FUNCTION: printOrderRankings
+// DESCRIPTION:
+//    Prints the top customers by order total and the top parts by quantity ordered, from the
+//    rankings counted while the orders loaded, then the same across the loaded order shards.
+// PARAMETERS:
+//    const OrderRankings* rankings: The rankings of the loaded orders.
+//    const ShardedOrders* sharded: The sharded orders, whose per-shard rankings are merged.
+// RETURNS:
+//    void
+void printOrderRankings(const OrderRankings* rankings, const ShardedOrders* sharded) {
+  if (rankings->customerTotals.count == 0 && countShardedOrders(sharded) == 0) {
+    printf("No orders to rank. Try loading databases or order shards first.\n");
+    return;
+  }
+  if (rankings->customerTotals.count > 0) {
+    printf("Loaded orders:\n");
+    printRankedKeys(&rankings->customerTotals, "Customer", "Order Total");
+    printRankedKeys(&rankings->partQuantities, "Part", "Quantity");
+  }
+  if (countShardedOrders(sharded) > 0) {
+    OrderRankings merged;
+    if (!initOrderRankings(&merged, HEAVY_HITTER_SLOTS) || !mergeShardRankings(sharded, &merged)) {
+      printf("Failed to merge the shard rankings. See %s for details.\n", LOG_FILE);
+      freeOrderRankings(&merged);
+      return;
+    }
+    printf("Orders across the shards:\n");
+    printRankedKeys(&merged.customerTotals, "Customer", "Order Total");
+    printRankedKeys(&merged.partQuantities, "Part", "Quantity");
+    freeOrderRankings(&merged);
+  }
+}
+// FUNCTION: printRankedKeys
+// DESCRIPTION:
+//    Prints the heaviest keys of a ranking, with how much each may be overcounted, and the most
+//    any key not listed can weigh.
+// PARAMETERS:
+//    const HeavyHitters* hitters: The ranking.
+//    const char* keyName: What the keys are, e.g. "Customer".
+//    const char* weightName: What the weights are, e.g. "Quantity".
+// RETURNS:
+//    void
+void printRankedKeys(const HeavyHitters* hitters, const char* keyName, const char* weightName) {
+  RankedKey top[TOP_RANKED_KEYS];
+  int topCount = getTopRankedKeys(hitters, TOP_RANKED_KEYS, top);
+  printf("Top %d %s(s) by %s:\n", topCount, keyName, weightName);
+  for (int i = 0; i < topCount; i++) {
+    printf("%3d. %s ID %-6lld %s: %.2f", i + 1, keyName, top[i].key, weightName, top[i].weight);
+    if (top[i].error > 0.0) {
+      printf(" (at most %.2f too high)", top[i].error);
+    }
+    printf("\n");
+  }
+  if (topCount == TOP_RANKED_KEYS) {
+    printf("Every %s not listed has a %s of at most %.2f.\n", keyName, weightName, top[topCount - 1].weight);
+  }
+  printf("---------------------\n");
+}
+// FUNCTION: reingestQuarantinedLines
+// DESCRIPTION:
+//    Loads the quarantined lines of each database again, after they were fixed, and appends the
+//    ones that are now valid to the loaded records. Customers and parts go first so orders that
+//    were rejected for an unknown customer or part can pass. Lines that are still rejected are
+//    quarantined again. The records already loaded win over re-ingested lines with the same ID.
+// PARAMETERS:
+//    Customer* customers: The customers array.
+//    int* customerCount: Number of customers, updated.
+//    Part* parts: The parts array.
+//    int* partCount: Number of parts, updated.
+//    Order* orders: The orders array.
+//    int* orderCount: Number of orders, updated.
+//    OrderDependencies* deps: The order dependency index, extended with the new orders.
+//    const LoadOptions* loadOptions: The options of the full load.
+// RETURNS:
+//    void
+void reingestQuarantinedLines(Customer* customers, int* customerCount, Part* parts, int* partCount, Order* orders, int* orderCount,
+  OrderDependencies* deps, const LoadOptions* loadOptions) {
+  LoadOptions reingestOptions = *loadOptions;
+  reingestOptions.duplicatePolicy = DUPLICATE_KEEP_FIRST;
+  reingestOptions.isQuarantining = 1;
+  reingestOptions.lazy = NULL; // Offsets into the work file would not outlive it
+  reingestOptions.trustedFiles = 0; // Quarantined lines have no checksum
+  char workFileName[QUARANTINE_FILE_NAME_SIZE];
+  int addedCustomers = 0;
+  int addedParts = 0;
+  int addedOrders = 0;
+  if (beginReingest(CUSTOMERS_FILE, workFileName, sizeof(workFileName))) {
+    reingestOptions.existingCount = *customerCount;
+    int newCount = loadCustomers(customers, workFileName, &reingestOptions);
+    if (newCount >= 0) {
+      addedCustomers = newCount - *customerCount;
+      *customerCount = newCount;
+    }
+    endReingest(workFileName);
+  }
+  if (beginReingest(PARTS_FILE, workFileName, sizeof(workFileName))) {
+    reingestOptions.existingCount = *partCount;
+    int newCount = loadParts(parts, workFileName, &reingestOptions);
+    if (newCount >= 0) {
+      addedParts = newCount - *partCount;
+      *partCount = newCount;
+    }
+    endReingest(workFileName);
+  }
+  if (beginReingest(ORDERS_FILE, workFileName, sizeof(workFileName))) {
+    reingestOptions.existingCount = *orderCount;
+    int newCount = loadOrders(orders, parts, *partCount, customers, *customerCount, workFileName, &reingestOptions);
+    for (int i = *orderCount; i < newCount; i++) {
+      addOrderDependencies(deps, &orders[i], i);
+    }
+    addedOrders = newCount - *orderCount;
+    *orderCount = newCount;
+    endReingest(workFileName);
+  }
+  printf("Re-ingested %d customers, %d parts, and %d orders. Lines still rejected remain in the %s files.\n",
+    addedCustomers, addedParts, addedOrders, QUARANTINE_LINES_SUFFIX);
+}
+// FUNCTION: toggleLazyLoading
+// DESCRIPTION:
+//    Turns lazy loading of customer and part details on or off for the next loads. When on, only
+//    IDs, amounts and dates are parsed while loading, and the other fields on first use.
+// PARAMETERS:
+//    LoadOptions* options: The load options to update.
+//    LazyRecords* lazy: The lazy sources used when lazy loading is on.
+// RETURNS:
+//    void
+void toggleLazyLoading(LoadOptions* options, LazyRecords* lazy) {
+  options->lazy = options->lazy == NULL ? lazy : NULL;
+  printf("Lazy loading of customer and part details is %s for the next load.\n", options->lazy != NULL ? "on" : "off");
+}
+// FUNCTION: promptTrustedFiles
+// DESCRIPTION:
+//    Prompts for which databases are loaded in trusted-input mode. Their fields are not format
+//    checked; instead the whole file must match its <database>.crc32 checksum, and orders still
+//    have their customer, parts and totals checked.
+// PARAMETERS:
+//    LoadOptions* options: The load options to update.
+// RETURNS:
+//    void
+void promptTrustedFiles(LoadOptions* options) {
+  const char* fileNames[] = { CUSTOMERS_FILE, PARTS_FILE, ORDERS_FILE };
+  const int flags[] = { TRUSTED_CUSTOMERS, TRUSTED_PARTS, TRUSTED_ORDERS };
+  char prompt[100];
+  for (int i = 0; i < 3; i++) {
+    int isTrusted = -1;
+    snprintf(prompt, sizeof(prompt), "Trust %s (1 = yes, 0 = no): ", fileNames[i]);
+    while (isTrusted != 0 && isTrusted != 1) {
+      promptInt(prompt, &isTrusted);
+    }
+    options->trustedFiles = isTrusted ? options->trustedFiles | flags[i] : options->trustedFiles & ~flags[i];
+  }
+}
+// FUNCTION: promptDuplicatePolicy
+// DESCRIPTION:
+//    Prompts the user for how records with a repeated customerID, partID or orderID are loaded.
+// PARAMETERS:
+//    LoadOptions* options: The load options to update.
+// RETURNS:
+//    void
+void promptDuplicatePolicy(LoadOptions* options) {
+  int policy = 0;
+  printf("1. Reject all records sharing an ID\n");
+  printf("2. Keep the first record with an ID\n");
+  printf("3. Keep the last record with an ID\n");
+  while (1) {
+    promptInt("Enter the duplicate ID policy (1-3): ", &policy);
+    if (policy >= 1 && policy <= 3) {
+      break;
+    }
+    printf("Invalid choice. Please choose between option 1-3.\n");
+  }
+  options->duplicatePolicy = policy == 1 ? DUPLICATE_REJECT : policy == 2 ? DUPLICATE_KEEP_FIRST : DUPLICATE_KEEP_LAST;
 }
 // FUNCTION: printMenu
 // DESCRIPTION:
@@ -210,7 +1183,31 @@ void printMenu() {
   printf("2. List Valid Customer(s)\n");
   printf("3. List Valid Part(s)\n");
   printf("4. List Valid Order(s)\n");
-  printf("5. Free memory and exit\n");
+  printf("5. Watch Database(s) for Changes\n");
+  printf("6. Update Part Cost\n");
+  printf("7. Set Duplicate ID Policy\n");
+  printf("8. Show Customer Order Summary\n");
+  printf("9. Calculate Part Demand and Shortages\n");
+  printf("10. Generate Pick List for Fulfilled Orders\n");
+  printf("11. Find Orders Between Two Dates\n");
+  printf("12. Find Customers Without a Recent Payment\n");
+  printf("13. Reserve a New Order ID\n");
+  printf("14. Sort and Merge Order Files\n");
+  printf("15. Split Orders into Shard Files\n");
+  printf("16. Load Changed Order Shards\n");
+  printf("17. Find a Customer's Orders in the Shards\n");
+  printf("18. Find an Order by ID Across the Shards\n");
+  printf("19. Re-ingest Quarantined Lines\n");
+  printf("20. Toggle Lazy Loading of Customer and Part Details\n");
+  printf("21. Set Trusted Input Files\n");
+  printf("22. Page Order Shards to Disk\n");
+  printf("23. Find an Order by ID in the Paged Orders\n");
+  printf("24. Apply Payments from %s\n", PAYMENTS_FILE);
+  printf("25. Apply Stock Receipts from %s\n", RECEIPTS_FILE);
+  printf("26. Submit New Orders\n");
+  printf("27. Show Sales of a Part or Customer Between Two Dates\n");
+  printf("28. Show Top Customers and Parts\n");
+  printf("29. Free memory and exit\n");
 }
 // FUNCTION: promptInt
 // DESCRIPTION:
@@ -244,6 +1241,97 @@ void promptInt(const char* prompt, int* input) {
     }
   }
 }
+// FUNCTION: promptFloat
+// DESCRIPTION:
+//		Prompts the user for a number and validates it.
+//		Continues to prompt until a valid number is entered.
+// PARAMETERS:
+//		const char* prompt : The prompt message to display to the user.
+//		float* input : Pointer to the float variable where the input will be stored.
+// RETURNS:
+//		void
+void promptFloat(const char* prompt, float* input) {
+  char inputBuffer[100];
+  while (1) {
+    printf("%s", prompt);
+    fgets(inputBuffer, sizeof(inputBuffer), stdin);
+    // When user input exceeds buffer amount
+    if (!strchr(inputBuffer, '\n')) {
+      flushInputStream();
+      printf("Input exceeds buffer size. Please try again.\n");
+      continue;
+    }
+
+    inputBuffer[strlen(inputBuffer) - 1] = '\0'; // Remove the trailing newline 
+
+    if (isNumber(inputBuffer)) {
+      sscanf_s(inputBuffer, "%f", input); // Writes directly into input
+      return;
+    }
+    else {
+      printf("Input must be a valid number. Try again\n");
+    }
+  }
+}
+// FUNCTION: promptDate
+// DESCRIPTION:
+//		Prompts the user for a date in YYYY-MM-DD format.
+//		Continues to prompt until a valid date is entered.
+// PARAMETERS:
+//		const char* prompt : The prompt message to display to the user.
+// RETURNS:
+//		int : The entered date as a day number.
+int promptDate(const char* prompt) {
+  char inputBuffer[100];
+  while (1) {
+    printf("%s", prompt);
+    fgets(inputBuffer, sizeof(inputBuffer), stdin);
+    // When user input exceeds buffer amount
+    if (!strchr(inputBuffer, '\n')) {
+      flushInputStream();
+      printf("Input exceeds buffer size. Please try again.\n");
+      continue;
+    }
+
+    inputBuffer[strlen(inputBuffer) - 1] = '\0'; // Remove the trailing newline 
+
+    if (validateDate(inputBuffer)) {
+      return dateToDayNumber(inputBuffer);
+    }
+    else {
+      printf("Input must be a valid date. Try again\n");
+    }
+  }
+}
+// FUNCTION: promptText
+// DESCRIPTION:
+//		Prompts the user for a line of text.
+//		Continues to prompt until a non-empty line that fits in the buffer is entered.
+// PARAMETERS:
+//		const char* prompt : The prompt message to display to the user.
+//		char* input : Receives the text, without the trailing newline.
+//		int size : The size of the input buffer.
+// RETURNS:
+//		void
+void promptText(const char* prompt, char* input, int size) {
+  while (1) {
+    printf("%s", prompt);
+    fgets(input, size, stdin);
+    // When user input exceeds buffer amount
+    if (!strchr(input, '\n')) {
+      flushInputStream();
+      printf("Input exceeds buffer size. Please try again.\n");
+      continue;
+    }
+
+    input[strlen(input) - 1] = '\0'; // Remove the trailing newline 
+
+    if (input[0] != '\0') {
+      return;
+    }
+    printf("Input must not be empty. Try again\n");
+  }
+}
 // FUNCTION: flushInputStream
 // DESCRIPTION:
 //		Flushes the input stream to remove any remaining characters.